@@ -5,29 +5,34 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include "../../application/command_line_options.h"
 #include "../../base/exception.h"
 #include "../../csv/stream.h"
 #include "../../csv/traits.h"
 #include "../../name_value/parser.h"
-#include "../multidimensional/array.h"
-#include "../multidimensional/traits.h"
+#include "../../string/split.h"
+#include "../multidimensional/lut.h"
 
 void usage( bool verbose )
 {
     std::cerr << "operations on a multidimensional lookup table" << std::endl;
-    std::cerr << "lookup tables with up to 4-dimension" << std::endl;
-    std::cerr << "values are currently supported; if you need more, just ask" << std::endl;
+    std::cerr << "lookup tables with up to 16 dimensions and values of any number of elements are supported" << std::endl;
     std::cerr << std::endl;
     std::cerr << "usage: cat input.csv | math-lookup <operation> [<lut-filename>[;<lut-csv-options>]] <options>" << std::endl;
     std::cerr << std::endl;
     std::cerr << "operations" << std::endl;
-    std::cerr << "    index: todo: output index for a given input" << std::endl;
-    std::cerr << "    interpolate: output interpolated value for the given input" << std::endl;
-    std::cerr << "    nearest: todo: output table element index and value nearest to the given input" << std::endl;
+    std::cerr << "    index: output index of table element for a given input" << std::endl;
+    std::cerr << "    interpolate: output index and multilinearly interpolated value for the given input" << std::endl;
+    std::cerr << "                 inputs past the last table element in a dimension, but less than one resolution beyond it," << std::endl;
+    std::cerr << "                 are extrapolated from the last cell; inputs further out are outside lookup table" << std::endl;
+    std::cerr << "    nearest: output index and value of table element nearest to the given input" << std::endl;
     std::cerr << "    query: output table element index and value for the given input" << std::endl;
     std::cerr << std::endl;
     std::cerr << "options" << std::endl;
+    std::cerr << "    --batch-size=<n>; default=4096: number of inputs to process at once, if more input is available" << std::endl;
+    std::cerr << "    --no-mmap: read lookup table into memory; default: memory-map lookup table file" << std::endl;
     std::cerr << "    --origin,-o=<point>; e.g: --origin=0,1,2,3" << std::endl;
     std::cerr << "    --resolution,-r=<point>; e.g: --resolution=0.5,3,2,3" << std::endl;
     std::cerr << "    --shape=<point>; e.g: --shape=3,2,5,3, same as in numpy" << std::endl;
@@ -36,201 +41,175 @@ void usage( bool verbose )
     std::cerr << "                     is rows first" << std::endl;
     std::cerr << std::endl;
     std::cerr << "input/output options" << std::endl;
-    std::cerr << "    --input-fields; todo: print input fields for an operation to stdout and exit" << std::endl;
-    std::cerr << "    --output-fields; todo: print output fields for an operation to stdout and exit" << std::endl;
-    std::cerr << "    --output-format; todo: print output format for an operation to stdout and exit" << std::endl;
-    std::cerr << "    --permissive; discard inputs outside lookup table" << std::endl;
+    std::cerr << "    --input-fields: print input fields to stdout and exit; requires --shape" << std::endl;
+    std::cerr << "    --output-fields: print output fields for an operation to stdout and exit; requires --shape and lookup table" << std::endl;
+    std::cerr << "    --output-format: print output format for an operation to stdout and exit; requires --shape and lookup table" << std::endl;
+    std::cerr << "    --permissive; discard inputs outside lookup table, i.e. below origin or at least one resolution past" << std::endl;
+    std::cerr << "                  the last table element in any dimension; default: exit with error on such input" << std::endl;
     std::cerr << std::endl;
     std::cerr << "csv options" << std::endl;
     std::cerr << comma::csv::options::usage( verbose ) << std::endl;
     std::cerr << std::endl;
+    std::cerr << "examples" << std::endl;
+    std::cerr << "    echo 0.5,1.5 | math-lookup interpolate 'lut.bin;binary=2f' --origin 0,0 --resolution 1,1 --shape 100,200" << std::endl;
+    std::cerr << "    cat points.bin | math-lookup nearest 'lut.bin;binary=d' --origin 0,0,0,0,0 --resolution 1,1,1,1,1 --shape 5,6,7,8,9 --binary 5d" << std::endl;
+    std::cerr << std::endl;
     exit( 0 );
 }
 
-// todo
-// - 1-dimensional: fix
-// - nearest: fix
-// - regression test: basics
-
 static bool permissive{false};
 static bool verbose{false};
 
-// template< typename T, std::size_t D, typename S >
-// std::array< T, D >& operator*=( std::array< T, D >& lhs, const S& rhs ) { for( unsigned int i = 0; i < D; ++i ) { lhs[i] *= rhs; } return lhs; } // quick and dirty; let compiler optimize
-
-// template< typename T, std::size_t D, typename S >
-// std::array< T, D > operator*( const std::array< T, D >& lhs, const S& rhs ) { auto r = lhs; r *= rhs; return r; }
-
-// template< typename T, std::size_t D >
-// std::array< T, D >& operator+=( std::array< T, D >& lhs, const std::array< T, D >& rhs ) { for( unsigned int i = 0; i < D; ++i ) { lhs[i] += rhs[i]; } return lhs; } // quick and dirty; let compiler optimize
+namespace comma { namespace applications { namespace lookup {
 
-// template< typename T, std::size_t D >
-// std::array< T, D > operator+( const std::array< T, D >& lhs, const std::array< T, D >& rhs ) { auto r = lhs; r += rhs; return r; }
+struct input { std::vector< double > point; };
 
-template< typename T, std::size_t D >
-std::ostream& operator<<( std::ostream& os, const std::array< T, D >& rhs ) { std::string d; for( unsigned int i = 0; i < D; ++i ) { os << d << rhs[i]; d = ","; } return os; }
+template < typename T > using output = std::pair< std::vector< std::size_t >, std::vector< T > >; // index, value
 
-namespace comma { namespace applications { namespace lookup { namespace operations {
-
-template< typename T, std::size_t D >
-struct _array { std::array< T, D > point; };
-
-template < typename T, std::size_t D, std::size_t E >
-struct lut
+template < typename T >
+class table
 {
-    typedef std::array< double, D > point_t;
-    typedef comma::containers::multidimensional::index< D > index_t; // typedef std::array< std::size_t, D > index_t;
-    typedef std::array< T, E > value_t;
-    typedef comma::containers::multidimensional::grid< value_t, D, point_t > grid_t;
-    typedef _array< double, D > input_t;
-    typedef _array< T, D > output_t;
-
-    static grid_t& load( grid_t& g, const comma::csv::options& csv )
-    {
-        std::ifstream ifs( csv.filename, std::ios::binary );
-        COMMA_ASSERT_BRIEF( ifs.is_open(), "lookup table: failed to open '" << csv.filename << "'" );
-        std::size_t size = g.data().size() * sizeof( T ) * E;
-        ifs.read( reinterpret_cast< char* >( &g.data()[0] ), size );
-        COMMA_ASSERT_BRIEF( ifs.gcount() > 0, "lookup table: failed to read from '" << csv.filename << "'" );
-        COMMA_ASSERT_BRIEF( std::size_t( ifs.gcount() ) == size, "lookup table: on file '" << csv.filename << "': expected " << size << " bytes; got: " << ifs.gcount() );
-        return g;
-    }
-
-    static std::pair< index_t, value_t > interpolate( const grid_t& g, const point_t& p )
-    {
-        std::pair< index_t, value_t > r;
-        r.first = g.index_of( p );
-        r.second = g.interpolated( p );
-        return r;
-    }
-
-    static std::pair< index_t, value_t > nearest( const grid_t& g, const point_t& p )
-    {
-        std::pair< index_t, value_t > r;
-        r.first = g.nearest_to( p );
-        r.second = g[r.first];
-        return r;
-    }
-
-    static std::pair< index_t, value_t > query( const grid_t& g, const point_t& p )
-    {
-        std::pair< index_t, value_t > r;
-        r.first = g.index_of( p );
-        r.second = g[r.first];
-        return r;
-    }
-
-    static int run( const std::string& operation
-                  , const comma::csv::options& csv
-                  , const comma::csv::options& lut_csv
-                  , const std::vector< double >& origin
-                  , const std::vector< double >& resolution
-                  , const std::vector< std::size_t >& shape )
-    {
-        std::pair< index_t, value_t > ( *f )( const grid_t&, const point_t& );
-        if( operation == "interpolate" ) { f = lut< T, D, E >::interpolate; }
-        else if( operation == "nearest" ) { COMMA_THROW_BRIEF( comma::exception, "nearest: todo" ); } //else if( operation == "nearest" ) { f = lut< T, D, E >::nearest; }
-        else if( operation == "query" ) { f = lut< T, D, E >::query; }
-        else { COMMA_THROW_BRIEF( comma::exception, "expected operation; got: '" << operation << "'" ); }
-        point_t o, r;
-        index_t s;
-        std::memcpy( &o[0], &origin[0], D * sizeof( double ) ); // quick and dirty
-        std::memcpy( &r[0], &resolution[0], D * sizeof( double ) ); // quick and dirty
-        std::memcpy( &s[0], &shape[0], D * sizeof( std::size_t ) ); // quick and dirty
-        grid_t grid( o, r, s );
-        load( grid, lut_csv );
-        input_t zero;
-        std::memset( &zero.point[0], 0, zero.point.size() * sizeof( T ) );
-        comma::csv::input_stream< input_t > istream( std::cin, csv, zero );
-        comma::csv::output_stream< std::pair< index_t, value_t > > ostream( std::cout, csv.binary() );
-        auto tied = comma::csv::make_tied( istream, ostream );
-        while( istream.ready() || std::cin.good() )
+    public:
+        table( const comma::csv::options& csv, std::size_t size, bool mmap )
         {
-            const auto& p = istream.read();
-            if( !p ) { break; }
-            if( !grid.has( p->point ) ) 
+            std::size_t bytes = size * sizeof( T );
+            if( mmap )
             {
-                if( permissive ) { comma::saymore() << "discarded input outside grid: " << p->point << std::endl; continue; }
-                comma::say() << "input outside grid: " << p->point << "; use --permissive to discard" << std::endl;
-                return 1;
+                try
+                {
+                    _file.reset( new boost::interprocess::file_mapping( &csv.filename[0], boost::interprocess::read_only ) );
+                    _region.reset( new boost::interprocess::mapped_region( *_file, boost::interprocess::read_only ) );
+                }
+                catch( const boost::interprocess::interprocess_exception& ex ) { COMMA_THROW_BRIEF( comma::exception, "lookup table: failed to map '" << csv.filename << "': " << ex.what() ); }
+                COMMA_ASSERT_BRIEF( _region->get_size() >= bytes, "lookup table: on file '" << csv.filename << "': expected " << bytes << " bytes; got: " << _region->get_size() );
+                _data = static_cast< const T* >( _region->get_address() );
+                return;
             }
-            tied.append( f( grid, p->point ) );
-            if( csv.flush ) { std::cout.flush(); }
+            std::ifstream ifs( csv.filename, std::ios::binary );
+            COMMA_ASSERT_BRIEF( ifs.is_open(), "lookup table: failed to open '" << csv.filename << "'" );
+            _buffer.resize( size );
+            ifs.read( reinterpret_cast< char* >( &_buffer[0] ), bytes );
+            COMMA_ASSERT_BRIEF( ifs.gcount() > 0, "lookup table: failed to read from '" << csv.filename << "'" );
+            COMMA_ASSERT_BRIEF( std::size_t( ifs.gcount() ) == bytes, "lookup table: on file '" << csv.filename << "': expected " << bytes << " bytes; got: " << ifs.gcount() );
+            _data = &_buffer[0];
         }
-        return 0;
-    }
+
+        const T* data() const { return _data; }
+
+    private:
+        std::vector< T > _buffer;
+        std::unique_ptr< boost::interprocess::file_mapping > _file;
+        std::unique_ptr< boost::interprocess::mapped_region > _region;
+        const T* _data{nullptr};
 };
 
-template < typename T, std::size_t D > static int run_with_dim( const std::string& operation
-                                                              , const comma::csv::options& csv
-                                                              , const comma::csv::options& lut_csv
-                                                              , const std::vector< double >& origin
-                                                              , const std::vector< double >& resolution
-                                                              , const std::vector< std::size_t >& shape )
+template < typename T > static output< T > output_sample( const std::string& operation, std::size_t dimensions, std::size_t elements )
 {
-    switch( lut_csv.format().count() )
-    {
-        case 1: return lut< T, D, 1 >::run( operation, csv, lut_csv, origin, resolution, shape );
-        case 2: return lut< T, D, 2 >::run( operation, csv, lut_csv, origin, resolution, shape );
-        case 3: return lut< T, D, 3 >::run( operation, csv, lut_csv, origin, resolution, shape );
-        case 4: return lut< T, D, 4 >::run( operation, csv, lut_csv, origin, resolution, shape );
-        default: COMMA_THROW( comma::exception, "up to 4-dimensional lookup table values currently supported; got: " << lut_csv.format().count() << " dimensions in " << lut_csv.format().string() );
-    }
-    return 1;
+    return output< T >( std::vector< std::size_t >( dimensions, 0 ), std::vector< T >( operation == "index" ? 0 : elements, 0 ) );
 }
 
-template < typename T > static int run_as( const std::string& operation
-                                         , const comma::csv::options& csv
-                                         , const comma::csv::options& lut_csv
-                                         , const std::vector< double >& origin
-                                         , const std::vector< double >& resolution
-                                         , const std::vector< std::size_t >& shape )
+template < typename T >
+static int run( const std::string& operation
+              , const comma::csv::options& csv
+              , const comma::csv::options& lut_csv
+              , const std::vector< double >& origin
+              , const std::vector< double >& resolution
+              , const std::vector< std::size_t >& shape
+              , std::size_t batch_size
+              , bool mmap )
 {
-    switch( origin.size() )
+    COMMA_ASSERT_BRIEF( operation == "index" || operation == "interpolate" || operation == "nearest" || operation == "query", "expected operation; got: '" << operation << "'" );
+    const std::size_t dimensions = shape.size();
+    const std::size_t elements = lut_csv.format().count();
+    std::size_t size = elements;
+    for( auto s: shape ) { size *= s; }
+    table< T > data( lut_csv, size, mmap );
+    comma::containers::multidimensional::lut< T > lut( origin, resolution, shape, elements, data.data() );
+    input sample;
+    sample.point.resize( dimensions, 0 );
+    comma::csv::input_stream< input > istream( std::cin, csv, sample );
+    output< T > out = output_sample< T >( operation, dimensions, elements );
+    comma::csv::output_stream< output< T > > ostream( std::cout, csv.binary(), true, csv.flush, out );
+    std::vector< double > points;
+    std::vector< std::string > records;
+    std::vector< T > values;
+    points.reserve( batch_size * dimensions );
+    records.reserve( batch_size );
+    auto process = [&]()
+    {
+        if( records.empty() ) { return; }
+        if( operation == "interpolate" ) { values.resize( records.size() * elements ); lut.interpolate( &points[0], records.size(), &values[0] ); }
+        for( std::size_t k = 0; k < records.size(); ++k )
+        {
+            const double* p = &points[ k * dimensions ];
+            if( operation == "nearest" ) { lut.nearest( p, &out.first[0] ); } else { lut.index_of( p, &out.first[0] ); }
+            if( operation == "interpolate" ) { std::memcpy( &out.second[0], &values[ k * elements ], elements * sizeof( T ) ); }
+            else if( operation != "index" ) { std::memcpy( &out.second[0], lut( &out.first[0] ), elements * sizeof( T ) ); }
+            ostream.append( records[k], out );
+        }
+        if( csv.flush ) { std::cout.flush(); }
+        points.clear();
+        records.clear();
+    };
+    while( istream.ready() || std::cin.good() )
     {
-        // todo! case 1: return run_with_dim< T, 1 >( operation, csv, lut_csv, origin, resolution, shape );
-        case 2: return run_with_dim< T, 2 >( operation, csv, lut_csv, origin, resolution, shape );
-        case 3: return run_with_dim< T, 3 >( operation, csv, lut_csv, origin, resolution, shape );
-        case 4: return run_with_dim< T, 4 >( operation, csv, lut_csv, origin, resolution, shape );
-        default: COMMA_THROW( comma::exception, "up to 4-dimensional lookup tables currently supported; got: " << origin.size() << " dimensions" );
+        const input* p = istream.read();
+        if( !p ) { break; }
+        if( !lut.has( &p->point[0] ) )
+        {
+            if( permissive ) { comma::saymore() << "discarded input outside grid: " << comma::join( p->point, ',' ) << std::endl; continue; }
+            process();
+            comma::say() << "input outside grid: " << comma::join( p->point, ',' ) << "; use --permissive to discard" << std::endl;
+            return 1;
+        }
+        points.insert( points.end(), p->point.begin(), p->point.end() );
+        records.push_back( istream.last() );
+        if( csv.flush || records.size() >= batch_size || !istream.ready() ) { process(); } // do not wait for more input, if none available
     }
-    return 1;
+    process();
+    return 0;
 }
 
-} } } } // namespace comma { namespace applications { namespace lookup { namespace operations {
-
-namespace comma { namespace visiting {
-
-template < typename T, std::size_t D > struct traits< comma::applications::lookup::operations::_array< T, D > >
-{
-    template < typename Key, class Visitor > static void visit( const Key&, comma::applications::lookup::operations::_array< T, D >& p, Visitor& v ) { v.apply( "point", p.point ); }
-    template < typename Key, class Visitor > static void visit( const Key&, const comma::applications::lookup::operations::_array< T, D >& p, Visitor& v ) { v.apply( "point", p.point ); }
-};
-
-} } // namespace comma { namespace visiting {
-
-namespace comma { namespace applications { namespace lookup { namespace operations {
-
 static int run( const comma::command_line_options& options, const csv::options& csv, const std::vector< std::string >& unnamed )
 {
+    const auto& shape = comma::split_as< std::size_t >( options.value< std::string >( "--shape" ), ',' );
+    if( options.exists( "--input-fields" ) ) { input sample; sample.point.resize( shape.size() ); std::cout << comma::join( comma::csv::names( true, sample ), ',' ) << std::endl; return 0; }
     COMMA_ASSERT_BRIEF( unnamed.size() > 1, "please specify lookup table file as: math-lookup <operation> <filename>" );
     auto lut_csv = comma::name_value::parser( "filename" ).get< comma::csv::options >( unnamed[1] );
     COMMA_ASSERT_BRIEF( lut_csv.binary(), "lookup table: on file '" << lut_csv.filename << "': only binary files are currently supported, e.g: 'lut.bin;binary=3f'" );
+    const auto& elements = lut_csv.format().elements();
+    for( const auto& e: elements ) { COMMA_ASSERT_BRIEF( e.type == elements[0].type, "expected lookup table values of the same type; got: '" << lut_csv.format().string() << "'" ); }
+    bool is_float = elements[0].type == comma::csv::format::float_t;
+    COMMA_ASSERT_BRIEF( is_float || elements[0].type == comma::csv::format::double_t, "only float and double as lookup table values are supported; got: '" << unnamed[1] << "'" );
+    if( options.exists( "--output-fields" ) ) { std::cout << comma::join( comma::csv::names( true, output_sample< double >( unnamed[0], shape.size(), lut_csv.format().count() ) ), ',' ) << std::endl; return 0; }
+    if( options.exists( "--output-format" ) )
+    {
+        if( is_float ) { std::cout << comma::csv::format::value( output_sample< float >( unnamed[0], shape.size(), lut_csv.format().count() ) ) << std::endl; }
+        else { std::cout << comma::csv::format::value( output_sample< double >( unnamed[0], shape.size(), lut_csv.format().count() ) ) << std::endl; }
+        return 0;
+    }
     const auto& origin = comma::split_as< double >( options.value< std::string >( "--origin,-o" ), ',' );
     const auto& resolution = comma::split_as< double >( options.value< std::string >( "--resolution,-r" ), ',' );
-    const auto& shape = comma::split_as< std::size_t >( options.value< std::string >( "--shape" ), ',' );
     COMMA_ASSERT_BRIEF( origin.size() == resolution.size(), "expected --origin and --resolution of the same dimensions; got: " << origin.size() << " and " << resolution.size() );
     COMMA_ASSERT_BRIEF( origin.size() == shape.size(), "expected --origin and --shape of the same dimensions; got: " << origin.size() << " and " << shape.size() );
-    switch( lut_csv.format().elements()[0].type ) // todo! quick and dirty
-    {
-        case comma::csv::format::float_t: return comma::applications::lookup::operations::run_as< float >( unnamed[0], csv, lut_csv, origin, resolution, shape );
-        case comma::csv::format::double_t: return comma::applications::lookup::operations::run_as< double >( unnamed[0], csv, lut_csv, origin, resolution, shape );
-        default: COMMA_THROW( comma::exception, "only float and double as lookup table values are supported; got: '" << unnamed[1] << "'" );
-    }
-    return 1;
+    std::size_t batch_size = options.value< std::size_t >( "--batch-size", 4096 );
+    COMMA_ASSERT_BRIEF( batch_size > 0, "expected positive --batch-size" );
+    bool mmap = !options.exists( "--no-mmap" );
+    return is_float ? run< float >( unnamed[0], csv, lut_csv, origin, resolution, shape, batch_size, mmap )
+                    : run< double >( unnamed[0], csv, lut_csv, origin, resolution, shape, batch_size, mmap );
 }
 
-} } } } // namespace comma { namespace applications { namespace lookup { namespace operations {
+} } } // namespace comma { namespace applications { namespace lookup {
+
+namespace comma { namespace visiting {
+
+template <> struct traits< comma::applications::lookup::input >
+{
+    template < typename Key, class Visitor > static void visit( const Key&, comma::applications::lookup::input& p, Visitor& v ) { v.apply( "point", p.point ); }
+    template < typename Key, class Visitor > static void visit( const Key&, const comma::applications::lookup::input& p, Visitor& v ) { v.apply( "point", p.point ); }
+};
+
+} } // namespace comma { namespace visiting {
 
 int main( int ac, char** av )
 {
@@ -238,11 +217,11 @@ int main( int ac, char** av )
     {
         comma::command_line_options options( ac, av, usage );
         comma::csv::options csv( options );
-        const auto& unnamed = options.unnamed( "--flush,--permissive,--verbose,-v", "-.*" );
+        const auto& unnamed = options.unnamed( "--flush,--permissive,--verbose,-v,--input-fields,--output-fields,--output-format,--no-mmap", "-.*" );
         if( unnamed.empty() ) { comma::say() << "please specify operation" << std::endl; return 1; }
         permissive = options.exists( "--permissive" );
         verbose = options.exists( "--verbose,-v" );
-        return comma::applications::lookup::operations::run( options, csv, unnamed );
+        return comma::applications::lookup::run( options, csv, unnamed );
     }
     catch( std::exception& ex ) { comma::say() << "caught exception: " << ex.what() << std::endl; }
     catch( ... ) { comma::say() << "caught unknown exception" << std::endl; }
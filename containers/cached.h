@@ -1,70 +1,528 @@
 // Copyright (c) 2024 Vsevolod Vlaskine
 // All Rights Reserved
 
-#include <deque>
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 namespace comma {
 
-template < typename T, typename K, typename Hash = std::hash< K > >
+namespace caching {
+
+struct statistics
+{
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+    std::uint64_t evictions{0};
+
+    statistics& operator+=( const statistics& rhs ) { hits += rhs.hits; misses += rhs.misses; evictions += rhs.evictions; return *this; }
+};
+
+/// default cost: each value costs 1, i.e. cache size is number of values
+struct unit_cost { template < typename T > std::size_t operator()( const T& ) const { return 1; } };
+
+/// intrusive doubly-linked lists of cache slots for eviction policies; a slot is in at most one list
+class lists
+{
+    public:
+        static constexpr std::uint32_t npos = std::uint32_t( -1 );
+
+        static constexpr unsigned int count = 2;
+
+        void resize( std::size_t n ) { _nodes.resize( n ); }
+
+        void push_back( unsigned int list, std::uint32_t i );
+
+        void remove( std::uint32_t i );
+
+        void move_to_back( std::uint32_t i ) { unsigned int l = _nodes[i].list; remove( i ); push_back( l, i ); }
+
+        std::uint32_t front( unsigned int list ) const { return _heads[ list ]; }
+
+        std::size_t size( unsigned int list ) const { return _sizes[ list ]; }
+
+        unsigned int list_of( std::uint32_t i ) const { return _nodes[i].list; }
+
+        void clear();
+
+    private:
+        struct node { std::uint32_t prev{npos}; std::uint32_t next{npos}; unsigned int list{0}; };
+        std::vector< node > _nodes;
+        std::uint32_t _heads[count]{ npos, npos };
+        std::uint32_t _tails[count]{ npos, npos };
+        std::size_t _sizes[count]{ 0, 0 };
+};
+
+/// eviction policy interface:
+///     void init( std::size_t max_size ); // called once by cache
+///     void inserted( lists& l, std::uint32_t i, std::size_t hash ); // put new slot into a list
+///     void accessed( lists& l, std::uint32_t i ); // on cache hit
+///     std::uint32_t victim( const lists& l ) const; // slot to evict next or lists::npos
+///     void erased( lists& l, std::uint32_t i, std::size_t hash ); // remove slot from its list
+///     void clear();
+
+/// evict values in order of insertion
+struct fifo
+{
+    void init( std::size_t ) {}
+    void inserted( lists& l, std::uint32_t i, std::size_t ) { l.push_back( 0, i ); }
+    void accessed( lists&, std::uint32_t ) {}
+    std::uint32_t victim( const lists& l ) const { return l.front( 0 ); }
+    void erased( lists& l, std::uint32_t i, std::size_t ) { l.remove( i ); }
+    void clear() {}
+};
+
+/// evict least recently used value
+struct lru
+{
+    void init( std::size_t ) {}
+    void inserted( lists& l, std::uint32_t i, std::size_t ) { l.push_back( 0, i ); }
+    void accessed( lists& l, std::uint32_t i ) { l.move_to_back( i ); }
+    std::uint32_t victim( const lists& l ) const { return l.front( 0 ); }
+    void erased( lists& l, std::uint32_t i, std::size_t ) { l.remove( i ); }
+    void clear() {}
+};
+
+/// 2q: new values go to a fifo queue; values evicted from it are remembered in a ghost queue of key hashes;
+/// values requested again while in the ghost queue go to the main lru queue, from which they are evicted only
+/// when the fifo queue is small; thus, values used repeatedly survive bursts and scans of values used once
+///
+/// since ghost queue keeps key hashes, not keys, hash collisions may promote a value to the main queue
+class two_queue
+{
+    public:
+        /// @param in share of cache size for the fifo queue
+        /// @param out size of ghost queue as share of cache size
+        two_queue( double in = 0.25, double out = 0.5 ): _in( in ), _out( out ) {}
+        void init( std::size_t max_size );
+        void inserted( lists& l, std::uint32_t i, std::size_t hash );
+        void accessed( lists& l, std::uint32_t i ) { if( l.list_of( i ) == 1 ) { l.move_to_back( i ); } }
+        std::uint32_t victim( const lists& l ) const { return l.size( 0 ) > _in_size || l.size( 1 ) == 0 ? l.front( 0 ) : l.front( 1 ); }
+        void erased( lists& l, std::uint32_t i, std::size_t hash );
+        void clear() { _ghosts.clear(); _ring.clear(); _next = 0; }
+
+    private:
+        double _in;
+        double _out;
+        std::size_t _in_size{0};
+        std::size_t _out_size{0};
+        std::vector< std::size_t > _ring;
+        std::size_t _next{0};
+        std::unordered_multiset< std::size_t > _ghosts;
+};
+
+} // namespace caching {
+
+/// cache of values of type T constructed from keys of type K on first request
+///
+/// values are constructed in place in chunks of slots, i.e. without heap allocation per value, and never move,
+/// i.e. references to values stay valid until values are evicted; slots of evicted values are reused
+///
+/// if max_size is not 0, when the total cost of values exceeds it, values are evicted as chosen by eviction policy
+/// (see caching::fifo, caching::lru, caching::two_queue); cost of each value is given by Cost functor, 1 by default
+template < typename T, typename K, typename Hash = std::hash< K >, typename Policy = caching::fifo, typename Cost = caching::unit_cost >
 class cached
 {
     public:
-        cached( unsigned int max_size = 0 ): _size( max_size ) {}
+        typedef caching::statistics statistics;
+
+        cached( std::size_t max_size = 0, const Policy& policy = Policy(), const Cost& cost = Cost() );
+
+        cached( const cached& ) = delete;
+
+        cached& operator=( const cached& ) = delete;
+
+        ~cached() { clear(); }
 
         template < typename... Args > T& get( Args... args );
 
-        template < typename... Args > const T& get( Args... args ) const;
+        template < typename... Args > const T& get( Args... args ) const { return const_cast< cached* >( this )->get( args... ); }
 
         template < typename... Args > auto operator()( Args... args ) { return get( args... )( args... ); }
 
         template < typename... Args > auto operator()( Args... args ) const { return get( args... )( args... ); }
 
-        void clear() { _values.clear(); }
+        /// return pointer to value, if cached, otherwise null; does not count as access
+        const T* find( const K& key ) const;
+
+        void clear();
 
+        /// evict given number of values
         void pop( unsigned int size = 1 );
 
-        const std::unordered_map< K, std::unique_ptr< T >, Hash >& values() const { return _values; }
+        /// number of values
+        std::size_t size() const { return _size; }
+
+        /// total cost of values
+        std::size_t cost() const { return _cost; }
+
+        std::size_t max_size() const { return _max_size; }
+
+        const statistics& stats() const { return _statistics; }
+
+        class values_type;
 
-    protected:
-        mutable std::unordered_map< K, std::unique_ptr< T >, Hash > _values; // todo! use proper move semantics instead of unique_ptr
-        mutable std::deque< K > _keys;
-        unsigned int _size{0};
+        /// return read-only view of cached values with the interface of std::unordered_map< K, std::unique_ptr< T > >
+        /// returned by previous versions: size(), empty(), begin(), end(), find(), count(), at(); elements are pairs
+        /// of key and pointer to value, thus e.g. *v.second, it->second->f(), or *values().at( key ) work as before
+        values_type values() const { return values_type( this ); }
+
+    private:
+        struct entry
+        {
+            K key;
+            T value;
+            entry( const K& k ): key( k ), value( k ) {}
+        };
+        struct meta { std::size_t hash{0}; std::size_t cost{0}; bool used{false}; };
+        static constexpr std::uint32_t npos = caching::lists::npos;
+        static constexpr std::size_t chunk_size = 64;
+        typedef typename std::aligned_storage< sizeof( entry ), alignof( entry ) >::type storage;
+        std::size_t _max_size;
+        Policy _policy;
+        Cost _cost_of;
+        std::vector< std::unique_ptr< storage[] > > _chunks;
+        std::vector< meta > _meta;
+        std::vector< std::uint32_t > _free;
+        std::vector< std::uint32_t > _index; // open addressing, linear probing: slot + 1 or 0, if empty
+        caching::lists _lists;
+        std::size_t _size{0};
+        std::size_t _cost{0};
+        statistics _statistics;
+
+        entry& _entry( std::uint32_t i ) const { return *reinterpret_cast< entry* >( &_chunks[ i / chunk_size ][ i % chunk_size ] ); }
+        std::uint32_t _find( const K& key, std::size_t hash ) const;
+        std::uint32_t _allocate();
+        void _index_insert( std::uint32_t i );
+        void _index_erase( std::uint32_t i );
+        void _evict( std::uint32_t i );
 };
 
-template < typename T, typename K, typename Hash >
-template < typename... Args >
-T& cached< T, K, Hash >::get( Args... args )
+/// thread-safe cache: keys are split between shards, each a cache with its own lock;
+/// since values may be evicted by other threads, they are accessed only under lock through functors
+template < typename T, typename K, typename Hash = std::hash< K >, typename Policy = caching::fifo, typename Cost = caching::unit_cost >
+class concurrent_cached
 {
-    K k{ args... };
-    auto i = _values.find( k );
-    if( i != _values.end() ) { return *( i->second ); }
-    if( _size > 0 && _values.size() == _size ) { pop(); }
-    _keys.emplace_back( k );
-    return *( _values.emplace( std::make_pair( k, std::make_unique< T >( k ) ) ).first->second );
+    public:
+        typedef cached< T, K, Hash, Policy, Cost > cache_type;
+
+        /// @param max_size total maximum size, split evenly between shards, 0: unlimited
+        /// @param shards number of shards
+        concurrent_cached( std::size_t max_size = 0, unsigned int shards = 16, const Policy& policy = Policy(), const Cost& cost = Cost() );
+
+        /// call f( T& ) on value for given key under lock, return result
+        template < typename F, typename... Args > auto apply( F f, Args... args );
+
+        template < typename... Args > auto operator()( Args... args ) { return apply( [&]( T& t ) { return t( args... ); }, args... ); }
+
+        std::size_t size() const;
+
+        caching::statistics stats() const;
+
+        void clear();
+
+    private:
+        struct alignas( 64 ) shard
+        {
+            mutable std::mutex mutex;
+            cache_type cache;
+            shard( std::size_t max_size, const Policy& policy, const Cost& cost ): cache( max_size, policy, cost ) {}
+        };
+        std::vector< std::unique_ptr< shard > > _shards;
+};
+
+namespace caching {
+
+inline void lists::push_back( unsigned int list, std::uint32_t i )
+{
+    node& n = _nodes[i];
+    n.list = list;
+    n.prev = _tails[ list ];
+    n.next = npos;
+    if( _tails[ list ] == npos ) { _heads[ list ] = i; } else { _nodes[ _tails[ list ] ].next = i; }
+    _tails[ list ] = i;
+    ++_sizes[ list ];
+}
+
+inline void lists::remove( std::uint32_t i )
+{
+    node& n = _nodes[i];
+    if( n.prev == npos ) { _heads[ n.list ] = n.next; } else { _nodes[ n.prev ].next = n.next; }
+    if( n.next == npos ) { _tails[ n.list ] = n.prev; } else { _nodes[ n.next ].prev = n.prev; }
+    n.prev = n.next = npos;
+    --_sizes[ n.list ];
+}
+
+inline void lists::clear()
+{
+    for( unsigned int l = 0; l < count; ++l ) { _heads[l] = _tails[l] = npos; _sizes[l] = 0; }
+}
+
+inline void two_queue::init( std::size_t max_size )
+{
+    _in_size = std::max( std::size_t( max_size * _in ), std::size_t( 1 ) );
+    _out_size = std::max( std::size_t( max_size * _out ), std::size_t( 1 ) );
+}
+
+inline void two_queue::inserted( lists& l, std::uint32_t i, std::size_t hash )
+{
+    auto it = _ghosts.find( hash );
+    if( it == _ghosts.end() ) { l.push_back( 0, i ); return; }
+    _ghosts.erase( it );
+    l.push_back( 1, i );
 }
 
-template < typename T, typename K, typename Hash >
+inline void two_queue::erased( lists& l, std::uint32_t i, std::size_t hash )
+{
+    if( l.list_of( i ) == 0 )
+    {
+        if( _ring.size() < _out_size ) { _ring.push_back( hash ); }
+        else { auto it = _ghosts.find( _ring[ _next ] ); if( it != _ghosts.end() ) { _ghosts.erase( it ); } _ring[ _next ] = hash; _next = ( _next + 1 ) % _out_size; }
+        _ghosts.insert( hash );
+    }
+    l.remove( i );
+}
+
+} // namespace caching {
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+class cached< T, K, Hash, Policy, Cost >::values_type
+{
+    public:
+        typedef std::pair< const K&, T* > value_type;
+
+        class const_iterator
+        {
+            public:
+                struct pointer { value_type pair; const value_type* operator->() const { return &pair; } };
+                value_type operator*() const { entry& e = _cache->_entry( _i ); return value_type( e.key, &e.value ); }
+                pointer operator->() const { return pointer{ **this }; }
+                const_iterator& operator++() { ++_i; _skip(); return *this; }
+                bool operator==( const const_iterator& rhs ) const { return _i == rhs._i; }
+                bool operator!=( const const_iterator& rhs ) const { return _i != rhs._i; }
+
+            private:
+                friend class values_type;
+                const cached* _cache;
+                std::uint32_t _i;
+                const_iterator( const cached* c, std::uint32_t i ): _cache( c ), _i( i ) { _skip(); }
+                void _skip() { while( _i < _cache->_meta.size() && !_cache->_meta[ _i ].used ) { ++_i; } }
+        };
+
+        std::size_t size() const { return _cache->size(); }
+
+        bool empty() const { return _cache->size() == 0; }
+
+        const_iterator begin() const { return const_iterator( _cache, 0 ); }
+
+        const_iterator end() const { return const_iterator( _cache, _cache->_meta.size() ); }
+
+        const_iterator find( const K& key ) const { std::uint32_t i = _cache->_find( key, Hash()( key ) ); return i == npos ? end() : const_iterator( _cache, i ); }
+
+        std::size_t count( const K& key ) const { return find( key ) == end() ? 0 : 1; }
+
+        T* at( const K& key ) const { auto it = find( key ); if( it == end() ) { throw std::out_of_range( "cached: key not found" ); } return ( *it ).second; }
+
+    private:
+        friend class cached;
+        const cached* _cache;
+        values_type( const cached* c ): _cache( c ) {}
+};
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+inline cached< T, K, Hash, Policy, Cost >::cached( std::size_t max_size, const Policy& policy, const Cost& cost ): _max_size( max_size ), _policy( policy ), _cost_of( cost )
+{
+    _policy.init( max_size );
+    _index.resize( 16, 0 );
+}
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
 template < typename... Args >
-const T& cached< T, K, Hash >::get( Args... args ) const
+inline T& cached< T, K, Hash, Policy, Cost >::get( Args... args )
 {
     K k{ args... };
-    auto i = _values.find( k );
-    if( i != _values.end() ) { return *( i->second ); }
-    if( _size > 0 && _values.size() == _size ) { pop(); }
-    _keys.emplace_back( k );
-    return *( _values.emplace( std::make_pair( k, std::make_unique< T >( k ) ) ).first->second );
+    std::size_t h = Hash()( k );
+    std::uint32_t i = _find( k, h );
+    if( i != npos ) { ++_statistics.hits; _policy.accessed( _lists, i ); return _entry( i ).value; }
+    ++_statistics.misses;
+    i = _allocate();
+    entry* e = nullptr;
+    std::size_t cost = 0;
+    try { e = new ( &_entry( i ) ) entry( k ); cost = _cost_of( e->value ); }
+    catch( ... ) { if( e ) { e->~entry(); } _free.push_back( i ); throw; } // give slot back, if value constructor or cost throws
+    meta& m = _meta[i];
+    m.hash = h;
+    m.cost = cost;
+    m.used = true;
+    _cost += m.cost;
+    ++_size;
+    _index_insert( i );
+    if( _max_size > 0 ) // evict before inserting new value into policy lists, so that it is never the victim
+    {
+        while( _cost > _max_size )
+        {
+            std::uint32_t v = _policy.victim( _lists );
+            if( v == npos ) { break; }
+            _evict( v );
+            ++_statistics.evictions;
+        }
+    }
+    _policy.inserted( _lists, i, h );
+    return e->value;
+}
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+inline const T* cached< T, K, Hash, Policy, Cost >::find( const K& key ) const
+{
+    std::uint32_t i = _find( key, Hash()( key ) );
+    return i == npos ? nullptr : &_entry( i ).value;
+}
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+inline void cached< T, K, Hash, Policy, Cost >::clear()
+{
+    for( std::uint32_t i = 0; i < _meta.size(); ++i ) { if( _meta[i].used ) { _entry( i ).~entry(); } }
+    _free.clear();
+    for( std::uint32_t i = _meta.size(); i > 0; --i ) { _free.push_back( i - 1 ); }
+    for( auto& m: _meta ) { m = meta(); }
+    std::fill( _index.begin(), _index.end(), 0 );
+    _lists.clear();
+    _policy.clear();
+    _size = 0;
+    _cost = 0;
+}
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+inline void cached< T, K, Hash, Policy, Cost >::pop( unsigned int size )
+{
+    for( unsigned int n = 0; n < size; ++n )
+    {
+        std::uint32_t v = _policy.victim( _lists );
+        if( v == npos ) { return; }
+        _evict( v );
+        ++_statistics.evictions;
+    }
+}
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+inline std::uint32_t cached< T, K, Hash, Policy, Cost >::_find( const K& key, std::size_t hash ) const
+{
+    const std::size_t mask = _index.size() - 1;
+    for( std::size_t j = hash & mask; _index[j] != 0; j = ( j + 1 ) & mask )
+    {
+        std::uint32_t i = _index[j] - 1;
+        if( _meta[i].hash == hash && _entry( i ).key == key ) { return i; }
+    }
+    return npos;
+}
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+inline std::uint32_t cached< T, K, Hash, Policy, Cost >::_allocate()
+{
+    if( !_free.empty() ) { std::uint32_t i = _free.back(); _free.pop_back(); return i; }
+    std::uint32_t i = _meta.size();
+    if( i % chunk_size == 0 ) { _chunks.emplace_back( new storage[ chunk_size ] ); }
+    _meta.emplace_back();
+    _lists.resize( _meta.size() );
+    return i;
 }
 
-template < typename T, typename K, typename Hash >
-inline void cached< T, K, Hash >::pop( unsigned int size )
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+inline void cached< T, K, Hash, Policy, Cost >::_index_insert( std::uint32_t i )
 {
-    for( unsigned int i = 0; i < size; ++i )
+    if( _size * 2 > _index.size() ) // keep load factor below 0.5
     {
-        if( _keys.empty() ) { return; }
-        _values.erase( _keys.front() );
-        _keys.pop_front();
+        std::vector< std::uint32_t > index( _index.size() * 2, 0 );
+        const std::size_t mask = index.size() - 1;
+        for( std::uint32_t k: _index )
+        {
+            if( k == 0 || k - 1 == i ) { continue; }
+            std::size_t j = _meta[ k - 1 ].hash & mask;
+            while( index[j] != 0 ) { j = ( j + 1 ) & mask; }
+            index[j] = k;
+        }
+        _index.swap( index );
     }
+    const std::size_t mask = _index.size() - 1;
+    std::size_t j = _meta[i].hash & mask;
+    while( _index[j] != 0 ) { j = ( j + 1 ) & mask; }
+    _index[j] = i + 1;
+}
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+inline void cached< T, K, Hash, Policy, Cost >::_index_erase( std::uint32_t i )
+{
+    const std::size_t mask = _index.size() - 1;
+    std::size_t j = _meta[i].hash & mask;
+    while( _index[j] != i + 1 ) { j = ( j + 1 ) & mask; }
+    for( std::size_t k = ( j + 1 ) & mask; _index[k] != 0; k = ( k + 1 ) & mask ) // backward shift deletion, no tombstones
+    {
+        std::size_t home = _meta[ _index[k] - 1 ].hash & mask;
+        if( ( ( k - home ) & mask ) >= ( ( k - j ) & mask ) ) { _index[j] = _index[k]; j = k; }
+    }
+    _index[j] = 0;
+}
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+inline void cached< T, K, Hash, Policy, Cost >::_evict( std::uint32_t i )
+{
+    _policy.erased( _lists, i, _meta[i].hash );
+    _index_erase( i );
+    _entry( i ).~entry();
+    _cost -= _meta[i].cost;
+    --_size;
+    _meta[i] = meta();
+    _free.push_back( i );
+}
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+inline concurrent_cached< T, K, Hash, Policy, Cost >::concurrent_cached( std::size_t max_size, unsigned int shards, const Policy& policy, const Cost& cost )
+{
+    if( shards == 0 ) { shards = 1; }
+    std::size_t m = max_size == 0 ? 0 : ( max_size + shards - 1 ) / shards;
+    for( unsigned int i = 0; i < shards; ++i ) { _shards.emplace_back( new shard( m, policy, cost ) ); }
+}
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+template < typename F, typename... Args >
+inline auto concurrent_cached< T, K, Hash, Policy, Cost >::apply( F f, Args... args )
+{
+    K k{ args... };
+    shard& s = *_shards[ ( std::uint64_t( Hash()( k ) ) * 0x9e3779b97f4a7c15ull >> 32 ) % _shards.size() ]; // high bits, since shard cache indexes by low bits
+    std::lock_guard< std::mutex > lock( s.mutex );
+    return f( s.cache.get( k ) );
+}
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+inline std::size_t concurrent_cached< T, K, Hash, Policy, Cost >::size() const
+{
+    std::size_t n = 0;
+    for( const auto& s: _shards ) { std::lock_guard< std::mutex > lock( s->mutex ); n += s->cache.size(); }
+    return n;
+}
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+inline caching::statistics concurrent_cached< T, K, Hash, Policy, Cost >::stats() const
+{
+    caching::statistics t;
+    for( const auto& s: _shards ) { std::lock_guard< std::mutex > lock( s->mutex ); t += s->cache.stats(); }
+    return t;
+}
+
+template < typename T, typename K, typename Hash, typename Policy, typename Cost >
+inline void concurrent_cached< T, K, Hash, Policy, Cost >::clear()
+{
+    for( auto& s: _shards ) { std::lock_guard< std::mutex > lock( s->mutex ); s->cache.clear(); }
 }
 
 } // namespace comma {
@@ -0,0 +1,419 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include "../base/exception.h"
+#include "../sync/futex.h"
+
+namespace comma {
+
+namespace impl {
+
+static constexpr std::size_t cache_line = 64;
+
+/// wait until a condition holds, sleeping on process-private futex
+class waiter
+{
+    public:
+        /// wake waiting threads, if any; call after making the condition true
+        void notify()
+        {
+            std::atomic_thread_fence( std::memory_order_seq_cst ); // make condition visible before checking for waiters
+            if( _waiters.load( std::memory_order_relaxed ) == 0 ) { return; }
+            _sequence.fetch_add( 1, std::memory_order_release );
+            comma::futex::wake( _sequence, false );
+        }
+
+        /// return true, if condition holds, false on timeout
+        template < typename Condition > bool wait( Condition condition, const boost::posix_time::time_duration& timeout );
+
+    private:
+        alignas( cache_line ) std::atomic< std::uint32_t > _sequence{0};
+        std::atomic< std::uint32_t > _waiters{0};
+};
+
+template < typename Condition >
+inline bool waiter::wait( Condition condition, const boost::posix_time::time_duration& timeout )
+{
+    for( unsigned int i = 0; i < 256; ++i ) { if( condition() ) { return true; } std::this_thread::yield(); } // cheap, if the other side is busy
+    const bool infinite = timeout.is_pos_infinity();
+    const auto deadline = infinite ? boost::posix_time::ptime() : boost::posix_time::microsec_clock::universal_time() + timeout;
+    while( true )
+    {
+        _waiters.fetch_add( 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_seq_cst ); // pairs with fence in notify()
+        std::uint32_t sequence = _sequence.load( std::memory_order_acquire );
+        if( condition() ) { _waiters.fetch_sub( 1, std::memory_order_relaxed ); return true; }
+        long long microseconds = -1;
+        if( !infinite )
+        {
+            microseconds = ( deadline - boost::posix_time::microsec_clock::universal_time() ).total_microseconds();
+            if( microseconds <= 0 ) { _waiters.fetch_sub( 1, std::memory_order_relaxed ); return condition(); }
+        }
+        comma::futex::wait( _sequence, sequence, microseconds, false );
+        _waiters.fetch_sub( 1, std::memory_order_relaxed );
+    }
+}
+
+inline std::size_t power_of_two( std::size_t size ) { std::size_t s = 1; while( s < size ) { s *= 2; } return s; }
+
+} // namespace impl {
+
+/// lock-free cyclic buffer for one producer thread and one consumer thread
+///
+/// capacity is rounded up to power of 2; elements are preallocated as in cyclic_buffer;
+/// push() and pop() do not block and return false, if buffer is full or empty;
+/// wait_push() and wait_pop() block until they can proceed, timeout expires or buffer is closed;
+/// producer and consumer indices are on separate cache lines, each side keeps a cached copy of the
+/// other's index, so that they touch each other's cache line only when the cached copy is exhausted
+template < typename T >
+class spsc_cyclic_buffer
+{
+    public:
+        spsc_cyclic_buffer( std::size_t size, const T& t = T() );
+
+        spsc_cyclic_buffer( const spsc_cyclic_buffer& ) = delete;
+
+        spsc_cyclic_buffer& operator=( const spsc_cyclic_buffer& ) = delete;
+
+        /// producer: push element; return false, if full
+        bool push( const T& t ) { return _push( [&]( T& v ) { v = t; } ); }
+
+        /// producer: push element; return false, if full
+        bool push( T&& t ) { return _push( [&]( T& v ) { v = std::move( t ); } ); }
+
+        /// producer: push as many elements as fit; return number of elements pushed
+        template < typename Iterator > std::size_t push( Iterator begin, Iterator end );
+
+        /// producer: push element, wait while full; return false on timeout or if closed
+        bool wait_push( const T& t, const boost::posix_time::time_duration& timeout = boost::posix_time::pos_infin );
+
+        /// consumer: return pointer to front element or null, if empty
+        T* front();
+
+        /// consumer: remove front element; buffer must not be empty
+        void pop();
+
+        /// consumer: pop element; return false, if empty
+        bool pop( T& t );
+
+        /// consumer: pop up to n elements into output iterator; return number of elements popped
+        template < typename Iterator > std::size_t pop( Iterator out, std::size_t n );
+
+        /// consumer: pop element, wait while empty; return false on timeout or if closed and empty
+        bool wait_pop( T& t, const boost::posix_time::time_duration& timeout = boost::posix_time::pos_infin );
+
+        /// consumer: wait while empty; return false on timeout or if closed and empty
+        bool wait( const boost::posix_time::time_duration& timeout = boost::posix_time::pos_infin );
+
+        /// mark buffer closed, i.e. no more elements will be pushed, and wake up waiting threads
+        void close() { _closed.store( true, std::memory_order_release ); _not_empty.notify(); _not_full.notify(); }
+
+        bool closed() const { return _closed.load( std::memory_order_acquire ); }
+
+        std::size_t size() const { return _tail.load( std::memory_order_acquire ) - _head.load( std::memory_order_acquire ); }
+
+        bool empty() const { return size() == 0; }
+
+        std::size_t capacity() const { return _data.size(); }
+
+    private:
+        std::vector< T > _data;
+        std::size_t _mask;
+        alignas( impl::cache_line ) std::atomic< std::size_t > _head{0}; // consumer
+        std::size_t _cached_tail{0};
+        alignas( impl::cache_line ) std::atomic< std::size_t > _tail{0}; // producer
+        std::size_t _cached_head{0};
+        alignas( impl::cache_line ) std::atomic< bool > _closed{false};
+        impl::waiter _not_empty;
+        impl::waiter _not_full;
+
+        template < typename F > bool _push( F f );
+        std::size_t _available( std::size_t wanted = 1 ); // consumer
+        std::size_t _space( std::size_t wanted = 1 ); // producer
+};
+
+/// bounded lock-free cyclic buffer for multiple producer and consumer threads
+///
+/// each slot carries a sequence number telling whether it is ready to be written or read in the current
+/// lap, so that producers and consumers claim slots with a single compare-and-swap on tail or head;
+/// as a result, there is no front(): an element is only accessible while being popped;
+/// e.g. csv::parallel hands input chunks to its worker threads through it
+template < typename T >
+class mpmc_cyclic_buffer
+{
+    public:
+        mpmc_cyclic_buffer( std::size_t size, const T& t = T() );
+
+        mpmc_cyclic_buffer( const mpmc_cyclic_buffer& ) = delete;
+
+        mpmc_cyclic_buffer& operator=( const mpmc_cyclic_buffer& ) = delete;
+
+        /// push element; return false, if full
+        bool push( const T& t ) { return _push( [&]( T& v ) { v = t; } ); }
+
+        /// push element; return false, if full
+        bool push( T&& t ) { return _push( [&]( T& v ) { v = std::move( t ); } ); }
+
+        /// push as many elements as fit; return number of elements pushed
+        template < typename Iterator > std::size_t push( Iterator begin, Iterator end );
+
+        /// push element, wait while full; return false on timeout or if closed
+        bool wait_push( const T& t, const boost::posix_time::time_duration& timeout = boost::posix_time::pos_infin );
+
+        /// pop element; return false, if empty
+        bool pop( T& t );
+
+        /// pop up to n elements into output iterator; return number of elements popped
+        template < typename Iterator > std::size_t pop( Iterator out, std::size_t n );
+
+        /// pop element, wait while empty; return false on timeout or if closed and empty
+        bool wait_pop( T& t, const boost::posix_time::time_duration& timeout = boost::posix_time::pos_infin );
+
+        /// mark buffer closed, i.e. no more elements will be pushed, and wake up waiting threads
+        void close() { _closed.store( true, std::memory_order_release ); _not_empty.notify(); _not_full.notify(); }
+
+        bool closed() const { return _closed.load( std::memory_order_acquire ); }
+
+        /// approximate number of elements
+        std::size_t size() const { std::size_t t = _tail.load( std::memory_order_acquire ); std::size_t h = _head.load( std::memory_order_acquire ); return t > h ? t - h : 0; }
+
+        bool empty() const { return size() == 0; }
+
+        std::size_t capacity() const { return _cells.size(); }
+
+    private:
+        struct cell
+        {
+            std::atomic< std::size_t > sequence;
+            T value;
+            cell( std::size_t s, const T& t ): sequence( s ), value( t ) {}
+            cell( const cell& rhs ): sequence( rhs.sequence.load() ), value( rhs.value ) {}
+        };
+        std::vector< cell > _cells;
+        std::size_t _mask;
+        alignas( impl::cache_line ) std::atomic< std::size_t > _head{0};
+        alignas( impl::cache_line ) std::atomic< std::size_t > _tail{0};
+        alignas( impl::cache_line ) std::atomic< bool > _closed{false};
+        impl::waiter _not_empty;
+        impl::waiter _not_full;
+
+        template < typename F > bool _push( F f );
+        bool _full() const { std::size_t t = _tail.load( std::memory_order_relaxed ); return _cells[ t & _mask ].sequence.load( std::memory_order_acquire ) != t; }
+        bool _empty() const { std::size_t h = _head.load( std::memory_order_relaxed ); return _cells[ h & _mask ].sequence.load( std::memory_order_acquire ) != h + 1; }
+};
+
+template < typename T >
+inline spsc_cyclic_buffer< T >::spsc_cyclic_buffer( std::size_t size, const T& t ): _data( impl::power_of_two( size ), t ), _mask( _data.size() - 1 )
+{
+    COMMA_ASSERT_BRIEF( size > 0, "cyclic buffer: expected positive size" );
+}
+
+template < typename T >
+inline std::size_t spsc_cyclic_buffer< T >::_space( std::size_t wanted )
+{
+    std::size_t t = _tail.load( std::memory_order_relaxed );
+    if( _data.size() - ( t - _cached_head ) < wanted ) { _cached_head = _head.load( std::memory_order_acquire ); }
+    return _data.size() - ( t - _cached_head );
+}
+
+template < typename T >
+inline std::size_t spsc_cyclic_buffer< T >::_available( std::size_t wanted )
+{
+    std::size_t h = _head.load( std::memory_order_relaxed );
+    if( _cached_tail - h < wanted ) { _cached_tail = _tail.load( std::memory_order_acquire ); }
+    return _cached_tail - h;
+}
+
+template < typename T >
+template < typename F >
+inline bool spsc_cyclic_buffer< T >::_push( F f )
+{
+    if( _space() == 0 ) { return false; }
+    std::size_t t = _tail.load( std::memory_order_relaxed );
+    f( _data[ t & _mask ] );
+    _tail.store( t + 1, std::memory_order_release );
+    _not_empty.notify();
+    return true;
+}
+
+template < typename T >
+template < typename Iterator >
+inline std::size_t spsc_cyclic_buffer< T >::push( Iterator begin, Iterator end )
+{
+    std::size_t space = _space( _data.size() );
+    std::size_t t = _tail.load( std::memory_order_relaxed );
+    std::size_t n = 0;
+    for( ; begin != end && n < space; ++begin, ++n ) { _data[ ( t + n ) & _mask ] = *begin; }
+    if( n == 0 ) { return 0; }
+    _tail.store( t + n, std::memory_order_release ); // publish the whole batch at once
+    _not_empty.notify();
+    return n;
+}
+
+template < typename T >
+inline bool spsc_cyclic_buffer< T >::wait_push( const T& t, const boost::posix_time::time_duration& timeout )
+{
+    while( true )
+    {
+        if( closed() ) { return false; }
+        if( push( t ) ) { return true; }
+        if( !_not_full.wait( [&]() { return closed() || _space() > 0; }, timeout ) ) { return false; }
+    }
+}
+
+template < typename T >
+inline T* spsc_cyclic_buffer< T >::front()
+{
+    return _available() == 0 ? nullptr : &_data[ _head.load( std::memory_order_relaxed ) & _mask ];
+}
+
+template < typename T >
+inline void spsc_cyclic_buffer< T >::pop()
+{
+    _head.store( _head.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+    _not_full.notify();
+}
+
+template < typename T >
+inline bool spsc_cyclic_buffer< T >::pop( T& t )
+{
+    T* f = front();
+    if( !f ) { return false; }
+    t = std::move( *f );
+    pop();
+    return true;
+}
+
+template < typename T >
+template < typename Iterator >
+inline std::size_t spsc_cyclic_buffer< T >::pop( Iterator out, std::size_t n )
+{
+    std::size_t a = std::min( n, _available( n ) );
+    if( a == 0 ) { return 0; }
+    std::size_t h = _head.load( std::memory_order_relaxed );
+    for( std::size_t i = 0; i < a; ++i, ++out ) { *out = std::move( _data[ ( h + i ) & _mask ] ); }
+    _head.store( h + a, std::memory_order_release );
+    _not_full.notify();
+    return a;
+}
+
+template < typename T >
+inline bool spsc_cyclic_buffer< T >::wait( const boost::posix_time::time_duration& timeout )
+{
+    if( !_not_empty.wait( [&]() { return _available() > 0 || closed(); }, timeout ) ) { return false; }
+    return _available() > 0;
+}
+
+template < typename T >
+inline bool spsc_cyclic_buffer< T >::wait_pop( T& t, const boost::posix_time::time_duration& timeout )
+{
+    return wait( timeout ) && pop( t );
+}
+
+template < typename T >
+inline mpmc_cyclic_buffer< T >::mpmc_cyclic_buffer( std::size_t size, const T& t ): _mask( impl::power_of_two( size ) - 1 )
+{
+    COMMA_ASSERT_BRIEF( size > 0, "cyclic buffer: expected positive size" );
+    _cells.reserve( _mask + 1 );
+    for( std::size_t i = 0; i <= _mask; ++i ) { _cells.emplace_back( i, t ); }
+}
+
+template < typename T >
+template < typename F >
+inline bool mpmc_cyclic_buffer< T >::_push( F f )
+{
+    std::size_t t = _tail.load( std::memory_order_relaxed );
+    while( true )
+    {
+        cell& c = _cells[ t & _mask ];
+        std::size_t s = c.sequence.load( std::memory_order_acquire );
+        if( s == t )
+        {
+            if( _tail.compare_exchange_weak( t, t + 1, std::memory_order_relaxed ) )
+            {
+                f( c.value );
+                c.sequence.store( t + 1, std::memory_order_release );
+                _not_empty.notify();
+                return true;
+            }
+        }
+        else if( s < t ) { return false; } // slot not yet read in previous lap: full
+        else { t = _tail.load( std::memory_order_relaxed ); }
+    }
+}
+
+template < typename T >
+template < typename Iterator >
+inline std::size_t mpmc_cyclic_buffer< T >::push( Iterator begin, Iterator end )
+{
+    std::size_t n = 0;
+    for( ; begin != end && push( *begin ); ++begin, ++n );
+    return n;
+}
+
+template < typename T >
+inline bool mpmc_cyclic_buffer< T >::wait_push( const T& t, const boost::posix_time::time_duration& timeout )
+{
+    while( true )
+    {
+        if( closed() ) { return false; }
+        if( push( t ) ) { return true; }
+        if( !_not_full.wait( [&]() { return closed() || !_full(); }, timeout ) ) { return false; }
+    }
+}
+
+template < typename T >
+inline bool mpmc_cyclic_buffer< T >::pop( T& t )
+{
+    std::size_t h = _head.load( std::memory_order_relaxed );
+    while( true )
+    {
+        cell& c = _cells[ h & _mask ];
+        std::size_t s = c.sequence.load( std::memory_order_acquire );
+        if( s == h + 1 )
+        {
+            if( _head.compare_exchange_weak( h, h + 1, std::memory_order_relaxed ) )
+            {
+                t = std::move( c.value );
+                c.sequence.store( h + _mask + 1, std::memory_order_release ); // ready for write in next lap
+                _not_full.notify();
+                return true;
+            }
+        }
+        else if( s < h + 1 ) { return false; } // slot not yet written: empty
+        else { h = _head.load( std::memory_order_relaxed ); }
+    }
+}
+
+template < typename T >
+template < typename Iterator >
+inline std::size_t mpmc_cyclic_buffer< T >::pop( Iterator out, std::size_t n )
+{
+    std::size_t i = 0;
+    T t;
+    for( ; i < n && pop( t ); ++i, ++out ) { *out = std::move( t ); }
+    return i;
+}
+
+template < typename T >
+inline bool mpmc_cyclic_buffer< T >::wait_pop( T& t, const boost::posix_time::time_duration& timeout )
+{
+    while( true )
+    {
+        if( pop( t ) ) { return true; }
+        if( closed() && _empty() ) { return false; }
+        if( !_not_empty.wait( [&]() { return closed() || !_empty(); }, timeout ) ) { return false; }
+    }
+}
+
+} // namespace comma {
@@ -6,6 +6,7 @@
 
 #include <array>
 #include <cstring>
+#include <vector>
 #include "../../base/types.h"
 #include "array_traits.h"
 #include "index.h"
@@ -0,0 +1,190 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "../../base/exception.h"
+#include "morton_map.h"
+
+namespace comma { namespace containers { namespace multidimensional {
+
+/// thread-safe hash map with array-like keys for parallel binning of points into voxels
+///
+/// keys are split between shards, each a morton_map with its own mutex (lock striping); a shard holds whole
+/// bricks of 8^Size voxels, so that a thread binning spatially coherent points mostly takes the same lock
+///
+/// values are accessed only under the lock, through functors, since shards may grow concurrently
+///
+/// for heavy contention, e.g. all threads binning points in the same small area, accumulate into a morton_map
+/// per thread and then merge() them in
+template < typename K, typename V, std::size_t Size, typename P = std::array< K, Size >, typename Traits = impl::operations< Size > >
+class concurrent_map
+{
+    public:
+        typedef morton_map< K, V, Size, P, Traits > shard_type;
+
+        enum { dimensions = Size };
+
+        typedef P point_type;
+
+        typedef typename shard_type::key_type key_type;
+
+        typedef key_type index_type;
+
+        typedef V mapped_type;
+
+        typedef typename shard_type::value_type value_type;
+
+        /// @param shards number of shards, rounded up to power of 2
+        concurrent_map( const point_type& origin, const point_type& resolution, unsigned int shards = 64 );
+
+        concurrent_map( const point_type& resolution, unsigned int shards = 64 ): concurrent_map( Traits::template zero< P >(), resolution, shards ) {}
+
+        /// insert default value at the given point, if it does not exist, and call f( V& ) on it under lock
+        template < typename F > void touch_at( const point_type& point, F f ) { touch( index_of( point ), f ); }
+
+        /// insert default value at the given index, if it does not exist, and call f( V& ) on it under lock
+        template < typename F > void touch( const key_type& index, F f );
+
+        /// insert value at the given point, if it does not exist; return true, if inserted
+        bool insert( const point_type& point, const V& value ) { return insert( index_of( point ), value ); }
+
+        /// insert value at the given index, if it does not exist; return true, if inserted
+        bool insert( const key_type& index, const V& value );
+
+        /// copy value at given index, if exists; return false, if none
+        bool find( const key_type& index, V& value ) const;
+
+        /// add all elements of other map, e.g. per-thread one, calling f( V& value, const V& other_value ) for keys present in both;
+        /// can be called from several threads at once
+        template < typename F > void merge( const shard_type& other, F f );
+
+        /// call f( const key_type&, V& ) for each element; if coherent, in z-order, i.e. spatially coherent, otherwise shard by shard;
+        /// not thread-safe with concurrent insertions
+        template < typename F > void for_each( F f, bool coherent = false );
+
+        template < typename F > void for_each( F f, bool coherent = false ) const;
+
+        /// number of elements; not thread-safe with concurrent insertions
+        std::size_t size() const;
+
+        bool empty() const { return size() == 0; }
+
+        key_type index_of( const point_type& point ) const { return Traits::template index_of< P, key_type >( point, _origin, _resolution ); }
+
+        const point_type& origin() const { return _origin; }
+
+        const point_type& resolution() const { return _resolution; }
+
+        unsigned int shards() const { return _shards.size(); }
+
+    private:
+        struct alignas( 64 ) shard // on separate cache lines to avoid false sharing of locks
+        {
+            mutable std::mutex mutex;
+            shard_type map;
+            shard( const point_type& origin, const point_type& resolution ): map( origin, resolution ) {}
+        };
+        point_type _origin;
+        point_type _resolution;
+        std::vector< std::unique_ptr< shard > > _shards;
+        unsigned int _bits{0};
+
+        std::size_t _shard_index( const key_type& index ) const;
+        shard& _shard( const key_type& index ) const { return *_shards[ _shard_index( index ) ]; }
+};
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+inline concurrent_map< K, V, Size, P, Traits >::concurrent_map( const point_type& origin, const point_type& resolution, unsigned int shards ): _origin( origin ), _resolution( resolution )
+{
+    COMMA_ASSERT_BRIEF( shards > 0, "concurrent_map: expected positive number of shards" );
+    while( ( 1u << _bits ) < shards ) { ++_bits; }
+    for( unsigned int i = 0; i < ( 1u << _bits ); ++i ) { _shards.emplace_back( new shard( origin, resolution ) ); }
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+inline std::size_t concurrent_map< K, V, Size, P, Traits >::_shard_index( const key_type& index ) const
+{
+    if( _bits == 0 ) { return 0; }
+    std::uint64_t brick = morton::code< Size >::value( index ) >> ( 3 * Size ); // 8^Size voxels
+    return ( brick * 0x9e3779b97f4a7c15ull ) >> ( 64 - _bits ); // fibonacci hashing
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+template < typename F >
+inline void concurrent_map< K, V, Size, P, Traits >::touch( const key_type& index, F f )
+{
+    shard& s = _shard( index );
+    std::lock_guard< std::mutex > lock( s.mutex );
+    f( s.map.touch( index ) );
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+inline bool concurrent_map< K, V, Size, P, Traits >::insert( const key_type& index, const V& value )
+{
+    shard& s = _shard( index );
+    std::lock_guard< std::mutex > lock( s.mutex );
+    return s.map.insert( index, value );
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+inline bool concurrent_map< K, V, Size, P, Traits >::find( const key_type& index, V& value ) const
+{
+    shard& s = _shard( index );
+    std::lock_guard< std::mutex > lock( s.mutex );
+    const V* v = s.map.find( index );
+    if( v ) { value = *v; }
+    return v != nullptr;
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+template < typename F >
+inline void concurrent_map< K, V, Size, P, Traits >::merge( const shard_type& other, F f )
+{
+    std::vector< std::vector< std::pair< const key_type*, const V* > > > buckets( _shards.size() ); // group by shard to take each lock once
+    other.for_each( [&]( const key_type& k, const V& v ) { buckets[ _shard_index( k ) ].emplace_back( &k, &v ); } );
+    for( std::size_t i = 0; i < buckets.size(); ++i )
+    {
+        if( buckets[i].empty() ) { continue; }
+        std::lock_guard< std::mutex > lock( _shards[i]->mutex );
+        for( const auto& e: buckets[i] )
+        {
+            V* v = _shards[i]->map.find( *e.first );
+            if( v ) { f( *v, *e.second ); } else { _shards[i]->map.insert( *e.first, *e.second ); }
+        }
+    }
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+template < typename F >
+inline void concurrent_map< K, V, Size, P, Traits >::for_each( F f, bool coherent )
+{
+    if( !coherent ) { for( auto& s: _shards ) { s->map.for_each( f ); } return; }
+    std::vector< const value_type* > all;
+    all.reserve( size() );
+    for( const auto& s: _shards ) { const auto& t = s->map.sorted(); all.insert( all.end(), t.begin(), t.end() ); }
+    std::sort( all.begin(), all.end(), []( const value_type* a, const value_type* b ) { return morton::less< Size >( a->first, b->first ); } );
+    for( const value_type* e: all ) { f( e->first, const_cast< value_type* >( e )->second ); }
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+template < typename F >
+inline void concurrent_map< K, V, Size, P, Traits >::for_each( F f, bool coherent ) const
+{
+    const_cast< concurrent_map* >( this )->for_each( [&]( const key_type& k, V& v ) { f( k, const_cast< const V& >( v ) ); }, coherent );
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+inline std::size_t concurrent_map< K, V, Size, P, Traits >::size() const
+{
+    std::size_t n = 0;
+    for( const auto& s: _shards ) { n += s->map.size(); }
+    return n;
+}
+
+} } } // namespace comma { namespace containers { namespace multidimensional {
@@ -0,0 +1,217 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "../../base/exception.h"
+
+namespace comma { namespace containers { namespace multidimensional {
+
+/// lookup table on a regular grid with any number of dimensions known at run time
+///
+/// each grid node holds a value of a given number of elements of type T; nodes are stored
+/// rows first (i.e. numpy layout: shape[0] is the slowest-changing), values are contiguous
+///
+/// the table does not own its data, which, for example, may be memory-mapped from a file
+///
+/// interpolate() is designed for throughput: it processes points in blocks, first computing
+/// node offsets and fractions for the whole block, then accumulating the weighted values corner
+/// by corner across the block; the inner loops run over the block with no branches, so that the
+/// compiler can vectorise them
+template < typename T >
+class lut
+{
+    public:
+        typedef T value_type;
+
+        lut( const std::vector< double >& origin, const std::vector< double >& resolution, const std::vector< std::size_t >& shape, std::size_t elements, const T* data );
+
+        std::size_t dimensions() const { return _shape.size(); }
+
+        std::size_t elements() const { return _elements; }
+
+        const std::vector< std::size_t >& shape() const { return _shape; }
+
+        /// return number of nodes
+        std::size_t size() const { return _size; }
+
+        /// return true, if point is inside the grid, i.e. its cell index is within shape
+        /// thus, points past the last node, but less than one resolution beyond it, are inside
+        bool has( const double* point ) const;
+
+        /// return index of cell the point is in, i.e. index of the node at its lower corner
+        /// throw, if point is not inside the grid
+        void index_of( const double* point, std::size_t* index ) const;
+
+        /// return index of node nearest to the point, clamped to the grid
+        void nearest( const double* point, std::size_t* index ) const;
+
+        /// return pointer to the value at given node index
+        const T* operator()( const std::size_t* index ) const { return _data + offset( index ) * _elements; }
+
+        /// return offset of node in nodes
+        std::size_t offset( const std::size_t* index ) const;
+
+        /// multilinear interpolation of n points given as n x dimensions() row-major array
+        /// into n x elements() row-major array of values; points beyond the last node in
+        /// any dimension are linearly extrapolated from the last cell, points outside the grid,
+        /// too, although callers normally check has() first
+        /// @note not thread-safe, since uses internal buffers; use a copy of lut per thread
+        void interpolate( const double* points, std::size_t n, T* values ) const;
+
+        /// interpolate one point
+        void interpolate( const double* point, T* value ) const { interpolate( point, 1, value ); }
+
+    private:
+        std::vector< double > _origin;
+        std::vector< double > _resolution;
+        std::vector< std::size_t > _shape;
+        std::size_t _elements;
+        const T* _data;
+        std::size_t _size;
+        std::vector< std::size_t > _strides; // in nodes
+        std::vector< std::size_t > _corners; // offsets of cell corners in nodes; bit d of corner index is 1 for the upper neighbour in dimension d
+        std::size_t _block;
+        mutable std::vector< std::size_t > _offsets; // block buffers
+        mutable std::vector< double > _fractions;
+        mutable std::vector< double > _weights;
+        mutable std::vector< double > _sums;
+
+        double _coordinate( const double* point, std::size_t d ) const { return ( point[d] - _origin[d] ) / _resolution[d]; }
+        void _interpolate( const double* points, std::size_t n, T* values ) const;
+};
+
+template < typename T >
+inline lut< T >::lut( const std::vector< double >& origin, const std::vector< double >& resolution, const std::vector< std::size_t >& shape, std::size_t elements, const T* data )
+    : _origin( origin )
+    , _resolution( resolution )
+    , _shape( shape )
+    , _elements( elements )
+    , _data( data )
+    , _size( 1 )
+    , _strides( shape.size() )
+{
+    COMMA_ASSERT_BRIEF( !shape.empty(), "lut: expected at least one dimension" );
+    COMMA_ASSERT_BRIEF( origin.size() == shape.size() && resolution.size() == shape.size(), "lut: expected origin, resolution, and shape of the same dimensions; got: " << origin.size() << ", " << resolution.size() << ", and " << shape.size() );
+    COMMA_ASSERT_BRIEF( elements > 0, "lut: expected positive number of value elements" );
+    COMMA_ASSERT_BRIEF( shape.size() <= 16, "lut: more than 16 dimensions not supported, since interpolation uses 2^dimensions cell corners; got: " << shape.size() );
+    for( std::size_t d = shape.size(); d > 0; --d )
+    {
+        COMMA_ASSERT_BRIEF( shape[ d - 1 ] > 0, "lut: expected positive shape; got 0 in dimension " << ( d - 1 ) );
+        COMMA_ASSERT_BRIEF( resolution[ d - 1 ] > 0, "lut: expected positive resolution; got " << resolution[ d - 1 ] << " in dimension " << ( d - 1 ) );
+        _strides[ d - 1 ] = _size;
+        _size *= shape[ d - 1 ];
+    }
+    _corners.resize( std::size_t( 1 ) << shape.size(), 0 );
+    for( std::size_t c = 0; c < _corners.size(); ++c ) { for( std::size_t d = 0; d < shape.size(); ++d ) { if( ( c >> d ) & 1 && shape[d] > 1 ) { _corners[c] += _strides[d]; } } }
+    _block = std::max( std::size_t( 16 ), std::size_t( 65536 ) / _corners.size() ); // keep block weights within cache
+    _block = std::min( _block, std::size_t( 1024 ) );
+}
+
+template < typename T >
+inline bool lut< T >::has( const double* point ) const
+{
+    for( std::size_t d = 0; d < _shape.size(); ++d )
+    {
+        double t = std::floor( _coordinate( point, d ) );
+        if( !( t >= 0 && t < double( _shape[d] ) ) ) { return false; } // also catches nan
+    }
+    return true;
+}
+
+template < typename T >
+inline void lut< T >::index_of( const double* point, std::size_t* index ) const
+{
+    for( std::size_t d = 0; d < _shape.size(); ++d )
+    {
+        double t = std::floor( _coordinate( point, d ) );
+        COMMA_ASSERT_BRIEF( t >= 0 && t < double( _shape[d] ), "lut: expected point inside grid; got coordinate " << point[d] << " in dimension " << d << " outside of it" ); // also catches nan
+        index[d] = std::size_t( t );
+    }
+}
+
+template < typename T >
+inline void lut< T >::nearest( const double* point, std::size_t* index ) const
+{
+    for( std::size_t d = 0; d < _shape.size(); ++d )
+    {
+        double t = std::floor( _coordinate( point, d ) + 0.5 );
+        index[d] = t <= 0 ? 0 : std::min( std::size_t( t ), _shape[d] - 1 );
+    }
+}
+
+template < typename T >
+inline std::size_t lut< T >::offset( const std::size_t* index ) const
+{
+    std::size_t o = 0;
+    for( std::size_t d = 0; d < _shape.size(); ++d ) { o += index[d] * _strides[d]; }
+    return o;
+}
+
+template < typename T >
+inline void lut< T >::interpolate( const double* points, std::size_t n, T* values ) const
+{
+    _offsets.resize( _block );
+    _fractions.resize( _block * _shape.size() );
+    _weights.resize( _block * _corners.size() );
+    _sums.resize( _block * _elements );
+    for( std::size_t i = 0; i < n; i += _block ) { _interpolate( points + i * _shape.size(), std::min( _block, n - i ), values + i * _elements ); }
+}
+
+template < typename T >
+inline void lut< T >::_interpolate( const double* points, std::size_t n, T* values ) const
+{
+    const std::size_t dimensions = _shape.size();
+    std::size_t* offsets = &_offsets[0];
+    double* weights = &_weights[0]; // weights of corner c are in weights[ c * n ... c * n + n )
+    double* sums = &_sums[0];
+    for( std::size_t k = 0; k < n; ++k ) { offsets[k] = 0; }
+    for( std::size_t k = 0; k < n; ++k ) { weights[k] = 1; }
+    for( std::size_t d = 0; d < dimensions; ++d ) // lower cell corners and fractions
+    {
+        double* f = &_fractions[ d * n ];
+        double last = _shape[d] > 1 ? double( _shape[d] - 2 ) : 0; // cells reach the last node; beyond it, extrapolate from the last cell
+        double o = _origin[d];
+        double r = 1 / _resolution[d];
+        std::size_t stride = _strides[d];
+        for( std::size_t k = 0; k < n; ++k )
+        {
+            double t = ( points[ k * dimensions + d ] - o ) * r;
+            double i = std::min( std::max( std::floor( t ), 0. ), last );
+            f[k] = _shape[d] > 1 ? t - i : 0;
+            offsets[k] += std::size_t( i ) * stride;
+        }
+        std::size_t corners = std::size_t( 1 ) << d; // corner weights: w[c] *= 1 - f; w[c + 2^d] = w[c] * f
+        for( std::size_t c = 0; c < corners; ++c )
+        {
+            double* lower = weights + c * n;
+            double* upper = weights + ( c + corners ) * n;
+            for( std::size_t k = 0; k < n; ++k ) { upper[k] = lower[k] * f[k]; lower[k] -= upper[k]; }
+        }
+    }
+    for( std::size_t k = 0; k < n * _elements; ++k ) { sums[k] = 0; }
+    for( std::size_t c = 0; c < _corners.size(); ++c )
+    {
+        const double* w = weights + c * n;
+        const T* data = _data + _corners[c] * _elements;
+        if( _elements == 1 ) // most common case: scalar table
+        {
+            for( std::size_t k = 0; k < n; ++k ) { sums[k] += w[k] * data[ offsets[k] ]; }
+            continue;
+        }
+        for( std::size_t k = 0; k < n; ++k )
+        {
+            const T* v = data + offsets[k] * _elements;
+            double* s = sums + k * _elements;
+            for( std::size_t e = 0; e < _elements; ++e ) { s[e] += w[k] * v[e]; }
+        }
+    }
+    for( std::size_t k = 0; k < n * _elements; ++k ) { values[k] = T( sums[k] ); }
+}
+
+} } } // namespace comma { namespace containers { namespace multidimensional {
@@ -0,0 +1,261 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "../../base/types.h"
+#include "array_traits.h"
+
+namespace comma { namespace containers { namespace multidimensional {
+
+namespace morton {
+
+/// map signed index element to unsigned preserving order
+inline std::uint32_t unsigned_of( comma::int32 i ) { return std::uint32_t( i ) ^ 0x80000000u; }
+
+/// morton code (z-order) of index: bits of index elements interleaved, element 0 in the least significant bit;
+/// if index has more than 2 elements, only the lower 64 / Size bits of each element are used
+template < std::size_t Size > struct code
+{
+    static std::uint64_t value( const std::array< comma::int32, Size >& index )
+    {
+        const unsigned int bits = 64 / Size;
+        std::uint64_t c = 0;
+        for( unsigned int b = 0; b < bits; ++b ) { for( std::size_t k = 0; k < Size; ++k ) { c |= std::uint64_t( ( unsigned_of( index[k] ) >> b ) & 1 ) << ( b * Size + k ); } }
+        return c;
+    }
+};
+
+template <> struct code< 1 > { static std::uint64_t value( const std::array< comma::int32, 1 >& index ) { return unsigned_of( index[0] ); } };
+
+template <> struct code< 2 >
+{
+    static std::uint64_t spread( std::uint64_t x )
+    {
+        x = ( x | ( x << 16 ) ) & 0x0000ffff0000ffffull;
+        x = ( x | ( x << 8 ) ) & 0x00ff00ff00ff00ffull;
+        x = ( x | ( x << 4 ) ) & 0x0f0f0f0f0f0f0f0full;
+        x = ( x | ( x << 2 ) ) & 0x3333333333333333ull;
+        x = ( x | ( x << 1 ) ) & 0x5555555555555555ull;
+        return x;
+    }
+    static std::uint64_t value( const std::array< comma::int32, 2 >& index ) { return spread( unsigned_of( index[0] ) ) | ( spread( unsigned_of( index[1] ) ) << 1 ); }
+};
+
+template <> struct code< 3 >
+{
+    static std::uint64_t spread( std::uint64_t x )
+    {
+        x &= 0x1fffff;
+        x = ( x | ( x << 32 ) ) & 0x1f00000000ffffull;
+        x = ( x | ( x << 16 ) ) & 0x1f0000ff0000ffull;
+        x = ( x | ( x << 8 ) ) & 0x100f00f00f00f00full;
+        x = ( x | ( x << 4 ) ) & 0x10c30c30c30c30c3ull;
+        x = ( x | ( x << 2 ) ) & 0x1249249249249249ull;
+        return x;
+    }
+    static std::uint64_t value( const std::array< comma::int32, 3 >& index ) { return spread( unsigned_of( index[0] ) ) | ( spread( unsigned_of( index[1] ) ) << 1 ) | ( spread( unsigned_of( index[2] ) ) << 2 ); }
+};
+
+/// exact z-order comparison of indices on all 32 bits of each element, consistent with code< Size > where it is not truncated
+template < std::size_t Size >
+inline bool less( const std::array< comma::int32, Size >& lhs, const std::array< comma::int32, Size >& rhs )
+{
+    std::size_t d = Size - 1;
+    std::uint32_t m = 0;
+    for( std::size_t k = Size; k > 0; --k ) // highest differing bit decides; on tie, higher element is more significant
+    {
+        std::uint32_t x = unsigned_of( lhs[ k - 1 ] ) ^ unsigned_of( rhs[ k - 1 ] );
+        if( m < x && m < ( m ^ x ) ) { m = x; d = k - 1; }
+    }
+    return unsigned_of( lhs[d] ) < unsigned_of( rhs[d] );
+}
+
+} // namespace morton {
+
+/// hash map with array-like keys as multidimensional::map, but with open addressing in a flat array of slots
+///
+/// slots are addressed by morton code of voxel index, so that neighbouring voxels are close to each other in memory,
+/// which makes binning spatially coherent points cache-friendly; no per-voxel heap allocations
+///
+/// references and iterators are invalidated on insertion of a new key, since table may grow;
+/// single-threaded: use one map per thread and merge(), or concurrent_map
+template < typename K, typename V, std::size_t Size, typename P = std::array< K, Size >, typename Traits = impl::operations< Size > >
+class morton_map
+{
+    public:
+        enum { dimensions = Size };
+
+        typedef P point_type;
+
+        typedef std::array< comma::int32, Size > key_type;
+
+        typedef key_type index_type;
+
+        typedef V mapped_type;
+
+        typedef std::pair< key_type, V > value_type;
+
+        morton_map( const point_type& origin, const point_type& resolution, std::size_t capacity = 1024 );
+
+        morton_map( const point_type& resolution, std::size_t capacity = 1024 ): morton_map( Traits::template zero< P >(), resolution, capacity ) {}
+
+        /// insert default value at the given point, if it does not exist; return reference to value
+        V& touch_at( const point_type& point ) { return touch( index_of( point ) ); }
+
+        /// insert value at the given point, if it does not exist; return true, if inserted
+        bool insert( const point_type& point, const V& value ) { return insert( index_of( point ), value ); }
+
+        /// insert default value at the given index, if it does not exist; return reference to value
+        V& touch( const key_type& index ) { return _slots[ _touch( index, morton::code< Size >::value( index ) ).first ].second; }
+
+        /// insert value at the given index, if it does not exist; return true, if inserted
+        bool insert( const key_type& index, const V& value );
+
+        /// return pointer to value at given point or null, if none
+        V* at( const point_type& point ) { return find( index_of( point ) ); }
+
+        const V* at( const point_type& point ) const { return find( index_of( point ) ); }
+
+        /// return pointer to value at given index or null, if none
+        V* find( const key_type& index );
+
+        const V* find( const key_type& index ) const { return const_cast< morton_map* >( this )->find( index ); }
+
+        /// add all elements of other map, calling f( V& value, const V& other_value ) for keys present in both, e.g. to combine per-thread maps
+        template < typename F > void merge( const morton_map& other, F f );
+
+        /// call f( const key_type&, V& ) for each element, in order of slots, i.e. roughly spatially coherent
+        template < typename F > void for_each( F f );
+
+        template < typename F > void for_each( F f ) const;
+
+        /// return elements sorted in z-order, i.e. spatially coherent
+        std::vector< const value_type* > sorted() const;
+
+        std::size_t size() const { return _size; }
+
+        bool empty() const { return _size == 0; }
+
+        void clear();
+
+        key_type index_of( const point_type& point ) const { return Traits::template index_of< P, key_type >( point, _origin, _resolution ); }
+
+        const point_type& origin() const { return _origin; }
+
+        const point_type& resolution() const { return _resolution; }
+
+    private:
+        point_type _origin;
+        point_type _resolution;
+        std::vector< value_type > _slots;
+        std::vector< unsigned char > _used;
+        std::size_t _size{0};
+        std::size_t _mask{0};
+        unsigned int _bits{0};
+
+        std::size_t _slot( std::uint64_t code ) const { return std::size_t( code ^ ( code >> _bits ) ) & _mask; } // keep low bits for locality, fold high bits in
+        std::pair< std::size_t, bool > _touch( const key_type& index, std::uint64_t code );
+        void _resize( std::size_t capacity );
+};
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+inline morton_map< K, V, Size, P, Traits >::morton_map( const point_type& origin, const point_type& resolution, std::size_t capacity ): _origin( origin ), _resolution( resolution )
+{
+    std::size_t c = 16;
+    while( c < capacity * 2 ) { c *= 2; } // keep load factor below 0.5
+    _resize( c );
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+inline std::pair< std::size_t, bool > morton_map< K, V, Size, P, Traits >::_touch( const key_type& index, std::uint64_t code )
+{
+    std::size_t i = _slot( code );
+    for( ; _used[i]; i = ( i + 1 ) & _mask ) { if( _slots[i].first == index ) { return std::make_pair( i, false ); } }
+    if( ( _size + 1 ) * 2 > _slots.size() ) { _resize( _slots.size() * 2 ); return _touch( index, code ); }
+    _used[i] = 1;
+    _slots[i].first = index;
+    ++_size;
+    return std::make_pair( i, true );
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+inline bool morton_map< K, V, Size, P, Traits >::insert( const key_type& index, const V& value )
+{
+    auto r = _touch( index, morton::code< Size >::value( index ) );
+    if( r.second ) { _slots[ r.first ].second = value; }
+    return r.second;
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+inline V* morton_map< K, V, Size, P, Traits >::find( const key_type& index )
+{
+    for( std::size_t i = _slot( morton::code< Size >::value( index ) ); _used[i]; i = ( i + 1 ) & _mask ) { if( _slots[i].first == index ) { return &_slots[i].second; } }
+    return nullptr;
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+template < typename F >
+inline void morton_map< K, V, Size, P, Traits >::merge( const morton_map& other, F f )
+{
+    other.for_each( [&]( const key_type& k, const V& v ) { auto r = _touch( k, morton::code< Size >::value( k ) ); if( r.second ) { _slots[ r.first ].second = v; } else { f( _slots[ r.first ].second, v ); } } );
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+template < typename F >
+inline void morton_map< K, V, Size, P, Traits >::for_each( F f )
+{
+    for( std::size_t i = 0; i < _slots.size(); ++i ) { if( _used[i] ) { f( const_cast< const key_type& >( _slots[i].first ), _slots[i].second ); } }
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+template < typename F >
+inline void morton_map< K, V, Size, P, Traits >::for_each( F f ) const
+{
+    for( std::size_t i = 0; i < _slots.size(); ++i ) { if( _used[i] ) { f( _slots[i].first, _slots[i].second ); } }
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+inline std::vector< const typename morton_map< K, V, Size, P, Traits >::value_type* > morton_map< K, V, Size, P, Traits >::sorted() const
+{
+    std::vector< const value_type* > s;
+    s.reserve( _size );
+    for( std::size_t i = 0; i < _slots.size(); ++i ) { if( _used[i] ) { s.push_back( &_slots[i] ); } }
+    std::sort( s.begin(), s.end(), []( const value_type* a, const value_type* b ) { return morton::less< Size >( a->first, b->first ); } );
+    return s;
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+inline void morton_map< K, V, Size, P, Traits >::clear()
+{
+    std::fill( _used.begin(), _used.end(), 0 );
+    std::fill( _slots.begin(), _slots.end(), value_type() );
+    _size = 0;
+}
+
+template < typename K, typename V, std::size_t Size, typename P, typename Traits >
+inline void morton_map< K, V, Size, P, Traits >::_resize( std::size_t capacity )
+{
+    std::vector< value_type > slots( capacity );
+    std::vector< unsigned char > used( capacity, 0 );
+    _slots.swap( slots );
+    _used.swap( used );
+    _mask = capacity - 1;
+    for( _bits = 0; ( std::size_t( 1 ) << _bits ) < capacity; ++_bits );
+    for( std::size_t i = 0; i < slots.size(); ++i )
+    {
+        if( !used[i] ) { continue; }
+        std::size_t j = _slot( morton::code< Size >::value( slots[i].first ) );
+        while( _used[j] ) { j = ( j + 1 ) & _mask; }
+        _used[j] = 1;
+        _slots[j] = std::move( slots[i] );
+    }
+}
+
+} } } // namespace comma { namespace containers { namespace multidimensional {
@@ -0,0 +1,320 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include "../../base/exception.h"
+#include "array.h"
+#include "index.h"
+
+namespace comma { namespace containers { namespace multidimensional {
+
+/// strided view of multidimensional data, not owning the data
+///
+/// element at index i is data[ offset( i ) ], offset( i ) = i[0] * strides[0] + ... + i[D-1] * strides[D-1];
+/// views of array or slice are row-major, i.e. contiguous, while transposed(), permuted(), sub(),
+/// and strided() views address the same data without copying
+///
+/// use V = const T for read-only views
+template < typename V, unsigned int D >
+class view
+{
+    public:
+        typedef multidimensional::index< D > index_type;
+
+        typedef V value_type;
+
+        static const unsigned int dimensions{D};
+
+        view( const index_type& shape, const index_type& strides, V* data ): _shape( shape ), _strides( strides ), _data( data ) {}
+
+        /// row-major view of contiguous data
+        view( const index_type& shape, V* data ): view( shape, row_major( shape ), data ) {}
+
+        template < typename W > view( const slice< W, D >& s ): view( s.shape(), const_cast< W* >( s.data() ) ) {}
+
+        template < typename W, typename S > view( array< W, D, S >& a ): view( a.shape(), &a.data()[0] ) {}
+
+        template < typename W, typename S > view( const array< W, D, S >& a ): view( a.shape(), &a.data()[0] ) {}
+
+        /// read-only view of a view
+        template < typename W, typename = typename std::enable_if< std::is_same< const W, V >::value && !std::is_same< W, V >::value >::type >
+        view( const view< W, D >& rhs ): view( rhs.shape(), rhs.strides(), rhs.data() ) {}
+
+        V& operator[]( const index_type& i ) const { return _data[ offset( i ) ]; }
+
+        std::size_t offset( const index_type& i ) const;
+
+        V* data() const { return _data; }
+
+        const index_type& shape() const { return _shape; }
+
+        const index_type& strides() const { return _strides; }
+
+        /// return number of elements
+        std::size_t size() const;
+
+        /// return true, if elements are contiguous and in row-major order
+        bool contiguous() const { return _strides == row_major( _shape ); }
+
+        /// return view with reversed order of dimensions, e.g. for 2 dimensions: t[{j, i}] is the same element as v[{i, j}]
+        view transposed() const;
+
+        /// return view with dimensions in given order: p[k] is dimension of this view that becomes dimension k
+        view permuted( const index_type& order ) const;
+
+        /// return view of block of given shape starting at given index
+        view sub( const index_type& begin, const index_type& shape ) const;
+
+        /// return view of every step[k]-th element in dimension k, starting from the first
+        view strided( const index_type& step ) const;
+
+        /// return strides of contiguous row-major data of given shape
+        static index_type row_major( const index_type& shape );
+
+        /// return shape of tile of up to given number of bytes, e.g. to fit in L1 or L2 cache, with roughly equal edges
+        index_type tile( std::size_t bytes = 32768 ) const;
+
+        class iterator
+        {
+            public:
+                iterator() = default;
+                V& operator*() const { return *_it; }
+                iterator& operator++();
+                const index_type& index() const { return _index; }
+                bool operator==( const iterator& rhs ) const { return _it == rhs._it; }
+                bool operator!=( const iterator& rhs ) const { return !operator==( rhs ); }
+
+            private:
+                friend class view< V, D >;
+                const view* _view{nullptr};
+                index_type _index;
+                V* _it{nullptr};
+                iterator( const view* v, V* it ): _view( v ), _it( it ) {}
+        };
+
+        /// iterate in row-major order of the view index, i.e. for transposed view, in column-major order of the data
+        iterator begin() const { return iterator( this, size() == 0 ? nullptr : _data ); }
+
+        iterator end() const { return iterator( this, nullptr ); }
+
+    private:
+        index_type _shape;
+        index_type _strides;
+        V* _data;
+};
+
+namespace impl {
+
+/// call f( a, b ) for each row of given shape, where a and b are pointers to first elements of a row
+/// in two views with given strides; rows run along the last dimension
+template < unsigned int D, typename A, typename B, typename F >
+inline void for_each_row( const multidimensional::index< D >& shape, A* a, const multidimensional::index< D >& sa, B* b, const multidimensional::index< D >& sb, F f )
+{
+    for( unsigned int k = 0; k < D; ++k ) { if( shape[k] == 0 ) { return; } }
+    multidimensional::index< D > i;
+    while( true )
+    {
+        f( a, b );
+        unsigned int k = D - 1;
+        for( ; k > 0; --k ) // carry, without division
+        {
+            if( ++i[ k - 1 ] < shape[ k - 1 ] ) { a += sa[ k - 1 ]; b += sb[ k - 1 ]; break; }
+            a -= sa[ k - 1 ] * ( shape[ k - 1 ] - 1 );
+            b -= sb[ k - 1 ] * ( shape[ k - 1 ] - 1 );
+            i[ k - 1 ] = 0;
+        }
+        if( k == 0 ) { return; }
+    }
+}
+
+} // namespace impl {
+
+/// call f( i ) for the index i of the first element of each tile of given shape covering the given shape
+/// in row-major order of tiles; tiles at the upper boundaries are clipped
+template < unsigned int D, typename F >
+inline void for_each_tile( const index< D >& shape, const index< D >& tile, F f )
+{
+    index< D > counts;
+    for( unsigned int k = 0; k < D; ++k ) { counts[k] = tile[k] == 0 ? 0 : ( shape[k] + tile[k] - 1 ) / tile[k]; }
+    for( unsigned int k = 0; k < D; ++k ) { if( counts[k] == 0 ) { return; } }
+    index< D > t;
+    do
+    {
+        index< D > begin;
+        for( unsigned int k = 0; k < D; ++k ) { begin[k] = t[k] * tile[k]; }
+        f( begin );
+    }
+    while( t.increment( counts ) != index< D >{} );
+}
+
+/// return shape of tile starting at begin, clipped to shape
+template < unsigned int D >
+inline index< D > clipped( const index< D >& shape, const index< D >& begin, const index< D >& tile )
+{
+    index< D > s;
+    for( unsigned int k = 0; k < D; ++k ) { s[k] = std::min( tile[k], shape[k] - begin[k] ); }
+    return s;
+}
+
+/// call f( v ) for each element of view
+template < typename V, unsigned int D, typename F >
+inline void for_each( const view< V, D >& v, F f )
+{
+    if( v.contiguous() ) { V* p = v.data(); for( std::size_t i = 0, n = v.size(); i < n; ++i ) { f( p[i] ); } return; }
+    const std::size_t n = v.shape()[ D - 1 ];
+    const std::size_t s = v.strides()[ D - 1 ];
+    impl::for_each_row( v.shape(), v.data(), v.strides(), v.data(), v.strides(), [&]( V* p, V* ) { for( std::size_t i = 0; i < n; ++i ) { f( p[ i * s ] ); } } );
+}
+
+/// call f( a, b ) for each pair of elements with the same index in views of the same shape, e.g. to accumulate one grid into another
+///
+/// if both views are contiguous, walks memory linearly; otherwise, if the views have different layouts, e.g. one is
+/// transposed, walks tile by tile, so that for each tile the elements of both views stay in cache
+template < typename A, typename B, unsigned int D, typename F >
+inline void for_each( const view< A, D >& a, const view< B, D >& b, F f, std::size_t tile_bytes = 32768 )
+{
+    COMMA_ASSERT( a.shape() == b.shape(), "expected views of the same shape" );
+    if( a.contiguous() && b.contiguous() ) { A* p = a.data(); B* q = b.data(); for( std::size_t i = 0, n = a.size(); i < n; ++i ) { f( p[i], q[i] ); } return; }
+    auto rows = [&]( const view< A, D >& u, const view< B, D >& w )
+    {
+        const std::size_t n = u.shape()[ D - 1 ];
+        const std::size_t su = u.strides()[ D - 1 ];
+        const std::size_t sw = w.strides()[ D - 1 ];
+        if( su == 1 && sw == 1 ) { impl::for_each_row( u.shape(), u.data(), u.strides(), w.data(), w.strides(), [&]( A* p, B* q ) { for( std::size_t i = 0; i < n; ++i ) { f( p[i], q[i] ); } } ); return; }
+        impl::for_each_row( u.shape(), u.data(), u.strides(), w.data(), w.strides(), [&]( A* p, B* q ) { for( std::size_t i = 0; i < n; ++i ) { f( p[ i * su ], q[ i * sw ] ); } } );
+    };
+    if( a.strides() == b.strides() ) { rows( a, b ); return; } // same layout: tiling would not help
+    const auto& tile = a.tile( tile_bytes / 2 );
+    for_each_tile( a.shape(), tile, [&]( const typename view< A, D >::index_type& i ) { const auto& s = clipped( a.shape(), i, tile ); rows( a.sub( i, s ), b.sub( i, s ) ); } );
+}
+
+/// set all elements of view to value
+template < typename V, unsigned int D >
+inline void fill( const view< V, D >& v, const V& value )
+{
+    if( v.contiguous() ) { std::fill( v.data(), v.data() + v.size(), value ); return; }
+    for_each( v, [&]( V& e ) { e = value; } );
+}
+
+/// copy elements of one view into another of the same shape, e.g. to transpose
+template < typename A, typename B, unsigned int D >
+inline void copy( const view< A, D >& from, const view< B, D >& to, std::size_t tile_bytes = 32768 )
+{
+    if( std::is_same< typename std::remove_const< A >::type, B >::value && std::is_trivially_copyable< B >::value && from.shape() == to.shape() && from.contiguous() && to.contiguous() )
+    {
+        std::memcpy( reinterpret_cast< char* >( to.data() ), reinterpret_cast< const char* >( from.data() ), from.size() * sizeof( B ) );
+        return;
+    }
+    for_each( from, to, []( const A& a, B& b ) { b = a; }, tile_bytes );
+}
+
+/// set each element of view b to f( a ), where a is the element of view a with the same index
+template < typename A, typename B, unsigned int D, typename F >
+inline void transform( const view< A, D >& a, const view< B, D >& b, F f, std::size_t tile_bytes = 32768 )
+{
+    for_each( a, b, [&]( const A& x, B& y ) { y = f( x ); }, tile_bytes );
+}
+
+template < typename V, unsigned int D >
+inline std::size_t view< V, D >::offset( const index_type& i ) const
+{
+    std::size_t o = 0;
+    for( unsigned int k = 0; k < D; ++k ) { o += i[k] * _strides[k]; }
+    return o;
+}
+
+template < typename V, unsigned int D >
+inline std::size_t view< V, D >::size() const
+{
+    std::size_t s = 1;
+    for( unsigned int k = 0; k < D; ++k ) { s *= _shape[k]; }
+    return s;
+}
+
+template < typename V, unsigned int D >
+inline typename view< V, D >::index_type view< V, D >::row_major( const index_type& shape )
+{
+    index_type s;
+    std::size_t p = 1;
+    for( unsigned int k = D; k > 0; --k ) { s[ k - 1 ] = p; p *= shape[ k - 1 ]; }
+    return s;
+}
+
+template < typename V, unsigned int D >
+inline view< V, D > view< V, D >::transposed() const
+{
+    index_type order;
+    for( unsigned int k = 0; k < D; ++k ) { order[k] = D - 1 - k; }
+    return permuted( order );
+}
+
+template < typename V, unsigned int D >
+inline view< V, D > view< V, D >::permuted( const index_type& order ) const
+{
+    index_type shape, strides, seen;
+    for( unsigned int k = 0; k < D; ++k )
+    {
+        COMMA_ASSERT( order[k] < D && seen[ order[k] ] == 0, "expected permutation of 0.." << ( D - 1 ) << "; got invalid or repeated dimension " << order[k] );
+        seen[ order[k] ] = 1;
+        shape[k] = _shape[ order[k] ];
+        strides[k] = _strides[ order[k] ];
+    }
+    return view( shape, strides, _data );
+}
+
+template < typename V, unsigned int D >
+inline view< V, D > view< V, D >::sub( const index_type& begin, const index_type& shape ) const
+{
+    for( unsigned int k = 0; k < D; ++k ) { COMMA_ASSERT( begin[k] + shape[k] <= _shape[k], "sub-view out of bounds in dimension " << k << ": " << begin[k] << " + " << shape[k] << " > " << _shape[k] ); }
+    return view( shape, _strides, _data + offset( begin ) );
+}
+
+template < typename V, unsigned int D >
+inline view< V, D > view< V, D >::strided( const index_type& step ) const
+{
+    index_type shape, strides;
+    for( unsigned int k = 0; k < D; ++k )
+    {
+        COMMA_ASSERT( step[k] > 0, "expected positive step; got 0 in dimension " << k );
+        shape[k] = ( _shape[k] + step[k] - 1 ) / step[k];
+        strides[k] = _strides[k] * step[k];
+    }
+    return view( shape, strides, _data );
+}
+
+template < typename V, unsigned int D >
+inline typename view< V, D >::index_type view< V, D >::tile( std::size_t bytes ) const
+{
+    std::size_t elements = std::max( bytes / sizeof( V ), std::size_t( 1 ) );
+    std::size_t edge = std::max( std::size_t( std::pow( double( elements ), 1. / D ) ), std::size_t( 1 ) );
+    index_type t;
+    std::size_t remaining = elements;
+    for( unsigned int k = D; k > 0; --k ) // edges of dimensions shorter than tile edge go to the rest of dimensions
+    {
+        t[ k - 1 ] = std::max( std::min( { edge, _shape[ k - 1 ], remaining } ), std::size_t( 1 ) );
+        remaining = std::max( remaining / t[ k - 1 ], std::size_t( 1 ) );
+        if( k > 1 ) { edge = std::max( std::size_t( std::pow( double( remaining ), 1. / ( k - 1 ) ) ), std::size_t( 1 ) ); }
+    }
+    return t;
+}
+
+template < typename V, unsigned int D >
+inline typename view< V, D >::iterator& view< V, D >::iterator::operator++()
+{
+    for( unsigned int k = D; k > 0; --k )
+    {
+        if( ++_index[ k - 1 ] < _view->_shape[ k - 1 ] ) { _it += _view->_strides[ k - 1 ]; return *this; }
+        _it -= _view->_strides[ k - 1 ] * ( _view->_shape[ k - 1 ] - 1 );
+        _index[ k - 1 ] = 0;
+    }
+    _it = nullptr;
+    return *this;
+}
+
+} } } // namespace comma { namespace containers { namespace multidimensional {
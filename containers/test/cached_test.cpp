@@ -1,6 +1,11 @@
 // Copyright (c) 2024 Vsevolod Vlaskine
 // All Rights Reserved
 
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <stdexcept>
+#include <thread>
 #include <gtest/gtest.h>
 #include <vector>
 #include <boost/functional/hash.hpp>
@@ -146,3 +151,185 @@ TEST( cached, operators )
     EXPECT_EQ( plans.values().size(), 3 );
 }
 
+
+struct counted // not copyable or movable: values must stay in place
+{
+    static int alive;
+    int key;
+    counted( int k ): key( k ) { ++alive; }
+    counted( const counted& ) = delete;
+    ~counted() { --alive; }
+};
+
+int counted::alive = 0;
+
+TEST( cached, in_place )
+{
+    {
+        comma::cached< counted, int > c( 100 );
+        std::vector< const counted* > p;
+        for( int i = 0; i < 100; ++i ) { p.push_back( &c.get( i ) ); }
+        EXPECT_EQ( 100, counted::alive );
+        for( int i = 0; i < 100; ++i ) { EXPECT_EQ( p[i], &c.get( i ) ); EXPECT_EQ( i, c.get( i ).key ); } // values do not move
+        c.get( 100 );
+        EXPECT_EQ( 100, counted::alive );
+        EXPECT_EQ( nullptr, c.find( 0 ) );
+        EXPECT_EQ( p[1], c.find( 1 ) );
+        int sum = 0;
+        for( auto v: c.values() ) { EXPECT_EQ( v.first, v.second->key ); sum += v.first; }
+        EXPECT_EQ( 100 * 101 / 2, sum );
+        c.clear();
+        EXPECT_EQ( 0, counted::alive );
+        EXPECT_EQ( 0u, c.values().size() );
+        EXPECT_EQ( 5, c.get( 5 ).key );
+    }
+    EXPECT_EQ( 0, counted::alive );
+}
+
+TEST( cached, values )
+{
+    comma::cached< square, int > c;
+    c.get( 2 );
+    c.get( 3 );
+    auto values = c.values();
+    EXPECT_EQ( 2u, values.size() );
+    EXPECT_FALSE( values.empty() );
+    EXPECT_EQ( 1u, values.count( 2 ) );
+    EXPECT_EQ( 0u, values.count( 4 ) );
+    EXPECT_TRUE( values.find( 4 ) == values.end() );
+    auto it = values.find( 3 );
+    ASSERT_TRUE( it != values.end() );
+    EXPECT_EQ( 3, it->first );
+    EXPECT_EQ( 9, it->second->calculate( 3 ) );
+    EXPECT_EQ( &c.get( 3 ), it->second );
+    EXPECT_EQ( 4, ( *values.at( 2 ) ).calculate( 2 ) );
+    EXPECT_THROW( values.at( 4 ), std::out_of_range );
+}
+
+struct throwing
+{
+    static int alive;
+    throwing( int k ) { if( k < 0 ) { throw std::runtime_error( "negative key" ); } ++alive; }
+    ~throwing() { --alive; }
+};
+
+int throwing::alive = 0;
+
+struct throwing_cost { std::size_t operator()( const throwing& ) const { if( fail ) { throw std::runtime_error( "cost" ); } return 1; } static bool fail; };
+
+bool throwing_cost::fail = false;
+
+TEST( cached, exceptions )
+{
+    {
+        comma::cached< throwing, int, std::hash< int >, comma::caching::fifo, throwing_cost > c( 2 );
+        c.get( 1 );
+        EXPECT_THROW( c.get( -1 ), std::runtime_error );
+        EXPECT_EQ( 1u, c.size() );
+        throwing_cost::fail = true;
+        EXPECT_THROW( c.get( 2 ), std::runtime_error );
+        throwing_cost::fail = false;
+        EXPECT_EQ( 1u, c.size() );
+        EXPECT_EQ( 1, throwing::alive ); // value whose cost failed is destroyed
+        EXPECT_EQ( nullptr, c.find( 2 ) );
+        c.get( 2 );
+        c.get( 3 );
+        EXPECT_EQ( 2u, c.size() );
+        EXPECT_EQ( 2, throwing::alive );
+        std::size_t count = 0;
+        for( auto v: c.values() ) { ++count; EXPECT_NE( nullptr, v.second ); }
+        EXPECT_EQ( 2u, count );
+    }
+    EXPECT_EQ( 0, throwing::alive );
+}
+
+template < typename Policy > static comma::caching::statistics cyclic( const Policy& policy = Policy() )
+{
+    comma::cached< square, int, std::hash< int >, Policy > c( 10, policy );
+    for( int round = 0; round < 100; ++round ) // hot keys 0..4 and a scan of 12 keys used once: cyclic access to more keys than cache size
+    {
+        for( int i = 0; i < 5; ++i ) { c.get( i ); }
+        for( int i = 0; i < 12; ++i ) { c.get( 1000 + round * 12 + i ); }
+    }
+    EXPECT_LE( c.size(), 10u );
+    return c.stats();
+}
+
+TEST( cached, policies )
+{
+    {
+        comma::cached< square, int, std::hash< int >, comma::caching::fifo > c( 3 );
+        c.get( 1 ); c.get( 2 ); c.get( 3 ); c.get( 1 ); c.get( 4 );
+        EXPECT_EQ( nullptr, c.find( 1 ) );
+        EXPECT_NE( nullptr, c.find( 2 ) );
+    }
+    {
+        comma::cached< square, int, std::hash< int >, comma::caching::lru > c( 3 );
+        c.get( 1 ); c.get( 2 ); c.get( 3 ); c.get( 1 ); c.get( 4 );
+        EXPECT_NE( nullptr, c.find( 1 ) );
+        EXPECT_EQ( nullptr, c.find( 2 ) );
+        EXPECT_EQ( 1u, c.stats().hits );
+        EXPECT_EQ( 4u, c.stats().misses );
+        EXPECT_EQ( 1u, c.stats().evictions );
+    }
+    auto fifo = cyclic< comma::caching::fifo >();
+    auto lru = cyclic< comma::caching::lru >();
+    auto two_queue = cyclic( comma::caching::two_queue( 0.25, 2 ) ); // ghost queue longer than the scan
+    EXPECT_EQ( 0u, fifo.hits );
+    EXPECT_EQ( 0u, lru.hits );
+    EXPECT_GT( two_queue.hits, 450u ); // hot keys survive scans
+    EXPECT_EQ( 1700u, two_queue.hits + two_queue.misses );
+}
+
+struct weighted
+{
+    std::vector< char > buffer;
+    weighted( int size ): buffer( size ) {}
+};
+
+struct weight { std::size_t operator()( const weighted& w ) const { return w.buffer.size(); } };
+
+TEST( cached, cost )
+{
+    comma::cached< weighted, int, std::hash< int >, comma::caching::lru, weight > c( 100 );
+    c.get( 40 );
+    c.get( 50 );
+    EXPECT_EQ( 90u, c.cost() );
+    c.get( 30 );
+    EXPECT_EQ( 80u, c.cost() );
+    EXPECT_EQ( nullptr, c.find( 40 ) );
+    c.get( 200 ); // larger than cache: kept alone
+    EXPECT_EQ( 1u, c.size() );
+    EXPECT_EQ( 200u, c.cost() );
+}
+
+TEST( cached, concurrent )
+{
+    comma::concurrent_cached< square, int, std::hash< int >, comma::caching::lru > c( 64, 4 );
+    std::vector< std::thread > threads;
+    std::atomic< bool > ok{true};
+    for( int t = 0; t < 4; ++t ) { threads.emplace_back( [&,t]() { for( int i = 0; i < 10000; ++i ) { int k = ( i * 7 + t ) % 100; if( c.apply( [&]( square& s ) { return s.calculate( 2 ); }, k ) != k * 2 ) { ok = false; } } } ); }
+    for( auto& t: threads ) { t.join(); }
+    EXPECT_TRUE( ok );
+    EXPECT_LE( c.size(), 64u );
+    EXPECT_EQ( 40000u, c.stats().hits + c.stats().misses );
+}
+
+TEST( cached, lru_random )
+{
+    comma::cached< square, int, std::hash< int >, comma::caching::lru > c( 50 );
+    std::list< int > expected; // most recent at the back
+    for( int n = 0; n < 20000; ++n )
+    {
+        int k = std::rand() % 200;
+        auto it = std::find( expected.begin(), expected.end(), k );
+        bool hit = it != expected.end();
+        if( hit ) { expected.erase( it ); } else if( expected.size() == 50 ) { expected.pop_front(); }
+        expected.push_back( k );
+        auto hits = c.stats().hits;
+        ASSERT_EQ( k, c.get( k ).a );
+        ASSERT_EQ( hit, c.stats().hits == hits + 1 );
+    }
+    ASSERT_EQ( expected.size(), c.size() );
+    for( int k: expected ) { ASSERT_NE( nullptr, c.find( k ) ); }
+}
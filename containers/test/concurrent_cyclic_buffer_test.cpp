@@ -0,0 +1,119 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../concurrent_cyclic_buffer.h"
+
+namespace comma {
+
+TEST( spsc_cyclic_buffer, basics )
+{
+    spsc_cyclic_buffer< int > b( 3 );
+    EXPECT_EQ( 4u, b.capacity() );
+    EXPECT_TRUE( b.empty() );
+    EXPECT_EQ( nullptr, b.front() );
+    int v = 0;
+    EXPECT_FALSE( b.pop( v ) );
+    for( int i = 0; i < 4; ++i ) { EXPECT_TRUE( b.push( i ) ); }
+    EXPECT_FALSE( b.push( 4 ) );
+    EXPECT_EQ( 4u, b.size() );
+    ASSERT_NE( nullptr, b.front() );
+    EXPECT_EQ( 0, *b.front() );
+    b.pop();
+    EXPECT_TRUE( b.pop( v ) );
+    EXPECT_EQ( 1, v );
+    std::vector< int > batch{ 10, 11, 12, 13 };
+    EXPECT_EQ( 2u, b.push( batch.begin(), batch.end() ) );
+    std::vector< int > out;
+    EXPECT_EQ( 4u, b.pop( std::back_inserter( out ), 10 ) );
+    EXPECT_EQ( ( std::vector< int >{ 2, 3, 10, 11 } ), out );
+    EXPECT_TRUE( b.empty() );
+    EXPECT_FALSE( b.wait_pop( v, boost::posix_time::milliseconds( 10 ) ) );
+    b.close();
+    EXPECT_FALSE( b.wait_pop( v ) );
+    EXPECT_FALSE( b.wait_push( 1 ) );
+}
+
+TEST( spsc_cyclic_buffer, threads )
+{
+    const unsigned int size = 1000000;
+    spsc_cyclic_buffer< unsigned int > b( 64 );
+    std::thread producer( [&]()
+    {
+        std::vector< unsigned int > batch( 7 );
+        for( unsigned int i = 0; i < size; )
+        {
+            if( i % 3 == 0 ) { ASSERT_TRUE( b.wait_push( i++ ) ); continue; }
+            unsigned int n = std::min( size - i, 7u );
+            for( unsigned int k = 0; k < n; ++k ) { batch[k] = i + k; }
+            unsigned int pushed = b.push( batch.begin(), batch.begin() + n );
+            if( pushed == 0 ) { std::this_thread::yield(); }
+            i += pushed;
+        }
+        b.close();
+    } );
+    unsigned int expected = 0;
+    unsigned int v;
+    std::vector< unsigned int > out( 5 );
+    while( b.wait() )
+    {
+        if( expected % 2 ) { ASSERT_TRUE( b.pop( v ) ); ASSERT_EQ( expected++, v ); continue; }
+        std::size_t n = b.pop( out.begin(), out.size() );
+        for( std::size_t k = 0; k < n; ++k ) { ASSERT_EQ( expected++, out[k] ); }
+    }
+    producer.join();
+    EXPECT_EQ( size, expected );
+}
+
+TEST( mpmc_cyclic_buffer, basics )
+{
+    mpmc_cyclic_buffer< int > b( 4 );
+    EXPECT_EQ( 4u, b.capacity() );
+    int v = 0;
+    EXPECT_FALSE( b.pop( v ) );
+    for( int i = 0; i < 4; ++i ) { EXPECT_TRUE( b.push( i ) ); }
+    EXPECT_FALSE( b.push( 4 ) );
+    EXPECT_EQ( 4u, b.size() );
+    EXPECT_TRUE( b.pop( v ) );
+    EXPECT_EQ( 0, v );
+    std::vector< int > batch{ 10, 11 };
+    EXPECT_EQ( 1u, b.push( batch.begin(), batch.end() ) );
+    std::vector< int > out;
+    EXPECT_EQ( 4u, b.pop( std::back_inserter( out ), 10 ) );
+    EXPECT_EQ( ( std::vector< int >{ 1, 2, 3, 10 } ), out );
+    for( int i = 0; i < 20; ++i ) { EXPECT_TRUE( b.push( i ) ); EXPECT_TRUE( b.pop( v ) ); EXPECT_EQ( i, v ); } // wrap around
+    EXPECT_FALSE( b.wait_pop( v, boost::posix_time::milliseconds( 10 ) ) );
+    b.close();
+    EXPECT_FALSE( b.wait_pop( v ) );
+}
+
+TEST( mpmc_cyclic_buffer, threads )
+{
+    const unsigned int producers = 3;
+    const unsigned int consumers = 3;
+    const unsigned int size = 100000;
+    mpmc_cyclic_buffer< unsigned int > b( 32 );
+    std::vector< std::vector< unsigned int > > popped( consumers );
+    std::vector< std::thread > threads;
+    for( unsigned int c = 0; c < consumers; ++c ) { threads.emplace_back( [&,c]() { unsigned int v; while( b.wait_pop( v ) ) { popped[c].push_back( v ); } } ); }
+    std::vector< std::thread > pushers;
+    for( unsigned int p = 0; p < producers; ++p ) { pushers.emplace_back( [&,p]() { for( unsigned int i = 0; i < size; ++i ) { ASSERT_TRUE( b.wait_push( p * size + i ) ); } } ); }
+    for( auto& t: pushers ) { t.join(); }
+    b.close();
+    for( auto& t: threads ) { t.join(); }
+    std::vector< unsigned int > all;
+    for( const auto& p: popped )
+    {
+        for( unsigned int i = 1; i < p.size(); ++i ) { if( p[ i - 1 ] / size == p[i] / size ) { ASSERT_LT( p[ i - 1 ], p[i] ); } } // per-producer order preserved for each consumer
+        all.insert( all.end(), p.begin(), p.end() );
+    }
+    ASSERT_EQ( producers * size, all.size() );
+    std::sort( all.begin(), all.end() );
+    for( unsigned int i = 0; i < all.size(); ++i ) { ASSERT_EQ( i, all[i] ); }
+}
+
+} // namespace comma {
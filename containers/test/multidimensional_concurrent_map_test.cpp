@@ -0,0 +1,127 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <cstdlib>
+#include <map>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../multidimensional/concurrent_map.h"
+#include "../multidimensional/map.h"
+
+namespace cmd = comma::containers::multidimensional;
+
+TEST( multidimensional_morton, code )
+{
+    typedef std::array< comma::int32, 2 > index_t;
+    EXPECT_EQ( 0u, cmd::morton::code< 2 >::value( index_t{ { comma::int32( 0x80000000 ), comma::int32( 0x80000000 ) } } ) );
+    EXPECT_EQ( 3u, cmd::morton::code< 2 >::value( index_t{ { comma::int32( 0x80000001 ), comma::int32( 0x80000001 ) } } ) );
+    EXPECT_EQ( 2u, cmd::morton::code< 2 >::value( index_t{ { comma::int32( 0x80000000 ), comma::int32( 0x80000001 ) } } ) );
+    typedef std::array< comma::int32, 3 > index3_t;
+    EXPECT_EQ( 0x7u, cmd::morton::code< 3 >::value( index3_t{ { 1, 1, 1 } } ) & 0x3f );
+    EXPECT_EQ( 0x38u, cmd::morton::code< 3 >::value( index3_t{ { 2, 2, 2 } } ) & 0x3f );
+    EXPECT_EQ( 0xf1u, cmd::morton::code< 4 >::value( std::array< comma::int32, 4 >{ { 3, 2, 2, 2 } } ) & 0xfff );
+    for( unsigned int i = 0; i < 1000; ++i ) // exact comparison is consistent with code, where code is not truncated, i.e. for same sign
+    {
+        index3_t a{ { std::rand() % 200, std::rand() % 200, std::rand() % 200 } };
+        index3_t b{ { std::rand() % 200, std::rand() % 200, std::rand() % 200 } };
+        std::uint64_t generic = 0;
+        for( unsigned int bit = 0; bit < 21; ++bit ) { for( unsigned int k = 0; k < 3; ++k ) { generic |= std::uint64_t( ( cmd::morton::unsigned_of( a[k] ) >> bit ) & 1 ) << ( bit * 3 + k ); } }
+        ASSERT_EQ( generic, cmd::morton::code< 3 >::value( a ) );
+        ASSERT_EQ( cmd::morton::code< 3 >::value( a ) < cmd::morton::code< 3 >::value( b ), cmd::morton::less< 3 >( a, b ) );
+    }
+}
+
+TEST( multidimensional_morton_map, operations )
+{
+    typedef cmd::morton_map< double, int, 3 > map_type;
+    map_type m( {1, 1, 1}, 4 );
+    EXPECT_TRUE( m.empty() );
+    EXPECT_EQ( nullptr, m.at( map_type::point_type{1., 1., 1.} ) );
+    m.touch_at( {1.1, 1.2, 1.3} ) = 5;
+    EXPECT_EQ( 1u, m.size() );
+    ASSERT_NE( nullptr, m.at( map_type::point_type{1., 1., 1.} ) );
+    EXPECT_EQ( 5, *m.at( map_type::point_type{1.9, 1.9, 1.9} ) );
+    EXPECT_FALSE( m.insert( map_type::point_type{1.5, 1.5, 1.5}, 7 ) );
+    EXPECT_TRUE( m.insert( map_type::point_type{-0.5, -0.5, -0.5}, 7 ) );
+    EXPECT_EQ( 7, *m.find( map_type::key_type{ { -1, -1, -1 } } ) );
+    std::map< map_type::key_type, int > expected;
+    expected[ map_type::key_type{ { 1, 1, 1 } } ] = 5;
+    expected[ map_type::key_type{ { -1, -1, -1 } } ] = 7;
+    for( unsigned int i = 0; i < 100000; ++i ) // grow from small capacity
+    {
+        map_type::key_type k{ { std::rand() % 100 - 50, std::rand() % 100 - 50, std::rand() % 20000 - 10000 } };
+        m.touch( k ) += 1;
+        expected[k] += 1;
+    }
+    EXPECT_EQ( expected.size(), m.size() );
+    std::size_t count = 0;
+    m.for_each( [&]( const map_type::key_type& k, int v ) { ++count; ASSERT_EQ( expected[k], v ); } );
+    EXPECT_EQ( expected.size(), count );
+    auto sorted = m.sorted();
+    ASSERT_EQ( expected.size(), sorted.size() );
+    for( unsigned int i = 1; i < sorted.size(); ++i ) { ASSERT_TRUE( cmd::morton::less< 3 >( sorted[ i - 1 ]->first, sorted[i]->first ) ); }
+    m.clear();
+    EXPECT_TRUE( m.empty() );
+    EXPECT_EQ( nullptr, m.find( map_type::key_type{ { 1, 1, 1 } } ) );
+}
+
+TEST( multidimensional_morton_map, merge )
+{
+    typedef cmd::morton_map< double, int, 2 > map_type;
+    map_type a( {1, 1} ), b( {1, 1} );
+    a.touch_at( {0, 0} ) = 1;
+    a.touch_at( {1, 0} ) = 2;
+    b.touch_at( {1, 0} ) = 3;
+    b.touch_at( {5, 5} ) = 4;
+    a.merge( b, []( int& v, int w ) { v += w; } );
+    EXPECT_EQ( 3u, a.size() );
+    EXPECT_EQ( 1, *a.at( map_type::point_type{0, 0} ) );
+    EXPECT_EQ( 5, *a.at( map_type::point_type{1, 0} ) );
+    EXPECT_EQ( 4, *a.at( map_type::point_type{5, 5} ) );
+}
+
+TEST( multidimensional_concurrent_map, parallel )
+{
+    typedef cmd::concurrent_map< double, unsigned int, 3 > map_type;
+    map_type m( {0.5, 0.5, 0.5}, 16 );
+    EXPECT_EQ( 16u, m.shards() );
+    const unsigned int threads = 4;
+    const unsigned int points = 50000;
+    std::vector< std::vector< map_type::point_type > > input( threads );
+    for( auto& p: input ) { for( unsigned int i = 0; i < points; ++i ) { p.push_back( map_type::point_type{ std::rand() % 1000 / 100., std::rand() % 1000 / 100., std::rand() % 100 / 100. } ); } }
+    std::map< map_type::key_type, unsigned int > expected;
+    for( const auto& p: input ) { for( const auto& q: p ) { ++expected[ m.index_of( q ) ]; } }
+    std::vector< std::thread > workers;
+    for( unsigned int t = 0; t < threads; ++t ) { workers.emplace_back( [&,t]() { for( const auto& q: input[t] ) { m.touch_at( q, []( unsigned int& v ) { ++v; } ); } } ); }
+    for( auto& w: workers ) { w.join(); }
+    EXPECT_EQ( expected.size(), m.size() );
+    for( const auto& e: expected ) { unsigned int v = 0; ASSERT_TRUE( m.find( e.first, v ) ); ASSERT_EQ( e.second, v ); }
+    std::vector< map_type::key_type > keys;
+    m.for_each( [&]( const map_type::key_type& k, unsigned int ) { keys.push_back( k ); }, true );
+    ASSERT_EQ( expected.size(), keys.size() );
+    for( unsigned int i = 1; i < keys.size(); ++i ) { ASSERT_TRUE( cmd::morton::less< 3 >( keys[ i - 1 ], keys[i] ) ); }
+}
+
+TEST( multidimensional_concurrent_map, merge )
+{
+    typedef cmd::concurrent_map< double, unsigned int, 2 > map_type;
+    map_type m( {1, 1} );
+    const unsigned int threads = 4;
+    std::vector< std::thread > workers;
+    for( unsigned int t = 0; t < threads; ++t )
+    {
+        workers.emplace_back( [&]()
+        {
+            map_type::shard_type local( m.origin(), m.resolution() ); // per-thread accumulation
+            for( int i = 0; i < 100; ++i ) { for( int j = 0; j < 100; ++j ) { local.touch( map_type::key_type{ { i, j } } ) += 1; } }
+            m.merge( local, []( unsigned int& v, unsigned int w ) { v += w; } );
+        } );
+    }
+    for( auto& w: workers ) { w.join(); }
+    EXPECT_EQ( 10000u, m.size() );
+    m.for_each( [&]( const map_type::key_type&, unsigned int v ) { ASSERT_EQ( threads, v ); } );
+    EXPECT_TRUE( m.insert( map_type::point_type{ -1, -1 }, 7 ) );
+    EXPECT_FALSE( m.insert( map_type::point_type{ -0.5, -0.5 }, 8 ) );
+}
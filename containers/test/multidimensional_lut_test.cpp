@@ -0,0 +1,91 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include "../multidimensional/array.h"
+#include "../multidimensional/lut.h"
+
+namespace cmd = comma::containers::multidimensional;
+
+TEST( multidimensional_lut, index )
+{
+    std::vector< double > data( 6, 0 );
+    cmd::lut< double > t( {0, 0}, {1, 1}, {2, 3}, 1, &data[0] );
+    EXPECT_EQ( 6u, t.size() );
+    std::size_t i[2];
+    { double p[] = {0, 1.01}; t.index_of( p, i ); EXPECT_EQ( 0u, i[0] ); EXPECT_EQ( 1u, i[1] ); EXPECT_TRUE( t.has( p ) ); }
+    { double p[] = {1.9, 2.5}; t.index_of( p, i ); EXPECT_EQ( 1u, i[0] ); EXPECT_EQ( 2u, i[1] ); EXPECT_TRUE( t.has( p ) ); }
+    { double p[] = {2, 0}; EXPECT_FALSE( t.has( p ) ); }
+    { double p[] = {0, -0.1}; EXPECT_FALSE( t.has( p ) ); EXPECT_THROW( t.index_of( p, i ), comma::exception ); }
+    { double p[] = {2, 0}; EXPECT_THROW( t.index_of( p, i ), comma::exception ); }
+    { double p[] = {0.4, 1.6}; t.nearest( p, i ); EXPECT_EQ( 0u, i[0] ); EXPECT_EQ( 2u, i[1] ); }
+    { double p[] = {1.9, 2.9}; t.nearest( p, i ); EXPECT_EQ( 1u, i[0] ); EXPECT_EQ( 2u, i[1] ); } // clamped
+    { std::size_t j[] = {1, 2}; EXPECT_EQ( 5u, t.offset( j ) ); }
+}
+
+TEST( multidimensional_lut, interpolate )
+{
+    std::vector< double > data = { 0, 1, 0, 1 };
+    cmd::lut< double > t( {0, 0}, {1, 1}, {2, 2}, 1, &data[0] );
+    double v;
+    { double p[] = {0, 0}; t.interpolate( p, &v ); EXPECT_DOUBLE_EQ( 0, v ); }
+    { double p[] = {0, 0.5}; t.interpolate( p, &v ); EXPECT_DOUBLE_EQ( 0.5, v ); }
+    { double p[] = {0.5, 0.5}; t.interpolate( p, &v ); EXPECT_DOUBLE_EQ( 0.5, v ); }
+    { double p[] = {0.5, 0}; t.interpolate( p, &v ); EXPECT_DOUBLE_EQ( 0, v ); }
+    { double p[] = {1, 1}; t.interpolate( p, &v ); EXPECT_DOUBLE_EQ( 1, v ); } // last node
+    { double p[] = {1.5, 1.5}; t.interpolate( p, &v ); EXPECT_DOUBLE_EQ( 1.5, v ); } // extrapolated from last cell
+}
+
+TEST( multidimensional_lut, same_as_grid )
+{
+    cmd::grid< double, 3 > g( {1, 2, 3}, {0.5, 1, 2}, {4, 5, 6}, 0 );
+    for( auto it = g.begin(); it != g.end(); ++it ) { *it = std::rand() % 1000 / 10.; }
+    cmd::lut< double > t( {1, 2, 3}, {0.5, 1, 2}, {4, 5, 6}, 1, &g.data()[0] );
+    std::vector< double > points;
+    for( unsigned int i = 0; i < 3000; ++i ) // more than a block
+    {
+        points.push_back( 1 + std::rand() % 1000 / 1000. * 1.5 ); // within cells, i.e. not beyond the last node
+        points.push_back( 2 + std::rand() % 1000 / 1000. * 4 );
+        points.push_back( 3 + std::rand() % 1000 / 1000. * 10 );
+    }
+    std::vector< double > values( 3000 );
+    t.interpolate( &points[0], 3000, &values[0] );
+    for( unsigned int i = 0; i < 3000; ++i ) { ASSERT_NEAR( g.interpolated( {points[i*3], points[i*3+1], points[i*3+2]} ), values[i], 1e-9 ); }
+}
+
+TEST( multidimensional_lut, dimensions )
+{
+    const std::size_t dimensions = 6;
+    std::vector< std::size_t > shape = { 3, 2, 4, 1, 2, 3 };
+    std::vector< double > origin( dimensions, 0 ), resolution( dimensions, 1 );
+    std::size_t size = 1;
+    for( auto s: shape ) { size *= s; }
+    std::vector< float > data( size * 2 );
+    std::vector< double > coefficients = { 1, -2, 3, 4, 0.5, -1 };
+    for( std::size_t j = 0, n = 0; j < size; ++j ) // linear function of node coordinates: interpolation is exact
+    {
+        double v = 0;
+        for( std::size_t d = dimensions, k = j; d > 0; k /= shape[ d - 1 ], --d ) { v += coefficients[ d - 1 ] * ( k % shape[ d - 1 ] ); }
+        data[n++] = v;
+        data[n++] = -v;
+    }
+    cmd::lut< float > t( origin, resolution, shape, 2, &data[0] );
+    std::vector< double > points;
+    std::vector< double > expected;
+    for( unsigned int i = 0; i < 100; ++i )
+    {
+        double v = 0;
+        for( std::size_t d = 0; d < dimensions; ++d )
+        {
+            double p = shape[d] == 1 ? 0 : std::rand() % 1000 / 1000. * ( shape[d] - 1 );
+            points.push_back( p );
+            v += coefficients[d] * p;
+        }
+        expected.push_back( v );
+    }
+    std::vector< float > values( 200 );
+    t.interpolate( &points[0], 100, &values[0] );
+    for( unsigned int i = 0; i < 100; ++i ) { EXPECT_NEAR( expected[i], values[ i * 2 ], 1e-4 ); EXPECT_NEAR( -expected[i], values[ i * 2 + 1 ], 1e-4 ); }
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "../multidimensional/view.h"
+
+namespace cmd = comma::containers::multidimensional;
+
+TEST( multidimensional_view, array )
+{
+    cmd::array< int, 3 > a( {2, 3, 4}, 0 );
+    int n = 0;
+    for( auto it = a.begin(); it != a.end(); ++it ) { *it = n++; }
+    cmd::view< int, 3 > v( a );
+    EXPECT_TRUE( v.contiguous() );
+    EXPECT_EQ( 24u, v.size() );
+    EXPECT_EQ( ( cmd::index< 3 >{12, 4, 1} ), v.strides() );
+    EXPECT_EQ( 23, ( v[{1, 2, 3}] ) );
+    v[{1, 1, 2}] = 100;
+    EXPECT_EQ( 100, ( a[{1, 1, 2}] ) );
+    cmd::view< const int, 3 > c( v );
+    EXPECT_EQ( 100, ( c[{1, 1, 2}] ) );
+    cmd::view< int, 2 > s( a.at( 1 ) );
+    EXPECT_EQ( 13, ( s[{0, 1}] ) );
+}
+
+TEST( multidimensional_view, transposed )
+{
+    cmd::array< int, 2 > a( {2, 3}, 0 );
+    int n = 0;
+    for( auto it = a.begin(); it != a.end(); ++it ) { *it = n++; }
+    cmd::view< int, 2 > t = cmd::view< int, 2 >( a ).transposed();
+    EXPECT_FALSE( t.contiguous() );
+    EXPECT_EQ( ( cmd::index< 2 >{3, 2} ), t.shape() );
+    for( std::size_t i = 0; i < 2; ++i ) { for( std::size_t j = 0; j < 3; ++j ) { EXPECT_EQ( ( a[{i, j}] ), ( t[{j, i}] ) ); } }
+    std::vector< int > expected = { 0, 3, 1, 4, 2, 5 };
+    std::vector< int > values;
+    std::vector< cmd::index< 2 > > indices;
+    for( auto it = t.begin(); it != t.end(); ++it ) { values.push_back( *it ); indices.push_back( it.index() ); }
+    EXPECT_EQ( expected, values );
+    EXPECT_EQ( ( cmd::index< 2 >{0, 1} ), indices[1] );
+    EXPECT_EQ( ( cmd::index< 2 >{2, 1} ), indices[5] );
+    values.clear();
+    cmd::for_each( t, [&]( int v ) { values.push_back( v ); } );
+    EXPECT_EQ( expected, values );
+}
+
+TEST( multidimensional_view, permuted )
+{
+    cmd::array< int, 3 > a( {2, 3, 4}, 0 );
+    int n = 0;
+    for( auto it = a.begin(); it != a.end(); ++it ) { *it = n++; }
+    cmd::view< int, 3 > p = cmd::view< int, 3 >( a ).permuted( {2, 0, 1} );
+    EXPECT_EQ( ( cmd::index< 3 >{4, 2, 3} ), p.shape() );
+    for( std::size_t i = 0; i < 2; ++i ) { for( std::size_t j = 0; j < 3; ++j ) { for( std::size_t k = 0; k < 4; ++k ) { EXPECT_EQ( ( a[{i, j, k}] ), ( p[{k, i, j}] ) ); } } }
+    cmd::index< 3 > invalid{0, 0, 1};
+    cmd::view< int, 3 > v( a );
+    EXPECT_THROW( v.permuted( invalid ), comma::exception );
+}
+
+TEST( multidimensional_view, sub_and_strided )
+{
+    cmd::array< int, 2 > a( {4, 5}, 0 );
+    int n = 0;
+    for( auto it = a.begin(); it != a.end(); ++it ) { *it = n++; }
+    cmd::view< int, 2 > v( a );
+    cmd::view< int, 2 > s = v.sub( {1, 2}, {2, 3} );
+    EXPECT_EQ( 7, ( s[{0, 0}] ) );
+    EXPECT_EQ( 14, ( s[{1, 2}] ) );
+    std::vector< int > values;
+    for( auto it = s.begin(); it != s.end(); ++it ) { values.push_back( *it ); }
+    EXPECT_EQ( ( std::vector< int >{ 7, 8, 9, 12, 13, 14 } ), values );
+    cmd::index< 2 > begin{3, 0}, shape{2, 1};
+    EXPECT_THROW( v.sub( begin, shape ), comma::exception );
+    cmd::view< int, 2 > e = v.strided( {2, 2} );
+    EXPECT_EQ( ( cmd::index< 2 >{2, 3} ), e.shape() );
+    values.clear();
+    cmd::for_each( e, [&]( int x ) { values.push_back( x ); } );
+    EXPECT_EQ( ( std::vector< int >{ 0, 2, 4, 10, 12, 14 } ), values );
+    cmd::fill( e, -1 );
+    EXPECT_EQ( -1, ( a[{2, 4}] ) );
+    EXPECT_EQ( 11, ( a[{2, 1}] ) );
+}
+
+TEST( multidimensional_view, tile )
+{
+    cmd::array< float, 3 > a( {100, 200, 300}, 0 );
+    cmd::view< float, 3 > v( a );
+    auto t = v.tile( 32768 );
+    EXPECT_LE( t[0] * t[1] * t[2] * sizeof( float ), 32768u );
+    EXPECT_GE( t[0] * t[1] * t[2] * sizeof( float ), 16384u );
+    cmd::view< float, 3 > w( {2, 200, 300}, &a.data()[0] );
+    t = w.tile( 32768 );
+    EXPECT_EQ( 2u, t[0] );
+    EXPECT_LE( t[0] * t[1] * t[2] * sizeof( float ), 32768u );
+    std::size_t count = 0;
+    cmd::for_each_tile( cmd::index< 2 >{5, 7}, cmd::index< 2 >{2, 3}, [&]( const cmd::index< 2 >& i ) { count += cmd::clipped( cmd::index< 2 >{5, 7}, i, cmd::index< 2 >{2, 3} )[0] * cmd::clipped( cmd::index< 2 >{5, 7}, i, cmd::index< 2 >{2, 3} )[1]; } );
+    EXPECT_EQ( 35u, count );
+}
+
+TEST( multidimensional_view, copy )
+{
+    cmd::array< double, 3 > a( {13, 50, 70}, 0 );
+    int n = 0;
+    for( auto it = a.begin(); it != a.end(); ++it ) { *it = n++; }
+    cmd::array< double, 3 > b( {70, 50, 13}, 0 );
+    cmd::copy( cmd::view< const double, 3 >( a ), cmd::view< double, 3 >( b ).transposed(), 1024 ); // small tiles
+    for( std::size_t i = 0; i < 13; ++i ) { for( std::size_t j = 0; j < 50; ++j ) { for( std::size_t k = 0; k < 70; ++k ) { ASSERT_EQ( ( a[{i, j, k}] ), ( b[{k, j, i}] ) ); } } }
+    cmd::array< double, 3 > c( {13, 50, 70}, 0 );
+    cmd::copy( cmd::view< const double, 3 >( a ), cmd::view< double, 3 >( c ) );
+    EXPECT_EQ( a.data(), c.data() );
+    cmd::array< float, 3 > d( {13, 50, 70}, 0 );
+    cmd::transform( cmd::view< double, 3 >( b ).transposed(), cmd::view< float, 3 >( d ), []( double x ) { return float( x * 2 ); } );
+    for( std::size_t i = 0; i < a.data().size(); ++i ) { ASSERT_EQ( float( a.data()[i] * 2 ), d.data()[i] ); }
+    cmd::for_each( cmd::view< const double, 3 >( a ), cmd::view< float, 3 >( d ), []( double x, float& y ) { y += x; } ); // accumulate
+    for( std::size_t i = 0; i < a.data().size(); ++i ) { ASSERT_EQ( float( a.data()[i] * 3 ), d.data()[i] ); }
+}
@@ -34,69 +34,249 @@
 #include <io.h>
 #endif
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstring>
 #include <iostream>
-#include <map>
+#include <thread>
+#include <vector>
 #include "../../application/command_line_options.h"
+#include "../../base/exception.h"
 
 using namespace comma;
 
+static const std::size_t npos = std::size_t( -1 );
+
+/// print lengths with highest scores first; ties: longer length first
+/// @param top output only the first <top> lengths, sorted partially
+template < typename T > static void print_sorted( std::ostream& os, const std::vector< std::size_t >& lengths, const std::vector< T >& scores, double total, std::size_t top )
+{
+    std::vector< std::size_t > sorted = lengths;
+    std::size_t size = std::min( top, sorted.size() );
+    std::partial_sort( sorted.begin(), sorted.begin() + size, sorted.end(), [&]( std::size_t a, std::size_t b ) { return scores[a] > scores[b] || ( scores[a] == scores[b] && a > b ); } );
+    for( std::size_t i = 0; i < size; ++i ) { os << sorted[i] << "," << scores[ sorted[i] ] << "," << ( double( scores[ sorted[i] ] ) / total ) << std::endl; }
+}
+
+/// histogram of distances between consecutive occurrences of the same byte value
 class histogram
 {
 public:
-    histogram() : last_seen_index_(256,0), seen_(256,false) {}
+    histogram( std::size_t max_length ) : counts_( max_length + 1, 0 ) { clear(); }
 
-    void observe( unsigned char value, std::size_t location )
+    static std::size_t chunk_size( std::size_t ) { return 16777216; }
+
+    static std::size_t overlap( std::size_t ) { return 0; }
+
+    /// observe chunk of data starting at given position in input
+    void observe( const unsigned char* data, std::size_t size, std::size_t, std::size_t position )
     {
-        if( seen_[value] )
+        for( std::size_t i = 0, p = position; i < size; ++i, ++p )
         {
-            //assert( (i-last_seen_index[data[i]]) > 0 && (i-last_seen_index[data[i]]) < bytes_read );
-            assert( location > last_seen_index_[value] );
-            ++histogram_[ location - last_seen_index_[value] ];
+            std::size_t& last = last_[ data[i] ];
+            if( last == npos ) { first_[ data[i] ] = p; } else { add_( p - last ); }
+            last = p;
         }
-        last_seen_index_[value] = location;
-        seen_[value] = true;
     }
 
-    std::ostream& print_sorted(std::ostream& os) const
+    /// merge histogram of the chunk immediately following data observed so far
+    void merge( const histogram& next )
     {
-        //sort, ugly
-        std::multimap< std::size_t, std::size_t > sorted;
-        std::size_t sum=0;
-        for(std::map< std::size_t, std::size_t >::const_iterator it=histogram_.begin(), end=histogram_.end(); it!=end; ++it )
+        for( unsigned int v = 0; v < 256; ++v )
         {
-            sorted.insert( std::make_pair(it->second,it->first) );
-            sum += it->second;
-        }        
-        for(std::multimap< std::size_t, std::size_t >::const_reverse_iterator it=sorted.rbegin(), end=sorted.rend(); it!=end; ++it )
+            if( next.first_[v] == npos ) { continue; }
+            if( last_[v] == npos ) { first_[v] = next.first_[v]; } else { add_( next.first_[v] - last_[v] ); }
+            last_[v] = next.last_[v];
+        }
+        for( std::size_t i = 0; i < counts_.size(); ++i ) { counts_[i] += next.counts_[i]; }
+        longer_ += next.longer_;
+    }
+
+    void clear()
+    {
+        first_.fill( npos );
+        last_.fill( npos );
+        std::fill( counts_.begin(), counts_.end(), 0 );
+        longer_ = 0;
+    }
+
+    std::ostream& print_sorted( std::ostream& os, std::size_t top ) const
+    {
+        std::vector< std::size_t > lengths;
+        double sum = longer_;
+        for( std::size_t i = 1; i < counts_.size(); ++i )
         {
-            os << it->second << "," << it->first << "," << (double)((double)(it->first)/(double)sum) << std::endl;
+            if( counts_[i] == 0 ) { continue; }
+            lengths.push_back( i );
+            sum += counts_[i];
         }
+        ::print_sorted( os, lengths, counts_, sum, top );
         return os;
     }
 
+    std::size_t longer() const { return longer_; }
+
 private:
-    std::vector< std::size_t > last_seen_index_;
-    std::vector< bool > seen_;
-    std::map< std::size_t, std::size_t > histogram_; //length, count
+    std::array< std::size_t, 256 > first_;
+    std::array< std::size_t, 256 > last_;
+    std::vector< std::size_t > counts_; // counts_[length]: number of times length observed
+    std::size_t longer_{0}; // number of lengths greater than max length
+    void add_( std::size_t length ) { if( length < counts_.size() ) { ++counts_[length]; } else { ++longer_; } }
 };
 
-std::ostream& operator<<(std::ostream& os, const histogram & h) { return h.print_sorted(os); }
+/// autocorrelation of byte values, centered on their mean over the whole input, for lags up to max length
+/// computed by fft on blocks overlapping by max length; since the mean is known only at the end, blocks are
+/// correlated uncentered (shifted by 128 to keep magnitudes small) and corrected by the mean when output,
+/// using input size, sum, and the first and last max length bytes, i.e. the same as over the whole input in one go
+class autocorrelation
+{
+public:
+    autocorrelation( std::size_t max_length ) : max_length_( max_length ), sums_( max_length + 1, 0 )
+    {
+        std::size_t size = 65536;
+        while( size < 2 * ( max_length + 1 ) ) { size *= 2; }
+        buffer_.resize( size );
+        twiddles_.resize( size / 2 );
+        for( std::size_t i = 0; i < twiddles_.size(); ++i ) { double a = -2 * M_PI * i / size; twiddles_[i] = std::complex< double >( std::cos( a ), std::sin( a ) ); }
+    }
+
+    static std::size_t chunk_size( std::size_t max_length ) { std::size_t size = 65536; while( size < 2 * ( max_length + 1 ) ) { size *= 2; } return size - max_length; }
+
+    static std::size_t overlap( std::size_t max_length ) { return max_length; }
 
-static void usage( bool )
+    /// correlate chunk with itself followed by tail bytes after the chunk
+    void observe( const unsigned char* data, std::size_t size, std::size_t tail, std::size_t )
+    {
+        // two real sequences in one complex fft: chunk in real, chunk with tail in imaginary part
+        for( std::size_t i = 0; i < buffer_.size(); ++i ) { buffer_[i] = i < size ? std::complex< double >( value_( data[i] ), value_( data[i] ) ) : i < size + tail ? std::complex< double >( 0, value_( data[i] ) ) : std::complex< double >( 0, 0 ); }
+        fft_( false );
+        std::size_t n = buffer_.size();
+        std::vector< std::complex< double > >& z = buffer_;
+        for( std::size_t k = 0; k <= n / 2; ++k ) // cross spectrum conj( a ) * b, computed in place for k and n - k at once
+        {
+            std::size_t m = ( n - k ) % n;
+            std::complex< double > zk = z[k], zm = z[m];
+            std::complex< double > ak = ( zk + std::conj( zm ) ) * 0.5, bk = ( zk - std::conj( zm ) ) * std::complex< double >( 0, -0.5 );
+            std::complex< double > am = ( zm + std::conj( zk ) ) * 0.5, bm = ( zm - std::conj( zk ) ) * std::complex< double >( 0, -0.5 );
+            z[k] = std::conj( ak ) * bk;
+            z[m] = std::conj( am ) * bm;
+        }
+        fft_( true );
+        for( std::size_t i = 0; i <= max_length_; ++i ) { sums_[i] += z[i].real() / n; }
+        for( std::size_t i = 0; i < size; ++i ) { sum_ += value_( data[i] ); }
+        size_ += size;
+        head_.assign( data, data + std::min( size, max_length_ ) );
+        tail_.assign( data + size - std::min( size, max_length_ ), data + size );
+    }
+
+    /// merge correlation of the chunk immediately following data observed so far
+    void merge( const autocorrelation& next )
+    {
+        for( std::size_t i = 0; i < sums_.size(); ++i ) { sums_[i] += next.sums_[i]; }
+        sum_ += next.sum_;
+        size_ += next.size_;
+        head_.insert( head_.end(), next.head_.begin(), next.head_.begin() + std::min( next.head_.size(), max_length_ - head_.size() ) );
+        tail_.insert( tail_.end(), next.tail_.begin(), next.tail_.end() );
+        if( tail_.size() > max_length_ ) { tail_.erase( tail_.begin(), tail_.end() - max_length_ ); }
+    }
+
+    void clear() { std::fill( sums_.begin(), sums_.end(), 0 ); sum_ = 0; size_ = 0; head_.clear(); tail_.clear(); }
+
+    /// output lags with positive correlation, normalised by correlation at lag 0, i.e. variance
+    std::ostream& print_sorted( std::ostream& os, std::size_t top ) const
+    {
+        if( size_ == 0 ) { return os; }
+        std::vector< double > centered( std::min( sums_.size(), size_ ) ); // sum over i < size - lag of ( x[i] - mean ) * ( x[i + lag] - mean ) for values shifted by 128
+        double mean = sum_ / size_;
+        double first = 0; // sum of first lag values
+        double last = 0; // sum of last lag values
+        for( std::size_t lag = 0; lag < centered.size(); ++lag )
+        {
+            if( lag > 0 ) { first += value_( head_[ lag - 1 ] ); last += value_( tail_[ tail_.size() - lag ] ); }
+            centered[lag] = sums_[lag] - mean * ( ( sum_ - last ) + ( sum_ - first ) ) + mean * mean * ( size_ - lag );
+        }
+        std::vector< std::size_t > lengths;
+        for( std::size_t i = 1; i < centered.size(); ++i ) { if( centered[i] > 0 ) { lengths.push_back( i ); } }
+        ::print_sorted( os, lengths, centered, centered[0], top );
+        return os;
+    }
+
+    std::size_t longer() const { return 0; }
+
+private:
+    std::size_t max_length_;
+    std::vector< double > sums_; // sums_[lag]: uncentered
+    double sum_{0}; // sum of values
+    std::size_t size_{0}; // number of values
+    std::vector< unsigned char > head_; // first max length bytes
+    std::vector< unsigned char > tail_; // last max length bytes
+    std::vector< std::complex< double > > buffer_;
+    std::vector< std::complex< double > > twiddles_;
+
+    static double value_( unsigned char c ) { return double( c ) - 128; }
+
+    void fft_( bool inverse ) // in-place iterative radix-2 fft, unnormalised
+    {
+        std::vector< std::complex< double > >& a = buffer_;
+        std::size_t n = a.size();
+        for( std::size_t i = 1, j = 0; i < n; ++i )
+        {
+            std::size_t bit = n >> 1;
+            for( ; j & bit; bit >>= 1 ) { j ^= bit; }
+            j ^= bit;
+            if( i < j ) { std::swap( a[i], a[j] ); }
+        }
+        for( std::size_t length = 2, step = n / 2; length <= n; length <<= 1, step >>= 1 )
+        {
+            std::size_t half = length / 2;
+            for( std::size_t i = 0; i < n; i += length )
+            {
+                for( std::size_t j = 0; j < half; ++j )
+                {
+                    std::complex< double > w = inverse ? std::conj( twiddles_[ j * step ] ) : twiddles_[ j * step ];
+                    std::complex< double > u = a[ i + j ], v = a[ i + j + half ] * w;
+                    a[ i + j ] = u + v;
+                    a[ i + j + half ] = u - v;
+                }
+            }
+        }
+    }
+};
+
+static void usage( bool verbose )
 {
     std::cerr << std::endl;
     std::cerr << "Analyse binary data to guess message lengths in unknown binary stream: output candidate lengths, repeat counts and normalised probabilities" << std::endl;
     std::cerr << std::endl;
-    std::cerr << "Usage: cat file.bin | csv-analyse" << std::endl;
+    std::cerr << "Usage: cat file.bin | csv-analyse [<options>]" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Options" << std::endl;
+    std::cerr << "    --help,-h: show this help; --help --verbose: more help" << std::endl;
+    std::cerr << "    --max-length=<bytes>; default: 1048576 for histogram, 65536 for autocorrelation: maximum message length" << std::endl;
+    std::cerr << "                          histogram: longer distances are counted only for normalisation" << std::endl;
+    std::cerr << "    --method=<method>; default=histogram" << std::endl;
+    std::cerr << "        histogram: count distances between consecutive occurrences of the same byte value" << std::endl;
+    std::cerr << "                   output: length,count,normalised count" << std::endl;
+    std::cerr << "        autocorrelation: autocorrelation of byte values centered on their mean by fft; slower, but less sensitive to" << std::endl;
+    std::cerr << "                         payload bytes repeating at random distances; output lags with positive" << std::endl;
+    std::cerr << "                         correlation: length,correlation,correlation normalised by variance" << std::endl;
+    std::cerr << "    --chunk-size=<bytes>: size of input chunks processed at once, e.g. by each of --threads; the result" << std::endl;
+    std::cerr << "                          does not depend on it; default and maximum: 16777216 for histogram, for" << std::endl;
+    std::cerr << "                          autocorrelation: fft size (65536 or more to fit twice --max-length) minus --max-length" << std::endl;
+    std::cerr << "    --threads=<n>; default=1: process input in chunks on <n> threads" << std::endl;
+    std::cerr << "    --top=<n>: output only <n> most likely lengths; faster than piping to head for large --max-length" << std::endl;
+    std::cerr << "    --verbose,-v: more output to stderr" << std::endl;
     std::cerr << std::endl;
     std::cerr << "e.g. use the entire file.bin for calculation and display the five most likely binary message lengths" << std::endl;
     std::cerr << std::endl;
-    std::cerr << "     cat file.bin | csv-analyse | head -n 5 " << std::endl;
+    std::cerr << "     cat file.bin | csv-analyse --top 5" << std::endl;
     std::cerr << std::endl;
     std::cerr << "e.g  use the first 100 bytes of file.bin for calculation and display all message length candidates" << std::endl;
     std::cerr << std::endl;
     std::cerr << "     cat file.bin | head --bytes=100 | csv-analyse" << std::endl;
     std::cerr << std::endl;
+    if( !verbose ) { std::cerr << "run csv-analyse --help --verbose for more..." << std::endl << std::endl; exit( 0 ); }
     std::cerr << "note: algorithm is most efficient for relatively small message size (<<1MB), because large messages tend to contain all byte values within each message" << std::endl;
     std::cerr << "      to tease large message sizes, provide alot of data and filter results" << std::endl;
     std::cerr << std::endl;
@@ -115,7 +295,60 @@ static void usage( bool )
     std::cerr << "See also: \"csv-size\", \"csv-bin-cut\"" << std::endl;
     std::cerr << std::endl;
     std::cerr << std::endl;
-    exit( -1 );
+    exit( 0 );
+}
+
+static std::size_t read( unsigned char* buf, std::size_t size ) // read as many bytes as available on stdin up to size
+{
+    std::size_t count = 0;
+    while( count < size )
+    {
+        int bytes_read = ::read( 0, buf + count, size - count );
+        if( bytes_read <= 0 ) { break; }
+        count += bytes_read;
+    }
+    return count;
+}
+
+/// read input in batches of chunks, one chunk per thread; merge chunk results in input order
+template < typename Analyser > static void run( const comma::command_line_options& options, std::size_t max_length )
+{
+    unsigned int threads = std::max( options.value< unsigned int >( "--threads", 1 ), 1u );
+    std::size_t chunk_size = std::min( options.value< std::size_t >( "--chunk-size", Analyser::chunk_size( max_length ) ), Analyser::chunk_size( max_length ) );
+    COMMA_ASSERT_BRIEF( chunk_size > 0, "--chunk-size: expected positive number of bytes, got 0" );
+    std::size_t overlap = Analyser::overlap( max_length );
+    Analyser total( max_length );
+    std::vector< Analyser > analysers( threads, Analyser( max_length ) );
+    std::vector< unsigned char > data( threads * chunk_size + overlap );
+    std::size_t size = 0; // bytes in data
+    std::size_t position = 0; // position of data[0] in input
+    bool eof = false;
+    while( !eof || size > 0 )
+    {
+        std::size_t bytes_read = read( &data[size], data.size() - size );
+        eof = size + bytes_read < data.size();
+        size += bytes_read;
+        unsigned int count = 0;
+        std::size_t end = 0;
+        for( ; count < threads && end < size && ( eof || end + chunk_size + overlap <= size ); ++count ) { end = std::min( end + chunk_size, size ); }
+        auto observe = [&]( unsigned int i )
+        {
+            std::size_t begin = i * chunk_size;
+            std::size_t n = std::min( chunk_size, size - begin );
+            analysers[i].clear();
+            analysers[i].observe( &data[begin], n, std::min( overlap, size - begin - n ), position + begin );
+        };
+        std::vector< std::thread > workers;
+        for( unsigned int i = 1; i < count; ++i ) { workers.emplace_back( observe, i ); }
+        if( count > 0 ) { observe( 0 ); }
+        for( auto& w: workers ) { w.join(); }
+        for( unsigned int i = 0; i < count; ++i ) { total.merge( analysers[i] ); }
+        std::memmove( &data[0], &data[end], size - end );
+        size -= end;
+        position += end;
+    }
+    if( options.exists( "--verbose,-v" ) ) { std::cerr << "csv-analyse: read " << position << " byte(s)" << ( total.longer() ? "; lengths greater than --max-length: " + std::to_string( total.longer() ) : std::string() ) << std::endl; }
+    total.print_sorted( std::cout, options.value< std::size_t >( "--top", npos ) );
 }
 
 int main( int ac, char** av )
@@ -126,18 +359,10 @@ int main( int ac, char** av )
             _setmode( _fileno( stdin ), _O_BINARY );
         #endif
         command_line_options options( ac, av, usage );
-        const std::size_t read_size = 65535; // todo? better way?
-        std::vector< unsigned char > data( read_size );
-        std::size_t offset = 0;
-        histogram h;
-        while( std::cin.good() && !std::cin.eof() ) //read as many bytes as available on stdin
-        {
-            int bytes_read = ::read( 0, &data[0], read_size );
-            if( bytes_read <= 0 ) { break; }
-            for( int i = 0; i < bytes_read; ++i ) { h.observe( data[i], offset + i ); }
-            offset += bytes_read;
-        }
-        std::cout << h;
+        std::string method = options.value< std::string >( "--method", "histogram" );
+        if( method == "histogram" ) { run< histogram >( options, options.value< std::size_t >( "--max-length", 1048576 ) ); }
+        else if( method == "autocorrelation" ) { run< autocorrelation >( options, options.value< std::size_t >( "--max-length", 65536 ) ); }
+        else { COMMA_THROW( comma::exception, "expected method histogram or autocorrelation; got: '" << method << "'" ); }
         return 0;
     }
     catch( std::exception& ex ) { std::cerr << "csv-analyse: " << ex.what() << std::endl; }
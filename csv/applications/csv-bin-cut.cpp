@@ -15,6 +15,7 @@
 #include "../../application/command_line_options.h"
 #include "../../csv/format.h"
 #include "../../csv/options.h"
+#include "../../csv/projection.h"
 #include "../../string/string.h"
 
 using namespace comma;
@@ -208,7 +209,7 @@ namespace {
                 : fields_( fields )
                 , orecord_size_( std::accumulate( fields.begin(), fields.end(), (size_t)0, seeker::add_size ) )
                 , obuf_( orecord_size_ )
-                , ibuf_( 0 )
+                , projector_( make_projection_( fields, csv ), 65536, flush )
                 , irecord_size_( csv.format().size() )
                 , skip_( skip )
                 , count_( 0 )
@@ -226,7 +227,7 @@ namespace {
             const std::vector< field > & fields_;
             size_t orecord_size_;
             std::vector< char > obuf_;
-            std::vector< char > ibuf_;
+            comma::csv::projector projector_;
             size_t irecord_size_;
             unsigned int skip_;
             long int count_;
@@ -235,22 +236,23 @@ namespace {
             bool force_read_;
 
             static size_t add_size( size_t i, const field & f ){ return i + f.size; }
+            static comma::csv::projection make_projection_( const std::vector< field > & fields, const comma::csv::options & csv )
+            {
+                comma::csv::projection p( csv.format().size() );
+                for( unsigned int i = 0; i < fields.size(); ++i ) { p.push_back( fields[i].input_offset, fields[i].size ); }
+                return p;
+            }
     };
 
     int seeker::read_all( std::istream & is )
     {
         if ( count_max_ >= 0 && count_ >= count_max_ ) { return 0; }
-        ibuf_.resize( irecord_size_ );
-        while( is.good() && !is.eof() )
-        {
-            is.read( &ibuf_[0], irecord_size_ );
-            if( is.gcount() == 0 ) { continue; }
-            if( is.gcount() < int( irecord_size_ ) ) { std::cerr << "csv-bin-cut: expected " << irecord_size_ << " bytes, got only " << is.gcount() << std::endl; exit( 1 ); }
-            if ( skip_ ) { --skip_; continue; }
-            for( unsigned int i = 0; i < fields_.size(); ++i ) { std::cout.write( &ibuf_[0] + fields_[i].input_offset, fields_[i].size ); }
-            if( flush_ ) { std::cout.flush(); }
-            if ( count_max_ >= 0 && ++count_ >= count_max_ ) { return 0; }
-        }
+        size_t skip = skip_;
+        long int count = count_max_ < 0 ? -1 : count_max_ - count_;
+        count_ += projector_( is, std::cout, skip, count );
+        skip_ = skip;
+        if( projector_.incomplete() > 0 ) { std::cerr << "csv-bin-cut: expected " << irecord_size_ << " bytes, got only " << projector_.incomplete() << std::endl; exit( 1 ); }
+        if( std::cout.fail() ) { std::cerr << "csv-bin-cut: std::cout output failed" << std::endl; exit( 1 ); }
         return 0;
     }
 
@@ -43,6 +43,7 @@
 #include "../../application/command_line_options.h"
 #include "../../base/types.h"
 #include "../../csv/stream.h"
+#include "../../csv/impl/normalized_key.h"
 #include "../../csv/impl/unstructured.h"
 #include "../../string/string.h"
 #include "../../visiting/traits.h"
@@ -79,7 +80,7 @@ struct accumulate_input
     comma::uint32 block;
     comma::csv::impl::unstructured key;
     accumulate_input() : block( 0 ) {}
-    typedef boost::unordered_map< comma::csv::impl::unstructured, std::string, comma::csv::impl::unstructured::hash > unordered_map;
+    typedef boost::unordered_map< comma::csv::impl::normalized_key, std::string, comma::csv::impl::normalized_key::hash > unordered_map;
 };
 
 namespace comma { namespace visiting {
@@ -490,7 +491,7 @@ int main( int ac, char** av )
             { 
                 accumulate_input p = comma::csv::ascii< accumulate_input >( csv, default_input ).get( first_line ); 
                 block = p.block;
-                map[ p.key ] = first_line;
+                map[ comma::csv::impl::normalized_key::make( p.key ) ] = first_line;
             }
             std::vector< std::string > fields = comma::split( csv.fields, ',' );
             for( unsigned int i = 0; i < fields.size(); ++i ) { if( fields[i] != "block" ) { fields[i] = ""; } }
@@ -518,7 +519,7 @@ int main( int ac, char** av )
                     }
                 }
                 if( !p ) { break; }
-                map[ p->key ] = istream.last();
+                map[ comma::csv::impl::normalized_key::make( p->key ) ] = istream.last();
             }
             return 0;
         }
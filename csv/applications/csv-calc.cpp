@@ -9,9 +9,12 @@
 #include <io.h>
 #endif
 
+#include <algorithm>
+#include <cmath>
 #include <deque>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <type_traits>
 #include <unordered_set>
@@ -33,6 +36,7 @@ static void bash_completion( unsigned const ac, char const * const * av )
     static char const * const arguments =
         " min max mean mode percentile sum centre diameter radius var stddev size"
         " --append"
+        " --window --window-time"
         " --delimiter -d"
         " --fields -f"
         " --output-fields"
@@ -91,6 +95,14 @@ static void usage( bool verbose )
     std::cerr << "    --format: in ascii mode: format hint string containing the types of the csv data, default: double or time" << std::endl;
     std::cerr << "    --binary,-b: in binary mode: format string of the csv data types" << std::endl;
     std::cerr << "    --verbose,-v: more output to stderr" << std::endl;
+    std::cerr << "    --window=<n>: append to each record statistics over the last <n> records, by id, if id field present" << std::endl;
+    std::cerr << "    --window-time=<seconds>: append to each record statistics over records of the last <seconds>" << std::endl;
+    std::cerr << "                             by time field 't', i.e. with t in [t-<seconds>,t] of current record; by id, if id field present" << std::endl;
+    std::cerr << "        windows are cleared on block change; records are expected to be sorted by time for each id" << std::endl;
+    std::cerr << "        operations: centre, diameter, max, mean, min, percentile, radius, size, stddev, sum, var; numeric fields only" << std::endl;
+    std::cerr << "        min and max by monotonic queues, mean and variance by welford-style add and remove, all in amortized" << std::endl;
+    std::cerr << "        constant time per record; percentiles by ordered list of sorted blocks; memory is proportional to window" << std::endl;
+    std::cerr << "        statistics are output as doubles, size as ui; nans are skipped" << std::endl;
     std::cerr << comma::csv::format::usage() << std::endl;
     if( verbose )
     {
@@ -119,6 +131,9 @@ static void usage( bool verbose )
     std::cerr << "    seq 1 1000 | csv-calc percentile=0.1,percentile=0.9" << std::endl;
     std::cerr << "    seq 1 1000 | csv-calc percentile=0.9:interpolate --verbose" << std::endl;
     std::cerr << std::endl;
+    std::cerr << "    seq 1 1000 | csv-calc mean,stddev,percentile=0.5 --window=100" << std::endl;
+    std::cerr << "    cat sensors.csv | csv-calc min,max,mean --fields=t,id,a --window-time=0.5" << std::endl;
+    std::cerr << std::endl;
     std::cerr << "    {(seq 1 500 | csv-paste \"-\" \"value=0\") ; (seq 1 100 | csv-paste \"-\" \"value=1\") ; (seq 501 1000 | csv-paste \"-\" \"value=0\")} | csv-calc --fields=a,block percentile=0.9" << std::endl;
     std::cerr << std::endl;
     std::cerr << "    {(seq 1 500 | csv-paste \"-\" \"value=0\") ; (seq 1 100 | csv-paste \"-\" \"value=1\") ; (seq 501 1000 | csv-paste \"-\" \"value=0\")} | csv-calc --fields=a,id percentile=0.9" << std::endl;
@@ -127,6 +142,8 @@ static void usage( bool verbose )
     exit( -1 );
 }
 
+static bool has_time_field = false; // --window-time: field 't' is timestamp rather than value
+
 class Values
 {
     public:
@@ -150,6 +167,7 @@ class Values
             for( unsigned int i = 0; i < v.size(); ++i )
             {
                 if( ( block_index_ && *block_index_ == i ) || ( id_index_ && *id_index_ == i ) ) { input_format_ += "ui"; continue; }
+                if( time_index_ && *time_index_ == i ) { input_format_ += "t"; continue; }
                 try { boost::posix_time::from_iso_string( v[i] ); input_format_ += "t"; }
                 catch( ... ) { input_format_ += "d"; }
             }
@@ -159,12 +177,14 @@ class Values
 
         void set( const char* buf )
         {
+            if( input_format_.swapped() ) { record_.assign( buf, buf + input_format_.size() ); input_format_.to_host( &record_[0] ); buf = &record_[0]; } // fields in host byte order from here on
             for( unsigned int i = 0; i < indices_.size(); ++i )
             {
                 ::memcpy( &buffer_[0] + elements_[i].offset, buf + input_elements_[i].offset, elements_[i].size );
             }
             if( block_index_ ) { block_ = block_from_bin_( buf + block_element_.offset ); }
             if( id_index_ ) { id_ = id_from_bin_( buf + id_element_.offset ); }
+            if( time_index_ ) { time_ = time_element_.type == comma::csv::format::long_time ? comma::csv::format::traits< boost::posix_time::ptime, comma::csv::format::long_time >::from_bin( buf + time_element_.offset ) : comma::csv::format::traits< boost::posix_time::ptime, comma::csv::format::time >::from_bin( buf + time_element_.offset ); }
         }
 
         void set( const std::string& line ) // quick and dirty, probably very slow
@@ -176,11 +196,13 @@ class Values
             ::memcpy( &buffer_[0], &s[0], buffer_.size() );
             if( block_index_ ) { block_ = boost::lexical_cast< unsigned int >( v[ *block_index_ ] ); }
             if( id_index_ ) { id_ = boost::lexical_cast< unsigned int >( v[ *id_index_ ] ); }
+            if( time_index_ ) { time_ = boost::posix_time::from_iso_string( v[ *time_index_ ] ); }
         }
 
         const comma::csv::format& format() const { return format_; }
         unsigned int block() const { return block_; }
         unsigned int id() const { return id_; }
+        const boost::posix_time::ptime& time() const { return time_; }
         const char* buffer() const { return &buffer_[0]; }
 
     private:
@@ -191,10 +213,14 @@ class Values
         std::vector< comma::csv::format::element > input_elements_;
         std::vector< comma::csv::format::element > elements_;
         std::vector< char > buffer_;
+        std::vector< char > record_; // input record in host byte order, if input format has explicit byte order
         boost::optional< unsigned int > block_index_{ comma::silent_none< unsigned int >() };
         boost::optional< unsigned int > id_index_{ comma::silent_none< unsigned int >() };
         comma::csv::format::element block_element_;
         comma::csv::format::element id_element_;
+        boost::optional< unsigned int > time_index_{ comma::silent_none< unsigned int >() };
+        comma::csv::format::element time_element_;
+        boost::posix_time::ptime time_;
         unsigned int block_;
         unsigned int id_;
         std::function< comma::uint32( const char* ) > block_from_bin_;
@@ -208,6 +234,7 @@ class Values
             {
                 if( v[i] == "block" ) { block_index_ = i; }
                 else if( v[i] == "id" ) { id_index_ = i; }
+                else if( v[i] == "t" && has_time_field ) { time_index_ = i; }
                 else if( v[i] != "" ) { indices_.push_back( i ); }
             }
         }
@@ -219,6 +246,7 @@ class Values
                 {
                     if( block_index_ && *block_index_ == i ) { continue; }
                     if( id_index_ && *id_index_ == i ) { continue; }
+                    if( time_index_ && *time_index_ == i ) { continue; }
                     indices_.push_back( i );
                 }
             }
@@ -233,6 +261,11 @@ class Values
                 input_elements_.push_back( input_format_.offset( indices_[i] ) );
             }
             buffer_.resize( format_.size() );
+            if( time_index_ )
+            {
+                time_element_ = input_format_.offset( *time_index_ );
+                if( time_element_.type != comma::csv::format::time && time_element_.type != comma::csv::format::long_time ) { COMMA_THROW( comma::exception, "expected time for field 't', got format " << input_format_.string() ); }
+            }
             if( block_index_ )
             {
                 block_element_ = input_format_.offset( *block_index_ );
@@ -1262,13 +1295,302 @@ static void calculate( const comma::csv::options& csv, operations_map_t& operati
     operations_battery_farm.reset();
 }
 
+namespace rolling { // --window, --window-time: statistics over last records, updated per record
+
+// order statistics over a multiset of values as a list of sorted blocks:
+// insert and erase in O(log n + block size), k-th value in O(n / block size)
+class sorted_list
+{
+    public:
+        void insert( double v )
+        {
+            if( blocks_.empty() ) { blocks_.emplace_back( 1, v ); ++size_; return; }
+            auto b = block_( v );
+            b->insert( std::upper_bound( b->begin(), b->end(), v ), v );
+            ++size_;
+            if( b->size() < 2 * block_size_ ) { return; }
+            std::vector< double > upper( b->begin() + block_size_, b->end() );
+            b->resize( block_size_ );
+            blocks_.insert( b + 1, std::move( upper ) );
+        }
+
+        void erase( double v )
+        {
+            auto b = block_( v );
+            auto it = std::lower_bound( b->begin(), b->end(), v );
+            if( it == b->end() || *it != v ) { COMMA_THROW( comma::exception, "window: value " << v << " not found; should not happen" ); }
+            b->erase( it );
+            --size_;
+            if( b->empty() ) { blocks_.erase( b ); }
+        }
+
+        std::size_t size() const { return size_; }
+
+        double operator[]( std::size_t k ) const
+        {
+            for( const auto& b: blocks_ ) { if( k < b.size() ) { return b[k]; } k -= b.size(); }
+            COMMA_THROW( comma::exception, "window: index out of range; should not happen" );
+        }
+
+    private:
+        enum { block_size_ = 512 };
+        std::vector< std::vector< double > > blocks_;
+        std::size_t size_{0};
+
+        std::vector< std::vector< double > >::iterator block_( double v ) // first block with v not greater than its back, otherwise last
+        {
+            auto b = std::lower_bound( blocks_.begin(), blocks_.end(), v, []( const std::vector< double >& b, double v ) { return b.back() < v; } );
+            return b == blocks_.end() ? b - 1 : b;
+        }
+};
+
+// rolling statistics of one field: sum, mean, and variance with welford-style add and remove,
+// min and max with monotonic deques, percentiles with sorted list; nans are skipped
+class statistics
+{
+    public:
+        statistics( bool percentiles = false ): percentiles_( percentiles ) {}
+
+        void push( double v, comma::uint64 sequence )
+        {
+            if( std::isnan( v ) ) { return; }
+            ++count_;
+            sum_ += v;
+            double d = v - mean_;
+            mean_ += d / count_;
+            m2_ += d * ( v - mean_ );
+            while( !min_.empty() && min_.back().second >= v ) { min_.pop_back(); }
+            min_.emplace_back( sequence, v );
+            while( !max_.empty() && max_.back().second <= v ) { max_.pop_back(); }
+            max_.emplace_back( sequence, v );
+            if( percentiles_ ) { sorted_.insert( v ); }
+        }
+
+        void pop( double v, comma::uint64 sequence ) // v: oldest value
+        {
+            if( std::isnan( v ) ) { return; }
+            if( --count_ == 0 ) { sum_ = mean_ = m2_ = 0; }
+            else
+            {
+                sum_ -= v;
+                double d = v - mean_;
+                mean_ -= d / count_;
+                m2_ -= d * ( v - mean_ );
+                if( m2_ < 0 ) { m2_ = 0; } // rounding
+            }
+            if( !min_.empty() && min_.front().first == sequence ) { min_.pop_front(); }
+            if( !max_.empty() && max_.front().first == sequence ) { max_.pop_front(); }
+            if( percentiles_ ) { sorted_.erase( v ); }
+        }
+
+        std::size_t count() const { return count_; }
+        double sum() const { return sum_; }
+        double mean() const { return count_ == 0 ? nan_() : mean_; }
+        double variance( bool sample ) const { return count_ == 0 || ( sample && count_ == 1 ) ? nan_() : m2_ / ( sample ? count_ - 1 : count_ ); }
+        double min() const { return min_.empty() ? nan_() : min_.front().second; }
+        double max() const { return max_.empty() ? nan_() : max_.front().second; }
+
+        double percentile( double p, bool interpolate ) const // same as Operations::Percentile
+        {
+            std::size_t count = sorted_.size();
+            if( count == 0 ) { return nan_(); }
+            if( !interpolate ) { return sorted_[ ( p == 0.0 ? 1 : std::size_t( std::ceil( count * p ) ) ) - 1 ]; }
+            double x = p * ( count + 1 );
+            if( x <= 1.0 ) { return sorted_[0]; }
+            if( x >= count ) { return sorted_[ count - 1 ]; }
+            std::size_t rank = x;
+            double v1 = sorted_[ rank - 1 ];
+            double v2 = sorted_[ rank ];
+            return v1 + ( v2 - v1 ) * ( x - rank );
+        }
+
+    private:
+        bool percentiles_;
+        std::size_t count_{0};
+        double sum_{0};
+        double mean_{0};
+        double m2_{0};
+        std::deque< std::pair< comma::uint64, double > > min_; // increasing values of records not yet expired
+        std::deque< std::pair< comma::uint64, double > > max_; // decreasing values of records not yet expired
+        sorted_list sorted_;
+        static double nan_() { return std::numeric_limits< double >::quiet_NaN(); }
+};
+
+struct operation
+{
+    Operations::Enum::Values type;
+    bool sample{false};
+    double percentile{0};
+    bool interpolate{false};
+
+    operation( const Operations::operation_parameters& p ): type( p.type )
+    {
+        switch( type )
+        {
+            case Operations::Enum::mode:
+            case Operations::Enum::skew:
+            case Operations::Enum::kurtosis:
+                COMMA_THROW( comma::exception, "window: mode, skew, and kurtosis not supported with --window or --window-time" );
+            case Operations::Enum::variance:
+            case Operations::Enum::stddev:
+                sample = !p.options.empty() && p.options[0] == "sample";
+                break;
+            case Operations::Enum::percentile:
+                if( p.options.empty() ) { COMMA_THROW( comma::exception, "percentile operation requires a percentile" ); }
+                percentile = boost::lexical_cast< double >( p.options[0] );
+                if( percentile < 0.0 || percentile > 1.0 ) { COMMA_THROW( comma::exception, "percentile value should be between 0 and 1, got " << percentile ); }
+                if( p.options.size() > 1 && p.options[1] != "nearest" && p.options[1] != "interpolate" ) { COMMA_THROW( comma::exception, "expected percentile method, got '" << p.options[1] << "'" ); }
+                interpolate = p.options.size() > 1 && p.options[1] == "interpolate";
+                break;
+            default:
+                break;
+        }
+    }
+
+    double calculate( const statistics& s ) const
+    {
+        switch( type )
+        {
+            case Operations::Enum::min: return s.min();
+            case Operations::Enum::max: return s.max();
+            case Operations::Enum::centre: return ( s.min() + s.max() ) / 2;
+            case Operations::Enum::diameter: return s.max() - s.min();
+            case Operations::Enum::radius: return ( s.max() - s.min() ) / 2;
+            case Operations::Enum::mean: return s.mean();
+            case Operations::Enum::sum: return s.sum();
+            case Operations::Enum::variance: return s.variance( sample );
+            case Operations::Enum::stddev: return std::sqrt( s.variance( sample ) );
+            case Operations::Enum::percentile: return s.percentile( percentile, interpolate );
+            default: return 0; // never here
+        }
+    }
+};
+
+// last records of one id: values of fields and timestamps in arrival order, and their statistics
+class window
+{
+    public:
+        window( std::size_t fields, bool percentiles ): fields_( fields, statistics( percentiles ) ) {}
+
+        void push( const double* values, const boost::posix_time::ptime& t )
+        {
+            values_.insert( values_.end(), values, values + fields_.size() );
+            times_.push_back( t );
+            for( std::size_t i = 0; i < fields_.size(); ++i ) { fields_[i].push( values[i], end_ ); }
+            ++end_;
+        }
+
+        void pop()
+        {
+            for( std::size_t i = 0; i < fields_.size(); ++i ) { fields_[i].pop( values_[i], end_ - times_.size() ); }
+            values_.erase( values_.begin(), values_.begin() + fields_.size() );
+            times_.pop_front();
+        }
+
+        std::size_t size() const { return times_.size(); }
+        const boost::posix_time::ptime& front() const { return times_.front(); }
+        const statistics& operator[]( std::size_t i ) const { return fields_[i]; }
+
+    private:
+        std::vector< statistics > fields_;
+        std::deque< double > values_;
+        std::deque< boost::posix_time::ptime > times_;
+        comma::uint64 end_{0}; // sequence number of next record
+};
+
+static double to_double( const char* buf, comma::csv::format::types_enum type )
+{
+    switch( type )
+    {
+        case comma::csv::format::char_t: return comma::csv::format::traits< char >::from_bin( buf );
+        case comma::csv::format::int8: return comma::csv::format::traits< char >::from_bin( buf );
+        case comma::csv::format::uint8: return comma::csv::format::traits< unsigned char >::from_bin( buf );
+        case comma::csv::format::int16: return comma::csv::format::traits< comma::int16 >::from_bin( buf );
+        case comma::csv::format::uint16: return comma::csv::format::traits< comma::uint16 >::from_bin( buf );
+        case comma::csv::format::int32: return comma::csv::format::traits< comma::int32 >::from_bin( buf );
+        case comma::csv::format::uint32: return comma::csv::format::traits< comma::uint32 >::from_bin( buf );
+        case comma::csv::format::int64: return comma::csv::format::traits< comma::int64 >::from_bin( buf );
+        case comma::csv::format::uint64: return comma::csv::format::traits< comma::uint64 >::from_bin( buf );
+        case comma::csv::format::float_t: return comma::csv::format::traits< float >::from_bin( buf );
+        case comma::csv::format::double_t: return comma::csv::format::traits< double >::from_bin( buf );
+        default: COMMA_THROW( comma::exception, "window: expected numeric fields, got field of type " << comma::csv::format::to_format( type ) << "; time fields are not supported with --window or --window-time" );
+    }
+}
+
+static std::string output_format( const std::vector< Operations::operation_parameters >& operations, std::size_t fields )
+{
+    std::string f;
+    for( const auto& o: operations ) { for( std::size_t i = 0; i < fields; ++i ) { f += std::string( f.empty() ? "" : "," ) + ( o.type == Operations::Enum::size ? "ui" : "d" ); } }
+    return f;
+}
+
+// append statistics over window to each record; windows are per id and are cleared on block change
+template < typename Input > static int run( const comma::csv::options& csv, Input& input, const std::vector< Operations::operation_parameters >& parameters, boost::optional< std::size_t > size, boost::optional< double > seconds )
+{
+    std::vector< operation > operations( parameters.begin(), parameters.end() );
+    bool percentiles = false;
+    for( const auto& o: operations ) { percentiles = percentiles || o.type == Operations::Enum::percentile; }
+    boost::posix_time::time_duration duration = boost::posix_time::microseconds( static_cast< comma::int64 >( seconds ? *seconds * 1000000 : 0 ) );
+    boost::unordered_map< comma::uint32, window > windows;
+    std::vector< double > values;
+    std::vector< comma::csv::format::element > elements;
+    std::string output;
+    boost::optional< comma::uint32 > block = boost::make_optional< comma::uint32 >( false, 0 );
+    while( std::cin.good() && !std::cin.eof() )
+    {
+        const Values* v = input.read();
+        if( v == NULL ) { if( csv.binary() ) { break; } else { continue; } } // quick and dirty: skip empty lines in ascii
+        if( elements.empty() )
+        {
+            for( unsigned int i = 0; i < v->format().count(); ++i ) { elements.push_back( v->format().offset( i ) ); }
+            values.resize( elements.size() );
+        }
+        if( block && *block != v->block() ) { windows.clear(); }
+        block = v->block();
+        for( std::size_t i = 0; i < elements.size(); ++i ) { values[i] = to_double( v->buffer() + elements[i].offset, elements[i].type ); }
+        auto it = windows.find( v->id() );
+        if( it == windows.end() ) { it = windows.emplace( v->id(), window( elements.size(), percentiles ) ).first; }
+        window& w = it->second;
+        w.push( &values[0], v->time() );
+        if( size ) { while( w.size() > *size ) { w.pop(); } }
+        else { while( w.front() < v->time() - duration ) { w.pop(); } }
+        if( csv.binary() ) { output = input.line(); } else { std::cout << input.line(); }
+        for( const auto& o: operations )
+        {
+            for( std::size_t i = 0; i < elements.size(); ++i )
+            {
+                if( o.type == Operations::Enum::size )
+                {
+                    comma::uint32 s = w.size();
+                    if( csv.binary() ) { output.append( reinterpret_cast< const char* >( &s ), sizeof( s ) ); } else { std::cout << csv.delimiter << s; }
+                    continue;
+                }
+                double r = o.calculate( w[i] );
+                if( csv.binary() ) { output.append( reinterpret_cast< const char* >( &r ), sizeof( r ) ); } else { std::cout << csv.delimiter << r; }
+            }
+        }
+        if( csv.binary() ) { std::cout.write( &output[0], output.size() ); } else { std::cout << '\n'; }
+        if( csv.flush ) { std::cout.flush(); }
+    }
+    return 0;
+}
+
+} // namespace rolling {
+
 int main( int ac, char** av )
 {
     try
     {
         comma::command_line_options options( ac, av, usage );
         if( options.exists( "--bash-completion" ) ) bash_completion( ac, av );
-        std::vector< std::string > unnamed = options.unnamed( "--append,--append-once,--append-to-first,--flush,--output-fields,--output-format", "--binary,-b,--delimiter,-d,--format,--fields,-f,--output-fields" );
+        std::vector< std::string > unnamed = options.unnamed( "--append,--append-once,--append-to-first,--flush,--output-fields,--output-format", "--binary,-b,--delimiter,-d,--format,--fields,-f,--output-fields,--window,--window-time" );
+        options.assert_mutually_exclusive( "--window,--window-time,--append,--append-once,--append-to-first" );
+        auto window_size = options.optional< std::size_t >( "--window" );
+        auto window_time = options.optional< double >( "--window-time" );
+        bool window = window_size || window_time;
+        if( window_size && *window_size == 0 ) { std::cerr << comma::verbose.app_name() << ": --window: expected positive size, got 0" << std::endl; return 1; }
+        if( window_time && *window_time < 0 ) { std::cerr << comma::verbose.app_name() << ": --window-time: expected non-negative value, got " << *window_time << std::endl; return 1; }
+        has_time_field = bool( window_time );
         comma::csv::options csv( options );
         csv.full_xpath = false;
         std::cout.precision( csv.precision );
@@ -1300,7 +1622,8 @@ int main( int ac, char** av )
         bool has_block = csv.has_field( "block" );
         bool has_id = csv.has_field( "id" );
         bool append_once = options.exists( "--append-once,--append-to-first" );
-        bool append = options.exists( "--append" ) || append_once;
+        bool append = options.exists( "--append" ) || append_once || window;
+        if( window_time && !csv.has_field( "t" ) ) { std::cerr << comma::verbose.app_name() << ": --window-time: expected time field 't', got fields: \"" << csv.fields << "\"" << std::endl; return 1; }
         if( options.exists( "--output-fields" ) )
         {
             std::vector < std::string > fields = comma::split(csv.fields, ',');
@@ -1312,7 +1635,7 @@ int main( int ac, char** av )
                 std::replace(v[op].begin(), v[op].end(), ':', '_');
                 for( std::size_t f = 0; f < fields.size(); f++ )
                 {
-                    if( fields[f] == "" || fields[f] == "id" || fields[f] == "block" ) { continue; }
+                    if( fields[f] == "" || fields[f] == "id" || fields[f] == "block" || ( fields[f] == "t" && has_time_field ) ) { continue; }
                     output_fields.push_back( fields[f] + "/" + v[op] );
                 }
             }
@@ -1324,6 +1647,7 @@ int main( int ac, char** av )
         if( options.exists( "--output-format" ) )
         {
             if ( !format ) { std::cerr << comma::verbose.app_name() << ": option --output-format requires input format to be specified, please use --format or --binary" << std::endl; return 1; }
+            if( window ) { std::cout << rolling::output_format( operations_parameters, Values( csv, *format ).format().count() ) << std::endl; return 0; }
             auto ops = operations_battery_farm.make( operations_parameters, Values( csv, *format ).format() );
             std::cout << ops[0]->output_format().string();
             for( std::size_t i = 1; i < ops.size(); ++i ) { std::cout << ',' << ops[i]->output_format().string(); }
@@ -1332,6 +1656,7 @@ int main( int ac, char** av )
             std::cout << std::endl;
             return 0;
         }
+        if( window ) { return csv.binary() ? rolling::run( csv, *binary, operations_parameters, window_size, window_time ) : rolling::run( csv, *ascii, operations_parameters, window_size, window_time ); }
         while( std::cin.good() && !std::cin.eof() )
         {
             const Values* v = csv.binary() ? binary->read() : ascii->read();
@@ -36,11 +36,13 @@
 #include <io.h>
 #endif
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include "../../application/command_line_options.h"
 #include "../../base/exception.h"
 #include "../../csv/format.h"
+#include "../../csv/parallel.h"
 
 static const std::string app_name = "csv-cast";
 
@@ -56,6 +58,7 @@ static void usage( bool verbose = false )
     std::cerr << "    --output-binary,--output,-o,--to: output binary format" << std::endl;
     std::cerr << "    --flush: flush stdout after each record" << std::endl;
     std::cerr << "    --force: allow narrowing conversions" << std::endl;
+    std::cerr << comma::csv::parallel::usage( 4 );
     std::cerr << std::endl;
     std::cerr << comma::csv::format::usage() << std::endl;
     std::cerr << "notes:" << std::endl;
@@ -72,6 +75,9 @@ static void usage( bool verbose = false )
     std::cerr << "    convert t,d,f to t,f,d (creates sample binary data)" << std::endl;
     std::cerr << "        echo {0..9}.2345789,3.1415 | fmt -1 | csv-time-stamp | csv-to-bin t,d,f | csv-cast t,d,f t,f,d --force | csv-from-bin t,f,d" << std::endl;
     std::cerr << std::endl;
+    std::cerr << "    convert big endian doubles to host byte order" << std::endl;
+    std::cerr << "        cat big-endian.bin | csv-cast '>3d' 3d > host.bin" << std::endl;
+    std::cerr << std::endl;
     std::cerr << "    lexical cast, convert s[22],s[10],s[6] to t,2d (creates sample binary data)" << std::endl;
     std::cerr << "        echo {0..9}.2345789,3.1415 | fmt -1 | csv-time-stamp | csv-to-bin s[22],s[10],s[6] | csv-cast s[22],s[10],s[6] t,2d | csv-from-bin t,2d" << std::endl;
     std::cerr << std::endl;
@@ -209,12 +215,10 @@ static void cast( const comma::csv::format::types_enum to_type, const char* in,
     }
 }
 
-void cast( const comma::csv::format& iformat, const std::vector< char >& input, const comma::csv::format& oformat, std::vector< char >& output )
+void cast( const comma::csv::format& iformat, const char* in, const comma::csv::format& oformat, char* out )
 {
-    const char* in = &input[0];
     unsigned int ioffset = 0;
     unsigned int icount = 0;
-    char* out = &output[0];
     unsigned int ooffset = 0;
     unsigned int ocount = 0;
     for( unsigned int i = 0; i < iformat.count(); ++i, ++icount, ++ocount )
@@ -262,18 +266,27 @@ int main( int ac, char** av )
         comma::csv::format oformat( options.value< std::string >( "--output-binary,--output,-o,--to", av[2] ) );
         check_conversions( iformat, oformat, options.exists( "--force" ) );
         bool flush = options.exists( "--flush" );
-        std::vector< char > in( iformat.size() );
-        std::vector< char > out( oformat.size() );
+        std::size_t records = flush ? 1 : std::max( 65536 / iformat.size(), std::size_t( 1 ) ); // read in blocks to byte-swap and write whole blocks at once
         if( !flush ) { std::cin.tie( NULL ); }
-        while( std::cin.good() )
+        comma::csv::parallel parallel( options, iformat.size() );
+        parallel( std::cin, std::cout, [&]( std::istream& is, std::ostream& os )
         {
-            std::cin.read( &in[0], iformat.size() );
-            if( std::cin.gcount() == 0 ) { break; }
-            if( std::cin.gcount() < static_cast< int >( iformat.size() ) ) { COMMA_THROW( comma::exception, "expected " << iformat.size() << " bytes, got only " << std::cin.gcount() ); }
-            cast( iformat, in, oformat, out );
-            std::cout.write( &out[0], oformat.size() );
-            if( flush ) { std::cout.flush(); }
-        }
+            std::vector< char > in( iformat.size() * records );
+            std::vector< char > out( oformat.size() * records );
+            while( is.good() )
+            {
+                is.read( &in[0], in.size() );
+                std::size_t size = is.gcount();
+                if( size == 0 ) { break; }
+                std::size_t count = size / iformat.size();
+                if( count * iformat.size() < size ) { COMMA_THROW( comma::exception, "expected " << iformat.size() << " bytes, got only " << ( size - count * iformat.size() ) ); }
+                iformat.to_host( &in[0], count );
+                for( std::size_t i = 0; i < count; ++i ) { cast( iformat, &in[0] + i * iformat.size(), oformat, &out[0] + i * oformat.size() ); }
+                oformat.from_host( &out[0], count );
+                os.write( &out[0], count * oformat.size() );
+                if( flush ) { os.flush(); }
+            }
+        } );
         return 0;
     }
     catch( std::exception& ex ) { std::cerr << app_name << ": " << ex.what() << std::endl; }
@@ -0,0 +1,118 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <iostream>
+#include <vector>
+#include "../../application/command_line_options.h"
+#include "../../application/verbose.h"
+#include "../../base/exception.h"
+#include "../columnar.h"
+#include "../options.h"
+
+static void usage( bool verbose )
+{
+    std::cerr << std::endl;
+    std::cerr << "convert binary records to and from columnar (one file per field) containers" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "usage: cat records.bin | csv-columnar to <dir> --binary=<format> [--fields=<fields>]" << std::endl;
+    std::cerr << "       csv-columnar from <dir> [--fields=<fields>] > records.bin" << std::endl;
+    std::cerr << "       csv-columnar info <dir>" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "operations" << std::endl;
+    std::cerr << "    to: read binary records from stdin, write them as columnar container to <dir>" << std::endl;
+    std::cerr << "        --binary,-b=<format>: input format" << std::endl;
+    std::cerr << "        --fields,-f=<fields>: field names to store in container; unnamed fields can be referred to by index" << std::endl;
+    std::cerr << "        --chunk=<rows>; default=65536: number of rows buffered per column" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "    from: read given columns from container in <dir>, write binary records of these fields to stdout" << std::endl;
+    std::cerr << "        --fields,-f=<fields>: field names or indices to read, e.g. --fields=t,x or --fields=0,3; default: all fields" << std::endl;
+    std::cerr << "        --output-fields: output names of fields to output and exit" << std::endl;
+    std::cerr << "        --output-format: output binary format of output records and exit" << std::endl;
+    std::cerr << "        --chunk=<rows>; default=65536: number of rows read at once" << std::endl;
+    std::cerr << "        --flush: flush after each chunk" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "    info: output container header as name=value" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "container layout" << std::endl;
+    std::cerr << "    <dir>/header: name=value text file with fields: format (expanded), fields, size (number of rows)" << std::endl;
+    std::cerr << "    <dir>/<i>.bin: values of i-th field in row order" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "    only files of requested fields are read, i.e. reading 2 of 40 fields reads about 1/20 of data" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "examples" << std::endl;
+    std::cerr << "    cat points.bin | csv-columnar to points.columnar --binary=t,3d,ui --fields=t,x,y,z,id" << std::endl;
+    std::cerr << "    csv-columnar from points.columnar --fields=x | csv-calc mean --binary=d" << std::endl;
+    std::cerr << "    csv-columnar from points.columnar --fields=t,z | csv-from-bin $( csv-columnar from points.columnar --fields=t,z --output-format )" << std::endl;
+    std::cerr << "    csv-columnar info points.columnar" << std::endl;
+    std::cerr << std::endl;
+    if( verbose ) { std::cerr << comma::csv::format::usage() << std::endl; }
+    exit( 0 );
+}
+
+static int to( const comma::command_line_options& options, const std::string& dir )
+{
+    comma::csv::options csv( options );
+    COMMA_ASSERT_BRIEF( csv.binary(), "to: please specify --binary" );
+    comma::csv::columnar::writer writer( dir, csv.format(), csv.fields, options.value< std::size_t >( "--chunk", 65536 ) );
+    const std::size_t record_size = csv.format().size();
+    std::vector< char > buffer( std::max( std::size_t( 65536 ) / record_size, std::size_t( 1 ) ) * record_size );
+    std::cin.tie( NULL );
+    while( std::cin.good() && !std::cin.eof() )
+    {
+        std::cin.read( &buffer[0], buffer.size() );
+        std::size_t size = std::cin.gcount();
+        if( size == 0 ) { continue; }
+        std::size_t count = size / record_size;
+        COMMA_ASSERT_BRIEF( count * record_size == size, "expected " << record_size << " bytes, got only " << ( size - count * record_size ) );
+        writer.write( &buffer[0], count );
+    }
+    writer.close();
+    return 0;
+}
+
+static int from( const comma::command_line_options& options, const std::string& dir )
+{
+    std::string fields = options.value< std::string >( "--fields,-f", "" );
+    std::size_t chunk = options.value< std::size_t >( "--chunk", 65536 );
+    comma::csv::columnar::reader reader( dir, fields, chunk );
+    if( options.exists( "--output-fields" ) ) { std::cout << reader.fields() << std::endl; return 0; }
+    if( options.exists( "--output-format" ) ) { std::cout << reader.format().string() << std::endl; return 0; }
+    bool flush = options.exists( "--flush" );
+    std::vector< char > buffer( chunk * reader.format().size() );
+    if( buffer.empty() ) { return 0; }
+    for( std::size_t n = reader.read( &buffer[0], chunk ); n > 0; n = reader.read( &buffer[0], chunk ) )
+    {
+        std::cout.write( &buffer[0], n * reader.format().size() );
+        if( flush ) { std::cout.flush(); }
+    }
+    return 0;
+}
+
+static int info( const std::string& dir )
+{
+    comma::csv::columnar::header header = comma::csv::columnar::header::load( dir );
+    std::cout << "format=" << header.format.string() << std::endl;
+    std::cout << "fields=" << comma::join( header.fields, ',' ) << std::endl;
+    std::cout << "size=" << header.size << std::endl;
+    return 0;
+}
+
+int main( int ac, char** av )
+{
+    try
+    {
+        comma::command_line_options options( ac, av, usage );
+        std::vector< std::string > unnamed = options.unnamed( "--flush,--output-fields,--output-format,--verbose,-v", "-.*" );
+        COMMA_ASSERT_BRIEF( unnamed.size() == 2, "expected operation and directory; got: '" << comma::join( unnamed, ' ' ) << "'" );
+        const std::string& operation = unnamed[0];
+        if( options.exists( "--chunk" ) && options.value< std::size_t >( "--chunk" ) == 0 ) { std::cerr << "csv-columnar: --chunk: expected positive number of rows, got 0" << std::endl; return 1; }
+        if( operation == "to" ) { return to( options, unnamed[1] ); }
+        if( operation == "from" ) { return from( options, unnamed[1] ); }
+        if( operation == "info" ) { return info( unnamed[1] ); }
+        std::cerr << "csv-columnar: expected operation; got: '" << operation << "'" << std::endl;
+    }
+    catch( std::exception& ex ) { std::cerr << "csv-columnar: " << ex.what() << std::endl; }
+    catch( ... ) { std::cerr << "csv-columnar: unknown exception" << std::endl; }
+    return 1;
+}
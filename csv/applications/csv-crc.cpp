@@ -34,14 +34,16 @@
 #include <fcntl.h>
 #include <io.h>
 #endif
+#include <errno.h>
 #include <string.h>
 #include <algorithm>
 #include <iostream>
 #include <vector>
-#include <boost/crc.hpp>
 #include <boost/optional.hpp>
 #include "../../application/command_line_options.h"
+#include "../../base/exception.h"
 #include "../../base/types.h"
+#include "../../math/crc.h"
 
 static void usage( bool )
 {
@@ -72,7 +74,9 @@ crc options
         ccitt:  16-bit, generator 0x1021
         xmodem: 16-bit, generator 0x1021
         32:     32-bit, generator 0x04C11DB7
+        32c:    32-bit castagnoli, generator 0x1EDC6F41; uses sse4.2 crc32 instruction, if cpu supports it
         default: ccitt
+        crc is computed 8 bytes at a time (slicing-by-8); binary input is read and output in large chunks
     --big-endian,--net-byte-order: if binary, crc is big endian
 
 recover options
@@ -84,6 +88,9 @@ recover options
                          default: 0; recover on the next valid packet
     --discard-on-recovery,--discard: discard packets accumulated when recovering
 
+    Recovery searches for the next valid packet with rolling crc, i.e. in time
+    linear in the number of bytes skipped, rather than recomputing crc at each offset
+
     Note that the check command is equivalent to
     csv-crc recover --give-up-after 0
 
@@ -121,152 +128,197 @@ struct traits< comma::uint32 >
     static comma::uint32 ntoh( comma::uint32 v ) { return ntohl( v ); }
 };
 
-template < typename Crc >
-static typename Crc::value_type crc_( const char* buf, std::size_t size )
+template < typename T >
+class binary_stream
 {
-    return std::for_each( buf, buf + size, Crc() )();
-}
+    public:
+        binary_stream( const comma::math::crc& crc ): _crc( crc ), _payload_size( wrap ? size : size - sizeof( T ) ), _rolling( crc, std::max( _payload_size, std::size_t( 1 ) ) )
+        {
+            std::size_t s = std::max( std::size_t( recover_after + 2 ) * size, std::size_t( 1048576 ) ); // enough to hold packets being verified when recovering
+            _buffer.resize( s - s % size );
+        }
 
-template < typename Crc >
-static bool run_()
-{
-    if( binary )
-    {
-        #ifdef WIN32
-            _setmode( _fileno( stdin ), _O_BINARY );
-            _setmode( _fileno( stdout ), _O_BINARY );
-        #endif
-        std::vector< char > buffer( 65536 < size ? size : ( 65536 - 65536 % size ) );
-        char* begin = &buffer[0];
-        char* end = &buffer[ buffer.size() ];
-        char* p = begin;
-        std::size_t offset = 0;
-        bool recovered = true;
-        std::size_t recovered_count = 0;
-        std::size_t recovered_byte_count = 0;
-        std::size_t current_recovered_byte_count = 0;
-        std::vector< char > recovery_buffer( recover_after * size );
-        while( std::cin.good() && !std::cin.eof() )
+        /// read and process input in large chunks; output is written once per chunk
+        bool run()
+        {
+            while( !_gave_up )
+            {
+                int r = ::read( 0, &_buffer[_end], _buffer.size() - _end );
+                if( r < 0 )
+                {
+                    if( errno == EINTR ) { continue; }
+                    COMMA_THROW( comma::exception, "failed to read stdin: " << ::strerror( errno ) );
+                }
+                if( r == 0 ) { break; }
+                _end += r;
+                if( wrap ) { _wrap(); } else { _recover(); }
+                if( !_output.empty() ) { std::cout.write( &_output[0], _output.size() ); std::cout.flush(); _output.clear(); }
+                if( _begin > 0 ) { ::memmove( &_buffer[0], &_buffer[_begin], _end - _begin ); _end -= _begin; _begin = 0; }
+            }
+            std::size_t offset = _end - _begin;
+            COMMA_ASSERT_BRIEF( offset == 0 || offset >= size, "expected at least " << size << " byte(s), got only " << offset );
+            return 0;
+        }
+
+    private:
+        const comma::math::crc& _crc;
+        std::size_t _payload_size;
+        comma::math::crc::rolling _rolling;
+        std::vector< char > _buffer;
+        std::vector< char > _output;
+        std::size_t _begin{0};
+        std::size_t _end{0};
+        bool _synced{true};
+        unsigned int _verified{0}; // number of consecutive valid packets starting at _begin, when recovering
+        std::size_t _lost{0}; // bytes skipped since crc check failed
+        bool _gave_up{false};
+
+        T _expected( std::size_t i ) const
+        {
+            T expected;
+            ::memcpy( &expected, &_buffer[ i + _payload_size ], sizeof( T ) );
+            return big_endian ? traits< T >::ntoh( expected ) : expected;
+        }
+
+        bool _valid( std::size_t i ) const { return T( _crc( &_buffer[i], _payload_size ) ) == _expected( i ); }
+
+        void _append( std::size_t i, std::size_t n ) { _output.insert( _output.end(), &_buffer[i], &_buffer[i] + n ); }
+
+        void _wrap()
+        {
+            for( ; _end - _begin >= size; _begin += size )
+            {
+                T crc = _crc( &_buffer[_begin], size );
+                if( big_endian ) { crc = traits< T >::hton( crc ); }
+                _append( _begin, size );
+                _output.insert( _output.end(), reinterpret_cast< const char* >( &crc ), reinterpret_cast< const char* >( &crc ) + sizeof( T ) );
+            }
+        }
+
+        bool _give_up() // call on failed check
+        {
+            if( _synced ) { comma::say() << "crc check failed" << ( !give_up_after || *give_up_after > 0 ? "; recovering..." : "" ) << std::endl; }
+            _synced = false;
+            _verified = 0;
+            _gave_up = give_up_after && _lost >= *give_up_after;
+            return _gave_up;
+        }
+
+        void _recover()
         {
-            if( offset >= size )
+            while( !_gave_up && _end - _begin >= size )
             {
-                if( wrap )
+                if( _synced )
                 {
-                    typename Crc::value_type crc = crc_< Crc >( p, size );
-                    if( big_endian ) { crc = traits< typename Crc::value_type >::hton( crc ); }
-                    std::cout.write( p, size );
-                    std::cout.write( reinterpret_cast< const char* >( &crc ), sizeof( typename Crc::value_type ) );
-                    std::cout.flush();
+                    if( _valid( _begin ) ) { _append( _begin, size ); _begin += size; } else { _give_up(); }
                 }
-                else if( recover )
+                else if( _verified == 0 )
                 {
-                    static const std::size_t payload_size = size - sizeof( typename Crc::value_type );
-                    typename Crc::value_type crc = crc_< Crc >( p, payload_size );
-                    typename Crc::value_type expected = *( reinterpret_cast< typename Crc::value_type* >( p + payload_size ) );
-                    if( big_endian ) { expected = traits< typename Crc::value_type >::hton( expected ); }
-                    if( crc == expected )
-                    {
-                        bool output_input_buffer = true;
-                        if( !recovered )
-                        {
-                            if( recovered_count == recover_after )
-                            {
-                                comma::say() << "recovered after " << recovered_byte_count << " byte(s)" << std::endl;
-                                if( !discard_on_recovery ) { std::cout.write( &recovery_buffer[0], recovery_buffer.size() ); }
-                                recovered = true;
-                                recovered_count = 0;
-                                recovered_byte_count = 0;
-                                current_recovered_byte_count = 0;
-                            }
-                            else
-                            {
-                                ::memcpy( &recovery_buffer[ recovered_count * size ], p, size );
-                                ++recovered_count;
-                                output_input_buffer = false;        // we're just stashing them until we check
-                            }
-                        }
-                        if( output_input_buffer ) { std::cout.write( p, size ); }
-                        std::cout.flush();
-                    }
-                    else // quick and dirty: lots of code duplication, but just to make it working
-                    {
-                        if( current_recovered_byte_count / size > recovered_count )
-                        {
-                            recovered_count = 0;
-                            current_recovered_byte_count = 0;
-                        }
-                        if( recovered ) { comma::say() << "crc check failed" << ( !give_up_after || *give_up_after > 0 ? "; recovering..." : "" ) << std::endl; }
-                        recovered = false;
-                        if( give_up_after && recovered_byte_count >= *give_up_after ) { break; }
-                    }
+                    _search();
                 }
-                unsigned int step = recovered ? size : 1;
-                p += step;
-                offset -= step;
-                if( !recovered ) { recovered_byte_count += step; current_recovered_byte_count += step; }
-                if( end - p < int( size ) )
+                else if( _verified > recover_after )
                 {
-                    ::memcpy( begin, p, offset ); // todo: quick and dirty, check if works in case of overlapping
-                    p = begin;
+                    std::size_t last = _begin + ( _verified - 1 ) * size;
+                    comma::say() << "recovered after " << _lost << " byte(s)" << std::endl;
+                    if( discard_on_recovery ) { _append( last, size ); } else { _append( _begin, last + size - _begin ); }
+                    _begin = last + size;
+                    _synced = true;
+                    _verified = 0;
+                    _lost = 0;
+                }
+                else
+                {
+                    std::size_t i = _begin + _verified * size;
+                    if( _end - i < size ) { return; } // wait for more data
+                    if( _valid( i ) ) { ++_verified; } else if( !_give_up() ) { ++_begin; ++_lost; }
                 }
-                continue;
             }
-            int r = ::read( 0, p, end - p );
-            if( r <= 0 ) { break; }
-            offset += r;
         }
-        COMMA_ASSERT_BRIEF( offset <= 0 || offset >= size, "expected at least " << size << " byte(s), got only " << offset );
+
+        void _search() // find next valid packet with rolling crc, i.e. in linear time
+        {
+            T crc = _rolling.reset( &_buffer[_begin] );
+            while( true )
+            {
+                if( crc == _expected( _begin ) ) { _verified = 1; return; }
+                if( _give_up() ) { return; }
+                if( _end - _begin <= size ) { ++_begin; ++_lost; return; }
+                crc = _rolling.roll( _buffer[_begin], _buffer[ _begin + _payload_size ] );
+                ++_begin;
+                ++_lost;
+            }
+        }
+};
+
+template < typename T >
+static bool run_( const comma::math::crc& crc )
+{
+    if( binary )
+    {
+        #ifdef WIN32
+            _setmode( _fileno( stdin ), _O_BINARY );
+            _setmode( _fileno( stdout ), _O_BINARY );
+        #endif
+        return binary_stream< T >( crc ).run();
     }
-    else
+    std::string line;
+    while( std::cin.good() && !std::cin.eof() )
     {
-        std::string line;
-        while( std::cin.good() && !std::cin.eof() )
+        std::getline( std::cin, line );
+        if( line.empty() ) { continue; }
+        if( wrap )
+        {
+            std::cout << line << delimiter << T( crc( &line[0], line.size() ) ) << std::endl;
+        }
+        else
         {
-            std::getline( std::cin, line );
-            if( line.empty() ) { continue; }
-            if( wrap )
+            std::vector< std::string > v = comma::split( line, delimiter );
+            bool ok = true;
+            T expected;
+            try { expected = boost::lexical_cast< T >( v.back() ); }
+            catch( ... ) { ok = false; }
+            if( ok && v.size() > 1 && T( crc( &line[0], line.size() - v.back().size() - 1 ) ) == expected )
             {
-                std::cout << line << delimiter << crc_< Crc >( &line[0], line.size() ) << std::endl;
+                std::cout << line << std::endl;
             }
             else
             {
-                std::vector< std::string > v = comma::split( line, delimiter );
-                bool ok = true;
-                typename Crc::value_type expected;
-                try { expected = boost::lexical_cast< typename Crc::value_type >( v.back() ); }
-                catch( ... ) { ok = false; }
-                if( ok && v.size() > 1 && crc_< Crc >( &line[0], line.size() - v.back().size() - 1 ) == expected )
-                {
-                    std::cout << line << std::endl;
-                }
-                else
-                {
-                    comma::say() << "check failed (recovery is not implemented for ascii mode, todo)" << std::endl;
-                    return 1;
-                }
+                comma::say() << "check failed (recovery is not implemented for ascii mode, todo)" << std::endl;
+                return 1;
             }
         }
     }
     return 0;
 }
 
+static boost::optional< comma::math::crc::parameters > parameters_of( const std::string& crc )
+{
+    // The list of crc versions predefined by boost is given at
+    //     http://www.boost.org/doc/libs/1_58_0/libs/crc/crc.html#crc_ex
+    // However note that the crc versions identified by boost typedef's are not always correct.
+    // This is the definitive list of 16 bits CRC algorithms:
+    //     http://reveng.sourceforge.net/crc-catalogue/16.htm
+    // The error is acknowledged in the boost/crc git repo:
+    //     https://github.com/boostorg/crc/blob/develop/include/boost/crc.hpp
+    // but for some reason this is not in any released Boost version (up to at least Boost 1.65)
+    if( crc == "16" ) { return comma::math::crc::crc16(); }
+    if( crc == "32" ) { return comma::math::crc::crc32(); }
+    if( crc == "32c" ) { return comma::math::crc::crc32c(); }
+    if( crc == "ccitt" ) { return comma::math::crc::ccitt(); }
+    if( crc == "xmodem" ) { return comma::math::crc::xmodem(); } // designated boost::crc_xmodem_t in the git repo for boost/crc.hpp
+    if( crc == "xmodem-boost" ) { return comma::math::crc::xmodem_boost(); }
+    return boost::none;
+}
+
 int main( int ac, char** av )
 {
     try
     {
         comma::command_line_options options( ac, av, usage );
         std::string crc = options.value< std::string >( "--crc", "ccitt" );
-        if( options.exists( "--crc-size" ) )
-        {
-            if( crc == "16" ) { std::cout << sizeof( boost::crc_16_type::value_type ) << std::endl; }
-            else if( crc == "32" ) { std::cout << sizeof( boost::crc_32_type::value_type ) << std::endl; }
-            else if( crc == "ccitt" ) { std::cout << sizeof( boost::crc_ccitt_type::value_type ) << std::endl; }
-            else if( crc == "xmodem" ) { std::cout << sizeof( boost::crc_xmodem_type::value_type ) << std::endl; }
-            else if( crc == "xmodem-boost" ) { std::cout << sizeof( boost::crc_xmodem_type::value_type ) << std::endl; }
-            else { comma::say() << "expected crc type, got \"" << crc << "\"" << std::endl; return 1; }
-            return 0;
-        }
-        COMMA_ASSERT_BRIEF( !wrap || !recover, "if 'wrap', then no 'check' or 'recover'" );
+        auto parameters = parameters_of( crc );
+        if( !parameters ) { comma::say() << "expected crc type, got \"" << crc << "\"" << std::endl; return 1; }
+        if( options.exists( "--crc-size" ) ) { std::cout << parameters->width / 8 << std::endl; return 0; }
         verbose = options.exists( "--verbose,-v" );
         give_up_after = options.optional< unsigned int >( "--give-up-after" );
         recover_after = options.value( "--recover-after", 0 );
@@ -284,21 +336,11 @@ int main( int ac, char** av )
             else if( commands[i] == "recover" ) { recover = true; }
             else { comma::say() << "expected command, got '" << commands[i] << "'" << std::endl; return 1; }
         }
-        // The list of crc versions predefined by boost is given at
-        //     http://www.boost.org/doc/libs/1_58_0/libs/crc/crc.html#crc_ex
-        // However note that the crc versions identified by boost typedef's are not always correct.
-        // This is the definitive list of 16 bits CRC algorithms:
-        //     http://reveng.sourceforge.net/crc-catalogue/16.htm
-        // The error is acknowledged in the boost/crc git repo:
-        //     https://github.com/boostorg/crc/blob/develop/include/boost/crc.hpp
-        // but for some reason this is not in any released Boost version (up to at least Boost 1.65)
-        if( crc == "16" ) { return run_< boost::crc_16_type >(); }
-        else if( crc == "32" ) { return run_< boost::crc_32_type >(); }
-        else if( crc == "ccitt" ) { return run_< boost::crc_ccitt_type >(); }
-        // the following is designated boost::crc_xmodem_t in the git repo for boost/crc.hpp
-        else if( crc == "xmodem" ) { return run_< boost::crc_optimal< 16, 0x1021, 0, 0, false, false > >(); }
-        else if( crc == "xmodem-boost" ) { return run_< boost::crc_xmodem_type >(); }
-        comma::say() << "expected crc type, got '" << crc << "'" << std::endl;
+        COMMA_ASSERT_BRIEF( !wrap || !recover, "if 'wrap', then no 'check' or 'recover'" );
+        COMMA_ASSERT_BRIEF( !binary || size > ( wrap ? 0 : parameters->width / 8 ), "expected --size greater than " << ( wrap ? 0 : parameters->width / 8 ) << "; got: " << size );
+        comma::math::crc engine( *parameters );
+        if( verbose ) { comma::say() << "crc: " << crc << ( engine.hardware() ? " (hardware)" : "" ) << std::endl; }
+        return parameters->width == 16 ? run_< comma::uint16 >( engine ) : run_< comma::uint32 >( engine );
     }
     catch( std::exception& ex ) { comma::say() << ex.what() << std::endl; }
     catch( ... ) { comma::say() << "unknown exception" << std::endl; }
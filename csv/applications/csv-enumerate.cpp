@@ -34,18 +34,18 @@
 #include "../../base/exception.h"
 #include "../../base/types.h"
 #include "../../csv/stream.h"
+#include "../../csv/impl/normalized_key.h"
 #include "../../csv/impl/unstructured.h"
 #include "../../string/string.h"
 
 static void usage( bool verbose )
 {
     std::cerr << R"(
-append unique id to csv records with the same values; support integer, time, and string fields
+append unique id to csv records with the same values; support integer, floating point, time, and string fields
+floating point keys are matched exactly
 
 usage: cat data.csv | csv-enumerate <options>
 
-todo: support floating point values as input keys
-
 options
     --fields,-f=<fields>; fields of interest, actual field names do not matter
                           e.g: --fields ,,,a,,b,,,c
@@ -82,7 +82,8 @@ template <> struct traits< output >
 int main( int ac, char** av )
 {
     typedef comma::csv::impl::unstructured input_t;
-    typedef std::unordered_map< comma::csv::impl::unstructured, std::pair< comma::uint32, comma::uint32 >, comma::csv::impl::unstructured::hash >  map_t;
+    typedef std::pair< comma::csv::impl::unstructured, std::pair< comma::uint32, comma::uint32 > > entry_t;
+    typedef std::unordered_map< comma::csv::impl::normalized_key, entry_t, comma::csv::impl::normalized_key::hash >  map_t;
     try
     {
         comma::command_line_options options( ac, av, usage );
@@ -121,7 +122,7 @@ int main( int ac, char** av )
         if( !first_line.empty() )
         { 
             input_t input = comma::csv::ascii< input_t >( csv, default_input ).get( first_line );
-            map[ comma::csv::ascii< input_t >( csv, default_input ).get( first_line ) ] = std::make_pair( id++, 1 );
+            map[ comma::csv::impl::normalized_key::make( input ) ] = entry_t( input, std::make_pair( id++, 1 ) );
             if( !output_map ) { std::cout << first_line << csv.delimiter << 0 << std::endl; }
         }
         comma::csv::options output_csv;
@@ -137,9 +138,10 @@ int main( int ac, char** av )
         {
             const input_t* p = istream.read();
             if( !p ) { break; }
-            map_t::iterator it = map.find( *p );
+            comma::csv::impl::normalized_key key = comma::csv::impl::normalized_key::make( *p );
+            map_t::iterator it = map.find( key );
             comma::uint32 cur = id;
-            if( it == map.end() ) { map[ *p ] = std::make_pair( id++, 1 ); } else { cur = it->second.first; ++( it->second.second ); }
+            if( it == map.end() ) { map[ key ] = entry_t( *p, std::make_pair( id++, 1 ) ); } else { cur = it->second.second.first; ++( it->second.second.second ); }
             if( !output_map ) { tied.append( output( cur ) ); }
         }
         if( !output_map ) { return 0; }
@@ -150,8 +152,8 @@ int main( int ac, char** av )
             output_map_csv.format( map_output_binary_format + ",2ui" ); //output_map_csv.format( comma::csv::format::value< input_t >( default_input ) + ",2ui" );
             comma::say() << "binary output format for map: '" << output_map_csv.format().string() << "'" << std::endl;
         }
-        comma::csv::output_stream< map_t::value_type > omstream( std::cout, output_map_csv, std::make_pair( default_input, std::make_pair( 0, 0 ) ) );
-        for( map_t::const_iterator it = map.begin(); it != map.end(); ++it ) { omstream.write( *it ); }
+        comma::csv::output_stream< entry_t > omstream( std::cout, output_map_csv, entry_t( default_input, std::make_pair( 0, 0 ) ) );
+        for( map_t::const_iterator it = map.begin(); it != map.end(); ++it ) { omstream.write( it->second ); }
         return 0;
     }
     catch( std::exception& ex ) { comma::say() << ex.what() << std::endl; }
@@ -0,0 +1,602 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <iostream>
+#include <regex>
+#include <set>
+#include <string>
+#include <vector>
+#include "../../application/command_line_options.h"
+#include "../../base/exception.h"
+#include "../../csv/format.h"
+#include "../../csv/impl/numpy_ascii.h"
+#include "../../csv/options.h"
+#include "../../string/split.h"
+#include "eval/parser.h"
+#include "eval/program.h"
+
+static void usage( bool verbose )
+{
+    std::cerr << R"(
+evaluate numerical expressions and append computed values to csv stream
+
+usage: csv-eval <expressions> [<options>]
+
+native implementation of python csv-eval (comma.csv.applications.csv_eval): expressions
+are compiled once into typed column-at-a-time bytecode and evaluated on batches of records
+following numpy 2 semantics, i.e. same types, promotion, wraparound, division, etc
+
+expressions, select, and exit-if conditions outside of the subset supported natively, as well
+as --init-values, string outputs, etc, are transparently run by python csv-eval with the same
+command line, as: python3 -c 'from comma.csv.applications.csv_eval import main; main()' <options>;
+ascii values not parsed natively, e.g. 1_000, are handed over to python csv-eval from that line on
+
+options
+    --help,-h: show this help; --help --verbose for more help
+    --verbose,-v: more output to stderr, e.g. why falling back to python csv-eval
+    --binary,-b=<format>: format for binary stream; default: ascii
+    --default-values,--default=<assignments>: default values for variables in expressions but not in input stream
+    --delimiter,-d=<char>: csv delimiter of ascii stream; default: ','
+    --exit-if,--output-until,--until=<condition>: output all records and exit when the condition is satisfied
+    --fields,-f=<names>: field names of input stream
+    --flush,--unbuffered: flush stdout after each batch of records; default: flush only when no
+                          more input is available at once, batches are not held back anyway
+    --format=<format>: for ascii stream, format of named input fields; default: 'd' for each,
+                       if absent, format is guessed from the first line
+    --full-xpath: use full xpaths as variable names with / replaced by _; default: basenames
+    --init-values,--init=<assignments>: init values, applied only once on start; runs python csv-eval
+    --init-format=<format>: format of init non-output variables
+    --native: do not fall back to python csv-eval, exit with error instead
+    --output-fields,-o=<names>: do not infer output fields from expressions; output specified fields appended to input instead
+    --output-format=<format>: format of output fields; default: 'd' for each
+    --permissive: leave python builtins in the exec environment (use with care)
+    --precision=<precision>: floating point precision of ascii output; default: 12
+    --python: run python csv-eval
+    --select,--output-if,--if=<condition>: select and output records of input stream that satisfy the condition
+    --with-error=<message>: if --exit-if, exit with error and a given error message
+
+input fields
+    - slashes are replaced by underscores if --full-xpath is given, otherwise basenames are used
+    - for ascii streams, input fields are treated as floating point numbers, unless --format is given
+
+output fields
+    - inferred from the names assigned in expression unless specified by --output-fields
+    - appended to input record (input field values can be modified by expression, too)
+    - treated as 64-bit floating point numbers, unless --output-format is given
+
+native subset
+    statements: assignments, e.g. 'a = b = x + 1', 'a, b = b, a + b', 'a += 1'
+    operators: + - * / // % ** & | ^ << >> ~ < > <= >= == !=
+    literals and constants: integers, floats, True, False, pi, e, inf, nan, euler_gamma
+    functions: sin cos tan arcsin arccos arctan arctan2 sinh cosh tanh arcsinh arccosh arctanh
+               exp exp2 expm1 log log2 log10 log1p sqrt cbrt square hypot deg2rad rad2deg degrees radians
+               abs absolute fabs sign floor ceil trunc rint minimum maximum fmin fmax clip fmod copysign
+               isnan isinf isfinite signbit where logical_and logical_or logical_xor logical_not
+               add subtract multiply divide true_divide floor_divide mod remainder power negative positive
+               invert bitwise_not bitwise_and bitwise_or bitwise_xor left_shift right_shift
+               less greater less_equal greater_equal equal not_equal
+               float64 double float32 single int8 byte uint8 ubyte int16 short uint16 ushort
+               int32 intc uint32 uintc int64 int_ uint64 bool_
+    time: adding and subtracting integer microseconds, comparisons, where
+
+examples
+    # basic
+    ( echo 1; echo 2; echo 3 ) | csv-eval --fields=x 'y = x**2'
+
+    # using an intermediate variable
+    ( echo 1; echo 2; echo 3 ) | csv-eval --fields=x 'n = 2; y = x**n' --output-fields=y
+
+    # ascii stream with non-default formats
+    ( echo 0,1; echo 1,1 ) | csv-eval --fields=x,y 'n = x<y' --output-format=ub
+    ( echo 0,1; echo 1,1 ) | csv-eval --fields=i,j --format=2ub 'n = i==j' --output-format=ub
+
+    # binary stream
+    ( echo 0.1,2; echo 0.1,3 ) | csv-to-bin d,i | csv-eval --binary=d,i --fields=x,n 'y = x**n' | csv-from-bin d,i,d
+
+    # evaluate one of two expressions based on condition
+    ( echo 1,2; echo 2,1 ) | csv-eval --fields=x,y 'a=where(x<y,x+y,x-y)'
+
+    # select output based on condition
+    ( echo 1,2 ; echo 1,3; echo 1,4 ) | csv-eval --fields=a,b --format=2i --select='(a < b - 1) & (b < 4)'
+
+    # pass through input until condition is met
+    ( echo 1,2 ; echo 1,3; echo 1,4 ) | csv-eval --fields=a,b --format=2i --exit-if='(a < b - 1) & (b < 4)'
+
+    # update input stream values in place
+    ( echo 1,2 ; echo 3,4 ) | csv-eval --fields=x,y "x=x+y; y=y-1"
+
+    # full xpaths
+    ( echo 1,2 ; echo 3,4 ) | csv-eval --fields=one/x,two/y "x+=1; y-=1"
+    ( echo 1,2 ; echo 3,4 ) | csv-eval --fields=one/x,two/y "one_x+=1; two_y-=1" --full-xpath
+
+    # default values
+    ( echo 1,2 ; echo 3,4 ) | csv-eval --fields=,y "a=x+y" --default-values="x=0;y=0"
+
+    # operating on time (internally represented in microseconds)
+    echo 20171112T224515.5 | csv-eval --format=t --fields=t1 "t2=t1+1000000" --output-format t
+)";
+    if( verbose ) { std::cerr << "csv options" << std::endl << comma::csv::options::usage( "", true ) << std::endl; }
+    else { std::cerr << "run csv-eval --python --help --verbose for numpy functions available via python csv-eval" << std::endl << std::endl; }
+    exit( 0 );
+}
+
+namespace eval = comma::csv::applications::eval;
+
+/// genuine errors, reported the same way as in python csv-eval
+struct error : public std::runtime_error { error( const std::string& what ) : std::runtime_error( what ) {} };
+
+static const std::string valueless_options = "--help,-h,--verbose,-v,--permissive,--flush,--unbuffered,--full-xpath,--python,--native";
+static const std::string valued_options = "--fields,-f,--binary,-b,--delimiter,-d,--precision,--format,--output-fields,-o,--output-format,--append-fields,-F,--append-binary,-B"
+                                          ",--default-values,--default,--init-values,--init,--init-format,--with-error,--exit-if,--output-until,--until,--select,--output-if,--if";
+
+/// stdin read directly, since stdin buffer would not let us know whether more records are available without blocking
+class input
+{
+    public:
+        /// read available bytes, blocking only if nothing is available; @return false on end of stream
+        bool read()
+        {
+            if( begin_ > 0 ) { std::memmove( &buffer_[0], &buffer_[begin_], end_ - begin_ ); end_ -= begin_; begin_ = 0; }
+            if( buffer_.size() - end_ < 65536 ) { buffer_.resize( std::max( buffer_.size() * 2, end_ + 65536 ) ); }
+            ssize_t n;
+            do { n = ::read( 0, &buffer_[end_], buffer_.size() - end_ ); } while( n < 0 && errno == EINTR );
+            if( n < 0 ) { COMMA_THROW( comma::exception, "failed to read stdin: " << ::strerror( errno ) ); }
+            end_ += n;
+            return n > 0;
+        }
+
+        /// @return true, if more bytes can be read without blocking
+        static bool ready()
+        {
+            struct pollfd p = { 0, POLLIN, 0 };
+            return ::poll( &p, 1, 0 ) > 0;
+        }
+
+        const char* begin() const { return &buffer_[0] + begin_; }
+
+        const char* end() const { return &buffer_[0] + end_; }
+
+        std::size_t size() const { return end_ - begin_; }
+
+        void consume( std::size_t size ) { begin_ += size; }
+
+    private:
+        std::vector< char > buffer_{ std::vector< char >( 1 ) };
+        std::size_t begin_{0};
+        std::size_t end_{0};
+};
+
+/// run python csv-eval with the same command line; if some input already has been read, feed it to python first
+/// @param format ascii format, if python takes over in the middle of stream, when the first line used to guess format is gone
+static void python( int ac, char** av, const input& in, const std::string& reason, bool verbose, const std::string& format = "" )
+{
+    if( verbose ) { comma::say() << "running python csv-eval: " << reason << std::endl; }
+    std::vector< char* > args;
+    static char executable[] = "python3"; // explicitly, since python csv-eval may be installed as csv-eval, too, or not on path at all
+    static char command[] = "-c";
+    static char script[] = "import sys; sys.argv[0] = 'csv-eval'; from comma.csv.applications.csv_eval import main; main()";
+    args.push_back( executable );
+    args.push_back( command );
+    args.push_back( script );
+    for( int i = 1; i < ac; ++i ) { if( std::string( av[i] ) != "--python" && std::string( av[i] ) != "--native" ) { args.push_back( av[i] ); } }
+    std::string format_option = "--format=" + format;
+    if( !format.empty() ) { args.push_back( &format_option[0] ); }
+    args.push_back( nullptr );
+    if( in.size() > 0 )
+    {
+        int fd[2];
+        if( ::pipe( fd ) != 0 ) { COMMA_THROW( comma::exception, "failed to create pipe: " << ::strerror( errno ) ); }
+        pid_t pid = ::fork();
+        if( pid < 0 ) { COMMA_THROW( comma::exception, "failed to fork: " << ::strerror( errno ) ); }
+        if( pid == 0 )
+        {
+            ::close( fd[0] );
+            auto write = [&]( const char* p, std::size_t size ) { while( size > 0 ) { ssize_t n = ::write( fd[1], p, size ); if( n < 0 ) { if( errno == EINTR ) { continue; } ::_exit( 0 ); } p += n; size -= n; } };
+            write( in.begin(), in.size() );
+            char buf[65536];
+            while( true )
+            {
+                ssize_t n = ::read( 0, buf, sizeof( buf ) );
+                if( n < 0 && errno == EINTR ) { continue; }
+                if( n <= 0 ) { ::_exit( 0 ); }
+                write( buf, n );
+            }
+        }
+        ::close( fd[1] );
+        ::dup2( fd[0], 0 );
+        ::close( fd[0] );
+    }
+    ::execvp( executable, &args[0] );
+    COMMA_THROW( comma::exception, reason << "; failed to run python csv-eval: " << ::strerror( errno ) );
+}
+
+static std::vector< std::string > split_fields( const std::string& s ) { return s.empty() ? std::vector< std::string >() : comma::split( s, ',' ); }
+
+static void check_fields( const std::vector< std::string >& fields )
+{
+    static const std::regex valid( "^[a-z_]\\w*$", std::regex::icase );
+    for( const auto& f: fields )
+    {
+        if( !std::regex_match( f, valid ) ) { throw error( "'" + f + "' is not a valid field name" ); }
+        if( f == "_init" || f == "_input" || f == "_update" || f == "_output" ) { throw error( "'" + f + "' is a reserved name" ); }
+    }
+}
+
+/// as comma.csv.format.guess_format() in python: elements split by comma, not by delimiter
+static std::string guess_format( const std::string& line )
+{
+    if( line.find( '"' ) != std::string::npos ) { throw eval::unsupported( "quoted fields in the first line" ); }
+    static const std::regex time( "^\\d{8}T\\d{6}(\\.\\d{0,12})?$" );
+    std::string format;
+    for( const auto& s: comma::split( line, ',' ) )
+    {
+        std::string type = "s[1024]";
+        if( !s.empty() )
+        {
+            try { comma::csv::impl::numpy_ascii::double_from_ascii( &s[0], &s[0] + s.size() ); type = "d"; }
+            catch( ... )
+            {
+                if( s.find( '_' ) != std::string::npos ) { throw eval::unsupported( "underscores in numbers in the first line" ); }
+                if( s == "not-a-date-time" || s == "-inf" || s == "-infinity" || std::regex_match( s, time ) ) { type = "t"; }
+            }
+        }
+        format += ( format.empty() ? "" : "," ) + type;
+    }
+    return format;
+}
+
+/// expanded format with fields as python csv-eval does, e.g. "ui" for fields "a,b,c" gives "ui,d,d"
+static std::vector< std::string > format_without_blanks( const std::string& format, const std::vector< std::string >& fields, bool unnamed )
+{
+    std::vector< std::string > types;
+    if( !format.empty() )
+    {
+        for( const auto& t: comma::split( format, ',' ) ) // as python csv-eval: blank types default to double
+        {
+            if( t.empty() ) { types.push_back( "" ); continue; }
+            const auto& expanded = comma::split( comma::csv::format( t ).expanded_string(), ',' );
+            types.insert( types.end(), expanded.begin(), expanded.end() );
+        }
+    }
+    if( !unnamed )
+    {
+        for( const auto& f: fields ) { if( f.empty() ) { throw eval::unsupported( "expected all fields to be named" ); } }
+        if( types.size() > fields.size() ) { throw eval::unsupported( "format '" + format + "' is longer than fields" ); }
+    }
+    types.resize( std::max( types.size(), fields.size() ) );
+    for( std::size_t i = 0; i < types.size(); ++i ) { if( types[i].empty() ) { types[i] = "d"; } }
+    return types;
+}
+
+static comma::csv::format::element element_of( const std::string& type )
+{
+    comma::csv::format f( type );
+    if( f.count() != 1 ) { throw eval::unsupported( "expected single type, got '" + type + "'" ); }
+    return f.elements()[0];
+}
+
+static bool type_of( const comma::csv::format::element& e, eval::type_t& t ) { return !e.swapped() && eval::from_format( comma::csv::format::to_format( e.type ), t ); }
+
+struct field
+{
+    std::string name;
+    comma::csv::format::element element; ///< offset in binary record
+    std::size_t index{0}; ///< field index in ascii line
+    std::size_t column{0}; ///< register
+};
+
+static comma::csv::options csv_options( const comma::command_line_options& options )
+{
+    try { return comma::csv::options( options ); }
+    catch( std::exception& ex ) { throw eval::unsupported( ex.what() ); } // e.g. format with blanks that python csv-eval fills in
+}
+
+/// @param python_format if python has to take over in the middle of stream, format guessed from the first line
+static int run( const comma::command_line_options& options, input& in, std::string& python_format )
+{
+    bool verbose = options.exists( "--verbose,-v" );
+    comma::csv::options csv = csv_options( options );
+    std::string expressions;
+    auto unnamed = options.unnamed( valueless_options, valued_options );
+    if( !unnamed.empty() ) { expressions = unnamed[0]; }
+    std::string select = options.value< std::string >( "--select,--output-if,--if", "" );
+    std::string exit_if = options.value< std::string >( "--exit-if,--output-until,--until", "" );
+    std::string with_error = options.value< std::string >( "--with-error", "" );
+    std::string default_values = options.value< std::string >( "--default-values,--default", "" );
+    std::string format = options.value< std::string >( "--format", "" );
+    std::string output_format = options.value< std::string >( "--append-binary,-B", options.value< std::string >( "--output-format", "" ) );
+    boost::optional< std::string > output_fields_option; // as python csv-eval: empty --output-fields means no output fields
+    if( options.exists( "--append-fields,-F" ) ) { output_fields_option = options.value< std::string >( "--append-fields,-F", "" ); }
+    else if( options.exists( "--output-fields,-o" ) ) { output_fields_option = options.value< std::string >( "--output-fields,-o", "" ); }
+    if( csv.fields.empty() ) { std::cerr << "csv-eval: please specify --fields" << std::endl; return 1; }
+    if( expressions.empty() && select.empty() && exit_if.empty() ) { throw error( "please specify expression" ); }
+    if( csv.binary() && !format.empty() ) { throw error( "--binary and --format are mutually exclusive" ); }
+    if( !select.empty() || !exit_if.empty() )
+    {
+        if( !expressions.empty() ) { throw error( "--select <condition> and --exit-if <condition> cannot be used with expressions" ); }
+        if( output_fields_option && !output_fields_option->empty() ) { throw error( "--select and --exit-if cannot be used with --output-fields" ); }
+        if( !output_format.empty() ) { throw error( "--select and --exit-if cannot be used with --output-format" ); }
+    }
+    if( !with_error.empty() && exit_if.empty() ) { throw error( "--with-error can only be used with --exit-if" ); }
+    if( options.exists( "--init-values,--init" ) && !options.value< std::string >( "--init-values,--init" ).empty() ) { throw eval::unsupported( "--init-values" ); }
+    std::vector< eval::statement > defaults = eval::parse( default_values );
+    check_fields( eval::assigned_names( defaults ) );
+    std::vector< std::string > names;
+    for( const auto& f: split_fields( csv.fields ) ) { names.push_back( options.exists( "--full-xpath" ) ? comma::join( comma::split( f, '/' ), '_' ) : comma::split( f, '/' ).back() ); }
+    std::vector< std::string > types;
+    std::string guessed;
+    if( csv.binary() )
+    {
+        types = comma::split( csv.format().expanded_string(), ',' );
+    }
+    else if( !format.empty() )
+    {
+        types = format_without_blanks( format, names, true );
+    }
+    else
+    {
+        std::string line;
+        while( true ) // as readlines_unbuffered() in python: skip blank lines
+        {
+            const char* eol = static_cast< const char* >( std::memchr( in.begin(), '\n', in.size() ) );
+            bool eof = !eol && !in.read();
+            if( !eol && !eof ) { continue; }
+            std::size_t size = eol ? eol - in.begin() : in.size();
+            if( size == 0 && eof ) { return 0; }
+            line.assign( in.begin(), size );
+            if( line.find_first_not_of( " \t\r\n\v\f" ) != std::string::npos ) { break; }
+            if( eof ) { return 0; }
+            in.consume( size + 1 );
+        }
+        guessed = guess_format( line );
+        types = comma::split( guessed, ',' );
+        if( verbose ) { comma::say() << "guessed format: " << comma::join( types, ',' ) << std::endl; }
+    }
+    std::vector< std::string > nonblank;
+    for( const auto& n: names ) { if( !n.empty() ) { nonblank.push_back( n ); } }
+    if( nonblank.empty() ) { throw error( "please specify input stream fields, e.g. --fields=x,y" ); }
+    check_fields( nonblank );
+    if( std::set< std::string >( nonblank.begin(), nonblank.end() ).size() != nonblank.size() ) { throw eval::unsupported( "duplicated field names" ); }
+    if( names.size() > types.size() ) { throw eval::unsupported( "more fields than types in format" ); }
+    eval::program program;
+    program.execute( defaults );
+    std::vector< field > inputs;
+    std::map< std::string, field > fields;
+    for( std::size_t i = 0; i < names.size(); ++i )
+    {
+        if( names[i].empty() ) { continue; }
+        comma::csv::format::element e = csv.binary() ? csv.format().offset( i ) : element_of( types[i] );
+        field f;
+        f.name = names[i];
+        f.index = i;
+        f.element = e;
+        eval::type_t t;
+        if( type_of( e, t ) ) { f.column = program.input( f.name, t ); inputs.push_back( f ); }
+        else { program.opaque( f.name ); }
+        fields[ f.name ] = f;
+    }
+    std::vector< field > updates;
+    std::vector< field > outputs;
+    std::size_t condition = 0;
+    if( select.empty() && exit_if.empty() )
+    {
+        std::vector< eval::statement > statements = eval::parse( expressions );
+        std::vector< std::string > assigned = eval::assigned_names( statements );
+        std::vector< std::string > output_names;
+        if( output_fields_option ) { output_names = split_fields( *output_fields_option ); }
+        for( const auto& n: assigned )
+        {
+            if( fields.count( n ) ) { updates.push_back( fields[n] ); }
+            else if( !output_fields_option ) { output_names.push_back( n ); }
+        }
+        std::vector< std::string > output_types = format_without_blanks( output_format, output_names, false );
+        if( !output_names.empty() )
+        {
+            check_fields( output_names );
+            std::vector< std::string > common;
+            for( const auto& n: output_names ) { if( fields.count( n ) ) { common.push_back( n ); } }
+            if( !common.empty() ) { throw error( "output field(s) '" + comma::join( common, ',' ) + "' should not contain input fields '" + comma::join( nonblank, ',' ) + "'" ); }
+        }
+        for( const auto& n: output_names ) { program.uninitialized( n ); }
+        program.execute( statements );
+        for( auto& u: updates )
+        {
+            eval::type_t t;
+            if( !type_of( u.element, t ) ) { throw eval::unsupported( "update of field '" + u.name + "' of type not supported natively" ); }
+            u.column = program.result( u.name, t );
+        }
+        std::size_t offset = 0;
+        for( std::size_t i = 0; i < output_names.size(); ++i )
+        {
+            field f;
+            f.name = output_names[i];
+            f.element = element_of( output_types[i] );
+            f.element.offset = offset;
+            offset += f.element.size;
+            eval::type_t t;
+            if( !type_of( f.element, t ) ) { throw eval::unsupported( "output field '" + f.name + "' of type '" + output_types[i] + "' not supported natively" ); }
+            f.column = program.result( f.name, t );
+            outputs.push_back( f );
+        }
+    }
+    else
+    {
+        condition = program.condition( eval::parse_expression( select.empty() ? exit_if : select ), !select.empty() );
+    }
+    std::vector< field > used;
+    for( const auto& f: inputs ) { if( program.used( f.column ) ) { used.push_back( f ); } }
+    if( verbose ) { comma::say() << "compiled " << program.size() << " instruction(s); input fields used: " << used.size() << "; updated: " << updates.size() << "; output: " << outputs.size() << std::endl; }
+    const std::size_t capacity = 4096;
+    program.allocate( capacity );
+    std::size_t record_size = csv.binary() ? csv.format().size() : 0;
+    std::size_t output_size = outputs.empty() ? 0 : outputs.back().element.offset + outputs.back().element.size;
+    std::size_t last_field = 0;
+    for( const auto& f: used ) { last_field = std::max( last_field, f.index + 1 ); }
+    struct line { const char* begin; const char* end; const char* first; const char* last; }; // whole line and line trimmed as in numpy.genfromtxt
+    std::vector< line > lines;
+    std::vector< std::pair< const char*, const char* > > values;
+    std::string out;
+    auto split = [&]( const char* begin, const char* end, std::size_t size ) // split into fields, at least given number of them, if size is not zero
+    {
+        values.clear();
+        for( const char* p = begin; true; )
+        {
+            const char* q = static_cast< const char* >( std::memchr( p, csv.delimiter, end - p ) );
+            values.emplace_back( p, q ? q : end );
+            if( !q || ( size > 0 && values.size() >= size ) ) { return; }
+            p = q + 1;
+        }
+    };
+    auto output = [&]( std::size_t k ) // output k-th record of batch with updated and output fields
+    {
+        if( csv.binary() )
+        {
+            std::size_t size = out.size();
+            out.append( in.begin() + k * record_size, record_size );
+            out.resize( size + record_size + output_size );
+            for( const auto& u: updates ) { std::memcpy( &out[ size + u.element.offset ], program.column< char >( u.column ) + k * u.element.size, u.element.size ); }
+            for( const auto& o: outputs ) { std::memcpy( &out[ size + record_size + o.element.offset ], program.column< char >( o.column ) + k * o.element.size, o.element.size ); }
+            return;
+        }
+        const line& l = lines[k];
+        if( updates.empty() )
+        {
+            out.append( l.begin, l.end );
+        }
+        else
+        {
+            split( l.begin, l.end, 0 ); // as python csv-eval: updates in the original line, other fields are output as they are
+            for( std::size_t i = 0; i < values.size(); ++i )
+            {
+                if( i > 0 ) { out += csv.delimiter; }
+                auto u = std::find_if( updates.begin(), updates.end(), [&]( const field& f ) { return f.index == i; } );
+                if( u == updates.end() ) { out.append( values[i].first, values[i].second ); }
+                else { comma::csv::impl::numpy_ascii::to_ascii( out, u->element, program.column< char >( u->column ) + k * u->element.size, csv.precision ); }
+            }
+        }
+        for( const auto& o: outputs )
+        {
+            out += csv.delimiter;
+            comma::csv::impl::numpy_ascii::to_ascii( out, o.element, program.column< char >( o.column ) + k * o.element.size, csv.precision );
+        }
+        out += '\n';
+    };
+    bool flush = options.exists( "--flush,--unbuffered" );
+    auto write = [&]()
+    {
+        if( !out.empty() ) { std::cout.write( &out[0], out.size() ); }
+        if( flush || !in.ready() ) { std::cout.flush(); } // otherwise, more records follow at once anyway
+        out.clear();
+    };
+    bool eof = false;
+    while( true )
+    {
+        std::size_t size = 0;
+        std::size_t consumed = 0;
+        std::string failure;
+        if( csv.binary() )
+        {
+            size = std::min( in.size() / record_size, capacity );
+            if( size == 0 )
+            {
+                if( !eof ) { eof = !in.read(); continue; }
+                if( in.size() > 0 ) { COMMA_THROW( comma::exception, "expected records of size " << record_size << ", got " << in.size() << " trailing bytes" ); }
+                break;
+            }
+            for( const auto& f: used )
+            {
+                char* column = program.column< char >( f.column );
+                const char* record = in.begin() + f.element.offset;
+                for( std::size_t k = 0; k < size; ++k, record += record_size ) { std::memcpy( column + k * f.element.size, record, f.element.size ); }
+            }
+            consumed = size * record_size;
+        }
+        else
+        {
+            lines.clear();
+            const char* p = in.begin();
+            while( lines.size() < capacity && p < in.end() )
+            {
+                const char* eol = static_cast< const char* >( std::memchr( p, '\n', in.end() - p ) );
+                if( !eol && !eof ) { break; }
+                line l;
+                l.begin = p;
+                l.end = eol ? eol : in.end();
+                p = eol ? eol + 1 : in.end();
+                l.first = l.begin;
+                l.last = l.end;
+                while( l.first < l.last && comma::csv::impl::numpy_ascii::is_space( *l.first ) ) { ++l.first; }
+                while( l.first < l.last && comma::csv::impl::numpy_ascii::is_space( l.last[-1] ) ) { --l.last; }
+                if( l.first < l.last ) { lines.push_back( l ); }
+            }
+            consumed = p - in.begin();
+            if( lines.empty() )
+            {
+                in.consume( consumed );
+                if( eof ) { break; }
+                eof = !in.read();
+                continue;
+            }
+            size = lines.size();
+            for( std::size_t k = 0; k < size && !used.empty(); ++k )
+            {
+                split( lines[k].first, lines[k].last, last_field );
+                if( values.size() < last_field ) { COMMA_THROW( comma::exception, "expected at least " << last_field << " fields, got " << values.size() << " in line: '" << std::string( lines[k].begin, lines[k].end ) << "'" ); }
+                try { for( const auto& f: used ) { comma::csv::impl::numpy_ascii::from_ascii( f.element, values[ f.index ].first, values[ f.index ].second, program.column< char >( f.column ) + k * f.element.size ); } }
+                catch( std::exception& ) // python falls back to more lenient numpy.genfromtxt, e.g. on 1_000; records are independent, thus output records so far and hand the rest over to python
+                {
+                    failure = "failed to parse line '" + std::string( lines[k].begin, lines[k].end ) + "'";
+                    size = k;
+                    consumed = lines[k].begin - in.begin();
+                }
+            }
+        }
+        program.run( size );
+        const bool* mask = select.empty() && exit_if.empty() ? nullptr : program.column< bool >( condition );
+        for( std::size_t k = 0; k < size; ++k )
+        {
+            if( !exit_if.empty() && mask[k] )
+            {
+                write();
+                if( with_error.empty() ) { return 0; }
+                std::cerr << "csv-eval error: " << with_error << std::endl;
+                return 1;
+            }
+            if( select.empty() || mask[k] ) { output( k ); }
+        }
+        in.consume( consumed );
+        write();
+        if( !failure.empty() ) { std::cout.flush(); python_format = guessed; throw eval::unsupported( failure ); }
+    }
+    return 0;
+}
+
+int main( int ac, char** av )
+{
+    input in;
+    try
+    {
+        comma::command_line_options options( ac, av, usage );
+        bool verbose = options.exists( "--verbose,-v" );
+        if( options.exists( "--python" ) ) { python( ac, av, in, "--python given", verbose ); }
+        std::string format;
+        try
+        {
+            return run( options, in, format );
+        }
+        catch( eval::unsupported& ex )
+        {
+            if( options.exists( "--native" ) ) { comma::say() << "not supported natively: " << ex.what() << std::endl; return 1; }
+            python( ac, av, in, ex.what(), verbose, format );
+        }
+    }
+    catch( error& ex ) { std::cerr << "csv-eval error: " << ex.what() << std::endl; }
+    catch( std::exception& ex ) { comma::say() << ex.what() << std::endl; }
+    catch( ... ) { comma::say() << "unknown exception" << std::endl; }
+    return 1;
+}
@@ -29,14 +29,14 @@
 
 /// @author Vinny Do
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <limits>
 #include <set>
 #include <string>
 #include <tuple>
-#include <boost/icl/interval.hpp>
-#include <boost/icl/interval_map.hpp>
+#include <vector>
 #include "../../application/command_line_options.h"
 #include "../../base/exception.h"
 #include "../../csv/stream.h"
@@ -225,6 +225,7 @@ struct bound_t
     bool operator<( const bound_t& rhs ) const
     {
         if( value && rhs.value ) { return *value < *rhs.value; }
+        if( !value && !rhs.value ) { return side == LOWER && rhs.side == UPPER; }
         if( !value ) { return side == LOWER; }
         return rhs.side == UPPER;
     }
@@ -314,8 +315,15 @@ template < typename From, typename To = From >
 struct intervals
 {
     typedef typename bound_traits< From >::type bound_type;
-    typedef std::set< std::string > set_t;
-    typedef boost::icl::interval_map< bound_t< bound_type >, set_t > map_t;
+    typedef bound_t< bound_type > bound;
+    struct record_t
+    {
+        bound from;
+        bound to;
+        comma::uint32 id;
+        record_t( const bound& from, const bound& to, comma::uint32 id ): from( from ), to( to ), id( id ) {}
+    };
+    typedef std::set< comma::uint32 > set_t; // payload ids; ids are assigned in payload order, thus payloads are output sorted, as before
     const comma::command_line_options& options;
     comma::csv::options csv;
     comma::csv::options ocsv;
@@ -323,7 +331,8 @@ struct intervals
     boost::optional< bound_type > empty;
     bool intervals_only;
     bool use_limits;
-    map_t map;
+    std::vector< std::string > payloads; // arena: each distinct payload stored once, referenced by id
+    std::vector< record_t > records;
     unsigned int min_overlap_count;
     unsigned int max_overlap_count;
 
@@ -358,79 +367,164 @@ struct intervals
         }
     }
 
-    void add( const bound_t< bound_type >& from, const bound_t< bound_type >& to, const std::string& payload )
+    void add( const bound& from, const bound& to, const std::string& payload )
     {
         // todo?! don't discard identical strings, which currently is not the case
         // todo?! [optionally?] add records in the order they are read from stdin
-        set_t s;
-        s.insert( payload );
-        map += std::make_pair( boost::icl::interval< bound_t< bound_type > >::right_open( from, to ), s );
+        if( !( from < to ) ) { return; } // empty interval
+        records.emplace_back( from, to, payloads.size() );
+        payloads.push_back( payload );
+    }
+
+    void finalise() // sort payloads, merge identical payloads and renumber records accordingly
+    {
+        std::vector< comma::uint32 > order( payloads.size() );
+        for( comma::uint32 i = 0; i < order.size(); ++i ) { order[i] = i; }
+        std::sort( order.begin(), order.end(), [&]( comma::uint32 lhs, comma::uint32 rhs ) { return payloads[lhs] < payloads[rhs]; } );
+        std::vector< comma::uint32 > ids( payloads.size() );
+        std::vector< std::string > sorted;
+        for( std::size_t i = 0; i < order.size(); ++i )
+        {
+            if( i == 0 || payloads[ order[i] ] != sorted.back() ) { sorted.push_back( std::move( payloads[ order[i] ] ) ); }
+            ids[ order[i] ] = sorted.size() - 1;
+        }
+        payloads.swap( sorted );
+        for( auto& r: records ) { r.id = ids[ r.id ]; }
+        if( verbose ) { std::cerr << "csv-intervals: loaded " << records.size() << " interval(s) with " << payloads.size() << " distinct payload(s)" << std::endl; }
+    }
+
+    /// sweep through sorted interval ends, call f( from, to, payload ids ) for maximal intervals with the same non-empty set of payloads
+    template < typename F > void sweep( F f ) const
+    {
+        struct event_t { bound at; int delta; comma::uint32 id; };
+        std::vector< event_t > events;
+        events.reserve( records.size() * 2 );
+        for( const auto& r: records ) { events.push_back( event_t{ r.from, 1, r.id } ); events.push_back( event_t{ r.to, -1, r.id } ); }
+        std::sort( events.begin(), events.end(), []( const event_t& lhs, const event_t& rhs ) { return lhs.at < rhs.at; } );
+        std::vector< unsigned int > counts( payloads.size(), 0 );
+        std::vector< std::size_t > touched_at( payloads.size(), events.size() );
+        std::vector< std::pair< comma::uint32, bool > > touched; // payload id, whether it was active before the current point
+        set_t active;
+        bound from;
+        for( std::size_t i = 0; i < events.size(); )
+        {
+            touched.clear();
+            std::size_t j = i;
+            for( ; j < events.size() && !( events[i].at < events[j].at ); ++j )
+            {
+                unsigned int& count = counts[ events[j].id ];
+                if( touched_at[ events[j].id ] != i ) { touched_at[ events[j].id ] = i; touched.emplace_back( events[j].id, count > 0 ); }
+                count += events[j].delta;
+            }
+            bool changed = false;
+            for( const auto& t: touched ) { if( t.second != ( counts[ t.first ] > 0 ) ) { changed = true; break; } }
+            if( changed )
+            {
+                if( !active.empty() ) { f( from, events[i].at, active ); }
+                for( const auto& t: touched ) { if( counts[ t.first ] > 0 ) { active.insert( t.first ); } else { active.erase( t.first ); } }
+                from = events[i].at;
+            }
+            i = j;
+        }
     }
 
-    void write()
+    /// static interval tree: records sorted by lower bound, implicit balanced binary tree with maximum upper bound in subtree
+    class index
+    {
+        public:
+            index( std::vector< record_t >& records ): _records( records ), _max( records.size() )
+            {
+                std::sort( _records.begin(), _records.end(), []( const record_t& lhs, const record_t& rhs ) { return lhs.from < rhs.from; } );
+                if( !_records.empty() ) { _build( 0, _records.size() ); }
+            }
+
+            /// call f( payload id ) for each interval containing scalar, stop if f returns false
+            template < typename T, typename F > void query( const T& t, F f ) const { _query( 0, _records.size(), t, f ); }
+
+        private:
+            std::vector< record_t >& _records;
+            std::vector< bound > _max;
+
+            const bound& _build( std::size_t begin, std::size_t end )
+            {
+                std::size_t middle = ( begin + end ) / 2;
+                _max[middle] = _records[middle].to;
+                if( begin < middle ) { const bound& b = _build( begin, middle ); if( _max[middle] < b ) { _max[middle] = b; } }
+                if( middle + 1 < end ) { const bound& b = _build( middle + 1, end ); if( _max[middle] < b ) { _max[middle] = b; } }
+                return _max[middle];
+            }
+
+            template < typename T, typename F > bool _query( std::size_t begin, std::size_t end, const T& t, F& f ) const
+            {
+                if( begin >= end ) { return true; }
+                std::size_t middle = ( begin + end ) / 2;
+                if( _max[middle].value && !( t < *_max[middle].value ) ) { return true; } // all intervals in subtree end before t
+                if( !_query( begin, middle, t, f ) ) { return false; }
+                const record_t& r = _records[middle];
+                if( r.from.value && t < *r.from.value ) { return true; } // this and all intervals to the right start after t
+                if( ( !r.to.value || t < *r.to.value ) && !f( r.id ) ) { return false; }
+                return _query( middle + 1, end, t, f );
+            }
+    };
+
+    void write( const bound& from, const bound& to, const set_t& s )
     {
         static comma::csv::output_stream< interval_t< From, To > > ostream( std::cout, ocsv );
         static comma::csv::ascii< from_t< std::string > > from_ascii( ascii_csv );
         static comma::csv::ascii< to_t< std::string > > to_ascii( ascii_csv );
-        for( typename map_t::iterator it = map.begin(); it != map.end(); ++it )
+        interval_t< From, To > interval;
+        bool from_has_value = true;
+        bool to_has_value = true;
+        if( from.value ) { interval.from.value = *from.value; }
+        else if( use_limits ) { interval.from.value = limits< From >::lowest(); }
+        else if( empty ) { interval.from.value = static_cast< From >( *empty ); }
+        else { from_has_value = false; }
+        if( to.value ) { interval.to.value = *to.value; }
+        else if( use_limits ) { interval.to.value = limits< To >::max(); }
+        else if( empty ) { interval.to.value = static_cast< To >( *empty ); }
+        else { to_has_value = false; }
+        if( s.size() < min_overlap_count || s.size() > max_overlap_count ) { return; }
+        if( append )
         {
-            bound_t< bound_type > from = it->first.lower();
-            bound_t< bound_type > to = it->first.upper();
-            interval_t< From, To > interval;
-            bool from_has_value = true;
-            bool to_has_value = true;
-            if( from.value ) { interval.from.value = *from.value; }
-            else if( use_limits ) { interval.from.value = limits< From >::lowest(); }
-            else if( empty ) { interval.from.value = static_cast< From >( *empty ); }
-            else { from_has_value = false; }
-            if( to.value ) { interval.to.value = *to.value; }
-            else if( use_limits ) { interval.to.value = limits< To >::max(); }
-            else if( empty ) { interval.to.value = static_cast< To >( *empty ); }
-            else { to_has_value = false; }
-            const set_t& s = it->second;
-            if( s.size() < min_overlap_count || s.size() > max_overlap_count ) { continue; }
-            if( append )
+            if( csv.binary() )
             {
-                if( csv.binary() )
-                {
-                    for( typename set_t::const_iterator v = s.begin(); v != s.end(); ++v )
-                    { 
-                        std::cout.write( &( *v )[0], v->size() );
-                        ostream.write( interval );
-                    }
-                    ostream.flush(); // todo: use csv.flush flag
-                }
-                else
+                for( auto id: s )
                 {
-                    //std::ostringstream oss;
-                    //comma::csv::output_stream< interval_t< From, To > > osstream( oss ); // todo! quick and dirty, watch performance!
-                    if( !from_has_value || !to_has_value ) { std::cerr << "csv-interval: support for empty from/to values for --append: todo" << std::endl; exit( 1 ); }
-                    for( typename set_t::const_iterator v = s.begin(); v != s.end(); ++v )
-                    {
-                        std::cout << *v << csv.delimiter;
-                        ostream.write( interval );
-                    }
+                    std::cout.write( &payloads[id][0], payloads[id].size() );
+                    ostream.write( interval );
                 }
+                ostream.flush(); // todo: use csv.flush flag
             }
             else
             {
-                if( csv.binary() )
+                //std::ostringstream oss;
+                //comma::csv::output_stream< interval_t< From, To > > osstream( oss ); // todo! quick and dirty, watch performance!
+                if( !from_has_value || !to_has_value ) { std::cerr << "csv-interval: support for empty from/to values for --append: todo" << std::endl; exit( 1 ); }
+                for( auto id: s )
                 {
-                    if( intervals_only ) { ostream.write( interval ); ostream.flush(); continue; }
-                    for( typename set_t::const_iterator v = s.begin(); v != s.end(); ++v ) { ostream.write( interval, *v ); }
-                    ostream.flush();
+                    std::cout << payloads[id] << csv.delimiter;
+                    ostream.write( interval );
                 }
-                else
+            }
+        }
+        else
+        {
+            if( csv.binary() )
+            {
+                if( intervals_only ) { ostream.write( interval ); ostream.flush(); return; }
+                for( auto id: s ) { ostream.write( interval, payloads[id] ); }
+                ostream.flush();
+            }
+            else
+            {
+                for( auto id: s )
                 {
-                    for( typename set_t::const_iterator v = s.begin(); v != s.end(); ++v )
-                    {
-                        std::string payload( intervals_only ? "" : *v );
-                        ostream.ascii().ascii().put( interval, payload );
-                        if( !from_has_value ) { from_ascii.put( from_t< std::string >(), payload ); }
-                        if( !to_has_value ) { to_ascii.put( to_t< std::string >(), payload); }
-                        std::cout << payload << std::endl;
-                        if( intervals_only ) { break; }
-                    }
+                    std::string payload( intervals_only ? "" : payloads[id] );
+                    ostream.ascii().ascii().put( interval, payload );
+                    if( !from_has_value ) { from_ascii.put( from_t< std::string >(), payload ); }
+                    if( !to_has_value ) { to_ascii.put( to_t< std::string >(), payload); }
+                    std::cout << payload << std::endl;
+                    if( intervals_only ) { break; }
                 }
             }
         }
@@ -443,8 +537,8 @@ struct intervals
         if( !first_line.empty() )
         {
             interval_t< From, To > interval = comma::csv::ascii< interval_t< From, To > >( csv.fields ).get( first_line );
-            bound_t< bound_type > from( LOWER );
-            bound_t< bound_type > to( UPPER );
+            bound from( LOWER );
+            bound to( UPPER );
             std::string payload;
             interval_t< std::string > first;
             ascii.get( first, first_line );
@@ -459,8 +553,8 @@ struct intervals
         {
             const interval_t< From, To >* interval = istream.read();
             if( !interval ) { break; }
-            bound_t< bound_type > from( LOWER );
-            bound_t< bound_type > to( UPPER );
+            bound from( LOWER );
+            bound to( UPPER );
             std::string payload;
             if( csv.binary() )
             {
@@ -483,6 +577,7 @@ struct intervals
             if( verbose ) { std::cerr << "csv-intervals: from: " << from << " to: " << to << " payload: " << ( csv.binary() ? "<binary>" : payload ) << std::endl; }
             add( from, to, payload );
         }
+        finalise();
     }
 
     int contain( std::istream& is, const std::string& first_line )
@@ -493,17 +588,13 @@ struct intervals
         comma::csv::output_stream< scalar_t< bool > > ostream( std::cout, icsv.binary() );
         auto tied = comma::csv::make_tied( istream, ostream );
         this->read( is, first_line ); // todo: support block
+        const index intervals_index( records );
         while( istream.ready() || std::cin.good() )
         {
             auto p = istream.read();
             if( !p ) { break; }
             bool contained = false;
-            for( typename map_t::iterator it = map.begin(); it != map.end() && !contained; ++it ) // todo! quadratic complexity; how the heck to query icl map? use boost::...::query?
-            {
-                const bound_t< bound_type >& from = it->first.lower();
-                const bound_t< bound_type >& to = it->first.upper();
-                contained = ( !from.value || p->scalar >= *from.value ) && ( !to.value || p->scalar < *to.value );
-            }
+            intervals_index.query( p->scalar, [&]( comma::uint32 ) { contained = true; return false; } );
             tied.append( scalar_t< bool >( contained ) );
             if( icsv.flush ) { std::cout.flush(); }
         }
@@ -522,26 +613,25 @@ struct intervals
         comma::csv::input_stream< scalar_t< From > > istream( std::cin, icsv );
         append = true;
         this->read( is, first_line ); // todo: support block
+        const index intervals_index( records );
+        std::vector< comma::uint32 > ids;
         while( istream.ready() || std::cin.good() )
         {
             auto p = istream.read();
             if( !p ) { break; }
-            bool found = false;
-            typename map_t::iterator it;
-            for( it = map.begin(); it != map.end(); ++it ) // todo! quadratic complexity; how the heck to query icl map? use boost::...::query?
-            {
-                const bound_t< bound_type >& from = it->first.lower();
-                const bound_t< bound_type >& to = it->first.upper();
-                found = ( !from.value || p->scalar >= *from.value ) && ( !to.value || p->scalar < *to.value );
-                if( found ) { break; }
-            }
+            ids.clear();
+            intervals_index.query( p->scalar, [&]( comma::uint32 id ) { ids.push_back( id ); return output_joined; } );
+            bool found = !ids.empty();
             if( output_joined )
             {
                 if( found )
                 {
+                    std::sort( ids.begin(), ids.end() );
+                    ids.erase( std::unique( ids.begin(), ids.end() ), ids.end() );
                     std::string joined = csv.binary() ? "" : comma::join( istream.ascii().last(), icsv.delimiter );
-                    for( const auto& s: it->second )
+                    for( auto id: ids )
                     {
+                        const std::string& s = payloads[id];
                         if( csv.binary() )
                         {
                             std::cout.write( istream.binary().last(), icsv.format().size() );
@@ -567,7 +657,7 @@ struct intervals
     int make( const std::string& first_line )
     {
         this->read( std::cin, first_line );
-        this->write();
+        sweep( [&]( const bound& from, const bound& to, const set_t& s ) { write( from, to, s ); } );
         return 0;
     }
 };
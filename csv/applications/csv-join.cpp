@@ -4,6 +4,8 @@
 /// @author vsevolod vlaskine
 
 #include <string.h>
+#include <algorithm>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <map>
@@ -40,8 +42,10 @@ static void usage( bool more )
     std::cerr << std::endl;
     std::cerr << "options" << std::endl;
     std::cerr << "    --help,-h: help; --help --verbose: more help" << std::endl;
-    std::cerr << "    --block-less; todo! better option name! input and filter block ids expected sorted" << std::endl;
-    std::cerr << "                  todo! document" << std::endl;
+    std::cerr << "    --block-less,--sorted-blocks: input and filter block ids expected sorted ascending; each input record is joined with" << std::endl;
+    std::cerr << "                                  the filter block with the greatest block id not greater than the input block id," << std::endl;
+    std::cerr << "                                  i.e. gaps in filter block ids are allowed; input records before the first filter" << std::endl;
+    std::cerr << "                                  block are discarded; only one filter block is held in memory at a time" << std::endl;
     std::cerr << "    --drop-id-fields,--drop-id; remove id and block fields from filter output (same as if you did csv-join|csv-shuffle)" << std::endl;
     std::cerr << "    --first-matching: output only the first matching record (a bit of hack for now, but we needed it)" << std::endl;
     std::cerr << "    --flag-matching: output all records, with 1 appended to matching records and 0 appended to not-matching records" << std::endl;
@@ -50,6 +54,10 @@ static void usage( bool more )
     std::cerr << "    --not-matching: not matching records as read from stdin, no join performed" << std::endl;
     std::cerr << "    --output-swap,--swap-output,--swap; output filter records first with the stdin record appended, a convenience option" << std::endl;
     std::cerr << "    --radius,--epsilon=<value>; compare keys in given radius; the keys will be interpreted as floating point numbers" << std::endl;
+    std::cerr << "    --sorted: merge join: both input and filter are sorted ascending by block, if present, and then by keys;" << std::endl;
+    std::cerr << "              streams are advanced in lockstep, only filter records matching the current input key" << std::endl;
+    std::cerr << "              (or within --radius of it) are held in memory, e.g. to join files larger than memory;" << std::endl;
+    std::cerr << "              fails if either stream is found not sorted; finite state machine not supported" << std::endl;
     std::cerr << "    --strict: fail, if id on stdin is not found, or there are multiple filter keys on --unique, etc" << std::endl;
     std::cerr << "    --unique,--unique-matches: expect only unique matches, exit with error otherwise" << std::endl;
     std::cerr << "    --verbose,-v: more output to stderr" << std::endl;
@@ -111,6 +119,10 @@ static void usage( bool more )
         std::cerr << "        echo 1,blah | csv-join --fields=,id \"data.csv;fields=,,,id\" --string --not-matching" << std::endl;
         std::cerr << "        echo 1,blah | csv-join --fields=,id \"data.csv;fields=,,,id\" --string --strict" << std::endl;
         std::cerr << std::endl;
+        std::cerr << "    merge join on sorted inputs, many-to-many" << std::endl;
+        std::cerr << "        ( echo 1,a; echo 2,b; echo 2,c; echo 4,d ) | csv-join --fields id <( echo 2,x; echo 2,y; echo 3,z )';fields=id' --sorted" << std::endl;
+        std::cerr << "        ( echo 1.1,a; echo 2.9,b ) | csv-join --fields t <( echo 1; echo 2; echo 3 )';fields=t' --sorted --radius 0.5" << std::endl;
+        std::cerr << std::endl;
         std::cerr << "    block id ordered, gaps in filter blocks allowed" << std::endl;
         std::cerr << "        csv-paste line-number value=0 | head \\" << std::endl;
         std::cerr << "            | csv-join --fields block,id <( echo 3,0; echo 6,0 )';fields=block,id' --block-less" << std::endl;
@@ -163,6 +175,8 @@ static void hash_combine_( std::size_t& seed, boost::posix_time::ptime key )
 
 template < typename K > static void hash_combine_( std::size_t& seed, K key ) { boost::hash_combine( seed, key ); }
 
+static bool sorted;
+
 template < typename K >
 struct input
 {
@@ -217,6 +231,10 @@ template < typename K, bool Strict = true > struct traits
 
 template < typename K > struct type_traits
 {
+    static void shift( K& key, double d ) { key += d; }
+
+    static double distance( const K& lhs, const K& rhs ) { return std::abs( lhs - rhs ); }
+
     template < typename Map >
     static typename std::pair< typename Map::iterator, typename Map::iterator > bounds( Map& m, const input< K >& k ) // quick and dirty
     {
@@ -242,6 +260,8 @@ template < typename K > struct type_traits
 
 template <> struct type_traits< std::string > // quick and dirty
 {
+    static void shift( std::string&, double ) { COMMA_THROW( comma::exception, "never here" ); }
+    static double distance( const std::string&, const std::string& ) { COMMA_THROW( comma::exception, "never here" ); }
     template < typename Map >
     static std::pair< typename Map::iterator, typename Map::iterator > bounds( Map& m, const input< std::string >& k ) { COMMA_THROW( comma::exception, "never here" ); }    
     template < typename Map > static typename Map::iterator nearest( Map& m, const input< std::string >& ) { COMMA_THROW( comma::exception, "never here" ); }
@@ -249,6 +269,8 @@ template <> struct type_traits< std::string > // quick and dirty
 
 template <> struct type_traits< boost::posix_time::ptime > // quick and dirty
 {
+    static void shift( boost::posix_time::ptime&, double ) { COMMA_THROW( comma::exception, "never here" ); }
+    static double distance( const boost::posix_time::ptime&, const boost::posix_time::ptime& ) { COMMA_THROW( comma::exception, "never here" ); }
     template < typename Map >
     static typename std::pair< typename Map::iterator, typename Map::iterator > bounds( Map& m, const input< boost::posix_time::ptime >& k ) { COMMA_THROW( comma::exception, "never here" ); }
     template < typename Map >
@@ -365,7 +387,7 @@ template < typename K, bool Strict = true > struct join_impl_ // quick and dirty
 
     static int run( const comma::command_line_options& options )
     {
-        bool block_less = options.exists( "--block-less" );
+        bool block_less = options.exists( "--block-less,--sorted-blocks" );
         std::vector< std::string > v = comma::split( stdin_csv.fields, ',' );
         std::vector< std::string > w = comma::split( filter_csv.fields, ',' );
         if( filter_id_fields_discard ) { filter_id_fields_flags.resize( w.size(), 0 ); }
@@ -432,6 +454,17 @@ template < typename K, bool Strict = true > struct join_impl_ // quick and dirty
         comma::csv::input_stream< input< K > > stdin_stream( std::cin, stdin_csv, default_input );
         filter_transport.reset( new comma::io::istream( filter_csv.filename, filter_csv.binary() ? comma::io::mode::binary : comma::io::mode::ascii ) );
         if( filter_transport->fd() == comma::io::invalid_file_descriptor ) { std::cerr << "csv-join: failed to open \"" << filter_csv.filename << "\"" << std::endl; return 1; }
+        if( sorted )
+        {
+            if( is_state_machine ) { std::cerr << "csv-join: --sorted: finite state machine not supported" << std::endl; return 1; }
+            if( do_full_join ) { std::cerr << "csv-join: --sorted: please specify at least one common key" << std::endl; return 1; }
+            if( radius && default_input.keys.size() > 1 ) { std::cerr << "csv-join: --sorted: if --radius given, expected one key, got: " << default_input.keys.size() << std::endl; return 1; }
+            #ifdef WIN32
+            if( stdin_stream.is_binary() ) { _setmode( _fileno( stdout ), _O_BINARY ); }
+            #endif
+            comma::csv::input_stream< input< K > > filter_stream( **filter_transport, filter_csv, default_input );
+            return run_sorted_( stdin_stream, filter_stream );
+        }
         std::size_t discarded = 0;
         auto last = read_filter_block();
         #ifdef WIN32
@@ -464,73 +497,146 @@ template < typename K, bool Strict = true > struct join_impl_ // quick and dirty
             {
                 pair = traits< K, Strict >::find( filter_map, *p, nearest );
             }
-            if( pair.first == filter_map.end() ) // if( it == filter_map.end() || it->second.empty() )
+            if( pair.first == pair.second ) // no matches, e.g. key not found or nothing within radius
             {
-                if( not_matching )
-                {
-                    if( stdin_stream.is_binary() ) { std::cout.write( stdin_stream.binary().last(), stdin_csv.format().size() ); }
-                    else { std::cout << comma::join( stdin_stream.ascii().last(), stdin_csv.delimiter ) << std::endl; }
-                    continue;
-                }
-                if ( flag_matching )
-                {
-                    if( stdin_stream.is_binary() ) { 
-                        std::cout.write( stdin_stream.binary().last(), stdin_csv.format().size() ); 
-                        char match = 0; std::cout.write( &match, 1 );
-                    }
-                    else { std::cout << comma::join( stdin_stream.ascii().last(), stdin_csv.delimiter ) << stdin_csv.delimiter << 0 << std::endl; }
-                    continue;
-                }
-                if( !strict ) { ++discarded; continue; }
-                std::string s;
-                comma::csv::options c;
-                c.full_xpath = false;
-                c.fields = "keys";
-                std::cerr << "csv-join: match not found for key(s): " << comma::csv::ascii< input< K > >( c, default_input ).put( *p, s ) << ", block: " << block << std::endl;
-                return 1;
+                if( !output_not_matching_( stdin_stream, *p, discarded ) ) { return 1; }
+                continue;
             }
             if( not_matching ) { continue; }
-            for( typename traits< K, Strict >::map::const_iterator it = pair.first; it != pair.second; ++it )
+            if( !output_matching_( stdin_stream, pair.first, pair.second, is_state_machine, state ) ) { return 1; }
+            if( first_matching ) { filter_map.erase( pair.first, pair.second ); }
+        }
+        if( verbose ) { std::cerr << "csv-join: discarded " << discarded << " " << ( discarded == 1 ? "entry" : "entries" ) << " with no matches" << std::endl; }
+        return 0;
+    }
+
+    typedef comma::csv::input_stream< input< K > > stream_t;
+
+    /// output stdin record without matches as required by options; return false, if --strict
+    static bool output_not_matching_( const stream_t& stdin_stream, const input< K >& p, std::size_t& discarded )
+    {
+        if( not_matching )
+        {
+            if( stdin_stream.is_binary() ) { std::cout.write( stdin_stream.binary().last(), stdin_csv.format().size() ); }
+            else { std::cout << comma::join( stdin_stream.ascii().last(), stdin_csv.delimiter ) << std::endl; }
+            return true;
+        }
+        if ( flag_matching )
+        {
+            if( stdin_stream.is_binary() ) { 
+                std::cout.write( stdin_stream.binary().last(), stdin_csv.format().size() ); 
+                char match = 0; std::cout.write( &match, 1 );
+            }
+            else { std::cout << comma::join( stdin_stream.ascii().last(), stdin_csv.delimiter ) << stdin_csv.delimiter << 0 << std::endl; }
+            return true;
+        }
+        if( !strict ) { ++discarded; return true; }
+        std::string s;
+        comma::csv::options c;
+        c.full_xpath = false;
+        c.fields = "keys";
+        std::cerr << "csv-join: match not found for key(s): " << comma::csv::ascii< input< K > >( c, default_input ).put( p, s ) << ", block: " << ( sorted ? p.block : block ) << std::endl;
+        return false;
+    }
+
+    /// output stdin record joined with filter records in [begin, end), i.e. pairs of key and filter records; return false on error
+    template < typename It > static bool output_matching_( const stream_t& stdin_stream, It begin, It end, bool is_state_machine, K& state )
+    {
+        for( It it = begin; it != end; ++it )
+        {
+            if( unique && it->second.size() > 1 )
             {
-                if( unique && it->second.size() > 1 )
-                {
-                    if( strict ) { std::cerr << "csv-join: with --unique option, expected unique entries, got more than one filter entry on the key: " << keys_as_string( it->first ) << std::endl; return 1; }
-                    if( verbose ) { std::cerr << "csv-join: got --unique option, but more than one filter entry on the key: " << keys_as_string( it->first ) << "; only the first entry will be output; use --strict to make it fatal error" << std::endl; }
-                }
-                if( is_state_machine && it->second.size() > 1 ) { std::cerr << "csv-join: finite state machine, expected unique entries, got more than one state transition entry on the key: " << keys_as_string( it->first ) << std::endl; return 1; }
-                if( stdin_stream.is_binary() )
+                if( strict ) { std::cerr << "csv-join: with --unique option, expected unique entries, got more than one filter entry on the key: " << keys_as_string( it->first ) << std::endl; return false; }
+                if( verbose ) { std::cerr << "csv-join: got --unique option, but more than one filter entry on the key: " << keys_as_string( it->first ) << "; only the first entry will be output; use --strict to make it fatal error" << std::endl; }
+            }
+            if( is_state_machine && it->second.size() > 1 ) { std::cerr << "csv-join: finite state machine, expected unique entries, got more than one state transition entry on the key: " << keys_as_string( it->first ) << std::endl; return false; }
+            if( stdin_stream.is_binary() )
+            {
+                for( std::size_t i = 0; i < ( first_matching || unique ? 1 : it->second.size() ); ++i )
                 {
-                    for( std::size_t i = 0; i < ( first_matching || unique ? 1 : it->second.size() ); ++i )
-                    {
-                        if( !swap_output ) { std::cout.write( stdin_stream.binary().last(), stdin_csv.format().size() ); }
-                        if( is_state_machine ) { state = it->first.next_state; }
-                        if( flag_matching ) { char match = 1; std::cout.write( &match, 1 ); break; }
-                        if( matching ) { break; }
-                        std::cout.write( &( it->second[i][0] ), it->second[i].size() );
-                        if( swap_output ) { std::cout.write( stdin_stream.binary().last(), stdin_csv.format().size() ); }
-                        std::cout.flush();
-                    }
+                    if( !swap_output ) { std::cout.write( stdin_stream.binary().last(), stdin_csv.format().size() ); }
+                    if( is_state_machine ) { state = it->first.next_state; }
+                    if( flag_matching ) { char match = 1; std::cout.write( &match, 1 ); break; }
+                    if( matching ) { break; }
+                    std::cout.write( &( it->second[i][0] ), it->second[i].size() );
+                    if( swap_output ) { std::cout.write( stdin_stream.binary().last(), stdin_csv.format().size() ); }
                     std::cout.flush();
                 }
-                else
+                std::cout.flush();
+            }
+            else
+            {
+                for( std::size_t i = 0; i < ( first_matching || unique ? 1 : it->second.size() ); ++i )
                 {
-                    for( std::size_t i = 0; i < ( first_matching || unique ? 1 : it->second.size() ); ++i )
-                    {
-                        if( !swap_output ) { std::cout << comma::join( stdin_stream.ascii().last(), stdin_csv.delimiter ); }
-                        if( is_state_machine ) { state = it->first.next_state; }
-                        if( flag_matching ) { std::cout << stdin_csv.delimiter << 1 << std::endl; break; }
-                        if( matching ) { std::cout << std::endl; break; }
-                        if( !swap_output ) { std::cout << stdin_csv.delimiter; }
-                        std::cout << ( filter_csv.binary()
-                                     ? filter_csv.format().bin_to_csv( &it->second[i][0], stdin_csv.delimiter )
-                                     : it->second[i] );
-                        if( swap_output ) { std::cout << stdin_csv.delimiter << comma::join( stdin_stream.ascii().last(), stdin_csv.delimiter ); }
-                        std::cout << std::endl;
-                    }
+                    if( !swap_output ) { std::cout << comma::join( stdin_stream.ascii().last(), stdin_csv.delimiter ); }
+                    if( is_state_machine ) { state = it->first.next_state; }
+                    if( flag_matching ) { std::cout << stdin_csv.delimiter << 1 << std::endl; break; }
+                    if( matching ) { std::cout << std::endl; break; }
+                    if( !swap_output ) { std::cout << stdin_csv.delimiter; }
+                    std::cout << ( filter_csv.binary()
+                                 ? filter_csv.format().bin_to_csv( &it->second[i][0], stdin_csv.delimiter )
+                                 : it->second[i] );
+                    if( swap_output ) { std::cout << stdin_csv.delimiter << comma::join( stdin_stream.ascii().last(), stdin_csv.delimiter ); }
+                    std::cout << std::endl;
                 }
-                if( first_matching ) { break; }
             }
-            if( first_matching ) { filter_map.erase( pair.first, pair.second ); }
+            if( first_matching ) { break; }
+        }
+        return true;
+    }
+
+    /// lexicographic order of block and keys
+    static bool less_( const input< K >& lhs, const input< K >& rhs )
+    {
+        if( lhs.block != rhs.block ) { return lhs.block < rhs.block; }
+        return std::lexicographical_compare( lhs.keys.begin(), lhs.keys.end(), rhs.keys.begin(), rhs.keys.end() );
+    }
+
+    /// merge join of sorted streams: filter records are read ahead only as far as the current stdin key
+    /// (plus radius); filter records behind it are dropped, i.e. memory is bounded by the number of
+    /// filter records matching one key, however large the streams are
+    static int run_sorted_( stream_t& stdin_stream, stream_t& filter_stream )
+    {
+        typedef std::deque< std::pair< input< K >, std::vector< std::string > > > window_t; // filter records grouped by key, ascending
+        window_t window;
+        boost::optional< input< K > > previous;
+        boost::optional< input< K > > previous_filter;
+        const input< K >* next = filter_stream.read();
+        std::size_t discarded = 0;
+        K state = K(); // unused: no finite state machine
+        auto shifted = [&]( const input< K >& i, double d ) { input< K > j = i; type_traits< K >::shift( j.keys[0], d ); return j; };
+        while( stdin_stream.ready() || std::cin.good() )
+        {
+            const input< K >* p = stdin_stream.read();
+            if( !p ) { break; }
+            if( previous && less_( *p, *previous ) ) { std::cerr << "csv-join: --sorted: expected stdin sorted ascending; got key(s) " << keys_as_string( *p ) << " after " << keys_as_string( *previous ) << std::endl; return 1; }
+            previous = *p;
+            input< K > lower = radius ? shifted( *p, -*radius ) : *p;
+            input< K > upper = radius ? shifted( *p, *radius ) : *p;
+            while( !window.empty() && less_( window.front().first, lower ) ) { window.pop_front(); }
+            for( ; next && !less_( upper, *next ); next = filter_stream.read() )
+            {
+                if( previous_filter && less_( *next, *previous_filter ) ) { std::cerr << "csv-join: --sorted: expected filter sorted ascending; got key(s) " << keys_as_string( *next ) << " after " << keys_as_string( *previous_filter ) << std::endl; return 1; }
+                previous_filter = *next;
+                if( less_( *next, lower ) ) { continue; }
+                if( window.empty() || less_( window.back().first, *next ) ) { window.emplace_back( *next, std::vector< std::string >() ); }
+                window.back().second.push_back( filter_stream.is_binary() ? make_output( filter_stream.binary().last() ) : make_output( filter_stream.ascii().last() ) );
+            }
+            typename window_t::iterator begin = window.begin();
+            typename window_t::iterator end = window.end();
+            if( radius && nearest && begin != end )
+            {
+                for( typename window_t::iterator it = window.begin(); it != window.end(); ++it ) { if( type_traits< K >::distance( it->first.keys[0], p->keys[0] ) < type_traits< K >::distance( begin->first.keys[0], p->keys[0] ) ) { begin = it; } }
+                end = begin + 1;
+            }
+            if( begin == end )
+            {
+                if( !output_not_matching_( stdin_stream, *p, discarded ) ) { return 1; }
+                continue;
+            }
+            if( not_matching ) { continue; }
+            if( !output_matching_( stdin_stream, begin, end, false, state ) ) { return 1; }
+            if( first_matching ) { window.erase( begin, end ); }
         }
         if( verbose ) { std::cerr << "csv-join: discarded " << discarded << " " << ( discarded == 1 ? "entry" : "entries" ) << " with no matches" << std::endl; }
         return 0;
@@ -554,6 +660,7 @@ int main( int ac, char** av )
         flag_matching = options.exists( "--flag-matching" );
         radius = options.optional< double >( "--radius,--epsilon" );
         nearest = options.exists( "--nearest" );
+        sorted = options.exists( "--sorted" );
         swap_output = options.exists( "--output-swap,--swap-output,--swap" );
         filter_id_fields_discard = options.exists( "--drop-id-fields,--drop-id" );
         if( nearest && !radius ) { std::cerr << "csv-join: if using --nearest, please specify --radius" << std::endl; return 1; }
@@ -561,8 +668,9 @@ int main( int ac, char** av )
         options.assert_mutually_exclusive( "--radius,--epsilon,--first-matching" );
         options.assert_mutually_exclusive( "--radius,--epsilon,--string,-s,--double,--time" );
         options.assert_mutually_exclusive( "--matching,--not-matching", "--drop-id-fields,--drop-id" );
+        options.assert_mutually_exclusive( "--sorted", "--block-less,--sorted-blocks" );
         stdin_csv = comma::csv::options( options );
-        std::vector< std::string > unnamed = options.unnamed( "--verbose,-v,--block-less,--first-matching,--matching,--not-matching,--string,-s,--time,--double,--strict,--swap-output,--swap,--output-swap,--nearest,--drop-id-fields,--drop-id", "-.*" );
+        std::vector< std::string > unnamed = options.unnamed( "--verbose,-v,--block-less,--sorted-blocks,--sorted,--first-matching,--matching,--not-matching,--string,-s,--time,--double,--strict,--swap-output,--swap,--output-swap,--nearest,--drop-id-fields,--drop-id", "-.*" );
         if( unnamed.empty() ) { std::cerr << "csv-join: please specify the second source" << std::endl; return 1; }
         if( unnamed.size() > 1 ) { std::cerr << "csv-join: expected one file or stream to join, got " << comma::join( unnamed, ' ' ) << std::endl; return 1; }
         comma::name_value::parser parser( "filename", ';', '=', false );
@@ -31,6 +31,7 @@
 #include <vector>
 #include <boost/lexical_cast.hpp>
 #include "../../application/command_line_options.h"
+#include "../../csv/parallel.h"
 #include "../../string/string.h"
 
 static void usage( bool verbose )
@@ -49,6 +50,7 @@ static void usage( bool verbose )
     std::cerr << "    --mangle-delimiter=<what>: mangle delimiter inside of the quotes (to unmangle later e.g. with sed)" << std::endl;
     std::cerr << "    --quote=<quote sign>; default: double quote" << std::endl;
     std::cerr << "    --unquote; remove quotes" << std::endl;
+    std::cerr << comma::csv::parallel::usage( 4 );
     std::cerr << std::endl;
     std::cerr << "example" << std::endl;
     std::cerr << "    echo -e \"x=hi there\\ny=34\" | csv-quote --delimiter = --fields ,x" << std::endl;
@@ -65,29 +67,33 @@ int main( int ac, char** av )
     {
         comma::command_line_options options( ac, av, usage );
         char delimiter = options.value( "--delimiter,-d", ',' );
+        comma::csv::parallel parallel( options );
         if( options.exists( "--mangle-delimiter" ) )
         {
             std::string mangled = options.value< std::string >( "--mangle-delimiter" );
-            while( std::cin.good() )
+            parallel( std::cin, std::cout, [&]( std::istream& is, std::ostream& os )
             {
-                std::string line;
-                std::getline( std::cin, line );
-                if( line.empty() ) { continue; }
-                bool quoted = false;
-                bool escaped = false;
-                for( char c: line ) // quick and dirty; performance should be OK, since std::cout gets flushed only on std::endl
+                while( is.good() )
                 {
-                    if( quoted && c == delimiter ) { std::cout << mangled; continue; }
-                    switch( c )
+                    std::string line;
+                    std::getline( is, line );
+                    if( line.empty() ) { continue; }
+                    bool quoted = false;
+                    bool escaped = false;
+                    for( char c: line ) // quick and dirty; performance should be OK, since std::cout gets flushed only on std::endl
                     {
-                        case '\\': escaped = !escaped; break;
-                        case '"': if( !escaped ) { quoted = !quoted; escaped = false; } break;
-                        default: if( escaped ) { escaped = false; } break;
+                        if( quoted && c == delimiter ) { os << mangled; continue; }
+                        switch( c )
+                        {
+                            case '\\': escaped = !escaped; break;
+                            case '"': if( !escaped ) { quoted = !quoted; escaped = false; } break;
+                            default: if( escaped ) { escaped = false; } break;
+                        }
+                        os << c;
                     }
-                    std::cout << c;
+                    os << std::endl;
                 }
-                std::cout << std::endl;
-            }
+            } );
             return 0;
         }
         std::set< std::size_t > fields;
@@ -107,47 +113,50 @@ int main( int ac, char** av )
         std::vector< std::string > format;
         if (options.exists("--format") ) { format = comma::split(options.value<std::string>("--format"), ','); }
         if( options.exists( "--escape" ) ) { backslash = "\\"; }
-        while( std::cin.good() )
+        parallel( std::cin, std::cout, [&]( std::istream& is, std::ostream& os )
         {
-            std::string line;
-            std::getline( std::cin, line );
-            if( line.empty() ) { continue; }
-            const std::vector< std::string >& v = comma::split( line, delimiter );
-            if (!format.empty() && format.size() != v.size()) { COMMA_THROW(comma::exception, "--format \"" << options.value<std::string>("--format") << "\" has " << format.size() << " fields but input line \"" << line << "\" has " << v.size() << " fields"); }
-            std::string comma;
-            for( std::size_t i = 0; i < v.size(); ++i )
+            while( is.good() )
             {
-                bool has_field = fields.empty() || fields.find( i ) != fields.end();
-                std::cout << comma;
-                comma = delimiter;
-                if( unquote )
-                {
-                    std::cout << ( has_field ? comma::strip( v[i], quote ) : v[i] );
-                }
-                else
+                std::string line;
+                std::getline( is, line );
+                if( line.empty() ) { continue; }
+                const std::vector< std::string >& v = comma::split( line, delimiter );
+                if (!format.empty() && format.size() != v.size()) { COMMA_THROW(comma::exception, "--format \"" << options.value<std::string>("--format") << "\" has " << format.size() << " fields but input line \"" << line << "\" has " << v.size() << " fields"); }
+                std::string comma;
+                for( std::size_t i = 0; i < v.size(); ++i )
                 {
-                    bool do_quote = false;
-                    const std::string& value = comma::strip( v[i], quote );
-                    if( has_field )
+                    bool has_field = fields.empty() || fields.find( i ) != fields.end();
+                    os << comma;
+                    comma = delimiter;
+                    if( unquote )
+                    {
+                        os << ( has_field ? comma::strip( v[i], quote ) : v[i] );
+                    }
+                    else
                     {
-                        if( format.empty() )
+                        bool do_quote = false;
+                        const std::string& value = comma::strip( v[i], quote );
+                        if( has_field )
                         {
-                            if( !( do_not_quote_empty_fields && v[i].empty() ) )
+                            if( format.empty() )
                             {
-                                do_quote = true;
-                                if( forced.find( i ) == forced.end() ) { try { boost::lexical_cast< double >( value ); do_quote = false; } catch( ... ) {} }
+                                if( !( do_not_quote_empty_fields && v[i].empty() ) )
+                                {
+                                    do_quote = true;
+                                    if( forced.find( i ) == forced.end() ) { try { boost::lexical_cast< double >( value ); do_quote = false; } catch( ... ) {} }
+                                }
+                            }
+                            else
+                            {
+                                do_quote = ( format[i][0] == 's' ); // quick and dirty
                             }
                         }
-                        else
-                        {
-                            do_quote = ( format[i][0] == 's' ); // quick and dirty
-                        }
+                        if( do_quote ) { os << backslash << quote << value << backslash << quote; } else { os << value; }
                     }
-                    if( do_quote ) { std::cout << backslash << quote << value << backslash << quote; } else { std::cout << value; }
                 }
+                os << std::endl;
             }
-            std::cout << std::endl;
-        }
+        } );
         return 0;
     }
     catch( std::exception& ex ) { std::cerr << "csv-quote: " << ex.what() << std::endl; }
@@ -14,6 +14,7 @@
 #include <boost/scoped_ptr.hpp>
 #include "../../application/command_line_options.h"
 #include "../../base/exception.h"
+#include "../../csv/parallel.h"
 #include "../../csv/stream.h"
 #include "../../csv/impl/unstructured.h"
 #include "../../math/compare.h"
@@ -53,6 +54,8 @@ void usage( bool verbose )
     std::cerr << "    --strict: if constraint field is not present among fields, exit with error (added for backward compatibility)" << std::endl;
     std::cerr << "    --verbose,-v: more output to stderr" << std::endl;
     std::cerr << "    --or: uses 'or' expression instead of 'and' (default is 'and')" << std::endl;
+    std::cerr << comma::csv::parallel::usage( 4 );
+    std::cerr << "        --first-matching and sorted constraints are not supported with --threads" << std::endl;
     std::cerr << std::endl;
     std::cerr << "fields: any non-empty fields will be treated as keys" << std::endl;
     std::cerr << std::endl;
@@ -335,12 +338,19 @@ int main( int ac, char** av )
         fields = comma::split( csv.fields, ',' );
         if( fields.size() == 1 && fields[0].empty() ) { fields.clear(); }
         std::vector< std::string > unnamed = options.unnamed( "--first-matching,--or,--sorted,--input-sorted,--not-matching,--output-all,--all,--strict,--verbose,-v,--flush"
-                                                            , "--equals,--not-equal,--less,--greater,--from,--greater-or-equal,--ge,--to,--less-or-equal,--le,--regex,--is-nan,--not-nan,--fields,-f,--binary,-b,--format,--delimiter,-d,--precision" );
+                                                            , "--equals,--not-equal,--less,--greater,--from,--greater-or-equal,--ge,--to,--less-or-equal,--le,--regex,--is-nan,--not-nan,--fields,-f,--binary,-b,--format,--delimiter,-d,--precision,--threads,--threads-chunk-size" );
         //for( unsigned int i = 0; i < unnamed.size(); constraints_map.insert( std::make_pair( comma::split( unnamed[i], ';' )[0], unnamed[i] ) ), ++i );
         bool strict = options.exists( "--strict" );
         bool first_matching = options.exists( "--first-matching" );
         bool not_matching = options.exists( "--not-matching" );
         bool all = options.exists( "--output-all,--all" );
+        comma::csv::parallel parallel( options, csv.binary() ? csv.format().size() : 0 );
+        if( parallel.threads() > 1 ) // chunks are filtered independently, thus no early exit
+        {
+            bool sorted = options.exists( "--sorted,--input-sorted" );
+            for( const auto& u: unnamed ) { for( const auto& c: comma::split( u, ';' ) ) { sorted = sorted || c == "sorted"; } }
+            COMMA_ASSERT_BRIEF( !first_matching && !sorted, "--threads: --first-matching and sorted constraints not supported" );
+        }
         for( unsigned int i = 0; i < unnamed.size(); ++i )
         {
             std::string field = comma::split( unnamed[i], ';' )[0];
@@ -356,20 +366,23 @@ int main( int ac, char** av )
             _setmode( _fileno( stdout ), _O_BINARY );
             #endif
             init_input( csv.format(), options );
-            comma::csv::binary_input_stream< input_t > istream( std::cin, csv, input );
-            while( istream.ready() || ( std::cin.good() && !std::cin.eof() ) )
+            parallel( std::cin, std::cout, [&]( std::istream& is, std::ostream& os )
             {
-                const input_t* p = istream.read();
-                if( !p || p->done( is_or ) ) { break; }
-                char match = ( p->is_a_match( is_or ) == !not_matching ) ? 1 : 0;
-                if( match || all )
+                comma::csv::binary_input_stream< input_t > istream( is, csv, input );
+                while( istream.ready() || ( is.good() && !is.eof() ) )
                 {
-                    std::cout.write( istream.last(), csv.format().size() );
-                    if( all ) { std::cout.write( &match, 1 ); }
-                    if( csv.flush ) { std::cout.flush(); }
-                    if( first_matching ) { break; }
+                    const input_t* p = istream.read();
+                    if( !p || p->done( is_or ) ) { break; }
+                    char match = ( p->is_a_match( is_or ) == !not_matching ) ? 1 : 0;
+                    if( match || all )
+                    {
+                        os.write( istream.last(), csv.format().size() );
+                        if( all ) { os.write( &match, 1 ); }
+                        if( csv.flush ) { os.flush(); }
+                        if( first_matching ) { break; }
+                    }
                 }
-            }
+            } );
         }
         else
         {
@@ -386,7 +399,6 @@ int main( int ac, char** av )
                                       : comma::csv::impl::unstructured::guess_format( line );
             if( !options.exists( "--format" ) ) { comma::say() << "guessed format from the first input line: " << format.string() << "; if you think the guess is wrong, please specify --format" << std::endl; }
             init_input( format, options );
-            comma::csv::ascii_input_stream< input_t > istream( std::cin, csv, input );
             // todo: quick and dirty: no time to debug why the commented section does not work (but that's the right way)
             std::istringstream iss( line );
             comma::csv::ascii_input_stream< input_t > isstream( iss, csv, input );
@@ -400,19 +412,23 @@ int main( int ac, char** av )
                 std::cout << std::endl;
                 if( first_matching ) { return 0; }
             }
-            while( istream.ready() || ( std::cin.good() && !std::cin.eof() ) )
+            parallel( std::cin, std::cout, [&]( std::istream& is, std::ostream& os )
             {
-                const input_t* p = istream.read();
-                if( !p || p->done( is_or ) ) { break; }
-                bool match = p->is_a_match( is_or ) == !not_matching;
-                if( match || all )
+                comma::csv::ascii_input_stream< input_t > istream( is, csv, input );
+                while( istream.ready() || ( is.good() && !is.eof() ) )
                 {
-                    std::cout << comma::join( istream.last(), csv.delimiter );
-                    if( all ) { std::cout << csv.delimiter << match; }
-                    std::cout << std::endl;
-                    if( first_matching ) { return 0; }
+                    const input_t* p = istream.read();
+                    if( !p || p->done( is_or ) ) { break; }
+                    bool match = p->is_a_match( is_or ) == !not_matching;
+                    if( match || all )
+                    {
+                        os << comma::join( istream.last(), csv.delimiter );
+                        if( all ) { os << csv.delimiter << match; }
+                        os << std::endl;
+                        if( first_matching ) { return; }
+                    }
                 }
-            }
+            } );
         }
         return 0;
     }
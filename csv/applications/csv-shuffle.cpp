@@ -13,6 +13,8 @@
 #include "../../application/command_line_options.h"
 #include "../../base/exception.h"
 #include "../../csv/options.h"
+#include "../../csv/parallel.h"
+#include "../../csv/projection.h"
 #include "../../string/string.h"
 
 static void usage( bool verbose )
@@ -33,6 +35,7 @@ options
                                           input fields see also --drop-empty
     --verbose,-v: more verbose output
 )" << std::endl;
+    std::cerr << comma::csv::parallel::usage( 4 ) << std::endl;
     std::cerr << "csv options" << std::endl;
     std::cerr << comma::csv::options::usage( verbose ) << std::endl;
 std::cerr << R"(examples
@@ -71,45 +74,41 @@ int main( int ac, char** av )
             for( ; j < input_fields.size(); ++j ) { if( input_fields[j] == n ) { return j; } }
             COMMA_THROW( comma::exception, "output field '" << n << "' not found in input fields '" << csv.fields << "'" );
         };
+        comma::csv::parallel parallel( options, csv.binary() ? csv.format().size() : 0 );
         if( csv.binary() )
         {
-            std::vector< std::pair< unsigned int, unsigned int > > offsets;
-            for( unsigned int i = 0; i < output_fields.size(); )
-            {
-                unsigned int j = find_( output_fields[i] );
-                offsets.push_back( std::make_pair( csv.format().offset( j ).offset, 0 ) );
-                for( ; i < output_fields.size() && j < input_fields.size() && input_fields[j] == output_fields[i]; ++i, ++j ) { offsets.back().second += csv.format().offset( j ).size; }
-            }
+            comma::csv::projection projection( csv.format().size() );
+            for( const auto& field: output_fields ) { unsigned int j = find_( field ); projection.push_back( csv.format().offset( j ).offset, csv.format().offset( j ).size ); }
             #ifdef WIN32
             _setmode( _fileno( stdin ), _O_BINARY );
             _setmode( _fileno( stdout ), _O_BINARY );
             #endif
-            std::vector< char > buf( csv.format().size() );
             if( !csv.flush ) { std::cin.tie( NULL ); } // quick and dirty; std::cin is tied to std::cout by default, which is thread-unsafe now
-            while( std::cin.good() && !std::cin.eof() )
+            parallel( std::cin, std::cout, [&]( std::istream& is, std::ostream& os )
             {
-                std::cin.read( &buf[0], csv.format().size() );
-                if( std::cin.gcount() == 0 ) { continue; }
-                COMMA_ASSERT_BRIEF( std::cin.gcount() >= int( csv.format().size() ), "expected " << csv.format().size() << " bytes, got only " << std::cin.gcount() );
-                for( const auto& offset: offsets ) { std::cout.write( &buf[ offset.first ], offset.second ); }
-                if( csv.flush ) { std::cout.flush(); }
-            }
+                comma::csv::projector projector( projection, 65536, csv.flush );
+                projector( is, os );
+                COMMA_ASSERT_BRIEF( projector.incomplete() == 0, "expected " << csv.format().size() << " bytes, got only " << projector.incomplete() );
+            } );
             return 0;
         }
         std::vector< unsigned int > indices;
         for( const auto& field: output_fields ) { indices.push_back( find_( field ) ); }
-        while( std::cin.good() && !std::cin.eof() )
+        parallel( std::cin, std::cout, [&]( std::istream& is, std::ostream& os )
         {
-            std::string line;
-            std::getline( std::cin, line );
-            if( !line.empty() && *line.rbegin() == '\r' ) { line = line.substr( 0, line.length() - 1 ); } // windows... sigh...
-            if( line.empty() ) { continue; }
-            const auto& v = comma::split( line, csv.delimiter );
-            COMMA_ASSERT_BRIEF( v.size() >= input_fields.size(), "expected at least " << input_fields.size() << " fields, got only " << v.size() << " in record \"" << line << "\"" );
-            std::string delimiter;
-            for( auto index: indices ) { std::cout << delimiter << v[index]; delimiter = csv.delimiter; }
-            std::cout << std::endl;
-        }
+            while( is.good() && !is.eof() )
+            {
+                std::string line;
+                std::getline( is, line );
+                if( !line.empty() && *line.rbegin() == '\r' ) { line = line.substr( 0, line.length() - 1 ); } // windows... sigh...
+                if( line.empty() ) { continue; }
+                const auto& v = comma::split( line, csv.delimiter );
+                COMMA_ASSERT_BRIEF( v.size() >= input_fields.size(), "expected at least " << input_fields.size() << " fields, got only " << v.size() << " in record \"" << line << "\"" );
+                std::string delimiter;
+                for( auto index: indices ) { os << delimiter << v[index]; delimiter = csv.delimiter; }
+                os << std::endl;
+            }
+        } );
         return 0;
     }
     catch( std::exception& ex ) { comma::say() << ex.what() << std::endl; }
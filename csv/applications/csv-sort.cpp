@@ -8,12 +8,14 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <queue>
 #include <random>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <boost/unordered_map.hpp>
 #include <boost/unordered_set.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/lexical_cast.hpp>
 #include "../../application/command_line_options.h"
 #include "../../base/exception.h"
@@ -26,6 +28,8 @@
 #include "../../name_value/parser.h"
 #include "../../string/string.h"
 #include "../../visiting/traits.h"
+#include "../../csv/impl/normalized_key.h"
+#include "../../csv/impl/radix_sort.h"
 #include "../../csv/impl/unstructured.h"
 
 static void usage( bool more )
@@ -44,6 +48,12 @@ static void usage( bool more )
     std::cerr << "               id: if present, multiple id fields accepted; output first record for each set of ids in a given block; e.g. --fields=id,a,,id" << std::endl;
     std::cerr << "               block: if present; output minimum for each contiguous block" << std::endl;
     std::cerr << "    --last: to be implemented: last line matching given keys; last line in the block, if block field present; no sorting will be done; if sorting required, use unique instead" << std::endl;
+    std::cerr << "    --max-lateness=<seconds>: sort live stream of records arriving up to <seconds> late, with bounded latency and memory;" << std::endl;
+    std::cerr << "                              the first sort key must be time; records are buffered in a heap and output as soon as their time" << std::endl;
+    std::cerr << "                              is earlier than the watermark, i.e. the latest time seen so far minus <seconds>; records earlier" << std::endl;
+    std::cerr << "                              than the watermark on arrival are discarded and their number is reported to stderr on exit;" << std::endl;
+    std::cerr << "                              with --reverse, the watermark is the earliest time seen so far plus <seconds>" << std::endl;
+    std::cerr << "                              e.g. merged sensor streams: csv-sort --fields=t,,,id --max-lateness=0.2" << std::endl;
     std::cerr << "    --min: output only record(s) with minimum value for a given field" << std::endl;
     std::cerr << "           fields" << std::endl;
     std::cerr << "               id: if present, multiple id fields accepted; output minimum for each set of ids in a given block; e.g. --fields=id,a,,id" << std::endl;
@@ -61,6 +71,10 @@ static void usage( bool more )
     std::cerr << "    --unique,-u: sort input, output only the first line matching given keys; if no sorting required, use --first for better performance" << std::endl;
     std::cerr << "    --verbose,-v: more output to stderr" << std::endl;
     std::cerr << std::endl;
+    std::cerr << "performance" << std::endl;
+    std::cerr << "    if all sort keys are integers, floating point numbers, or time, records are sorted in linear time" << std::endl;
+    std::cerr << "    with radix sort, which for large inputs is several times faster than sorting strings or mixed keys" << std::endl;
+    std::cerr << std::endl;
     std::cerr << "examples" << std::endl;
     std::cerr << "    sort by first field:" << std::endl;
     std::cerr << "        echo -e \"2\\n1\\n3\" | csv-sort --fields=a" << std::endl;
@@ -156,8 +170,24 @@ struct input_t
         }
         return false;
     }
+
+    comma::csv::impl::normalized_key key() const // keys in sort order, memcmp-comparable
+    {
+        comma::csv::impl::normalized_key k;
+        for( const auto& o: ordering )
+        {
+            switch( o.type )
+            {
+                case ordering_t::str_type: k.append( keys.strings[ o.index ] ); break;
+                case ordering_t::long_type: k.append( keys.longs[ o.index ] ); break;
+                case ordering_t::double_type: k.append( keys.doubles[ o.index ] ); break;
+                case ordering_t::time_type: k.append( keys.time[ o.index ] ); break;
+            }
+        }
+        return k;
+    }
     
-    typedef std::map< input_t, std::vector< std::string > > map;
+    typedef std::map< comma::csv::impl::normalized_key, std::vector< std::string > > map;
 };
 
 struct input_with_block : public input_t
@@ -230,6 +260,153 @@ template < typename T > static void output_( T t )
 
 template < typename It > static void output_( It it, It end ) { for( ; it != end; ++it ) { output_( it->second ); } }
 
+// records of a block with numeric or time keys only, sorted at once by radix sort rather than inserted in map
+class radix_block
+{
+    public:
+        static bool applicable() { for( const auto& o: ordering ) { if( o.type == ordering_t::str_type ) { return false; } } return true; }
+
+        radix_block( bool reverse, bool unique ): _reverse( reverse ), _unique( unique ) {}
+
+        void push( const input_t& input, const char* buf, std::size_t size )
+        {
+            for( const auto& o: ordering )
+            {
+                comma::uint64 k = 0;
+                switch( o.type )
+                {
+                    case ordering_t::long_type: k = comma::csv::impl::normalized_key::encode( input.keys.longs[ o.index ] ); break;
+                    case ordering_t::double_type: k = comma::csv::impl::normalized_key::encode( input.keys.doubles[ o.index ] ); break;
+                    case ordering_t::time_type: k = comma::csv::impl::normalized_key::encode( input.keys.time[ o.index ] ); break;
+                    case ordering_t::str_type: break; // never here
+                }
+                _keys.push_back( _reverse ? ~k : k ); // stable sort on inverted keys outputs equal keys in input order, same as reverse map traversal
+            }
+            _records.insert( _records.end(), buf, buf + size );
+            _offsets.push_back( _records.size() );
+        }
+
+        bool empty() const { return _offsets.size() == 1; }
+
+        void output()
+        {
+            if( empty() ) { return; }
+            std::size_t size = _offsets.size() - 1;
+            std::size_t width = ordering.size();
+            std::vector< std::size_t > indices = comma::csv::impl::radix_sort( _keys.data(), size, width );
+            const comma::uint64* previous = nullptr;
+            for( std::size_t i: indices )
+            {
+                const comma::uint64* key = _keys.data() + i * width;
+                if( _unique && previous && std::equal( key, key + width, previous ) ) { continue; }
+                previous = key;
+                std::cout.write( _records.data() + _offsets[i], _offsets[ i + 1 ] - _offsets[i] );
+                if( !csv.binary() ) { std::cout << std::endl; }
+            }
+            if( csv.flush ) { std::cout.flush(); }
+            _keys.clear();
+            _records.clear();
+            _offsets.resize( 1 );
+        }
+
+    private:
+        bool _reverse;
+        bool _unique;
+        std::vector< comma::uint64 > _keys;
+        std::vector< char > _records;
+        std::vector< std::size_t > _offsets{0};
+};
+
+static int handle_radix( comma::csv::input_stream< input_with_block >& istream, const std::string& first_line, const input_with_block& default_input, bool reverse, bool unique )
+{
+    radix_block records( reverse, unique );
+    if( !first_line.empty() )
+    {
+        input_with_block input = comma::csv::ascii< input_with_block >( csv, default_input ).get( first_line );
+        block.update( input );
+        records.push( input, first_line.data(), first_line.size() );
+    }
+    std::string line;
+    while( istream.ready() || ( std::cin.good() && !std::cin.eof() ) || !records.empty() )
+    {
+        const input_with_block* p = istream.read();
+        if( !p || block != *p ) { records.output(); }
+        if( !p ) { break; }
+        block.update( *p );
+        if( istream.is_binary() ) { records.push( *p, istream.binary().last(), csv.format().size() ); continue; }
+        line = comma::join( istream.ascii().last(), csv.delimiter );
+        records.push( *p, line.data(), line.size() );
+    }
+    return 0;
+}
+
+static int handle_max_lateness( comma::csv::input_stream< input_with_block >& istream, const std::string& first_line, const input_with_block& default_input, bool reverse, double max_lateness )
+{
+    if( ordering.empty() || ordering[0].type != ordering_t::time_type ) { std::cerr << "csv-sort: --max-lateness: expected the first sort key to be time, got fields: \"" << csv.fields << "\"" << std::endl; return 1; }
+    if( max_lateness < 0 ) { std::cerr << "csv-sort: --max-lateness: expected non-negative value, got: " << max_lateness << std::endl; return 1; }
+    struct entry_t
+    {
+        comma::csv::impl::normalized_key key;
+        comma::uint64 sequence;
+        boost::posix_time::ptime t;
+        std::string record;
+    };
+    auto later = [&]( const entry_t& lhs, const entry_t& rhs ) -> bool // heap top is the earliest entry; equal keys in input order
+    {
+        if( lhs.key != rhs.key ) { return reverse ? lhs.key < rhs.key : rhs.key < lhs.key; }
+        return lhs.sequence > rhs.sequence;
+    };
+    std::priority_queue< entry_t, std::vector< entry_t >, decltype( later ) > heap( later );
+    boost::posix_time::time_duration lateness = boost::posix_time::microseconds( static_cast< comma::int64 >( max_lateness * 1000000 ) );
+    boost::posix_time::ptime watermark; // nothing earlier than watermark is in the heap or will be accepted
+    comma::uint64 sequence = 0;
+    comma::uint64 discarded = 0;
+    auto earlier = [&]( const boost::posix_time::ptime& lhs, const boost::posix_time::ptime& rhs ) -> bool { return reverse ? rhs < lhs : lhs < rhs; };
+    auto output = [&]( bool all )
+    {
+        bool done = false;
+        while( !heap.empty() && ( all || earlier( heap.top().t, watermark ) ) )
+        {
+            const std::string& r = heap.top().record;
+            std::cout.write( &r[0], r.size() );
+            if( !csv.binary() ) { std::cout << std::endl; }
+            heap.pop();
+            done = true;
+        }
+        if( done && csv.flush ) { std::cout.flush(); }
+    };
+    auto push = [&]( const input_with_block& input, std::string&& record )
+    {
+        const boost::posix_time::ptime& t = input.keys.time[ ordering[0].index ];
+        if( !watermark.is_not_a_date_time() && earlier( t, watermark ) )
+        {
+            ++discarded;
+            if( verbose ) { std::cerr << "csv-sort: discarded record later than " << max_lateness << " seconds: " << boost::posix_time::to_iso_string( t ) << std::endl; }
+            return;
+        }
+        heap.push( entry_t{ input.key(), sequence++, t, std::move( record ) } );
+        boost::posix_time::ptime w = reverse ? t + lateness : t - lateness;
+        if( watermark.is_not_a_date_time() || earlier( watermark, w ) ) { watermark = w; output( false ); }
+    };
+    if( !first_line.empty() )
+    {
+        input_with_block input = comma::csv::ascii< input_with_block >( csv, default_input ).get( first_line );
+        block.update( input );
+        push( input, std::string( first_line ) );
+    }
+    while( istream.ready() || ( std::cin.good() && !std::cin.eof() ) )
+    {
+        const input_with_block* p = istream.read();
+        if( !p ) { break; }
+        if( block != *p ) { output( true ); watermark = boost::posix_time::not_a_date_time; }
+        block.update( *p );
+        push( *p, istream.is_binary() ? std::string( istream.binary().last(), csv.format().size() ) : comma::join( istream.ascii().last(), csv.delimiter ) );
+    }
+    output( true );
+    if( discarded > 0 ) { std::cerr << "csv-sort: discarded " << discarded << " record(s) later than " << max_lateness << " seconds" << std::endl; }
+    return 0;
+}
+
 static int handle_discard_out_of_order( comma::csv::input_stream< input_with_block >& istream, const std::string& first_line, const input_with_block& default_input, bool reverse )
 {
     boost::optional< input_with_block > last;
@@ -252,14 +429,14 @@ static int handle_discard_out_of_order( comma::csv::input_stream< input_with_blo
 
 static int handle_first( comma::csv::input_stream< input_with_ids_t >& istream, const std::string& first_line, const input_with_ids_t& default_input )
 {
-    typedef boost::unordered_set< comma::csv::impl::unstructured, comma::csv::impl::unstructured::hash > set_t;
-    typedef boost::unordered_map< comma::csv::impl::unstructured, set_t, comma::csv::impl::unstructured::hash > map_t;
+    typedef boost::unordered_set< comma::csv::impl::normalized_key, comma::csv::impl::normalized_key::hash > set_t;
+    typedef boost::unordered_map< comma::csv::impl::normalized_key, set_t, comma::csv::impl::normalized_key::hash > map_t;
     map_t keys;
     if( !first_line.empty() )
     { 
         input_with_ids_t input = comma::csv::ascii< input_with_ids_t >( csv, default_input ).get( first_line );
         block.update( input );
-        keys[ input.ids ].insert( input.keys );
+        keys[ comma::csv::impl::normalized_key::make( input.ids ) ].insert( input.key() );
         std::cout << first_line << std::endl;
     }
     while( istream.ready() || ( std::cin.good() && !std::cin.eof() ) )
@@ -267,7 +444,7 @@ static int handle_first( comma::csv::input_stream< input_with_ids_t >& istream,
         const input_with_ids_t* p = istream.read();
         if( !p ) { break; }
         if( block.ready( *p ) ) { block.update( *p ); keys.clear(); }
-        if( keys[ p->ids ].insert( p->keys ).second ) { output_last_( istream ); }
+        if( keys[ comma::csv::impl::normalized_key::make( p->ids ) ].insert( p->key() ).second ) { output_last_( istream ); }
     }
     return 0;
 }
@@ -282,7 +459,7 @@ static int handle_first( comma::csv::input_stream< input_with_ids_t >& istream,
 //     { 
 //         input_with_ids_t input = comma::csv::ascii< input_with_ids_t >( csv, default_input ).get( first_line );
 //         block.update( input );
-//         keys[ input.ids ].insert( input.keys );
+//         keys[ comma::csv::impl::normalized_key::make( input.ids ) ].insert( input.key() );
 //         //std::cout << first_line << std::endl;
 //     }
 //     while( istream.ready() || ( std::cin.good() && !std::cin.eof() ) )
@@ -290,7 +467,7 @@ static int handle_first( comma::csv::input_stream< input_with_ids_t >& istream,
 //         const input_with_ids_t* p = istream.read();
 //         if( !p ) { break; }
 //         if( block != *p ) { block.update( *p ); keys.clear(); }
-//         if( keys[ p->ids ].insert( p->keys ).second ) { output_last_( istream ); }
+//         if( keys[ comma::csv::impl::normalized_key::make( p->ids ) ].insert( p->key() ).second ) { output_last_( istream ); }
 //     }
 //     return 0;
 // }
@@ -299,13 +476,13 @@ static int handle_sliding_window( comma::csv::input_stream< input_with_block >&
 {
     if( sliding_window < 2 ) { std::cerr << "csv-sort: expected sliding window greater than 1, got: " << sliding_window << std::endl; return 1; }
     unsigned int count = 0;
-    typedef std::map< input_t, std::deque< std::string > > map_t;
+    typedef std::map< comma::csv::impl::normalized_key, std::deque< std::string > > map_t;
     map_t map;
     if( !first_line.empty() )
     { 
         input_with_block input = comma::csv::ascii< input_with_block >( csv, default_input ).get( first_line );
         block.update( input );
-        map_t::mapped_type& d = map[ input ];
+        map_t::mapped_type& d = map[ input.key() ];
         d.push_back( first_line );
         ++count;
     }
@@ -320,7 +497,7 @@ static int handle_sliding_window( comma::csv::input_stream< input_with_block >&
         }
         if( !p ) { break; }
         block.update( *p );
-        map_t::mapped_type& d = map[ *p ];
+        map_t::mapped_type& d = map[ p->key() ];
         if( istream.is_binary() )
         {
             d.push_back( std::string() );
@@ -367,19 +544,19 @@ struct limit_data_t
 };
 
 /// ID key to records
-typedef boost::unordered_map< comma::csv::impl::unstructured, limit_data_t, comma::csv::impl::unstructured::hash >  limit_map_t;
+typedef boost::unordered_map< comma::csv::impl::normalized_key, limit_data_t, comma::csv::impl::normalized_key::hash >  limit_map_t;
 
 /// Use to flag if a record is in the minimum map as well as the maximum map, this is true when a first new record is added (for that ID)
-typedef boost::unordered_map< comma::csv::impl::unstructured, bool, comma::csv::impl::unstructured::hash >  same_map_t;
+typedef boost::unordered_map< comma::csv::impl::normalized_key, bool, comma::csv::impl::normalized_key::hash >  same_map_t;
 static same_map_t is_same_map;
 
-std::vector< comma::csv::impl::unstructured > input_order;
+std::vector< comma::csv::impl::normalized_key > input_order;
 
 void output_current_block( const limit_map_t& min, const limit_map_t& max )
 {
     for( std::size_t i = 0; i < input_order.size(); ++i )
     {
-        const comma::csv::impl::unstructured& ids = input_order[i];
+        const comma::csv::impl::normalized_key& ids = input_order[i];
         if( is_min )
         {
             const limit_data_t& data = min.at( ids );
@@ -421,11 +598,10 @@ int handle_operations_with_ids( const comma::command_line_options& options )
         {
             ordering.push_back( ordering_t() );
             std::string type = default_input.keys.append( f.offset( k ).type ); 
-            if ( type[0] == 's' ) {      ordering.back().type = ordering_t::str_type; }
-            else if ( type[0] == 'l' ) { ordering.back().type = ordering_t::long_type; }
-            else if ( type[0] == 'd' ) { ordering.back().type = ordering_t::double_type; }
-            else if ( type[0] == 't' ) { ordering.back().type = ordering_t::time_type; }
-            ordering.back().index = keys_size;
+            if ( type[0] == 's' ) {      ordering.back().type = ordering_t::str_type; ordering.back().index = default_input.keys.strings.size() - 1; }
+            else if ( type[0] == 'l' ) { ordering.back().type = ordering_t::long_type; ordering.back().index = default_input.keys.longs.size() - 1; }
+            else if ( type[0] == 'd' ) { ordering.back().type = ordering_t::double_type; ordering.back().index = default_input.keys.doubles.size() - 1; }
+            else if ( type[0] == 't' ) { ordering.back().type = ordering_t::time_type; ordering.back().index = default_input.keys.time.size() - 1; }
             w[k] = "keys/" + type; 
             ++keys_size; 
         }
@@ -448,13 +624,14 @@ int handle_operations_with_ids( const comma::command_line_options& options )
     if (!first_line.empty()) 
     { 
         input_with_ids_t input =  comma::csv::ascii< input_with_ids_t >( csv, default_input ).get( first_line );
-        limit_data_t& data = min_map[input.ids];
+        comma::csv::impl::normalized_key ids = comma::csv::impl::normalized_key::make( input.ids );
+        limit_data_t& data = min_map[ids];
         data.keys = input;
         data.records.push_back( first_line + "\n");
         
-        max_map[input.ids] = data;
-        is_same_map[input.ids] = true;
-        input_order.push_back( input.ids );
+        max_map[ids] = data;
+        is_same_map[ids] = true;
+        input_order.push_back( ids );
         block.update( input );
         first = false;
     }
@@ -462,15 +639,16 @@ int handle_operations_with_ids( const comma::command_line_options& options )
     {
         const input_with_ids_t* p = stdin_stream.read();
         if( !p ) { break; }
+        comma::csv::impl::normalized_key ids = comma::csv::impl::normalized_key::make( p->ids );
 //         std::cerr  << "p: " << comma::join( stdin_stream.ascii().last(), csv.delimiter ) << " - " << p->keys.longs[0] << std::endl;
         if( first )
         {
-            limit_data_t& data = min_map[p->ids];
+            limit_data_t& data = min_map[ids];
             data.keys = *p;
             data.add_current_record( stdin_stream );
-            max_map[p->ids] = data;
-            is_same_map[p->ids] = true;
-            input_order.push_back( p->ids );
+            max_map[ids] = data;
+            is_same_map[ids] = true;
+            input_order.push_back( ids );
             block.update( *p );
             first = false;
         }
@@ -482,26 +660,26 @@ int handle_operations_with_ids( const comma::command_line_options& options )
             max_map.clear();
             input_order.clear();
             // Set the same record for both min and max, it's a new block, new IDs
-            limit_data_t& data = min_map[p->ids];
+            limit_data_t& data = min_map[ids];
             data.keys = *p;
             data.add_current_record( stdin_stream );
-            max_map[p->ids] = data;
-            is_same_map[p->ids] = true;
-            input_order.push_back( p->ids );
+            max_map[ids] = data;
+            is_same_map[ids] = true;
+            input_order.push_back( ids );
             block.update( *p );
         }
         else    /// The same block and not first record
         {
             if( is_min )
             {
-                limit_map_t::iterator iter = min_map.find( p->ids );
+                limit_map_t::iterator iter = min_map.find( ids );
                 if( iter == min_map.end() )
                 {
-                    limit_data_t& data = min_map[p->ids];
+                    limit_data_t& data = min_map[ids];
                     data.keys = *p;
                     data.add_current_record( stdin_stream );
-                    is_same_map[p->ids] = true;
-                    input_order.push_back( p->ids );
+                    is_same_map[ids] = true;
+                    input_order.push_back( ids );
                 }
                 else
                 {
@@ -512,21 +690,21 @@ int handle_operations_with_ids( const comma::command_line_options& options )
                         data.keys = *p;
                         data.records.clear();
                         data.add_current_record( stdin_stream );
-                        is_same_map[p->ids] = false;
+                        is_same_map[ids] = false;
                     }
                 }
             }
             if( is_max )
             {
-                limit_map_t::iterator iter = max_map.find( p->ids );
+                limit_map_t::iterator iter = max_map.find( ids );
                 if( iter == max_map.end() )
                 {
-//                     std::cerr  << "not found ids: " << p->ids.strings[0] << std::endl;
-                    limit_data_t& data = max_map[p->ids];
+//                     std::cerr  << "not found ids: " << ids.strings[0] << std::endl;
+                    limit_data_t& data = max_map[ids];
                     data.keys = *p;
                     data.add_current_record( stdin_stream );
-                    is_same_map[p->ids] = true;
-                    if( !is_min ) { input_order.push_back( p->ids ); }
+                    is_same_map[ids] = true;
+                    if( !is_min ) { input_order.push_back( ids ); }
                 }
                 else
                 {
@@ -538,7 +716,7 @@ int handle_operations_with_ids( const comma::command_line_options& options )
                         data.keys = *p;
                         data.records.clear();
                         data.add_current_record( stdin_stream );
-                        is_same_map[p->ids] = false;
+                        is_same_map[ids] = false;
                     }
                 }
             }
@@ -678,12 +856,15 @@ static int sort( const comma::command_line_options& options )
     if( options.exists( "--discard-out-of-order,--discard-unsorted" ) ) { return handle_discard_out_of_order( istream, first_line, default_input, reverse ); }
     auto sliding_window = options.optional< unsigned int >( "--sliding-window,--window" );
     if( sliding_window ) { return handle_sliding_window( istream, first_line, default_input, reverse, *sliding_window ); }
+    auto max_lateness = options.optional< double >( "--max-lateness" );
+    if( max_lateness ) { return handle_max_lateness( istream, first_line, default_input, reverse, *max_lateness ); }
+    if( radix_block::applicable() ) { if( verbose ) { std::cerr << "csv-sort: numeric or time keys only: using radix sort" << std::endl; } return handle_radix( istream, first_line, default_input, reverse, unique ); }
     input_t::map map;
     if( !first_line.empty() )
     {
         input_with_block input = comma::csv::ascii< input_with_block >( csv, default_input ).get( first_line );
         block.update( input );
-        input_t::map::mapped_type& d = map[ input ];
+        input_t::map::mapped_type& d = map[ input.key() ];
         d.push_back( first_line );
     }
     while( istream.ready() || ( std::cin.good() && !std::cin.eof() ) || !map.empty() )
@@ -700,7 +881,7 @@ static int sort( const comma::command_line_options& options )
         //std::cerr << "==> c: block: " << block() << " current_size: " << block.current_size() << std::endl;
         block.update( *p );
         //std::cerr << "==> d: block: " << block() << " current_size: " << block.current_size() << std::endl;
-        input_t::map::mapped_type& d = map[ *p ];
+        input_t::map::mapped_type& d = map[ p->key() ];
         if( unique && !d.empty() ) { continue; }
         if( istream.is_binary() )
         {
@@ -721,8 +902,8 @@ int main( int ac, char** av )
     try
     {
         comma::command_line_options options( ac, av, usage );
-        options.assert_mutually_exclusive( "--discard-out-of-order,--discard-unsorted,--first,--min,--sliding-window,--window,--unique,--random" );
-        options.assert_mutually_exclusive( "--discard-out-of-order,--discard-unsorted,--first,--max,--sliding-window,--window,--unique,--random" );
+        options.assert_mutually_exclusive( "--discard-out-of-order,--discard-unsorted,--first,--min,--sliding-window,--window,--max-lateness,--unique,--random" );
+        options.assert_mutually_exclusive( "--discard-out-of-order,--discard-unsorted,--first,--max,--sliding-window,--window,--max-lateness,--unique,--random" );
         if( options.exists( "--last" ) ) { std::cerr << "csv-sort: --last: not implemented; todo" << std::endl; return 1; }
         verbose = options.exists( "--verbose,-v" );
         csv = comma::csv::options( options );
@@ -10,6 +10,7 @@
 
 #include "../../application/command_line_options.h"
 #include "../../base/exception.h"
+#include "../../csv/parallel.h"
 #include "../../csv/stream.h"
 #include "../../csv/traits.h"
 #include "../../io/impl/filesystem.h"
@@ -35,6 +36,8 @@ static void usage( bool verbose )
     std::cerr << "                         unless different semantics specified for operation\n";
     std::cerr << "                         default: perform operation on the first field\n";
     std::cerr << "    --strict; exit on strings on which operation does not make sense\n";
+    std::cerr << comma::csv::parallel::usage( 4 );
+    std::cerr << "        path-common does not support --threads\n";
     std::cerr << '\n';
     std::cerr << "add\n";
     std::cerr << "    options\n";
@@ -114,34 +117,39 @@ static int run( const comma::command_line_options& options )
     }
     ::csv.fields = n == 0 ? std::string( "values[0]" ) : comma::join( v, ',' );
     if( n == 0 ) { ++n; }
-    comma::csv::input_stream< input > istream( std::cin, ::csv, input( n ) );
-    std::function< void( const typename T::output_t& p ) > write;
-    auto run_ = [&]() -> int
+    comma::csv::parallel parallel( options, ::csv.binary() ? ::csv.format().size() : 0 );
+    parallel( std::cin, std::cout, [&]( std::istream& is, std::ostream& os )
     {
-        T t( options );
-        while( istream.ready() || std::cin.good() )
+        comma::csv::input_stream< input > istream( is, ::csv, input( n ) );
+        std::function< void( const typename T::output_t& p ) > write;
+        auto run_ = [&]()
+        {
+            T t( options );
+            while( istream.ready() || is.good() )
+            {
+                const input* p = istream.read();
+                if( !p ) { break; }
+                typename T::output_t r( n );
+                for( unsigned int i = 0; i < p->values.size(); ++i ) { r.values[i] = t.convert( p->values[i] ); }
+                write( r );
+                if( ::csv.flush ) { os.flush(); }
+            }
+        };
+        if( options.exists( "--emplace" ) )
         {
-            const input* p = istream.read();
-            if( !p ) { break; }
-            typename T::output_t r( n );
-            for( unsigned int i = 0; i < p->values.size(); ++i ) { r.values[i] = t.convert( p->values[i] ); }
-            write( r );
-            if( ::csv.flush ) { std::cout.flush(); }
+            comma::csv::passed< input > passed( istream, os, ::csv.flush );
+            write = [&]( const typename T::output_t& p ) { passed.write( p ); };
+            run_();
+            return;
         }
-        return 0;
-    };
-    if( options.exists( "--emplace" ) )
-    {
-        comma::csv::passed< input > passed( istream, std::cout, ::csv.flush );
-        write = [&]( const typename T::output_t& p ) { passed.write( p ); };
-        return run_();
-    }
-    comma::csv::options output_csv = ::csv;
-    output_csv.fields = "values";
-    comma::csv::output_stream< typename T::output_t > ostream( std::cout, output_csv, input( n ) );
-    comma::csv::tied< input, typename T::output_t > tied( istream, ostream );
-    write = [&]( const typename T::output_t& p ) { tied.append( p ); };
-    return run_();
+        comma::csv::options output_csv = ::csv;
+        output_csv.fields = "values";
+        comma::csv::output_stream< typename T::output_t > ostream( os, output_csv, input( n ) );
+        comma::csv::tied< input, typename T::output_t > tied( istream, ostream );
+        write = [&]( const typename T::output_t& p ) { tied.append( p ); };
+        run_();
+    } );
+    return 0;
 }
 
 namespace path {
@@ -44,6 +44,7 @@
 #include "../../application/command_line_options.h"
 #include "../../base/exception.h"
 #include "../../base/types.h"
+#include "../../csv/parallel.h"
 #include "../../csv/stream.h"
 #include "../../csv/impl/epoch.h"
 #include "../../string/string.h"
@@ -66,6 +67,7 @@ static void usage( bool )
                  "\n                        e.g. \"1,5,7\" or \"a,b,,d\""
                  "\n                        defaults to \"a\" (first field only is datetime)"
                  "\n    --empty-as-not-a-date-time,--accept-empty,-e: if time field is empty, consider it as not-a-date-time"
+                 "\n" << comma::csv::parallel::usage( 4 ) <<
                  "\n"
                  "\nNote: no --binary option, do not use this utility on binary; instead read as unsigned long-long (time in microseconds)"
                  "\n"
@@ -455,11 +457,11 @@ static void init_input()
     input.values.resize( size );
 }
 
-static int run()
+static int run( std::istream& is, std::ostream& os )
 {
-    comma::csv::input_stream< input_t > istream( std::cin, csv, input );
-    comma::csv::output_stream< input_t > ostream( std::cout, csv, input );
-    while( istream.ready() || ( std::cin.good() && !std::cin.eof() ) )
+    comma::csv::input_stream< input_t > istream( is, csv, input );
+    comma::csv::output_stream< input_t > ostream( os, csv, input );
+    while( istream.ready() || ( is.good() && !is.eof() ) )
     {
         const input_t* p = istream.read();
         if( !p ) { break; }
@@ -488,7 +490,9 @@ int main( int ac, char** av )
         else if ( options.exists( "--to-seconds,--sec,-s" ) ) { from = iso; to = seconds; }
         else { from = what( "--from", options ); to = what( "--to", options ); }
         if( guess == to ) { std::cerr << "csv-time: please specify valid --to" << std::endl; return 1; }
-        return run();
+        comma::csv::parallel parallel( options );
+        parallel( std::cin, std::cout, run );
+        return 0;
     }
     catch( std::exception& ex ) { std::cerr << "csv-time: " << ex.what() << std::endl; }
     catch( ... ) { std::cerr << "csv-time: unknown exception" << std::endl; }
@@ -28,6 +28,7 @@
 
 #include "../../application/command_line_options.h"
 #include "../../base/exception.h"
+#include "../../csv/parallel.h"
 #include "../../csv/stream.h"
 #include "../../visiting/traits.h"
 
@@ -85,6 +86,7 @@ static void usage(char const * const txt = "")
 
     if( 0 != txt[0] ) std::cerr << "error: " << txt << std::endl;
     std::cerr << msg_general << std::endl; // endl to make this function easier to debug by flushing
+    std::cerr << comma::csv::parallel::usage( 4 );
     std::cerr << "\ncsv options\n" << comma::csv::options::usage() << std::endl;
     std::cerr << msg_examples << std::endl;
     exit( 1 );
@@ -436,11 +438,11 @@ static void init_input()
     input.values.resize( input_fields.size() ); //input.values.resize( size );
 }
 
-static int scale_and_offset( double factor, double offset )
+static int scale_and_offset( std::istream& is, std::ostream& os, double factor, double offset )
 {
-    comma::csv::input_stream< input_t > istream( std::cin, csv, input );
-    comma::csv::output_stream< input_t > ostream( std::cout, csv, input );
-    while( istream.ready() || ( std::cin.good() && !std::cin.eof() ) )
+    comma::csv::input_stream< input_t > istream( is, csv, input );
+    comma::csv::output_stream< input_t > ostream( os, csv, input );
+    while( istream.ready() || ( is.good() && !is.eof() ) )
     {
         const input_t* p = istream.read();
         if( !p ) { break; }
@@ -451,16 +453,16 @@ static int scale_and_offset( double factor, double offset )
     return 0;
 }
 
-static int run( const units::et from, const units::et to )
+static int run( std::istream& is, std::ostream& os, const units::et from, const units::et to )
 {
-    comma::csv::input_stream< input_t > istream( std::cin, csv, input );
-    comma::csv::output_stream< input_t > ostream( std::cout, csv, input );
+    comma::csv::input_stream< input_t > istream( is, csv, input );
+    comma::csv::output_stream< input_t > ostream( os, csv, input );
 
     units::cast_function const default_cast_function = units::cast_lookup( from, to );
     if (NULL == default_cast_function) { COMMA_THROW( comma::exception, "unsupported default conversion from " << debug_name(from) << " to " << debug_name(to) ); }
 
     unsigned line = 0;
-    while( istream.ready() || ( std::cin.good() && !std::cin.eof() ) )
+    while( istream.ready() || ( is.good() && !is.eof() ) )
     {
         const input_t* p = istream.read();
         if( !p ) { break; }
@@ -497,7 +499,8 @@ int main( int ac, char** av )
         init_input();
         boost::optional< double > scale_factor = options.optional< double >( "--scale" );
         boost::optional< double > offset = options.optional< double >( "--offset" );
-        if( scale_factor || offset ) { return scale_and_offset( scale_factor ? *scale_factor : 1, offset ? *offset : 0 ); }
+        comma::csv::parallel parallel( options, csv.binary() ? csv.format().size() : 0 );
+        if( scale_factor || offset ) { parallel( std::cin, std::cout, [&]( std::istream& is, std::ostream& os ) { scale_and_offset( is, os, scale_factor ? *scale_factor : 1, offset ? *offset : 0 ); } ); return 0; }
         units::et from = units::metres; // quick and dirty: to avoid compilation warning
         units::et to = units::metres; // quick and dirty: to avoid compilation warning
         if( csv.fields.find( "/units" ) == std::string::npos )
@@ -514,7 +517,8 @@ int main( int ac, char** av )
             from = !options.exists( "--from" ) ? to : units::value( options.value< std::string >( "--from" ) );
         }
         if( !units::can_convert( from, to ) ) { std::cerr << "csv-units: don't know how to convert " << units::name(from) << " to " << units::name(to) << std::endl; return 1; }
-        return run( from, to );
+        parallel( std::cin, std::cout, [&]( std::istream& is, std::ostream& os ) { run( is, os, from, to ); } );
+        return 0;
     }
     catch( std::exception& ex ) { std::cerr << "csv-units: caught: " << ex.what() << std::endl; }
     catch( ... ) { std::cerr << "csv-units: unknown exception" << std::endl; }
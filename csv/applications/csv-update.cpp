@@ -16,6 +16,7 @@
 #include "../../application/command_line_options.h"
 #include "../../base/types.h"
 #include "../../csv/stream.h"
+#include "../../csv/impl/normalized_key.h"
 #include "../../csv/impl/unstructured.h"
 #include "../../io/stream.h"
 #include "../../string/string.h"
@@ -138,7 +139,7 @@ struct map_t
         value_type() {}
         value_type( unsigned int index, const input_t& value, const std::string& string ) : index( index ), value( value ), string( string ) {}
     };
-    typedef boost::unordered_map< comma::csv::impl::unstructured, std::vector< value_type >, comma::csv::impl::unstructured::hash > type;
+    typedef boost::unordered_map< comma::csv::impl::normalized_key, std::vector< value_type >, comma::csv::impl::normalized_key::hash > type;
 };
 
 namespace comma { namespace visiting {
@@ -234,7 +235,7 @@ static void read_filter_block()
             if( csv.binary() ) { s.resize( csv.format().size() ); ::memcpy( &s[0], filter_stream->binary().last(), csv.format().size() ); }
             else { s = comma::join( filter_stream->ascii().last(), csv.delimiter ) + '\n'; }
         }
-        filter_map[ last->key ].push_back( map_t::value_type( count++, *last, s ) );
+        filter_map[ comma::csv::impl::normalized_key::make( last->key ) ].push_back( map_t::value_type( count++, *last, s ) );
         //if( d.size() > 1 ) {}
         if( verbose ) { if( count % 10000 == 0 ) { std::cerr << "csv-update: reading block " << block << "; loaded " << count << " point[s]; hash map size: " << filter_map.size() << std::endl; } }
         last = filter_stream->read();
@@ -276,7 +277,7 @@ static void update( const input_t& v, const comma::csv::input_stream< input_t >&
         std::string s;
         if( csv.binary() ) { s.resize( csv.format().size() ); ::memcpy( &s[0], istream.binary().last(), csv.format().size() ); }
         else { s = last.empty() ? comma::join( istream.ascii().last(), csv.delimiter ) : last; }
-        std::vector< map_t::value_type >& e = values[ v.key ];
+        std::vector< map_t::value_type >& e = values[ comma::csv::impl::normalized_key::make( v.key ) ];
         
         input_t current = v;
         if( !e.empty() ) 
@@ -290,7 +291,7 @@ static void update( const input_t& v, const comma::csv::input_stream< input_t >&
     }
     else if( has_filter )
     {
-        map_t::type::const_iterator it = filter_map.find( v.key );
+        map_t::type::const_iterator it = filter_map.find( comma::csv::impl::normalized_key::make( v.key ) );
         if( it == filter_map.end() || it->second.empty() )
         {
             if( last.empty() ) { output_last( istream ); }
@@ -315,10 +316,11 @@ static void update( const input_t& v, const comma::csv::input_stream< input_t >&
             std::string s;
             if( csv.binary() ) { s.resize( csv.format().size() ); ::memcpy( &s[0], istream.binary().last(), csv.format().size() ); }
             else { s = comma::join( istream.ascii().last(), csv.delimiter ); }
-            map_t::type::iterator it = values.find( v.key );
+            comma::csv::impl::normalized_key key = comma::csv::impl::normalized_key::make( v.key );
+            map_t::type::iterator it = values.find( key );
             if( it == values.end() )
             {
-                values[ v.key ].push_back( map_t::value_type( index++, v, s ) );
+                values[ key ].push_back( map_t::value_type( index++, v, s ) );
                 if( !last_only ) { ostream.write( v, s ); }
             }
             else
@@ -331,7 +333,7 @@ static void update( const input_t& v, const comma::csv::input_stream< input_t >&
         }
         else
         {
-            values[ v.key ].push_back( map_t::value_type( index++, v, last ) );
+            values[ comma::csv::impl::normalized_key::make( v.key ) ].push_back( map_t::value_type( index++, v, last ) );
             if( !last_only ) { ostream.write( v, last ); }
         }
     }
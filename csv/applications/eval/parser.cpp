@@ -0,0 +1,417 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <cstdlib>
+#include <limits>
+#include <unordered_set>
+#include "parser.h"
+
+namespace comma { namespace csv { namespace applications { namespace eval {
+
+namespace {
+
+struct token
+{
+    enum kinds { number, name, op, newline, end };
+    kinds kind{end};
+    std::string text;
+    eval::literal literal;
+};
+
+static bool is_name_start( char c ) { return ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || c == '_'; }
+
+static bool is_name_char( char c ) { return is_name_start( c ) || ( c >= '0' && c <= '9' ); }
+
+static bool is_digit( char c, unsigned int base )
+{
+    switch( base )
+    {
+        case 2: return c == '0' || c == '1';
+        case 8: return c >= '0' && c <= '7';
+        case 10: return c >= '0' && c <= '9';
+        default: return ( c >= '0' && c <= '9' ) || ( c >= 'a' && c <= 'f' ) || ( c >= 'A' && c <= 'F' );
+    }
+}
+
+static unsigned int digit_value( char c ) { return c <= '9' ? c - '0' : ( c | 0x20 ) - 'a' + 10; }
+
+static const std::unordered_set< std::string >& keywords()
+{
+    static const std::unordered_set< std::string > k = { "None", "and", "as", "assert", "async", "await", "break", "class", "continue", "def", "del", "elif", "else", "except", "finally", "for", "from", "global", "if", "import", "in", "is", "lambda", "nonlocal", "not", "or", "pass", "raise", "return", "try", "while", "with", "yield" };
+    return k;
+}
+
+class lexer
+{
+    public:
+        lexer( const std::string& s, bool indent ) : s_( s ), indent_( indent ) {}
+
+        std::vector< token > tokens()
+        {
+            std::vector< token > t;
+            while( true )
+            {
+                token k = next_();
+                t.push_back( k );
+                if( k.kind == token::end ) { return t; }
+            }
+        }
+
+    private:
+        const std::string& s_;
+        bool indent_; // whether leading whitespace is allowed, as in python eval()
+        std::size_t i_{0};
+        unsigned int depth_{0};
+        bool line_start_{true};
+
+        char peek_( std::size_t offset = 0 ) const { return i_ + offset < s_.size() ? s_[ i_ + offset ] : 0; }
+
+        token next_()
+        {
+            while( true )
+            {
+                std::size_t begin = i_;
+                while( peek_() == ' ' || peek_() == '\t' || peek_() == '\r' || peek_() == '\f' ) { ++i_; }
+                if( peek_() == '#' ) { while( i_ < s_.size() && s_[i_] != '\n' ) { ++i_; } }
+                if( peek_() == '\\' && peek_( 1 ) == '\n' ) { i_ += 2; continue; }
+                if( i_ == s_.size() ) { token t; t.kind = token::end; return t; }
+                if( s_[i_] == '\n' )
+                {
+                    ++i_;
+                    if( depth_ > 0 || line_start_ ) { line_start_ = depth_ == 0; continue; }
+                    line_start_ = true;
+                    token t; t.kind = token::newline; return t;
+                }
+                if( line_start_ && depth_ == 0 && i_ > begin && !indent_ ) { throw unsupported( "unexpected indent" ); }
+                line_start_ = false;
+                break;
+            }
+            char c = s_[i_];
+            if( ( c >= '0' && c <= '9' ) || ( c == '.' && peek_( 1 ) >= '0' && peek_( 1 ) <= '9' ) ) { return number_(); }
+            if( is_name_start( c ) )
+            {
+                token t;
+                t.kind = token::name;
+                while( is_name_char( peek_() ) ) { t.text += s_[ i_++ ]; }
+                if( keywords().count( t.text ) ) { throw unsupported( "python keyword '" + t.text + "' not supported" ); }
+                return t;
+            }
+            if( c < 0 ) { throw unsupported( "non-ascii character in expression" ); }
+            if( c == '\'' || c == '"' ) { throw unsupported( "strings not supported" ); }
+            static const char* ops[] = { "**=", "//=", ">>=", "<<=", "**", "//", ">>", "<<", "<=", ">=", "==", "!=", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "@=", "->", ":=", "+", "-", "*", "/", "%", "&", "|", "^", "~", "<", ">", "=", "(", ")", ",", ";", ".", "[", "]", "{", "}", ":", "@", "!" };
+            for( const char* op: ops )
+            {
+                std::size_t size = std::char_traits< char >::length( op );
+                if( s_.compare( i_, size, op ) != 0 ) { continue; }
+                i_ += size;
+                token t;
+                t.kind = token::op;
+                t.text = op;
+                if( t.text == "(" || t.text == "[" || t.text == "{" ) { ++depth_; }
+                else if( t.text == ")" || t.text == "]" || t.text == "}" ) { if( depth_ == 0 ) { throw unsupported( "unmatched '" + t.text + "'" ); } --depth_; }
+                return t;
+            }
+            throw unsupported( std::string( "unexpected character '" ) + c + "'" );
+        }
+
+        std::string digits_( unsigned int base ) // digits with single underscores between them
+        {
+            std::string d;
+            while( true )
+            {
+                if( is_digit( peek_(), base ) ) { d += s_[ i_++ ]; continue; }
+                if( peek_() == '_' && !d.empty() && is_digit( peek_( 1 ), base ) ) { ++i_; continue; }
+                return d;
+            }
+        }
+
+        token number_()
+        {
+            token t;
+            t.kind = token::number;
+            unsigned int base = 10;
+            if( peek_() == '0' )
+            {
+                char p = peek_( 1 ) | 0x20;
+                if( p == 'x' ) { base = 16; }
+                else if( p == 'o' ) { base = 8; }
+                else if( p == 'b' ) { base = 2; }
+                if( base != 10 ) { i_ += 2; if( peek_() == '_' ) { ++i_; } }
+            }
+            std::string whole = digits_( base );
+            std::string text = whole;
+            bool real = false;
+            if( base == 10 )
+            {
+                if( peek_() == '.' ) { ++i_; text += '.' + digits_( 10 ); real = true; }
+                if( ( peek_() | 0x20 ) == 'e' )
+                {
+                    std::size_t j = i_ + 1;
+                    if( j < s_.size() && ( s_[j] == '+' || s_[j] == '-' ) ) { ++j; }
+                    if( j < s_.size() && is_digit( s_[j], 10 ) )
+                    {
+                        text += 'e';
+                        if( s_[ i_ + 1 ] == '-' ) { text += '-'; }
+                        i_ = j;
+                        text += digits_( 10 );
+                        real = true;
+                    }
+                }
+            }
+            if( ( peek_() | 0x20 ) == 'j' ) { throw unsupported( "complex numbers not supported" ); }
+            if( is_name_char( peek_() ) || peek_() == '.' ) { throw unsupported( "invalid number" ); }
+            if( real ) { t.literal = eval::literal::make( std::strtod( text.c_str(), nullptr ) ); return t; }
+            if( whole.empty() ) { throw unsupported( "invalid number" ); }
+            if( base == 10 && whole.size() > 1 && whole[0] == '0' && whole.find_first_not_of( '0' ) != std::string::npos ) { throw unsupported( "leading zeros in decimal integer literals are not permitted" ); }
+            comma::uint64 v = 0;
+            for( char c: whole )
+            {
+                comma::uint64 d = digit_value( c );
+                if( v > ( comma::uint64( std::numeric_limits< comma::int64 >::max() ) - d ) / base ) { throw unsupported( "integer literal " + whole + " does not fit 64 bits" ); }
+                v = v * base + d;
+            }
+            t.literal = eval::literal::make( comma::int64( v ) );
+            return t;
+        }
+};
+
+class parser
+{
+    public:
+        parser( const std::string& code, bool indent = false ) : tokens_( lexer( code, indent ).tokens() ) {}
+
+        std::vector< statement > statements()
+        {
+            std::vector< statement > s;
+            while( true )
+            {
+                while( is_( token::newline ) || is_op_( ";" ) ) { ++i_; }
+                if( is_( token::end ) ) { return s; }
+                s.push_back( statement_() );
+                if( !is_( token::newline ) && !is_op_( ";" ) && !is_( token::end ) ) { throw unsupported( "invalid syntax" ); }
+            }
+        }
+
+        expression single_expression()
+        {
+            while( is_( token::newline ) ) { ++i_; }
+            expression e = testlist_();
+            while( is_( token::newline ) ) { ++i_; }
+            if( !is_( token::end ) ) { throw unsupported( "invalid syntax" ); }
+            return e;
+        }
+
+    private:
+        std::vector< token > tokens_;
+        std::size_t i_{0};
+
+        const token& current_() const { return tokens_[i_]; }
+        bool is_( token::kinds k ) const { return current_().kind == k; }
+        bool is_op_( const char* op ) const { return is_( token::op ) && current_().text == op; }
+        void expect_( const char* op ) { if( !is_op_( op ) ) { throw unsupported( std::string( "expected '" ) + op + "'" ); } ++i_; }
+
+        static std::vector< std::string > target_( const expression& e )
+        {
+            if( e.kind == expression::variable ) { return { e.name }; }
+            if( e.kind != expression::tuple ) { throw unsupported( "cannot assign to expression" ); }
+            std::vector< std::string > names;
+            for( const auto& o: e.operands )
+            {
+                if( o.kind != expression::variable ) { throw unsupported( "only names or tuples of names can be assigned to" ); }
+                names.push_back( o.name );
+            }
+            return names;
+        }
+
+        statement statement_()
+        {
+            statement s;
+            expression e = testlist_();
+            static const std::unordered_set< std::string > augmented = { "+=", "-=", "*=", "/=", "//=", "%=", "**=", "&=", "|=", "^=", "<<=", ">>=" };
+            if( is_( token::op ) && augmented.count( current_().text ) )
+            {
+                if( e.kind != expression::variable ) { throw unsupported( "augmented assignment to expression not supported" ); }
+                s.op = current_().text.substr( 0, current_().text.size() - 1 );
+                ++i_;
+                s.targets.push_back( { e.name } );
+                s.value = test_();
+                return s;
+            }
+            while( is_op_( "=" ) )
+            {
+                ++i_;
+                s.targets.push_back( target_( e ) );
+                e = testlist_();
+            }
+            s.value = e;
+            return s;
+        }
+
+        expression testlist_()
+        {
+            expression e = test_();
+            if( !is_op_( "," ) ) { return e; }
+            expression t;
+            t.kind = expression::tuple;
+            t.operands.push_back( e );
+            while( is_op_( "," ) )
+            {
+                ++i_;
+                if( !starts_expression_() ) { break; }
+                t.operands.push_back( test_() );
+            }
+            return t;
+        }
+
+        bool starts_expression_() const
+        {
+            if( is_( token::number ) || is_( token::name ) ) { return true; }
+            return is_op_( "(" ) || is_op_( "-" ) || is_op_( "+" ) || is_op_( "~" );
+        }
+
+        expression test_() { return comparison_(); }
+
+        static expression make_( expression::kinds kind, const std::string& op, expression a, expression b )
+        {
+            expression e;
+            e.kind = kind;
+            e.name = op;
+            e.operands.push_back( std::move( a ) );
+            e.operands.push_back( std::move( b ) );
+            return e;
+        }
+
+        expression comparison_()
+        {
+            expression e = or_();
+            static const std::unordered_set< std::string > ops = { "<", ">", "<=", ">=", "==", "!=" };
+            if( !is_( token::op ) || !ops.count( current_().text ) ) { return e; }
+            std::string op = current_().text;
+            ++i_;
+            e = make_( expression::comparison, op, e, or_() );
+            if( is_( token::op ) && ops.count( current_().text ) ) { throw unsupported( "chained comparisons not supported" ); }
+            return e;
+        }
+
+        template < typename F > expression binary_( F next, std::initializer_list< const char* > ops )
+        {
+            expression e = ( this->*next )();
+            while( true )
+            {
+                const char* found = nullptr;
+                for( const char* op: ops ) { if( is_op_( op ) ) { found = op; break; } }
+                if( !found ) { return e; }
+                ++i_;
+                e = make_( expression::binary, found, e, ( this->*next )() );
+            }
+        }
+
+        expression or_() { return binary_( &parser::xor_, { "|" } ); }
+        expression xor_() { return binary_( &parser::and_, { "^" } ); }
+        expression and_() { return binary_( &parser::shift_, { "&" } ); }
+        expression shift_() { return binary_( &parser::arithmetic_, { "<<", ">>" } ); }
+        expression arithmetic_() { return binary_( &parser::term_, { "+", "-" } ); }
+        expression term_() { if( is_op_( "@" ) ) { throw unsupported( "matrix multiplication not supported" ); } return binary_( &parser::factor_, { "*", "//", "/", "%" } ); }
+
+        expression factor_()
+        {
+            if( is_op_( "-" ) || is_op_( "+" ) || is_op_( "~" ) )
+            {
+                expression e;
+                e.kind = expression::unary;
+                e.name = current_().text;
+                ++i_;
+                e.operands.push_back( factor_() );
+                return e;
+            }
+            return power_();
+        }
+
+        expression power_()
+        {
+            expression e = primary_();
+            if( !is_op_( "**" ) ) { return e; }
+            ++i_;
+            return make_( expression::binary, "**", e, factor_() );
+        }
+
+        expression primary_()
+        {
+            expression e = atom_();
+            while( true )
+            {
+                if( is_op_( "." ) ) { throw unsupported( "attributes not supported" ); }
+                if( is_op_( "[" ) ) { throw unsupported( "subscripts not supported" ); }
+                if( !is_op_( "(" ) ) { return e; }
+                if( e.kind != expression::variable ) { throw unsupported( "only functions can be called" ); }
+                ++i_;
+                expression c;
+                c.kind = expression::call;
+                c.name = e.name;
+                while( !is_op_( ")" ) )
+                {
+                    if( is_op_( "*" ) || is_op_( "**" ) ) { throw unsupported( "argument unpacking not supported" ); }
+                    if( is_( token::name ) && tokens_[ i_ + 1 ].kind == token::op && tokens_[ i_ + 1 ].text == "=" ) { throw unsupported( "keyword arguments not supported" ); }
+                    c.operands.push_back( test_() );
+                    if( is_op_( ")" ) ) { break; }
+                    expect_( "," );
+                }
+                ++i_;
+                e = c;
+            }
+        }
+
+        expression atom_()
+        {
+            const token& t = current_();
+            expression e;
+            switch( t.kind )
+            {
+                case token::number:
+                    e.literal = t.literal;
+                    ++i_;
+                    return e;
+                case token::name:
+                    ++i_;
+                    if( t.text == "True" || t.text == "False" ) { e.literal = eval::literal::make( t.text == "True" ); return e; }
+                    e.kind = expression::variable;
+                    e.name = t.text;
+                    return e;
+                case token::op:
+                    if( t.text == "(" )
+                    {
+                        ++i_;
+                        if( is_op_( ")" ) ) { throw unsupported( "empty tuples not supported" ); }
+                        e = testlist_();
+                        expect_( ")" );
+                        return e;
+                    }
+                    throw unsupported( "unexpected '" + t.text + "'" );
+                default:
+                    throw unsupported( "unexpected end of expression" );
+            }
+        }
+};
+
+} // namespace {
+
+std::vector< statement > parse( const std::string& code ) { return parser( code ).statements(); }
+
+expression parse_expression( const std::string& code ) { return parser( code, true ).single_expression(); }
+
+std::vector< std::string > assigned_names( const std::vector< statement >& statements )
+{
+    std::vector< std::string > names;
+    std::unordered_set< std::string > seen;
+    for( const auto& s: statements )
+    {
+        for( const auto& t: s.targets )
+        {
+            for( const auto& n: t ) { if( seen.insert( n ).second ) { names.push_back( n ); } }
+        }
+    }
+    return names;
+}
+
+} } } } // namespace comma { namespace csv { namespace applications { namespace eval {
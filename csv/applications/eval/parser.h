@@ -0,0 +1,43 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "types.h"
+
+namespace comma { namespace csv { namespace applications { namespace eval {
+
+/// syntax tree of the python expression subset: literals, names, arithmetic, bitwise, and comparison
+/// operators with python precedence, and calls of functions by name
+struct expression
+{
+    enum kinds { constant, variable, unary, binary, comparison, call, tuple };
+
+    kinds kind{constant};
+    std::string name; ///< variable name, function name, or operator, e.g. "//"
+    eval::literal literal; ///< value of constant
+    std::vector< expression > operands;
+};
+
+/// assignment statement, e.g. "a = b = x + 1", "a, b = b, a + b", "a += 1", or a bare expression
+struct statement
+{
+    std::vector< std::vector< std::string > > targets; ///< assignment targets from left to right, each a name or a tuple of names
+    std::string op; ///< operator of augmented assignment, e.g. "+" for "+=", empty for plain assignment
+    expression value;
+};
+
+/// parse statements separated by semicolons or newlines
+/// @throw unsupported on syntax errors and on python constructs outside of the subset, e.g. strings, attributes, or indentation
+std::vector< statement > parse( const std::string& code );
+
+/// parse a single expression, e.g. select condition
+expression parse_expression( const std::string& code );
+
+/// @return names assigned by statements in the order of their first appearance, same as python csv-eval
+std::vector< std::string > assigned_names( const std::vector< statement >& statements );
+
+} } } } // namespace comma { namespace csv { namespace applications { namespace eval {
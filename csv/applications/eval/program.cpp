@@ -0,0 +1,1058 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include "../../../base/exception.h"
+#include "program.h"
+
+namespace comma { namespace csv { namespace applications { namespace eval {
+
+const char* name( type_t t )
+{
+    switch( t )
+    {
+        case type_t::boolean: return "bool";
+        case type_t::int8: return "int8";
+        case type_t::uint8: return "uint8";
+        case type_t::int16: return "int16";
+        case type_t::uint16: return "uint16";
+        case type_t::int32: return "int32";
+        case type_t::uint32: return "uint32";
+        case type_t::int64: return "int64";
+        case type_t::uint64: return "uint64";
+        case type_t::float32: return "float32";
+        case type_t::float64: return "float64";
+        case type_t::time: return "datetime64[us]";
+    }
+    return "unknown";
+}
+
+unsigned int size_of( type_t t )
+{
+    switch( t )
+    {
+        case type_t::boolean: case type_t::int8: case type_t::uint8: return 1;
+        case type_t::int16: case type_t::uint16: return 2;
+        case type_t::int32: case type_t::uint32: case type_t::float32: return 4;
+        default: return 8;
+    }
+}
+
+bool from_format( const std::string& s, type_t& t )
+{
+    static const std::map< std::string, type_t > types = { { "b", type_t::int8 }, { "ub", type_t::uint8 }, { "w", type_t::int16 }, { "uw", type_t::uint16 }
+                                                          , { "i", type_t::int32 }, { "ui", type_t::uint32 }, { "l", type_t::int64 }, { "ul", type_t::uint64 }
+                                                          , { "f", type_t::float32 }, { "d", type_t::float64 }, { "t", type_t::time } };
+    auto it = types.find( s );
+    if( it == types.end() ) { return false; }
+    t = it->second;
+    return true;
+}
+
+const char* to_format( type_t t )
+{
+    switch( t )
+    {
+        case type_t::boolean: case type_t::int8: return "b";
+        case type_t::uint8: return "ub";
+        case type_t::int16: return "w";
+        case type_t::uint16: return "uw";
+        case type_t::int32: return "i";
+        case type_t::uint32: return "ui";
+        case type_t::int64: return "l";
+        case type_t::uint64: return "ul";
+        case type_t::float32: return "f";
+        case type_t::float64: return "d";
+        case type_t::time: return "t";
+    }
+    return "d";
+}
+
+namespace {
+
+template < typename T > struct tag { typedef T type; };
+
+template < typename F > static auto dispatch( type_t t, F f )
+{
+    switch( t )
+    {
+        case type_t::boolean: return f( tag< bool >() );
+        case type_t::int8: return f( tag< std::int8_t >() );
+        case type_t::uint8: return f( tag< std::uint8_t >() );
+        case type_t::int16: return f( tag< comma::int16 >() );
+        case type_t::uint16: return f( tag< comma::uint16 >() );
+        case type_t::int32: return f( tag< comma::int32 >() );
+        case type_t::uint32: return f( tag< comma::uint32 >() );
+        case type_t::int64: case type_t::time: return f( tag< comma::int64 >() );
+        case type_t::uint64: return f( tag< comma::uint64 >() );
+        case type_t::float32: return f( tag< float >() );
+        case type_t::float64: break;
+    }
+    return f( tag< double >() );
+}
+
+template < typename T > constexpr bool is_bool_v = std::is_same< T, bool >::value;
+template < typename T > constexpr bool is_int_v = std::is_integral< T >::value && !is_bool_v< T >;
+template < typename T > constexpr bool is_signed_v = is_int_v< T > && std::is_signed< T >::value;
+template < typename T > constexpr bool is_float_v = std::is_floating_point< T >::value;
+template < typename T > constexpr unsigned int bits_v = sizeof( T ) * 8;
+
+static constexpr comma::int64 not_a_time = std::numeric_limits< comma::int64 >::min();
+
+/// floating point division and modulo exactly as npy_divmod
+template < typename T > static T divmod( T a, T b, T& mod )
+{
+    mod = std::fmod( a, b );
+    if( !b ) { return a / b; }
+    T div = ( a - mod ) / b;
+    if( mod ) { if( ( b < 0 ) != ( mod < 0 ) ) { mod += b; div -= T( 1 ); } }
+    else { mod = std::copysign( T( 0 ), b ); }
+    if( !div ) { return std::copysign( T( 0 ), a / b ); }
+    T floordiv = std::floor( div );
+    if( div - floordiv > T( 0.5 ) ) { floordiv += T( 1 ); }
+    return floordiv;
+}
+
+/// conversion of out of range floating point values to integers is undefined in c++; do what numpy gets from x86 instructions
+template < typename To, typename From > static To float_to_int( From x )
+{
+    double d = x;
+    if constexpr( sizeof( To ) < 4 || ( sizeof( To ) == 4 && std::is_signed< To >::value ) )
+    {
+        return To( d > -2147483649.0 && d < 2147483648.0 ? comma::int32( d ) : std::numeric_limits< comma::int32 >::min() );
+    }
+    else if constexpr( std::is_signed< To >::value || sizeof( To ) == 4 )
+    {
+        return To( d >= -9223372036854775808.0 && d < 9223372036854775808.0 ? comma::int64( d ) : std::numeric_limits< comma::int64 >::min() );
+    }
+    else
+    {
+        if( d >= 0 && d < 18446744073709551616.0 ) { return comma::uint64( d ); }
+        if( d < 0 && d >= -9223372036854775808.0 ) { return comma::uint64( comma::int64( d ) ); }
+        return comma::uint64( 1 ) << 63;
+    }
+}
+
+template < typename To, typename From > static To convert( From a )
+{
+    if constexpr( is_bool_v< To > ) { return a != 0; }
+    else if constexpr( is_float_v< From > && std::is_integral< To >::value ) { return float_to_int< To >( a ); }
+    else { return static_cast< To >( a ); }
+}
+
+struct add { template < typename T > static T apply( T a, T b ) { if constexpr( is_bool_v< T > ) { return a || b; } else if constexpr( is_int_v< T > ) { return T( comma::uint64( a ) + comma::uint64( b ) ); } else { return a + b; } } };
+struct subtract { template < typename T > static T apply( T a, T b ) { if constexpr( is_bool_v< T > ) { return a != b; } else if constexpr( is_int_v< T > ) { return T( comma::uint64( a ) - comma::uint64( b ) ); } else { return a - b; } } };
+struct multiply { template < typename T > static T apply( T a, T b ) { if constexpr( is_bool_v< T > ) { return a && b; } else if constexpr( is_int_v< T > ) { return T( comma::uint64( a ) * comma::uint64( b ) ); } else { return a * b; } } };
+struct divide { template < typename T > static T apply( T a, T b ) { if constexpr( is_float_v< T > ) { return a / b; } else { return a; } } };
+
+struct floor_divide
+{
+    template < typename T > static T apply( T a, T b )
+    {
+        if constexpr( is_int_v< T > )
+        {
+            if( b == 0 ) { return 0; }
+            if constexpr( is_signed_v< T > )
+            {
+                if( b == -1 ) { return T( comma::uint64( 0 ) - comma::uint64( a ) ); }
+                T q = a / b;
+                if( a % b != 0 && ( a < 0 ) != ( b < 0 ) ) { --q; }
+                return q;
+            }
+            else
+            {
+                return a / b;
+            }
+        }
+        else if constexpr( is_float_v< T > )
+        {
+            if( !b ) { return a / b; }
+            T mod;
+            return divmod( a, b, mod );
+        }
+        else
+        {
+            return a;
+        }
+    }
+};
+
+struct remainder
+{
+    template < typename T > static T apply( T a, T b )
+    {
+        if constexpr( is_int_v< T > )
+        {
+            if( b == 0 ) { return 0; }
+            if constexpr( is_signed_v< T > )
+            {
+                if( b == -1 ) { return 0; }
+                T r = a % b;
+                if( r != 0 && ( r < 0 ) != ( b < 0 ) ) { r += b; }
+                return r;
+            }
+            else
+            {
+                return a % b;
+            }
+        }
+        else if constexpr( is_float_v< T > )
+        {
+            if( !b ) { return std::fmod( a, b ); }
+            T mod;
+            divmod( a, b, mod );
+            return mod;
+        }
+        else
+        {
+            return a;
+        }
+    }
+};
+
+struct fmod
+{
+    template < typename T > static T apply( T a, T b )
+    {
+        if constexpr( is_int_v< T > )
+        {
+            if( b == 0 ) { return 0; }
+            if constexpr( is_signed_v< T > ) { if( b == -1 ) { return 0; } }
+            return a % b;
+        }
+        else if constexpr( is_float_v< T > ) { return std::fmod( a, b ); }
+        else { return a; }
+    }
+};
+
+struct power
+{
+    template < typename T > static T apply( T a, T b )
+    {
+        if constexpr( is_int_v< T > )
+        {
+            if constexpr( is_signed_v< T > ) { if( b < 0 ) { COMMA_THROW( comma::exception, "Integers to negative integer powers are not allowed." ); } }
+            comma::uint64 r = 1;
+            comma::uint64 x = comma::uint64( a );
+            for( comma::uint64 e = comma::uint64( b ); e; e >>= 1, x *= x ) { if( e & 1 ) { r *= x; } }
+            return T( r );
+        }
+        else if constexpr( is_float_v< T > ) { return std::pow( a, b ); }
+        else { return a; }
+    }
+};
+
+struct bitwise_and { template < typename T > static T apply( T a, T b ) { if constexpr( is_float_v< T > ) { return a; } else { return T( a & b ); } } };
+struct bitwise_or { template < typename T > static T apply( T a, T b ) { if constexpr( is_float_v< T > ) { return a; } else { return T( a | b ); } } };
+struct bitwise_xor { template < typename T > static T apply( T a, T b ) { if constexpr( is_float_v< T > ) { return a; } else { return T( a ^ b ); } } };
+
+struct left_shift
+{
+    template < typename T > static T apply( T a, T b )
+    {
+        if constexpr( is_int_v< T > ) { return comma::uint64( b ) < bits_v< T > ? T( comma::uint64( a ) << unsigned( b ) ) : T( 0 ); }
+        else { return a; }
+    }
+};
+
+struct right_shift
+{
+    template < typename T > static T apply( T a, T b )
+    {
+        if constexpr( is_signed_v< T > ) { return comma::uint64( b ) < bits_v< T > ? T( a >> unsigned( b ) ) : T( a < 0 ? -1 : 0 ); }
+        else if constexpr( is_int_v< T > ) { return comma::uint64( b ) < bits_v< T > ? T( a >> unsigned( b ) ) : T( 0 ); }
+        else { return a; }
+    }
+};
+
+struct minimum { template < typename T > static T apply( T a, T b ) { if constexpr( is_float_v< T > ) { return a <= b || std::isnan( a ) ? a : b; } else { return a <= b ? a : b; } } };
+struct maximum { template < typename T > static T apply( T a, T b ) { if constexpr( is_float_v< T > ) { return a >= b || std::isnan( a ) ? a : b; } else { return a >= b ? a : b; } } };
+struct fmin { template < typename T > static T apply( T a, T b ) { if constexpr( is_float_v< T > ) { return a <= b || std::isnan( b ) ? a : b; } else { return a <= b ? a : b; } } };
+struct fmax { template < typename T > static T apply( T a, T b ) { if constexpr( is_float_v< T > ) { return a >= b || std::isnan( b ) ? a : b; } else { return a >= b ? a : b; } } };
+struct arctan2 { template < typename T > static T apply( T a, T b ) { if constexpr( is_float_v< T > ) { return std::atan2( a, b ); } else { return a; } } };
+struct hypot { template < typename T > static T apply( T a, T b ) { if constexpr( is_float_v< T > ) { return std::hypot( a, b ); } else { return a; } } };
+struct copysign { template < typename T > static T apply( T a, T b ) { if constexpr( is_float_v< T > ) { return std::copysign( a, b ); } else { return a; } } };
+
+struct less { template < typename T > static bool apply( T a, T b ) { return a < b; } };
+struct greater { template < typename T > static bool apply( T a, T b ) { return a > b; } };
+struct less_equal { template < typename T > static bool apply( T a, T b ) { return a <= b; } };
+struct greater_equal { template < typename T > static bool apply( T a, T b ) { return a >= b; } };
+struct equal { template < typename T > static bool apply( T a, T b ) { return a == b; } };
+struct not_equal { template < typename T > static bool apply( T a, T b ) { return a != b; } };
+
+struct logical_and { template < typename T > static bool apply( T a, T b ) { return a && b; } };
+struct logical_or { template < typename T > static bool apply( T a, T b ) { return a || b; } };
+struct logical_xor { template < typename T > static bool apply( T a, T b ) { return bool( a ) != bool( b ); } };
+
+struct negative { template < typename T > static T apply( T a ) { if constexpr( is_bool_v< T > ) { return !a; } else if constexpr( is_int_v< T > ) { return T( comma::uint64( 0 ) - comma::uint64( a ) ); } else { return -a; } } };
+struct invert { template < typename T > static T apply( T a ) { if constexpr( is_bool_v< T > ) { return !a; } else if constexpr( is_int_v< T > ) { return T( ~comma::uint64( a ) ); } else { return a; } } };
+struct square { template < typename T > static T apply( T a ) { if constexpr( is_int_v< T > ) { return T( comma::uint64( a ) * comma::uint64( a ) ); } else if constexpr( is_float_v< T > ) { return a * a; } else { return a; } } };
+struct logical_not { template < typename T > static bool apply( T a ) { return !a; } };
+
+struct absolute
+{
+    template < typename T > static T apply( T a )
+    {
+        if constexpr( is_signed_v< T > ) { return a < 0 ? T( comma::uint64( 0 ) - comma::uint64( a ) ) : a; }
+        else if constexpr( is_float_v< T > ) { return std::fabs( a ); }
+        else { return a; }
+    }
+};
+
+struct sign
+{
+    template < typename T > static T apply( T a )
+    {
+        if constexpr( is_signed_v< T > ) { return T( a > 0 ? 1 : a < 0 ? -1 : 0 ); }
+        else if constexpr( is_float_v< T > ) { return a > 0 ? T( 1 ) : a < 0 ? T( -1 ) : a == 0 ? T( 0 ) : a; }
+        else { return T( a > 0 ); }
+    }
+};
+
+struct isnan { template < typename T > static bool apply( T a ) { if constexpr( is_float_v< T > ) { return std::isnan( a ); } else { return false; } } };
+struct isinf { template < typename T > static bool apply( T a ) { if constexpr( is_float_v< T > ) { return std::isinf( a ); } else { return false; } } };
+struct isfinite { template < typename T > static bool apply( T a ) { if constexpr( is_float_v< T > ) { return std::isfinite( a ); } else { return true; } } };
+struct signbit { template < typename T > static bool apply( T a ) { if constexpr( is_float_v< T > ) { return std::signbit( a ); } else { return false; } } };
+
+#define COMMA_EVAL_MATH( op, f ) struct op { template < typename T > static T apply( T a ) { if constexpr( is_float_v< T > ) { return f; } else { return a; } } };
+COMMA_EVAL_MATH( sin, std::sin( a ) )
+COMMA_EVAL_MATH( cos, std::cos( a ) )
+COMMA_EVAL_MATH( tan, std::tan( a ) )
+COMMA_EVAL_MATH( arcsin, std::asin( a ) )
+COMMA_EVAL_MATH( arccos, std::acos( a ) )
+COMMA_EVAL_MATH( arctan, std::atan( a ) )
+COMMA_EVAL_MATH( sinh, std::sinh( a ) )
+COMMA_EVAL_MATH( cosh, std::cosh( a ) )
+COMMA_EVAL_MATH( tanh, std::tanh( a ) )
+COMMA_EVAL_MATH( arcsinh, std::asinh( a ) )
+COMMA_EVAL_MATH( arccosh, std::acosh( a ) )
+COMMA_EVAL_MATH( arctanh, std::atanh( a ) )
+COMMA_EVAL_MATH( exp, std::exp( a ) )
+COMMA_EVAL_MATH( exp2, std::exp2( a ) )
+COMMA_EVAL_MATH( expm1, std::expm1( a ) )
+COMMA_EVAL_MATH( log, std::log( a ) )
+COMMA_EVAL_MATH( log2, std::log2( a ) )
+COMMA_EVAL_MATH( log10, std::log10( a ) )
+COMMA_EVAL_MATH( log1p, std::log1p( a ) )
+COMMA_EVAL_MATH( sqrt, std::sqrt( a ) )
+COMMA_EVAL_MATH( cbrt, std::cbrt( a ) )
+COMMA_EVAL_MATH( fabs, std::fabs( a ) )
+COMMA_EVAL_MATH( floor, std::floor( a ) )
+COMMA_EVAL_MATH( ceil, std::ceil( a ) )
+COMMA_EVAL_MATH( trunc, std::trunc( a ) )
+COMMA_EVAL_MATH( rint, std::rint( a ) )
+COMMA_EVAL_MATH( deg2rad, a * T( M_PI / 180 ) )
+COMMA_EVAL_MATH( rad2deg, a * T( 180 / M_PI ) )
+#undef COMMA_EVAL_MATH
+
+template < typename R, typename T, typename Op > static void unary_kernel( char* const* columns, const std::size_t* operands, std::size_t size )
+{
+    R* r = reinterpret_cast< R* >( columns[ operands[0] ] );
+    const T* a = reinterpret_cast< const T* >( columns[ operands[1] ] );
+    for( std::size_t i = 0; i < size; ++i ) { r[i] = Op::apply( a[i] ); }
+}
+
+template < typename R, typename T, typename Op > static void binary_kernel( char* const* columns, const std::size_t* operands, std::size_t size )
+{
+    R* r = reinterpret_cast< R* >( columns[ operands[0] ] );
+    const T* a = reinterpret_cast< const T* >( columns[ operands[1] ] );
+    const T* b = reinterpret_cast< const T* >( columns[ operands[2] ] );
+    for( std::size_t i = 0; i < size; ++i ) { r[i] = Op::apply( a[i], b[i] ); }
+}
+
+template < typename To, typename From > static void cast_kernel( char* const* columns, const std::size_t* operands, std::size_t size )
+{
+    To* r = reinterpret_cast< To* >( columns[ operands[0] ] );
+    const From* a = reinterpret_cast< const From* >( columns[ operands[1] ] );
+    for( std::size_t i = 0; i < size; ++i ) { r[i] = convert< To >( a[i] ); }
+}
+
+template < typename T > static void where_kernel( char* const* columns, const std::size_t* operands, std::size_t size )
+{
+    T* r = reinterpret_cast< T* >( columns[ operands[0] ] );
+    const bool* c = reinterpret_cast< const bool* >( columns[ operands[1] ] );
+    const T* a = reinterpret_cast< const T* >( columns[ operands[2] ] );
+    const T* b = reinterpret_cast< const T* >( columns[ operands[3] ] );
+    for( std::size_t i = 0; i < size; ++i ) { r[i] = c[i] ? a[i] : b[i]; }
+}
+
+template < typename T > static void clip_kernel( char* const* columns, const std::size_t* operands, std::size_t size )
+{
+    T* r = reinterpret_cast< T* >( columns[ operands[0] ] );
+    const T* a = reinterpret_cast< const T* >( columns[ operands[1] ] );
+    const T* lo = reinterpret_cast< const T* >( columns[ operands[2] ] );
+    const T* hi = reinterpret_cast< const T* >( columns[ operands[3] ] );
+    for( std::size_t i = 0; i < size; ++i ) { r[i] = minimum::apply( maximum::apply( a[i], lo[i] ), hi[i] ); }
+}
+
+template < bool Subtract > static void time_kernel( char* const* columns, const std::size_t* operands, std::size_t size )
+{
+    comma::int64* r = reinterpret_cast< comma::int64* >( columns[ operands[0] ] );
+    const comma::int64* a = reinterpret_cast< const comma::int64* >( columns[ operands[1] ] );
+    const comma::int64* b = reinterpret_cast< const comma::int64* >( columns[ operands[2] ] );
+    for( std::size_t i = 0; i < size; ++i ) { r[i] = a[i] == not_a_time || b[i] == not_a_time ? not_a_time : Subtract ? subtract::apply( a[i], b[i] ) : add::apply( a[i], b[i] ); }
+}
+
+template < typename Op > static void time_compare_kernel( char* const* columns, const std::size_t* operands, std::size_t size )
+{
+    bool* r = reinterpret_cast< bool* >( columns[ operands[0] ] );
+    const comma::int64* a = reinterpret_cast< const comma::int64* >( columns[ operands[1] ] );
+    const comma::int64* b = reinterpret_cast< const comma::int64* >( columns[ operands[2] ] );
+    for( std::size_t i = 0; i < size; ++i ) { r[i] = a[i] == not_a_time || b[i] == not_a_time ? std::is_same< Op, not_equal >::value : Op::apply( a[i], b[i] ); }
+}
+
+template < typename Op > static program::kernel_t same( type_t t ) { return dispatch( t, []( auto k ) -> program::kernel_t { typedef typename decltype( k )::type T; return &binary_kernel< T, T, Op >; } ); }
+template < typename Op > static program::kernel_t predicate( type_t t ) { return dispatch( t, []( auto k ) -> program::kernel_t { typedef typename decltype( k )::type T; return &binary_kernel< bool, T, Op >; } ); }
+template < typename Op > static program::kernel_t unary_same( type_t t ) { return dispatch( t, []( auto k ) -> program::kernel_t { typedef typename decltype( k )::type T; return &unary_kernel< T, T, Op >; } ); }
+template < typename Op > static program::kernel_t unary_predicate( type_t t ) { return dispatch( t, []( auto k ) -> program::kernel_t { typedef typename decltype( k )::type T; return &unary_kernel< bool, T, Op >; } ); }
+
+static program::kernel_t arithmetic_kernel( const std::string& op, type_t t )
+{
+    if( op == "+" ) { return same< add >( t ); }
+    if( op == "-" ) { return same< subtract >( t ); }
+    if( op == "*" ) { return same< multiply >( t ); }
+    if( op == "/" ) { return same< divide >( t ); }
+    if( op == "//" ) { return same< floor_divide >( t ); }
+    if( op == "%" ) { return same< remainder >( t ); }
+    if( op == "**" ) { return same< power >( t ); }
+    if( op == "&" ) { return same< bitwise_and >( t ); }
+    if( op == "|" ) { return same< bitwise_or >( t ); }
+    if( op == "^" ) { return same< bitwise_xor >( t ); }
+    if( op == "<<" ) { return same< left_shift >( t ); }
+    if( op == ">>" ) { return same< right_shift >( t ); }
+    if( op == "fmod" ) { return same< fmod >( t ); }
+    if( op == "minimum" ) { return same< minimum >( t ); }
+    if( op == "maximum" ) { return same< maximum >( t ); }
+    if( op == "fmin" ) { return same< fmin >( t ); }
+    if( op == "fmax" ) { return same< fmax >( t ); }
+    if( op == "arctan2" ) { return same< arctan2 >( t ); }
+    if( op == "hypot" ) { return same< hypot >( t ); }
+    if( op == "copysign" ) { return same< copysign >( t ); }
+    if( op == "logical_and" ) { return predicate< logical_and >( t ); }
+    if( op == "logical_or" ) { return predicate< logical_or >( t ); }
+    if( op == "logical_xor" ) { return predicate< logical_xor >( t ); }
+    COMMA_THROW( comma::exception, "unknown operator '" << op << "'" ); // never here
+}
+
+static program::kernel_t comparison_kernel( const std::string& op, type_t t )
+{
+    if( t == type_t::time )
+    {
+        if( op == "<" ) { return &time_compare_kernel< less >; }
+        if( op == ">" ) { return &time_compare_kernel< greater >; }
+        if( op == "<=" ) { return &time_compare_kernel< less_equal >; }
+        if( op == ">=" ) { return &time_compare_kernel< greater_equal >; }
+        if( op == "==" ) { return &time_compare_kernel< equal >; }
+        return &time_compare_kernel< not_equal >;
+    }
+    if( op == "<" ) { return predicate< less >( t ); }
+    if( op == ">" ) { return predicate< greater >( t ); }
+    if( op == "<=" ) { return predicate< less_equal >( t ); }
+    if( op == ">=" ) { return predicate< greater_equal >( t ); }
+    if( op == "==" ) { return predicate< equal >( t ); }
+    return predicate< not_equal >( t );
+}
+
+static program::kernel_t math_kernel( const std::string& f, type_t t )
+{
+    static const std::map< std::string, program::kernel_t ( * )( type_t ) > kernels =
+    {
+        { "sin", &unary_same< sin > }, { "cos", &unary_same< cos > }, { "tan", &unary_same< tan > }
+        , { "arcsin", &unary_same< arcsin > }, { "arccos", &unary_same< arccos > }, { "arctan", &unary_same< arctan > }
+        , { "sinh", &unary_same< sinh > }, { "cosh", &unary_same< cosh > }, { "tanh", &unary_same< tanh > }
+        , { "arcsinh", &unary_same< arcsinh > }, { "arccosh", &unary_same< arccosh > }, { "arctanh", &unary_same< arctanh > }
+        , { "exp", &unary_same< exp > }, { "exp2", &unary_same< exp2 > }, { "expm1", &unary_same< expm1 > }
+        , { "log", &unary_same< log > }, { "log2", &unary_same< log2 > }, { "log10", &unary_same< log10 > }, { "log1p", &unary_same< log1p > }
+        , { "sqrt", &unary_same< sqrt > }, { "cbrt", &unary_same< cbrt > }, { "fabs", &unary_same< fabs > }
+        , { "floor", &unary_same< floor > }, { "ceil", &unary_same< ceil > }, { "trunc", &unary_same< trunc > }, { "rint", &unary_same< rint > }
+        , { "deg2rad", &unary_same< deg2rad > }, { "radians", &unary_same< deg2rad > }, { "rad2deg", &unary_same< rad2deg > }, { "degrees", &unary_same< rad2deg > }
+        , { "absolute", &unary_same< absolute > }, { "square", &unary_same< square > }, { "sign", &unary_same< sign > }
+        , { "isnan", &unary_predicate< isnan > }, { "isinf", &unary_predicate< isinf > }, { "isfinite", &unary_predicate< isfinite > }, { "signbit", &unary_predicate< signbit > }
+    };
+    return kernels.at( f )( t );
+}
+
+enum class function_kind { floating, rounding, integral, predicate, logical, binary, binary_floating, operator_, comparison, cast, where, clip };
+
+struct function { function_kind kind; unsigned int arity; std::string op; type_t type; };
+
+static const std::map< std::string, function >& functions()
+{
+    static const std::map< std::string, function > f = []()
+    {
+        std::map< std::string, function > m;
+        for( const char* s: { "sin", "cos", "tan", "arcsin", "arccos", "arctan", "sinh", "cosh", "tanh", "arcsinh", "arccosh", "arctanh", "exp", "exp2", "expm1", "log", "log2", "log10", "log1p", "sqrt", "cbrt", "fabs", "deg2rad", "radians", "rad2deg", "degrees" } ) { m[s] = { function_kind::floating, 1, s, type_t::float64 }; }
+        for( const char* s: { "floor", "ceil", "trunc", "rint" } ) { m[s] = { function_kind::rounding, 1, s, type_t::float64 }; }
+        for( const char* s: { "round", "around" } ) { m[s] = { function_kind::rounding, 1, "rint", type_t::float64 }; } // numpy rounds half to even, as rint does
+        for( const char* s: { "absolute", "square", "sign" } ) { m[s] = { function_kind::integral, 1, s, type_t::float64 }; }
+        m["abs"] = { function_kind::integral, 1, "absolute", type_t::float64 };
+        for( const char* s: { "isnan", "isinf", "isfinite", "signbit" } ) { m[s] = { function_kind::predicate, 1, s, type_t::float64 }; }
+        m["logical_not"] = { function_kind::logical, 1, "logical_not", type_t::boolean };
+        for( const char* s: { "logical_and", "logical_or", "logical_xor" } ) { m[s] = { function_kind::logical, 2, s, type_t::boolean }; }
+        for( const char* s: { "minimum", "maximum", "fmin", "fmax", "fmod" } ) { m[s] = { function_kind::binary, 2, s, type_t::float64 }; }
+        for( const char* s: { "arctan2", "hypot", "copysign" } ) { m[s] = { function_kind::binary_floating, 2, s, type_t::float64 }; }
+        const std::pair< const char*, const char* > operators[] = { { "add", "+" }, { "subtract", "-" }, { "multiply", "*" }, { "divide", "/" }, { "true_divide", "/" }, { "floor_divide", "//" }
+                                                                  , { "mod", "%" }, { "remainder", "%" }, { "power", "**" }, { "bitwise_and", "&" }, { "bitwise_or", "|" }, { "bitwise_xor", "^" }
+                                                                  , { "left_shift", "<<" }, { "right_shift", ">>" } };
+        for( const auto& o: operators ) { m[o.first] = { function_kind::operator_, 2, o.second, type_t::float64 }; }
+        for( const char* s: { "negative", "positive", "invert", "bitwise_not", "bitwise_invert" } ) { m[s] = { function_kind::operator_, 1, s[0] == 'n' ? "-" : s[0] == 'p' ? "+" : "~", type_t::float64 }; }
+        const std::pair< const char*, const char* > comparisons[] = { { "less", "<" }, { "greater", ">" }, { "less_equal", "<=" }, { "greater_equal", ">=" }, { "equal", "==" }, { "not_equal", "!=" } };
+        for( const auto& o: comparisons ) { m[o.first] = { function_kind::comparison, 2, o.second, type_t::float64 }; }
+        const std::pair< const char*, type_t > casts[] = { { "float64", type_t::float64 }, { "double", type_t::float64 }, { "float32", type_t::float32 }, { "single", type_t::float32 }
+                                                         , { "int8", type_t::int8 }, { "byte", type_t::int8 }, { "uint8", type_t::uint8 }, { "ubyte", type_t::uint8 }
+                                                         , { "int16", type_t::int16 }, { "short", type_t::int16 }, { "uint16", type_t::uint16 }, { "ushort", type_t::uint16 }
+                                                         , { "int32", type_t::int32 }, { "intc", type_t::int32 }, { "uint32", type_t::uint32 }, { "uintc", type_t::uint32 }
+                                                         , { "int64", type_t::int64 }, { "int_", type_t::int64 }, { "uint64", type_t::uint64 }, { "bool_", type_t::boolean }, { "bool", type_t::boolean } };
+        for( const auto& c: casts ) { m[c.first] = { function_kind::cast, 1, c.first, c.second }; }
+        m["where"] = { function_kind::where, 3, "where", type_t::float64 };
+        m["clip"] = { function_kind::clip, 3, "clip", type_t::float64 };
+        return m;
+    }();
+    return f;
+}
+
+/// numpy promotion of two array types
+static type_t promote( type_t a, type_t b )
+{
+    if( a == b ) { return a; }
+    if( a == type_t::time || b == type_t::time ) { throw unsupported( std::string( "cannot combine " ) + name( a ) + " and " + name( b ) ); }
+    if( a == type_t::boolean ) { return b; }
+    if( b == type_t::boolean ) { return a; }
+    if( is_float( a ) || is_float( b ) )
+    {
+        if( is_float( a ) && is_float( b ) ) { return type_t::float64; }
+        type_t f = is_float( a ) ? a : b;
+        type_t i = is_float( a ) ? b : a;
+        return f == type_t::float32 && size_of( i ) <= 2 ? type_t::float32 : type_t::float64;
+    }
+    if( is_signed( a ) == is_signed( b ) ) { return size_of( a ) >= size_of( b ) ? a : b; }
+    type_t s = is_signed( a ) ? a : b;
+    type_t u = is_signed( a ) ? b : a;
+    if( size_of( s ) > size_of( u ) ) { return s; }
+    switch( u )
+    {
+        case type_t::uint8: return type_t::int16;
+        case type_t::uint16: return type_t::int32;
+        case type_t::uint32: return type_t::int64;
+        default: return type_t::float64;
+    }
+}
+
+static int kind_of( type_t t ) { return t == type_t::boolean ? 0 : is_integer( t ) ? 1 : is_float( t ) ? 2 : 3; }
+
+/// type of floating point loop numpy picks for functions defined only for floats; float16 loops are not supported
+static type_t floating( type_t t )
+{
+    if( t == type_t::time ) { throw unsupported( "datetime64 not supported in floating point functions" ); }
+    if( is_float( t ) ) { return t; }
+    if( size_of( t ) == 1 ) { throw unsupported( "float16 not supported" ); }
+    return size_of( t ) == 2 ? type_t::float32 : type_t::float64;
+}
+
+/// same_kind casting rule of numpy in-place operations
+static bool same_kind( type_t from, type_t to )
+{
+    if( from == to ) { return true; }
+    if( from == type_t::time || to == type_t::time ) { return false; }
+    if( promote( from, to ) == to ) { return true; }
+    auto kind = []( type_t t ) { return t == type_t::boolean ? 0 : is_signed( t ) ? 1 : is_integer( t ) ? 2 : 3; };
+    return kind( from ) == kind( to );
+}
+
+static double real_of( const literal& l ) { return l.type == type_t::float64 ? l.real : double( l.integer ); }
+
+/// python semantics of operators on python scalars, anything raising in python is unsupported
+static literal fold( const std::string& op, const literal& a, const literal& b )
+{
+    if( a.type == type_t::boolean && b.type == type_t::boolean )
+    {
+        if( op == "&" ) { return literal::make( bool( a.integer & b.integer ) ); }
+        if( op == "|" ) { return literal::make( bool( a.integer | b.integer ) ); }
+        if( op == "^" ) { return literal::make( bool( a.integer ^ b.integer ) ); }
+    }
+    if( a.type == type_t::float64 || b.type == type_t::float64 || op == "/" )
+    {
+        if( a.type != type_t::float64 && b.type != type_t::float64 && ( std::abs( a.integer ) > ( comma::int64( 1 ) << 53 ) || std::abs( b.integer ) > ( comma::int64( 1 ) << 53 ) ) ) { throw unsupported( "division of large integers not supported" ); }
+        double x = real_of( a );
+        double y = real_of( b );
+        double r;
+        if( op == "+" ) { r = x + y; }
+        else if( op == "-" ) { r = x - y; }
+        else if( op == "*" ) { r = x * y; }
+        else if( op == "/" ) { if( y == 0 ) { throw unsupported( "division by zero" ); } r = x / y; }
+        else if( op == "//" ) { if( y == 0 ) { throw unsupported( "division by zero" ); } double mod; r = divmod( x, y, mod ); }
+        else if( op == "%" ) { if( y == 0 ) { throw unsupported( "division by zero" ); } divmod( x, y, r ); }
+        else if( op == "**" )
+        {
+            if( x == 0 && y < 0 ) { throw unsupported( "division by zero" ); }
+            if( x < 0 && std::isfinite( y ) && y != std::floor( y ) ) { throw unsupported( "complex numbers not supported" ); }
+            r = std::pow( x, y );
+            if( std::isinf( r ) && std::isfinite( x ) && std::isfinite( y ) ) { throw unsupported( "numerical result out of range" ); }
+        }
+        else { throw unsupported( "unsupported operand type for " + op + ": float" ); }
+        return literal::make( r );
+    }
+    comma::int64 x = a.integer;
+    comma::int64 y = b.integer;
+    comma::int64 r;
+    if( op == "+" ) { if( __builtin_add_overflow( x, y, &r ) ) { throw unsupported( "python integers beyond int64 not supported" ); } }
+    else if( op == "-" ) { if( __builtin_sub_overflow( x, y, &r ) ) { throw unsupported( "python integers beyond int64 not supported" ); } }
+    else if( op == "*" ) { if( __builtin_mul_overflow( x, y, &r ) ) { throw unsupported( "python integers beyond int64 not supported" ); } }
+    else if( op == "//" || op == "%" )
+    {
+        if( y == 0 ) { throw unsupported( "division by zero" ); }
+        if( y == -1 && x == std::numeric_limits< comma::int64 >::min() ) { throw unsupported( "python integers beyond int64 not supported" ); }
+        r = op == "//" ? floor_divide::apply( x, y ) : remainder::apply( x, y );
+    }
+    else if( op == "**" )
+    {
+        if( y < 0 )
+        {
+            if( x == 0 ) { throw unsupported( "division by zero" ); }
+            return literal::make( std::pow( double( x ), double( y ) ) );
+        }
+        r = 1;
+        for( comma::int64 i = 0; i < y; ++i )
+        {
+            if( r == 0 || x == 1 ) { break; }
+            if( __builtin_mul_overflow( r, x, &r ) ) { throw unsupported( "python integers beyond int64 not supported" ); }
+        }
+    }
+    else if( op == "&" ) { r = x & y; }
+    else if( op == "|" ) { r = x | y; }
+    else if( op == "^" ) { r = x ^ y; }
+    else if( op == "<<" )
+    {
+        if( y < 0 ) { throw unsupported( "negative shift count" ); }
+        if( x != 0 && ( y >= 63 || ( ( x << y ) >> y ) != x ) ) { throw unsupported( "python integers beyond int64 not supported" ); }
+        r = x == 0 ? 0 : x << y;
+    }
+    else if( op == ">>" )
+    {
+        if( y < 0 ) { throw unsupported( "negative shift count" ); }
+        r = y >= 64 ? ( x < 0 ? -1 : 0 ) : x >> y;
+    }
+    else { throw unsupported( "unknown operator '" + op + "'" ); }
+    return literal::make( r );
+}
+
+static literal fold_comparison( const std::string& op, const literal& a, const literal& b )
+{
+    if( a.type == type_t::float64 || b.type == type_t::float64 )
+    {
+        double x = real_of( a );
+        double y = real_of( b );
+        if( op == "<" ) { return literal::make( x < y ); }
+        if( op == ">" ) { return literal::make( x > y ); }
+        if( op == "<=" ) { return literal::make( x <= y ); }
+        if( op == ">=" ) { return literal::make( x >= y ); }
+        if( op == "==" ) { return literal::make( x == y ); }
+        return literal::make( x != y );
+    }
+    if( op == "<" ) { return literal::make( a.integer < b.integer ); }
+    if( op == ">" ) { return literal::make( a.integer > b.integer ); }
+    if( op == "<=" ) { return literal::make( a.integer <= b.integer ); }
+    if( op == ">=" ) { return literal::make( a.integer >= b.integer ); }
+    if( op == "==" ) { return literal::make( a.integer == b.integer ); }
+    return literal::make( a.integer != b.integer );
+}
+
+static literal fold_unary( const std::string& op, const literal& a )
+{
+    if( a.type == type_t::float64 )
+    {
+        if( op == "-" ) { return literal::make( -a.real ); }
+        if( op == "+" ) { return a; }
+        throw unsupported( "bad operand type for unary ~: float" );
+    }
+    if( op == "-" ) { if( a.integer == std::numeric_limits< comma::int64 >::min() ) { throw unsupported( "python integers beyond int64 not supported" ); } return literal::make( -a.integer ); }
+    if( op == "+" ) { return literal::make( a.integer ); }
+    return literal::make( ~a.integer );
+}
+
+template < typename T > static bool in_range( comma::int64 i )
+{
+    if constexpr( std::is_same< T, comma::uint64 >::value ) { return i >= 0; }
+    else if constexpr( is_int_v< T > ) { return i >= comma::int64( std::numeric_limits< T >::min() ) && i <= comma::int64( std::numeric_limits< T >::max() ); }
+    else { return true; }
+}
+
+} // namespace {
+
+std::size_t program::register_( type_t type )
+{
+    registers_.emplace_back();
+    registers_.back().type = type;
+    return registers_.size() - 1;
+}
+
+std::size_t program::constant_( type_t type, const eval::literal& l, bool unsafe )
+{
+    eval::literal c;
+    c.type = type;
+    if( type == type_t::time ) { throw unsupported( "python scalars as datetime64 not supported" ); }
+    if( type == type_t::boolean ) { c.integer = l.type == type_t::float64 ? l.real != 0 : l.integer != 0; }
+    else if( is_float( type ) ) { c.real = real_of( l ); if( type == type_t::float32 ) { c.real = float( c.real ); } }
+    else
+    {
+        c.integer = l.integer;
+        if( l.type == type_t::float64 )
+        {
+            if( !unsafe ) { throw unsupported( "cannot cast float to integer" ); }
+            if( !std::isfinite( l.real ) || std::abs( l.real ) >= 9223372036854775808.0 ) { throw unsupported( "cannot convert float to integer" ); }
+            c.integer = comma::int64( l.real );
+        }
+        if( !dispatch( type, [&]( auto k ) { return in_range< typename decltype( k )::type >( c.integer ); } ) ) { throw unsupported( "python integer " + std::to_string( c.integer ) + " out of bounds for " + name( type ) ); }
+    }
+    comma::int64 bits;
+    std::memcpy( &bits, &c.real, sizeof( bits ) );
+    auto key = std::make_pair( int( type ), std::make_pair( c.integer, bits ) );
+    auto it = constants_.find( key );
+    if( it != constants_.end() ) { return it->second; }
+    std::size_t r = register_( type );
+    registers_[r].constant = true;
+    registers_[r].literal = c;
+    constants_[key] = r;
+    return r;
+}
+
+std::size_t program::emit_( kernel_t kernel, type_t type, std::size_t a, std::size_t b, std::size_t c )
+{
+    std::size_t r = register_( type );
+    instructions_.push_back( instruction{ kernel, { r, a, b, c } } );
+    return r;
+}
+
+std::size_t program::cast_( const value& v, type_t type, bool unsafe )
+{
+    if( v.state == value::weak ) { return constant_( type, v.literal, unsafe ); }
+    if( v.type == type ) { return v.index; }
+    if( v.type == type_t::time || type == type_t::time )
+    {
+        if( !unsafe || type != type_t::time || !is_integer( v.type ) || v.type == type_t::uint64 ) { throw unsupported( std::string( "cannot cast " ) + name( v.type ) + " to " + name( type ) ); }
+    }
+    kernel_t k = dispatch( type, [&]( auto to ) { return dispatch( v.type, [&]( auto from ) -> kernel_t { return &cast_kernel< typename decltype( to )::type, typename decltype( from )::type >; } ); } );
+    return emit_( k, type, v.index );
+}
+
+program::value program::column_( std::size_t index ) const
+{
+    value v;
+    v.type = registers_[index].type;
+    v.index = index;
+    return v;
+}
+
+program::value program::strong_( const value& v )
+{
+    if( v.state != value::weak ) { return v; }
+    return column_( constant_( v.literal.type, v.literal ) );
+}
+
+std::size_t program::input( const std::string& name, type_t type )
+{
+    std::size_t r = register_( type );
+    inputs_[r] = false;
+    assign_( name, column_( r ) );
+    return r;
+}
+
+void program::opaque( const std::string& name ) { value v; v.state = value::opaque; assign_( name, v ); }
+
+void program::uninitialized( const std::string& name ) { value v; v.state = value::uninitialized; assign_( name, v ); }
+
+bool program::defined( const std::string& name ) const
+{
+    auto it = variables_.find( name );
+    return it != variables_.end() && ( it->second.state == value::defined || it->second.state == value::weak );
+}
+
+bool program::used( std::size_t index ) const { return inputs_.at( index ); }
+
+void program::assign_( const std::string& name, const value& v ) { variables_[name] = v; }
+
+program::value program::lookup_( const std::string& name )
+{
+    auto it = variables_.find( name );
+    if( it != variables_.end() )
+    {
+        switch( it->second.state )
+        {
+            case value::uninitialized: throw unsupported( "'" + name + "' used before assignment" );
+            case value::opaque: throw unsupported( "'" + name + "' has type not supported natively" );
+            case value::defined: { auto i = inputs_.find( it->second.index ); if( i != inputs_.end() ) { i->second = true; } break; }
+            case value::weak: break;
+        }
+        return it->second;
+    }
+    static const std::map< std::string, double > constants = { { "pi", M_PI }, { "e", M_E }, { "inf", std::numeric_limits< double >::infinity() }, { "nan", std::numeric_limits< double >::quiet_NaN() }, { "euler_gamma", 0.5772156649015329 } };
+    auto c = constants.find( name );
+    if( c != constants.end() ) { value v; v.state = value::weak; v.literal = eval::literal::make( c->second ); return v; }
+    if( functions().count( name ) ) { throw unsupported( "function '" + name + "' used as value" ); }
+    throw unsupported( "name '" + name + "' is not defined" );
+}
+
+program::value program::evaluate_( const expression& e )
+{
+    switch( e.kind )
+    {
+        case expression::constant: { value v; v.state = value::weak; v.literal = e.literal; return v; }
+        case expression::variable: return lookup_( e.name );
+        case expression::unary: return unary_( e.name, evaluate_( e.operands[0] ) );
+        case expression::binary: { value a = evaluate_( e.operands[0] ); return binary_( e.name, a, evaluate_( e.operands[1] ) ); }
+        case expression::comparison: { value a = evaluate_( e.operands[0] ); return compare_( e.name, a, evaluate_( e.operands[1] ) ); }
+        case expression::call:
+        {
+            std::vector< value > args;
+            for( const auto& o: e.operands ) { args.push_back( evaluate_( o ) ); }
+            return call_( e.name, args );
+        }
+        case expression::tuple: break;
+    }
+    throw unsupported( "tuples not supported" );
+}
+
+/// type of operation on given values, python scalars being weak
+static type_t common( const std::vector< program::value >& values )
+{
+    bool strong = false;
+    type_t t = type_t::boolean;
+    int weak = -1;
+    for( const auto& v: values )
+    {
+        if( v.state == program::value::weak ) { weak = std::max( weak, kind_of( v.literal.type ) ); continue; }
+        t = strong ? promote( t, v.type ) : v.type;
+        strong = true;
+    }
+    if( !strong ) { return weak == 0 ? type_t::boolean : weak == 1 ? type_t::int64 : type_t::float64; }
+    if( weak < 0 ) { return t; }
+    if( t == type_t::time ) { throw unsupported( "python scalars with datetime64 not supported" ); }
+    if( weak <= kind_of( t ) ) { return t; }
+    return weak == 1 ? type_t::int64 : type_t::float64;
+}
+
+program::value program::unary_( const std::string& op, const value& a )
+{
+    if( a.state == value::weak ) { value v = a; v.literal = fold_unary( op, a.literal ); return v; }
+    if( a.type == type_t::time ) { throw unsupported( "unary " + op + " on datetime64 not supported" ); }
+    if( op == "~" )
+    {
+        if( is_float( a.type ) ) { throw unsupported( "ufunc 'invert' not supported for floats" ); }
+        return column_( emit_( unary_same< invert >( a.type ), a.type, a.index ) );
+    }
+    if( a.type == type_t::boolean ) { throw unsupported( "unary " + op + " on boolean not supported" ); }
+    if( op == "+" ) { return a; }
+    return column_( emit_( unary_same< negative >( a.type ), a.type, a.index ) );
+}
+
+program::value program::time_( const std::string& op, const value& a, const value& b )
+{
+    const value& t = op == "+" && !( a.state != value::weak && a.type == type_t::time ) ? b : a;
+    const value& d = &t == &a ? b : a;
+    bool valid = ( op == "+" || op == "-" ) && t.state != value::weak && t.type == type_t::time;
+    if( valid ) { valid = d.state == value::weak ? d.literal.type == type_t::int64 : is_integer( d.type ) && d.type != type_t::uint64; }
+    if( !valid ) { throw unsupported( "datetime64 operations other than adding or subtracting integer microseconds not supported" ); }
+    std::size_t rd = cast_( d, type_t::int64 );
+    return column_( emit_( op == "-" ? &time_kernel< true > : &time_kernel< false >, type_t::time, t.index, rd ) );
+}
+
+program::value program::binary_( const std::string& op, const value& a, const value& b )
+{
+    if( a.state == value::weak && b.state == value::weak ) { value v = a; v.literal = fold( op, a.literal, b.literal ); return v; }
+    if( ( a.state != value::weak && a.type == type_t::time ) || ( b.state != value::weak && b.type == type_t::time ) ) { return time_( op, a, b ); }
+    type_t t = common( { a, b } );
+    if( op == "/" ) { if( !is_float( t ) ) { t = type_t::float64; } }
+    else if( t == type_t::boolean )
+    {
+        if( op == "-" ) { throw unsupported( "numpy boolean subtract not supported" ); }
+        if( op == "//" || op == "%" || op == "**" || op == "<<" || op == ">>" ) { t = type_t::int8; }
+    }
+    else if( is_float( t ) && ( op == "&" || op == "|" || op == "^" || op == "<<" || op == ">>" ) )
+    {
+        throw unsupported( "bitwise operators not supported for floats" );
+    }
+    std::size_t ra = cast_( a, t );
+    std::size_t rb = cast_( b, t );
+    return column_( emit_( arithmetic_kernel( op, t ), t, ra, rb ) );
+}
+
+program::value program::compare_( const std::string& op, const value& a, const value& b )
+{
+    if( a.state == value::weak && b.state == value::weak ) { value v = a; v.literal = fold_comparison( op, a.literal, b.literal ); return v; }
+    bool ta = a.state != value::weak && a.type == type_t::time;
+    bool tb = b.state != value::weak && b.type == type_t::time;
+    if( ta || tb )
+    {
+        if( !ta || !tb ) { throw unsupported( "comparison of datetime64 with other types not supported" ); }
+        return column_( emit_( comparison_kernel( op, type_t::time ), type_t::boolean, a.index, b.index ) );
+    }
+    type_t t = common( { a, b } );
+    auto real = []( const value& v ) { return v.state == value::weak ? v.literal.type == type_t::float64 : is_float( v.type ); };
+    if( t == type_t::float64 && !real( a ) && !real( b ) ) { throw unsupported( "comparison of uint64 with signed integers not supported" ); }
+    std::size_t ra = cast_( a, t );
+    std::size_t rb = cast_( b, t );
+    return column_( emit_( comparison_kernel( op, t ), type_t::boolean, ra, rb ) );
+}
+
+program::value program::call_( const std::string& name, std::vector< value > args )
+{
+    if( variables_.count( name ) ) { throw unsupported( "'" + name + "' is not callable" ); }
+    auto it = functions().find( name );
+    if( it == functions().end() ) { throw unsupported( "function '" + name + "' not supported" ); }
+    const function& f = it->second;
+    if( args.size() != f.arity ) { throw unsupported( name + "() takes " + std::to_string( f.arity ) + " arguments" ); }
+    if( f.kind == function_kind::cast )
+    {
+        if( args[0].state != value::weak && args[0].type == type_t::time ) { throw unsupported( "datetime64 casts not supported" ); }
+        return column_( cast_( args[0], f.type, true ) );
+    }
+    if( std::all_of( args.begin(), args.end(), []( const value& v ) { return v.state == value::weak; } ) ) { for( auto& a: args ) { a = strong_( a ); } }
+    for( const auto& a: args )
+    {
+        if( a.state != value::weak && a.type == type_t::time && f.kind != function_kind::where && f.kind != function_kind::comparison && f.kind != function_kind::operator_ ) { throw unsupported( "datetime64 not supported in " + name + "()" ); }
+    }
+    switch( f.kind )
+    {
+        case function_kind::operator_: return args.size() == 1 ? unary_( f.op, args[0] ) : binary_( f.op, args[0], args[1] );
+        case function_kind::comparison: return compare_( f.op, args[0], args[1] );
+        case function_kind::floating:
+        {
+            type_t t = floating( args[0].type );
+            return column_( emit_( math_kernel( f.op, t ), t, cast_( args[0], t ) ) );
+        }
+        case function_kind::rounding:
+            if( !is_float( args[0].type ) ) { throw unsupported( name + "() of integers not supported" ); }
+            return column_( emit_( math_kernel( f.op, args[0].type ), args[0].type, args[0].index ) );
+        case function_kind::integral:
+            if( args[0].type == type_t::boolean && f.op != "absolute" ) { throw unsupported( name + "() of booleans not supported" ); }
+            return column_( emit_( math_kernel( f.op, args[0].type ), args[0].type, args[0].index ) );
+        case function_kind::predicate:
+        {
+            type_t t = f.op == "signbit" ? floating( args[0].type ) : args[0].type;
+            return column_( emit_( math_kernel( f.op, t ), type_t::boolean, cast_( args[0], t ) ) );
+        }
+        case function_kind::logical:
+        {
+            std::size_t a = cast_( args[0], type_t::boolean, true );
+            if( args.size() == 1 ) { return column_( emit_( unary_predicate< logical_not >( type_t::boolean ), type_t::boolean, a ) ); }
+            std::size_t b = cast_( args[1], type_t::boolean, true );
+            return column_( emit_( arithmetic_kernel( f.op, type_t::boolean ), type_t::boolean, a, b ) );
+        }
+        case function_kind::binary:
+        {
+            type_t t = common( args );
+            if( t == type_t::boolean && f.op == "fmod" ) { t = type_t::int8; }
+            std::size_t a = cast_( args[0], t );
+            return column_( emit_( arithmetic_kernel( f.op, t ), t, a, cast_( args[1], t ) ) );
+        }
+        case function_kind::binary_floating:
+        {
+            type_t t = floating( common( args ) );
+            std::size_t a = cast_( args[0], t );
+            return column_( emit_( arithmetic_kernel( f.op, t ), t, a, cast_( args[1], t ) ) );
+        }
+        case function_kind::where:
+        {
+            std::size_t c = cast_( args[0], type_t::boolean, true );
+            type_t t = common( { args[1], args[2] } );
+            std::size_t a = cast_( args[1], t );
+            std::size_t b = cast_( args[2], t );
+            kernel_t k = dispatch( t, []( auto k ) -> kernel_t { return &where_kernel< typename decltype( k )::type >; } );
+            std::size_t r = register_( t );
+            instructions_.push_back( instruction{ k, { r, c, a, b } } );
+            return column_( r );
+        }
+        case function_kind::clip:
+        {
+            type_t t = common( args );
+            std::size_t a = cast_( args[0], t );
+            std::size_t lo = cast_( args[1], t );
+            std::size_t hi = cast_( args[2], t );
+            kernel_t k = dispatch( t, []( auto k ) -> kernel_t { return &clip_kernel< typename decltype( k )::type >; } );
+            std::size_t r = register_( t );
+            instructions_.push_back( instruction{ k, { r, a, lo, hi } } );
+            return column_( r );
+        }
+        case function_kind::cast: break;
+    }
+    throw unsupported( "function '" + name + "' not supported" ); // never here
+}
+
+void program::update_( const std::string& name, const std::string& op, const expression& e )
+{
+    value x = lookup_( name );
+    value y = binary_( op, x, evaluate_( e ) );
+    if( x.state == value::weak ) { assign_( name, y ); return; } // python scalars are immutable, name simply gets rebound
+    for( const auto& v: variables_ )
+    {
+        if( v.first != name && v.second.state == value::defined && v.second.index == x.index ) { throw unsupported( "in-place update of array bound to several names not supported" ); }
+    }
+    if( !same_kind( y.type, x.type ) ) { throw unsupported( std::string( "cannot cast ufunc output from " ) + eval::name( y.type ) + " to " + eval::name( x.type ) + " with casting rule 'same_kind'" ); }
+    assign_( name, column_( cast_( y, x.type, true ) ) );
+}
+
+void program::execute( const std::vector< statement >& statements )
+{
+    for( const auto& s: statements )
+    {
+        if( s.targets.empty() ) { evaluate_( s.value ); continue; }
+        if( !s.op.empty() ) { update_( s.targets[0][0], s.op, s.value ); continue; }
+        std::vector< value > values;
+        if( s.value.kind == expression::tuple ) { for( const auto& o: s.value.operands ) { values.push_back( evaluate_( o ) ); } }
+        else { values.push_back( evaluate_( s.value ) ); }
+        for( const auto& t: s.targets )
+        {
+            if( t.size() == 1 && s.value.kind != expression::tuple ) { assign_( t[0], values[0] ); continue; }
+            if( t.size() == 1 || s.value.kind != expression::tuple ) { throw unsupported( "tuples not supported" ); }
+            if( t.size() != values.size() ) { throw unsupported( "expected " + std::to_string( t.size() ) + " values to unpack, got " + std::to_string( values.size() ) ); }
+            for( std::size_t i = 0; i < t.size(); ++i ) { assign_( t[i], values[i] ); }
+        }
+    }
+}
+
+std::size_t program::condition( const expression& e, bool mask )
+{
+    value v = evaluate_( e );
+    if( mask )
+    {
+        if( v.state == value::weak || v.type != type_t::boolean ) { throw unsupported( "select condition is expected to be a boolean array" ); }
+        return v.index;
+    }
+    if( v.state != value::weak && v.type == type_t::time ) { throw unsupported( "truth value of datetime64 not supported" ); }
+    return cast_( v, type_t::boolean, true );
+}
+
+std::size_t program::result( const std::string& name, type_t type )
+{
+    if( !variables_.count( name ) ) { throw unsupported( "name '" + name + "' is not defined" ); }
+    return cast_( lookup_( name ), type, true );
+}
+
+void program::allocate( std::size_t capacity )
+{
+    columns_.resize( registers_.size() );
+    for( std::size_t i = 0; i < registers_.size(); ++i )
+    {
+        register_t& r = registers_[i];
+        r.data.resize( ( capacity * size_of( r.type ) + 7 ) / 8 + 1 );
+        columns_[i] = reinterpret_cast< char* >( &r.data[0] );
+        if( !r.constant ) { continue; }
+        const eval::literal& l = r.literal;
+        dispatch( r.type, [&]( auto k )
+        {
+            typedef typename decltype( k )::type T;
+            T value = is_float( r.type ) ? T( l.real ) : T( l.integer );
+            std::fill( column< T >( i ), column< T >( i ) + capacity, value );
+            return 0;
+        } );
+    }
+}
+
+void program::run( std::size_t size ) { for( const auto& i: instructions_ ) { i.kernel( &columns_[0], i.operands, size ); } }
+
+} } } } // namespace comma { namespace csv { namespace applications { namespace eval {
@@ -0,0 +1,116 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "parser.h"
+#include "types.h"
+
+namespace comma { namespace csv { namespace applications { namespace eval {
+
+/// expressions compiled into bytecode evaluated column at a time over batches of records
+///
+/// types are inferred at compile time following numpy 2 rules, i.e. numpy promotion with python
+/// scalars being weak (nep 50), integer wraparound, python-style floor division and modulo,
+/// integer division by zero giving zero, etc; each instruction is a kernel instantiated for the
+/// operand types and applied to whole columns, constants are broadcast to columns once, when the
+/// program is allocated
+///
+/// anything that numpy would evaluate differently or that is not implemented, e.g. datetime
+/// differences or string functions, throws unsupported at compile time
+class program
+{
+    public:
+        /// bind variable to input column of given type and @return its register
+        std::size_t input( const std::string& name, type_t type );
+
+        /// declare variable that exists, but cannot be used natively, e.g. string input field
+        void opaque( const std::string& name );
+
+        /// declare variable that python csv-eval binds to uninitialized memory, e.g. output field
+        void uninitialized( const std::string& name );
+
+        /// compile statements
+        void execute( const std::vector< statement >& statements );
+
+        /// compile expression and @return register of its value cast to boolean as numpy truth value
+        std::size_t condition( const expression& e, bool mask );
+
+        /// @return register of current value of variable assigned to field of given type, casting as numpy does on assignment
+        std::size_t result( const std::string& name, type_t type );
+
+        /// @return true, if variable is bound to a value
+        bool defined( const std::string& name ) const;
+
+        /// @return true, if input register has been used in expressions
+        bool used( std::size_t index ) const;
+
+        /// allocate columns for batches of up to given size and broadcast constants
+        void allocate( std::size_t capacity );
+
+        /// evaluate program on first size elements of input columns
+        void run( std::size_t size );
+
+        /// @return column of given register
+        template < typename T > T* column( std::size_t index ) { return reinterpret_cast< T* >( &registers_[index].data[0] ); }
+
+        /// @return type of given register
+        type_t type( std::size_t index ) const { return registers_[index].type; }
+
+        /// @return number of instructions
+        std::size_t size() const { return instructions_.size(); }
+
+        typedef void ( *kernel_t )( char* const* columns, const std::size_t* operands, std::size_t size );
+
+        struct value
+        {
+            enum states { defined, weak, uninitialized, opaque };
+            states state{defined};
+            type_t type{type_t::float64}; ///< type of column
+            std::size_t index{0}; ///< register of column
+            eval::literal literal; ///< value of python scalar, if weak
+        };
+
+    private:
+        struct register_t
+        {
+            type_t type;
+            bool constant{false};
+            eval::literal literal;
+            std::vector< comma::uint64 > data;
+        };
+        struct instruction
+        {
+            kernel_t kernel;
+            std::size_t operands[4];
+        };
+        std::vector< register_t > registers_;
+        std::vector< instruction > instructions_;
+        std::vector< char* > columns_;
+        std::unordered_map< std::string, value > variables_;
+        std::map< std::size_t, bool > inputs_;
+        std::map< std::pair< int, std::pair< comma::int64, comma::int64 > >, std::size_t > constants_;
+
+        std::size_t register_( type_t type );
+        std::size_t constant_( type_t type, const eval::literal& l, bool unsafe = false );
+        std::size_t emit_( kernel_t kernel, type_t type, std::size_t a, std::size_t b = 0, std::size_t c = 0 );
+        std::size_t cast_( const value& v, type_t type, bool unsafe = false );
+        value column_( std::size_t index ) const;
+        value strong_( const value& v );
+        value lookup_( const std::string& name );
+        value evaluate_( const expression& e );
+        value unary_( const std::string& op, const value& a );
+        value binary_( const std::string& op, const value& a, const value& b );
+        value compare_( const std::string& op, const value& a, const value& b );
+        value call_( const std::string& name, std::vector< value > args );
+        value time_( const std::string& op, const value& a, const value& b );
+        void update_( const std::string& name, const std::string& op, const expression& e );
+        void assign_( const std::string& name, const value& v );
+};
+
+} } } } // namespace comma { namespace csv { namespace applications { namespace eval {
@@ -0,0 +1,50 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include "../../../base/types.h"
+
+namespace comma { namespace csv { namespace applications { namespace eval {
+
+/// thrown on anything the native implementation does not support, e.g. string functions;
+/// the caller is expected to fall back to the python implementation, which also reports
+/// genuine errors in expressions the way users are used to
+struct unsupported : public std::runtime_error { unsupported( const std::string& what ) : std::runtime_error( what ) {} };
+
+/// element types of columns, following numpy dtypes; time is datetime64[us]
+enum class type_t { boolean, int8, uint8, int16, uint16, int32, uint32, int64, uint64, float32, float64, time };
+
+const char* name( type_t t );
+
+unsigned int size_of( type_t t );
+
+inline bool is_integer( type_t t ) { return t >= type_t::int8 && t <= type_t::uint64; }
+
+inline bool is_signed( type_t t ) { return t == type_t::int8 || t == type_t::int16 || t == type_t::int32 || t == type_t::int64; }
+
+inline bool is_float( type_t t ) { return t == type_t::float32 || t == type_t::float64; }
+
+/// @return type for comma format type, e.g. "ui", or nothing for types not representable as columns, e.g. "s[8]"
+bool from_format( const std::string& s, type_t& t );
+
+/// @return comma format type, e.g. "ui"
+const char* to_format( type_t t );
+
+/// python scalar literal, i.e. bool, int, or float (only boolean, int64, and float64 types)
+struct literal
+{
+    type_t type{type_t::int64};
+    comma::int64 integer{0};
+    double real{0};
+
+    literal() = default;
+    static literal make( bool b ) { literal l; l.type = type_t::boolean; l.integer = b; l.real = b; return l; }
+    static literal make( comma::int64 i ) { literal l; l.type = type_t::int64; l.integer = i; l.real = double( i ); return l; }
+    static literal make( double d ) { literal l; l.type = type_t::float64; l.real = d; return l; }
+};
+
+} } } } // namespace comma { namespace csv { namespace applications { namespace eval {
@@ -0,0 +1,186 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <cstring>
+#include <sstream>
+#include <boost/lexical_cast.hpp>
+#include "../base/exception.h"
+#include "../io/impl/filesystem.h"
+#include "../string/string.h"
+#include "columnar.h"
+
+namespace comma { namespace csv { namespace columnar {
+
+header::header( const csv::format& f, const std::string& fields ): format( f.expanded_string() )
+{
+    this->fields = fields.empty() ? std::vector< std::string >() : comma::split( fields, ',' );
+    COMMA_ASSERT_BRIEF( this->fields.size() <= format.count(), "expected at most " << format.count() << " fields for format '" << f.string() << "'; got: '" << fields << "'" );
+    this->fields.resize( format.count() );
+}
+
+std::size_t header::index( const std::string& name ) const
+{
+    for( std::size_t i = 0; i < fields.size(); ++i ) { if( fields[i] == name ) { return i; } }
+    std::size_t i;
+    try { i = boost::lexical_cast< std::size_t >( name ); }
+    catch( ... ) { COMMA_THROW( comma::exception, "field '" << name << "' not found in " << comma::join( fields, ',' ) ); }
+    COMMA_ASSERT_BRIEF( i < count(), "expected column index less than " << count() << "; got: " << i );
+    return i;
+}
+
+header header::load( const std::string& dir )
+{
+    std::ifstream ifs( dir + "/header" );
+    COMMA_ASSERT_BRIEF( ifs.is_open(), "failed to open '" << dir << "/header'" );
+    header h;
+    std::string fields;
+    bool has_format = false;
+    bool has_size = false;
+    while( ifs.good() && !ifs.eof() )
+    {
+        std::string line;
+        std::getline( ifs, line );
+        if( line.empty() ) { continue; }
+        std::string::size_type p = line.find( '=' );
+        COMMA_ASSERT_BRIEF( p != std::string::npos, "expected name=value in '" << dir << "/header'; got: '" << line << "'" );
+        std::string name = line.substr( 0, p );
+        std::string value = line.substr( p + 1 );
+        if( name == "format" ) { h.format = csv::format( value ); has_format = true; }
+        else if( name == "fields" ) { fields = value; }
+        else if( name == "size" ) { h.size = boost::lexical_cast< std::size_t >( value ); has_size = true; }
+    }
+    COMMA_ASSERT_BRIEF( has_format && has_size, "expected format and size in '" << dir << "/header'" );
+    h.fields = fields.empty() ? std::vector< std::string >() : comma::split( fields, ',' );
+    h.fields.resize( h.format.count() );
+    return h;
+}
+
+void header::save( const std::string& dir ) const
+{
+    std::ofstream ofs( dir + "/header" );
+    COMMA_ASSERT_BRIEF( ofs.is_open(), "failed to open '" << dir << "/header' for writing" );
+    ofs << "format=" << format.string() << std::endl << "fields=" << comma::join( fields, ',' ) << std::endl << "size=" << size << std::endl;
+}
+
+std::string filename( const std::string& dir, std::size_t column ) { return dir + "/" + boost::lexical_cast< std::string >( column ) + ".bin"; }
+
+writer::writer( const std::string& dir, const csv::format& format, const std::string& fields, std::size_t chunk )
+    : _dir( dir )
+    , _header( format, fields )
+    , _chunk( std::max( chunk, std::size_t( 1 ) ) )
+{
+    COMMA_ASSERT_BRIEF( comma::filesystem::is_directory( dir ) || comma::filesystem::create_directories( dir ), "failed to create directory '" << dir << "'" );
+    _columns.resize( _header.count() );
+    for( std::size_t i = 0; i < _header.count(); ++i )
+    {
+        _columns[i].resize( _chunk * _header.format.elements()[i].size );
+        _files.emplace_back( new std::ofstream( filename( dir, i ), std::ios::binary | std::ios::trunc ) );
+        COMMA_ASSERT_BRIEF( _files.back()->is_open(), "failed to open '" << filename( dir, i ) << "' for writing" );
+    }
+    _header.save( dir );
+}
+
+writer::~writer() { try { close(); } catch( ... ) {} }
+
+void writer::write( const char* records, std::size_t count )
+{
+    const std::size_t record_size = _header.format.size();
+    while( count > 0 )
+    {
+        std::size_t n = std::min( count, _chunk - _buffered );
+        for( std::size_t i = 0; i < _columns.size(); ++i )
+        {
+            const csv::format::element e = _header.format.elements()[i];
+            const char* in = records + e.offset;
+            char* out = &_columns[i][0] + _buffered * e.size;
+            for( std::size_t j = 0; j < n; ++j, in += record_size, out += e.size ) { std::memcpy( out, in, e.size ); }
+        }
+        _buffered += n;
+        _header.size += n;
+        records += n * record_size;
+        count -= n;
+        if( _buffered == _chunk ) { flush(); }
+    }
+}
+
+void writer::flush()
+{
+    if( _files.empty() ) { return; }
+    for( std::size_t i = 0; i < _columns.size(); ++i ) { _files[i]->write( &_columns[i][0], _buffered * _header.format.elements()[i].size ); _files[i]->flush(); }
+    _buffered = 0;
+    _header.save( _dir ); // keep header consistent with written columns
+}
+
+void writer::close()
+{
+    if( _files.empty() ) { return; }
+    flush();
+    _files.clear();
+}
+
+reader::reader( const std::string& dir, const std::string& fields, std::size_t chunk )
+    : _header( header::load( dir ) )
+    , _chunk( std::max( chunk, std::size_t( 1 ) ) )
+{
+    std::vector< std::size_t > indices;
+    if( fields.empty() ) { for( std::size_t i = 0; i < _header.count(); indices.push_back( i++ ) ); }
+    else { for( const auto& f: comma::split( fields, ',' ) ) { indices.push_back( _header.index( f ) ); } }
+    std::vector< std::string > names;
+    std::size_t offset = 0;
+    for( std::size_t i: indices )
+    {
+        const csv::format::element e = _header.format.elements()[i];
+        column c;
+        c.index = i;
+        c.size = e.size;
+        c.offset = offset;
+        c.file.reset( new std::ifstream( filename( dir, i ), std::ios::binary ) );
+        COMMA_ASSERT_BRIEF( c.file->is_open(), "failed to open '" << filename( dir, i ) << "'" );
+        c.buffer.resize( _chunk * e.size );
+        _columns.push_back( std::move( c ) );
+        _format += csv::format::to_format( e.type, e.size, e.endianness );
+        names.push_back( _header.fields[i] );
+        offset += e.size;
+    }
+    _fields = comma::join( names, ',' );
+}
+
+std::size_t reader::read( char* buf, std::size_t count )
+{
+    const std::size_t record_size = _format.size();
+    std::size_t total = 0;
+    while( count > 0 && remaining() > 0 )
+    {
+        std::size_t n = std::min( std::min( count, _chunk ), remaining() );
+        for( auto& c: _columns )
+        {
+            c.file->read( &c.buffer[0], n * c.size );
+            COMMA_ASSERT_BRIEF( std::size_t( c.file->gcount() ) == n * c.size, "column " << c.index << ": expected " << n * c.size << " bytes, got " << c.file->gcount() );
+            const char* in = &c.buffer[0];
+            char* out = buf + c.offset;
+            for( std::size_t j = 0; j < n; ++j, in += c.size, out += record_size ) { std::memcpy( out, in, c.size ); }
+        }
+        _read += n;
+        total += n;
+        buf += n * record_size;
+        count -= n;
+    }
+    return total;
+}
+
+istream::streambuf::streambuf( const std::string& dir, const std::string& fields, std::size_t chunk ): reader( dir, fields, chunk ), buffer( chunk * reader.format().size() ) {}
+
+istream::streambuf::int_type istream::streambuf::underflow()
+{
+    if( gptr() < egptr() ) { return traits_type::to_int_type( *gptr() ); }
+    if( buffer.empty() ) { return traits_type::eof(); }
+    std::size_t n = reader.read( &buffer[0], buffer.size() / reader.format().size() );
+    if( n == 0 ) { return traits_type::eof(); }
+    setg( &buffer[0], &buffer[0], &buffer[0] + n * reader.format().size() );
+    return traits_type::to_int_type( *gptr() );
+}
+
+istream::istream( const std::string& dir, const std::string& fields, std::size_t chunk ): std::istream( nullptr ), _buf( dir, fields, chunk ) { rdbuf( &_buf ); }
+
+} } } // namespace comma { namespace csv { namespace columnar {
@@ -0,0 +1,144 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "format.h"
+
+namespace comma { namespace csv { namespace columnar {
+
+/// columnar (structure-of-arrays) container for fixed-size binary records
+///
+/// a container is a directory with:
+///     header: text file with name=value lines
+///         format=<expanded binary format, one element per column>
+///         fields=<comma-separated column names, may be empty>
+///         size=<number of rows>
+///     <i>.bin: values of i-th column in row order, written in chunks
+///
+/// reading only a few columns of a wide record reads only the files of those columns
+struct header
+{
+    csv::format format;
+    std::vector< std::string > fields;
+    std::size_t size{0};
+
+    header() = default;
+    header( const csv::format& format, const std::string& fields = "" );
+
+    /// return number of columns
+    std::size_t count() const { return format.count(); }
+
+    /// return column index by name or, if no column has the name, by numeric index, e.g. "x" or "3"
+    std::size_t index( const std::string& name ) const;
+
+    static header load( const std::string& dir );
+
+    void save( const std::string& dir ) const;
+};
+
+/// return column file name
+std::string filename( const std::string& dir, std::size_t column );
+
+/// write row-major records as columns
+class writer
+{
+    public:
+        /// @param chunk number of rows buffered per column before writing
+        writer( const std::string& dir, const csv::format& format, const std::string& fields = "", std::size_t chunk = 65536 );
+
+        ~writer();
+
+        /// write count contiguous records
+        void write( const char* records, std::size_t count = 1 );
+
+        /// write buffered rows and header
+        void flush();
+
+        /// flush and close column files
+        void close();
+
+        const columnar::header& header() const { return _header; }
+
+    private:
+        std::string _dir;
+        columnar::header _header;
+        std::size_t _chunk;
+        std::size_t _buffered{0};
+        std::vector< std::vector< char > > _columns;
+        std::vector< std::unique_ptr< std::ofstream > > _files;
+};
+
+/// read given columns and assemble them into row-major records
+class reader
+{
+    public:
+        /// @param fields comma-separated column names or indices to read; empty: all columns
+        reader( const std::string& dir, const std::string& fields = "", std::size_t chunk = 65536 );
+
+        const columnar::header& header() const { return _header; }
+
+        /// return format of assembled records
+        const csv::format& format() const { return _format; }
+
+        /// return field names of assembled records
+        const std::string& fields() const { return _fields; }
+
+        /// return number of rows not yet read
+        std::size_t remaining() const { return _header.size - _read; }
+
+        /// read up to count rows into buf; return number of rows read, 0 at the end
+        std::size_t read( char* buf, std::size_t count );
+
+    private:
+        struct column
+        {
+            std::size_t index;
+            std::size_t size;
+            std::size_t offset; /// offset in assembled record
+            std::unique_ptr< std::ifstream > file;
+            std::vector< char > buffer;
+        };
+        columnar::header _header;
+        csv::format _format;
+        std::string _fields;
+        std::size_t _chunk;
+        std::size_t _read{0};
+        std::vector< column > _columns;
+};
+
+/// std::istream over assembled records to plug columnar containers into csv::input_stream and alike
+///
+/// usage:
+///     csv::columnar::istream is( "log.columnar", "t,x" );
+///     csv::options csv;
+///     csv.fields = is.reader().fields();
+///     csv.format( is.reader().format() );
+///     csv::input_stream< point > stream( is, csv );
+class istream : public std::istream
+{
+    public:
+        istream( const std::string& dir, const std::string& fields = "", std::size_t chunk = 65536 );
+
+        columnar::reader& reader() { return _buf.reader; }
+
+        const columnar::reader& reader() const { return _buf.reader; }
+
+    private:
+        struct streambuf : public std::streambuf
+        {
+            columnar::reader reader;
+            std::vector< char > buffer;
+            streambuf( const std::string& dir, const std::string& fields, std::size_t chunk );
+            int_type underflow();
+        };
+        streambuf _buf;
+};
+
+} } } // namespace comma { namespace csv { namespace columnar {
@@ -12,6 +12,7 @@
 #include "../base/exception.h"
 #include "../base/types.h"
 #include "../csv/format.h"
+#include "../csv/impl/byte_swap.h"
 #include "../string/string.h"
 #include "../timing/conversions.h"
 
@@ -29,11 +30,20 @@ format::format( const std::string& f )
     std::size_t offset = 0;
     for( unsigned int i = 0; i < v.size(); ++i )
     {
+        endianness_enum endianness = native;
+        std::string e = v[i];
+        if( !e.empty() && ( e[0] == '<' || e[0] == '>' ) ) { endianness = e[0] == '<' ? little_endian : big_endian; e = e.substr( 1 ); } // e.g. ">3d"
         std::string s;
-        for( ; s.length() < v[i].length() && v[i][ s.length() ] >= '0' && v[i][ s.length() ] <= '9'; s += v[i][ s.length() ] );
-        if( s.length() >= v[i].length() ) { COMMA_THROW( comma::exception, "expected format, got '" << v[i] << "' in " << format ); }
+        for( ; s.length() < e.length() && e[ s.length() ] >= '0' && e[ s.length() ] <= '9'; s += e[ s.length() ] );
+        if( s.length() < e.length() && ( e[ s.length() ] == '<' || e[ s.length() ] == '>' ) ) // e.g. "3>d"
+        {
+            if( endianness != native ) { COMMA_THROW( comma::exception, "expected format, got '" << v[i] << "' in " << format << ": byte order specified twice" ); }
+            endianness = e[ s.length() ] == '<' ? little_endian : big_endian;
+            e.erase( s.length(), 1 );
+        }
+        if( s.length() >= e.length() ) { COMMA_THROW( comma::exception, "expected format, got '" << v[i] << "' in " << format ); }
         std::size_t arraySize = s.empty() ? 1 : boost::lexical_cast< std::size_t >( s );
-        std::string type = v[i].substr( s.length() );
+        std::string type = e.substr( s.length() );
         types_enum t;
         unsigned int size;
         if( type == "b" ) { t = format::int8; size = 1; }
@@ -57,12 +67,33 @@ format::format( const std::string& f )
             size = boost::lexical_cast< std::size_t >( type.substr( 2, type.length() - 3 ) );
         }
         else { COMMA_THROW( comma::exception, "expected format, got '" << type << "' in " << format ); }
-        elements_.push_back( element( offset, arraySize, size, t ) );
+        elements_.push_back( element( offset, arraySize, size, t, endianness ) );
         count_ += arraySize;
         size *= arraySize;
         offset += size;
         size_ += size;
     }
+    for( const element& e: elements_ ) // build byte swap plan, merging adjacent fields of the same width
+    {
+        if( !e.swapped() ) { continue; }
+        auto add = [&]( std::size_t offset, std::size_t size, std::size_t count )
+        {
+            if( !swaps_.empty() && swaps_.back().size == size && swaps_.back().offset + swaps_.back().size * swaps_.back().count == offset ) { swaps_.back().count += count; }
+            else { swaps_.push_back( swap_span_{ offset, size, count } ); }
+        };
+        if( e.type == long_time ) { for( std::size_t j = 0; j < e.count; ++j ) { add( e.offset + e.size * j, 8, 1 ); add( e.offset + e.size * j + 8, 4, 1 ); } }
+        else { add( e.offset, e.size, e.count ); }
+    }
+}
+
+void format::to_host( char* buf, std::size_t records ) const
+{
+    if( swaps_.empty() ) { return; }
+    if( swaps_.size() == 1 && swaps_[0].offset == 0 && swaps_[0].size * swaps_[0].count == size_ ) { impl::swap_bytes( buf, swaps_[0].size, swaps_[0].count * records ); return; } // quick path: all fields of the same width
+    for( std::size_t i = 0; i < records; ++i, buf += size_ )
+    {
+        for( const swap_span_& s: swaps_ ) { impl::swap_bytes( buf + s.offset, s.size, s.count ); }
+    }
 }
 
 const std::string& format::string() const { return string_; }
@@ -75,6 +106,16 @@ std::string format::to_format( types_enum type, unsigned int size )
     return oss.str();
 }
 
+std::string format::to_format( types_enum type, unsigned int size, endianness_enum endianness )
+{
+    switch( endianness )
+    {
+        case little_endian: return "<" + to_format( type, size );
+        case big_endian: return ">" + to_format( type, size );
+        default: return to_format( type, size );
+    }
+}
+
 std::string format::to_format( format::types_enum type )
 {
     switch( type )
@@ -102,9 +143,9 @@ std::size_t format::size() const { return size_; }
 
 std::size_t format::count() const { return count_; }
 
-static boost::array< unsigned int, 14 > Sizesimpl()
+static boost::array< unsigned int, 15 > Sizesimpl()
 {
-    boost::array< unsigned int, 14 > sizes;
+    boost::array< unsigned int, 15 > sizes;
     sizes[ format::char_t ] = sizeof( char );
     sizes[ format::int8 ] = sizeof( signed char );
     sizes[ format::uint8 ] = sizeof( unsigned char );
@@ -154,11 +195,14 @@ std::string format::usage()
         << "            s[<length>]  : fixed size string, e.g. \"s[4]\"" << std::endl
         << "            t  : time (64-bit signed int, number of microseconds since epoch)" << std::endl
         << "            lt : time (64+32 bit, seconds since epoch and nanoseconds)" << std::endl
-        << "            tp : chrono time point (64-bit signed int, number of microseconds since epoch)" << std::endl;
+        << "            tp : chrono time point (64-bit signed int, number of microseconds since epoch)" << std::endl
+        << "            byte order: optional prefix, host byte order by default" << std::endl
+        << "                < : little endian, e.g. \"<ui\" or \"<3d\"" << std::endl
+        << "                > : big endian, e.g. \">ui\" or \">3d\" (same as \"3>d\")" << std::endl;
     return oss.str();
 }
 
-static boost::array< unsigned int, 14 > format_sizes = Sizesimpl();
+static boost::array< unsigned int, 15 > format_sizes = Sizesimpl();
 std::size_t format::size_of( types_enum type ) { return format_sizes[ static_cast< std::size_t >( type ) ]; }
 
 namespace impl {
@@ -326,7 +370,9 @@ void format::csv_to_bin( std::ostream& os, const std::vector< std::string >& v,
         try
         {
             if( count >= elements_[ offsetIndex ].count ) { count = 0; ++offsetIndex; }
-            p += impl::csv_to_bin( p, v[i], elements_[ offsetIndex ].type, elements_[ offsetIndex ].size );
+            std::size_t size = impl::csv_to_bin( p, v[i], elements_[ offsetIndex ].type, elements_[ offsetIndex ].size );
+            if( elements_[ offsetIndex ].swapped() ) { impl::swap_field( p, elements_[ offsetIndex ].type, size ); }
+            p += size;
         }
         catch( std::exception& ex )
         {
@@ -367,7 +413,17 @@ std::string format::bin_to_csv( const char* buf, char delimiter, const boost::op
     {
         if( i > 0 ) { oss << delimiter; }
         if( count >= elements_[ offsetIndex ].count ) { count = 0; ++offsetIndex; }
-        p += impl::bin_to_csv( oss, p, elements_[ offsetIndex ].type, elements_[ offsetIndex ].size, precision );
+        if( elements_[ offsetIndex ].swapped() )
+        {
+            char swapped[16];
+            ::memcpy( swapped, p, elements_[ offsetIndex ].size );
+            impl::swap_field( swapped, elements_[ offsetIndex ].type, elements_[ offsetIndex ].size );
+            p += impl::bin_to_csv( oss, swapped, elements_[ offsetIndex ].type, elements_[ offsetIndex ].size, precision );
+        }
+        else
+        {
+            p += impl::bin_to_csv( oss, p, elements_[ offsetIndex ].type, elements_[ offsetIndex ].size, precision );
+        }
     }
     return oss.str();
 }
@@ -390,7 +446,8 @@ format::element format::offset( std::size_t ind ) const
     return element( elements_[ i.first ].offset + elements_[ i.first ].size * i.second
                   , 1
                   , elements_[ i.first ].size
-                  , elements_[ i.first ].type );
+                  , elements_[ i.first ].type
+                  , elements_[ i.first ].endianness );
 }
 
 std::string format::expanded_string() const
@@ -399,7 +456,7 @@ std::string format::expanded_string() const
     for ( unsigned int i = 0; i < elements_.size(); ++i )
     {
         for ( unsigned int n = 0; n < elements_[ i ].count; ++n )
-        { result += format::to_format( elements_[ i ].type, elements_[ i ].size ); }
+        { result += format::to_format( elements_[ i ].type, elements_[ i ].size, elements_[ i ].endianness ); }
     }
     return result.string();
 }
@@ -407,7 +464,11 @@ std::string format::expanded_string() const
 std::string format::collapsed_string() const
 {
     format result;
-
+    auto collapsed = []( const element& e, std::size_t count ) // byte order prefix goes first, as in usage, e.g. "<2d"
+    {
+        std::string f = format::to_format( e.type, e.size, e.endianness );
+        return count > 1 ? f.insert( e.endianness == native ? 0 : 1, std::to_string( count ) ) : f;
+    };
     if( elements_.size() >= 1 )
     {
         element last_element( elements_[ 0 ] );
@@ -415,21 +476,15 @@ std::string format::collapsed_string() const
         for ( unsigned int i = 1; i < elements_.size(); ++i )
         {
             types_enum type = elements_[ i ].type;
-            if( type != last_element.type || last_element.type == format::fixed_string )
+            if( type != last_element.type || elements_[ i ].endianness != last_element.endianness || last_element.type == format::fixed_string )
             {
-                std::ostringstream new_element;
-                if( count > 1 ) { new_element << count; }
-                new_element << format::to_format( last_element.type, last_element.size );
-                result += new_element.str();
+                result += collapsed( last_element, count );
                 last_element = elements_[ i ];
                 count = 0;
             }
             count += elements_[ i ].count;
         }
-        std::ostringstream new_element;
-        if( count > 1 ) { new_element << count; }
-        new_element << format::to_format( last_element.type, last_element.size );
-        result += new_element.str();
+        result += collapsed( last_element, count );
     }
     return result.string();
 }
@@ -46,6 +46,16 @@ class format
         ///       a variable size string is tricky and we may never implement it for csv
         enum types_enum { char_t, int8, uint8, int16, uint16, int32, uint32, int64, uint64, float_t, double_t, time, long_time, fixed_string, time_point };
 
+        /// byte order of binary fields: native means host byte order, which is the default
+        /// explicit byte order is specified by prefix in the format string, e.g. ">ui" (big endian) or "<3d" (little endian)
+        enum endianness_enum { native, little_endian, big_endian };
+
+        #if defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        static const endianness_enum host_endianness = big_endian;
+        #else
+        static const endianness_enum host_endianness = little_endian;
+        #endif
+
         /// type to enum
         template < typename T > struct type_to_enum {};
 
@@ -66,11 +76,14 @@ class format
         struct element
         {
             element() : offset( 0 ), count( 0 ), size( 0 ) {}
-            element( std::size_t o, std::size_t c, std::size_t s, types_enum type ) : offset( o ), count( c ), size( s ), type( type ) {}
+            element( std::size_t o, std::size_t c, std::size_t s, types_enum type, endianness_enum endianness = native ) : offset( o ), count( c ), size( s ), type( type ), endianness( endianness ) {}
             std::size_t offset; /// offset of the 1st element
             std::size_t count;  /// number of elements; e.g. as in "3d" size will be count * size, i.e count * sizeof(double)
             std::size_t size;   /// element size; e.g. as in "3d" size will be count * size, i.e count * sizeof(double)
             types_enum type; /// element type
+            endianness_enum endianness{native}; /// element byte order
+            /// return true, if element byte order is different from host byte order
+            bool swapped() const { return endianness != native && endianness != host_endianness && size > 1 && type != fixed_string; }
         };
 
         /// constructor
@@ -91,6 +104,15 @@ class format
         /// return number of fields
         std::size_t count() const;
 
+        /// return true, if any field is not in host byte order
+        bool swapped() const { return !swaps_.empty(); }
+
+        /// convert given number of records from their byte order to host byte order in place
+        void to_host( char* buf, std::size_t records = 1 ) const;
+
+        /// convert given number of records from host byte order to their byte order in place
+        void from_host( char* buf, std::size_t records = 1 ) const { to_host( buf, records ); } // byte swap is its own inverse
+
         /// append string (a convenience method)
         const format& operator+=( const std::string& rhs );
 
@@ -137,11 +159,16 @@ class format
 
         /// return format for a type
         static std::string to_format( types_enum type, unsigned int size );
+
+        /// return format for a type with byte order prefix, e.g. ">ui"
+        static std::string to_format( types_enum type, unsigned int size, endianness_enum endianness );
                 
     private:
+        struct swap_span_ { std::size_t offset; std::size_t size; std::size_t count; };
         std::string string_;
         std::vector< types_enum > types_;
         std::vector< element > elements_;
+        std::vector< swap_span_ > swaps_;
         std::size_t size_;
         std::size_t count_;
         std::size_t elements_number_; /// total number of elements
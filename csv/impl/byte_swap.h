@@ -0,0 +1,95 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <string.h>
+#include <algorithm>
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define COMMA_CSV_BYTE_SWAP_SSSE3
+#include <tmmintrin.h>
+#endif
+#include "../../base/exception.h"
+#include "../../base/types.h"
+#include "../format.h"
+
+namespace comma { namespace csv { namespace impl {
+
+#if defined( __GNUC__ )
+inline comma::uint16 byte_swapped( comma::uint16 v ) { return __builtin_bswap16( v ); }
+inline comma::uint32 byte_swapped( comma::uint32 v ) { return __builtin_bswap32( v ); }
+inline comma::uint64 byte_swapped( comma::uint64 v ) { return __builtin_bswap64( v ); }
+#else
+template < typename T > inline T byte_swapped( T v ) { char* p = reinterpret_cast< char* >( &v ); std::reverse( p, p + sizeof( T ) ); return v; }
+#endif
+
+#if defined( COMMA_CSV_BYTE_SWAP_SSSE3 )
+template < unsigned int Size > __attribute__(( target( "ssse3" ) )) inline __m128i byte_swap_mask();
+template <> __attribute__(( target( "ssse3" ) )) inline __m128i byte_swap_mask< 2 >() { return _mm_setr_epi8( 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 ); }
+template <> __attribute__(( target( "ssse3" ) )) inline __m128i byte_swap_mask< 4 >() { return _mm_setr_epi8( 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 ); }
+template <> __attribute__(( target( "ssse3" ) )) inline __m128i byte_swap_mask< 8 >() { return _mm_setr_epi8( 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 ); }
+
+/// swap 16 bytes at a time with a single byte shuffle; return number of values left
+template < unsigned int Size >
+__attribute__(( target( "ssse3" ) )) inline std::size_t swap_bytes_ssse3( char*& p, std::size_t count )
+{
+    const __m128i mask = byte_swap_mask< Size >();
+    for( ; count >= 16 / Size; count -= 16 / Size, p += 16 ) { _mm_storeu_si128( reinterpret_cast< __m128i* >( p ), _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast< const __m128i* >( p ) ), mask ) ); }
+    return count;
+}
+
+/// checked at run time, since binaries built for generic x86 may run on cpus with or without ssse3
+inline bool has_ssse3()
+{
+    #if defined( __SSSE3__ )
+    return true;
+    #else
+    static const bool supported = __builtin_cpu_supports( "ssse3" );
+    return supported;
+    #endif
+}
+#endif
+
+/// reverse byte order of count contiguous values of given size in place
+/// on x86 cpus with ssse3, 16 bytes are swapped at a time with a single byte shuffle
+template < unsigned int Size >
+inline void swap_bytes( char* p, std::size_t count )
+{
+    typedef typename comma::integer< Size, false >::type type;
+    #if defined( COMMA_CSV_BYTE_SWAP_SSSE3 )
+    if( count >= 16 / Size && has_ssse3() ) { count = swap_bytes_ssse3< Size >( p, count ); }
+    #endif
+    for( ; count > 0; --count, p += Size )
+    {
+        type v;
+        ::memcpy( &v, p, Size );
+        v = byte_swapped( v );
+        ::memcpy( p, &v, Size );
+    }
+}
+
+inline void swap_bytes( char* p, std::size_t size, std::size_t count )
+{
+    switch( size )
+    {
+        case 1: return;
+        case 2: swap_bytes< 2 >( p, count ); return;
+        case 4: swap_bytes< 4 >( p, count ); return;
+        case 8: swap_bytes< 8 >( p, count ); return;
+        default: COMMA_THROW( comma::exception, "expected value size of 1, 2, 4, or 8 bytes; got: " << size );
+    }
+}
+
+/// reverse byte order of a single field of given type in place
+inline void swap_field( char* p, format::types_enum type, std::size_t size )
+{
+    switch( type )
+    {
+        case format::fixed_string: return;
+        case format::long_time: swap_bytes< 8 >( p, 1 ); swap_bytes< 4 >( p + 8, 1 ); return; // seconds and nanoseconds are swapped separately
+        default: swap_bytes( p, size, 1 );
+    }
+}
+
+} } } // namespace comma { namespace csv { namespace impl {
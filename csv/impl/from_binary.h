@@ -45,6 +45,7 @@
 #include "../../string/string.h"
 #include "../../visiting/visit.h"
 #include "../../visiting/while.h"
+#include "byte_swap.h"
 #include "static_cast.h"
 
 namespace comma { namespace csv { namespace impl {
@@ -160,6 +161,13 @@ inline void from_binary_::apply_final( const K&, T& value )
         const char* buf = buf_ + offsets_[ index_ ]->offset;
         std::size_t size = offsets_[ index_ ]->size;
         format::types_enum type = offsets_[ index_ ]->type;
+        char swapped[16];
+        if( offsets_[ index_ ]->swapped() ) // decode from byte-swapped copy of the field, input buffer stays intact
+        {
+            ::memcpy( swapped, buf, size );
+            swap_field( swapped, type, size );
+            buf = swapped;
+        }
         if( type == format::traits< T >::type ) // quick path
         {
             value = format::traits< T >::from_bin( buf, size ); // copy( value, buf, size );
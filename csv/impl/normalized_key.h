@@ -0,0 +1,139 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <boost/container/small_vector.hpp>
+#include <boost/date_time/posix_time/ptime.hpp>
+#include "../../base/types.h"
+#include "unstructured.h"
+
+namespace comma { namespace csv { namespace impl {
+
+/// typed key fields encoded as a single byte string, which compares with memcmp in the same
+/// order as the original values compare field by field; small keys are stored inline, without
+/// heap allocation; intended as a fast map key instead of unstructured
+///
+/// encoding
+///     integers: big-endian with sign bit flipped
+///     floating point: big-endian ieee bits with sign bit flipped for positive and all bits flipped
+///                     for negative values; -0 is encoded as 0, all nans are equal and greater than +inf
+///     time: as 64-bit integer; special values: -infinity < any time < not-a-date-time < +infinity
+///     strings: bytes with 0 escaped as 0,255; terminated with 0,0, thus "a" < "a\0" < "ab"
+class normalized_key
+{
+    public:
+        enum { inline_size = 48 };
+
+        normalized_key& append( comma::int64 v ) { _append( encode( v ) ); return *this; }
+
+        normalized_key& append( double v ) { _append( encode( v ) ); return *this; }
+
+        normalized_key& append( const boost::posix_time::ptime& t ) { _append( encode( t ) ); return *this; }
+
+        normalized_key& append( const std::string& s )
+        {
+            for( char c: s ) { _buffer.push_back( c ); if( c == 0 ) { _buffer.push_back( char( 0xff ) ); } }
+            _buffer.push_back( 0 );
+            _buffer.push_back( 0 );
+            return *this;
+        }
+
+        /// single value encoded as unsigned integer in the same order as the value, e.g. for radix sort
+        static comma::uint64 encode( comma::int64 v ) { return comma::uint64( v ) ^ _sign; }
+
+        static comma::uint64 encode( double v )
+        {
+            if( std::isnan( v ) ) { return ~comma::uint64( 0 ); }
+            if( v == 0 ) { v = 0; }
+            comma::uint64 u;
+            std::memcpy( &u, &v, sizeof( u ) );
+            return u & _sign ? ~u : u | _sign;
+        }
+
+        static comma::uint64 encode( const boost::posix_time::ptime& t )
+        {
+            static_assert( sizeof( boost::posix_time::ptime ) == 8, "expected time of size 8" ); // quick and dirty, same as unstructured::hash
+            comma::int64 v;
+            std::memcpy( &v, &t, sizeof( v ) );
+            return encode( v );
+        }
+
+        /// encode all fields in the order: longs, doubles, time, strings
+        static normalized_key make( const unstructured& u )
+        {
+            normalized_key k;
+            for( auto v: u.longs ) { k.append( v ); }
+            for( auto v: u.doubles ) { k.append( v ); }
+            for( const auto& v: u.time ) { k.append( v ); }
+            for( const auto& v: u.strings ) { k.append( v ); }
+            return k;
+        }
+
+        const char* data() const { return _buffer.data(); }
+
+        std::size_t size() const { return _buffer.size(); }
+
+        bool empty() const { return _buffer.empty(); }
+
+        void clear() { _buffer.clear(); }
+
+        bool operator==( const normalized_key& rhs ) const { return size() == rhs.size() && ( empty() || std::memcmp( data(), rhs.data(), size() ) == 0 ); }
+
+        bool operator!=( const normalized_key& rhs ) const { return !operator==( rhs ); }
+
+        bool operator<( const normalized_key& rhs ) const
+        {
+            std::size_t size = std::min( this->size(), rhs.size() );
+            int c = size == 0 ? 0 : std::memcmp( data(), rhs.data(), size );
+            return c < 0 || ( c == 0 && this->size() < rhs.size() );
+        }
+
+        bool operator>( const normalized_key& rhs ) const { return rhs < *this; }
+
+        /// wyhash-style multiply-mix hash over encoded bytes
+        struct hash
+        {
+            std::size_t operator()( const normalized_key& k ) const
+            {
+                const char* p = k.data();
+                std::size_t size = k.size();
+                comma::uint64 seed = _mix( size ^ 0xa0761d6478bd642full, 0xe7037ed1a0b428dbull );
+                for( ; size >= 8; p += 8, size -= 8 ) { seed = _mix( _read( p, 8 ) ^ 0x8ebc6af09c88c6e3ull, seed ^ 0x589965cc75374cc3ull ); }
+                if( size > 0 ) { seed = _mix( _read( p, size ) ^ 0x1d8e4e27c47d124full, seed ^ 0x589965cc75374cc3ull ); }
+                return _mix( seed, k.size() ^ 0xe7037ed1a0b428dbull );
+            }
+
+            private:
+                static comma::uint64 _read( const char* p, std::size_t size ) { comma::uint64 v = 0; std::memcpy( &v, p, size ); return v; }
+
+                static comma::uint64 _mix( comma::uint64 a, comma::uint64 b )
+                {
+                    #ifdef __SIZEOF_INT128__
+                    __uint128_t r = a;
+                    r *= b;
+                    return comma::uint64( r ) ^ comma::uint64( r >> 64 );
+                    #else // portable 64x64->128 multiplication
+                    comma::uint64 ha = a >> 32, la = a & 0xffffffff, hb = b >> 32, lb = b & 0xffffffff;
+                    comma::uint64 hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+                    comma::uint64 mid = ( ll >> 32 ) + ( hl & 0xffffffff ) + ( lh & 0xffffffff );
+                    comma::uint64 lo = ( ll & 0xffffffff ) | ( mid << 32 );
+                    comma::uint64 hi = hh + ( hl >> 32 ) + ( lh >> 32 ) + ( mid >> 32 );
+                    return lo ^ hi;
+                    #endif
+                }
+        };
+
+    private:
+        static constexpr comma::uint64 _sign = comma::uint64( 1 ) << 63;
+        boost::container::small_vector< char, inline_size > _buffer;
+
+        void _append( comma::uint64 v ) { for( int shift = 56; shift >= 0; shift -= 8 ) { _buffer.push_back( char( ( v >> shift ) & 0xff ) ); } }
+};
+
+} } } // namespace comma { namespace csv { namespace impl {
@@ -0,0 +1,295 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <charconv>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include "../../base/exception.h"
+#include "../../base/types.h"
+#include "../format.h"
+
+namespace comma { namespace csv { namespace impl { namespace numpy_ascii {
+
+// conversions follow comma.csv.stream in python, i.e. numpy.genfromtxt and numpy_scalar_to_string(), for the
+// results to be the same; anything not converted exactly the same way, e.g. integers with underscores, is
+// reported as error, in which case python falls back to its own conversions
+
+static constexpr comma::int64 not_a_date_time = std::numeric_limits< comma::int64 >::min(); // numpy NaT
+static constexpr comma::int64 positive_infinity = 9223371950454775807LL; // as comma.csv.time.POSITIVE_INFINITY
+static constexpr comma::int64 negative_infinity = -9223371950454775807LL - 2; // as comma.csv.time.NEGATIVE_INFINITY
+static constexpr comma::int64 microseconds_per_day = 86400000000LL;
+
+inline bool is_space( char c ) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f'; }
+
+inline void trim( const char*& begin, const char*& end )
+{
+    while( begin < end && is_space( *begin ) ) { ++begin; }
+    while( begin < end && is_space( end[-1] ) ) { --end; }
+}
+
+inline void skip_plus( const char*& begin, const char* end ) // python int() and float() accept leading plus, std::from_chars does not
+{
+    if( begin + 1 < end && *begin == '+' && begin[1] != '+' && begin[1] != '-' ) { ++begin; }
+}
+
+template < typename T > inline void integer_from_ascii( const char* begin, const char* end, char* buf )
+{
+    trim( begin, end );
+    skip_plus( begin, end );
+    T t;
+    auto r = std::from_chars( begin, end, t );
+    if( begin == end || r.ec != std::errc() || r.ptr != end ) { COMMA_THROW( comma::exception, "expected integer, got '" << std::string( begin, end ) << "'" ); }
+    std::memcpy( buf, &t, sizeof( T ) );
+}
+
+inline double double_from_ascii( const char* begin, const char* end )
+{
+    trim( begin, end );
+    skip_plus( begin, end );
+    double d;
+    auto r = std::from_chars( begin, end, d );
+    if( begin == end || r.ec != std::errc() || r.ptr != end || std::memchr( begin, '(', end - begin ) ) { COMMA_THROW( comma::exception, "expected floating point number, got '" << std::string( begin, end ) << "'" ); }
+    return d;
+}
+
+inline unsigned int digits( const char* p, unsigned int n )
+{
+    unsigned int v = 0;
+    for( unsigned int i = 0; i < n; ++i ) { if( p[i] < '0' || p[i] > '9' ) { return std::numeric_limits< unsigned int >::max(); } v = v * 10 + ( p[i] - '0' ); }
+    return v;
+}
+
+inline bool is_leap( int y ) { return ( y % 4 == 0 && y % 100 != 0 ) || y % 400 == 0; }
+
+inline unsigned int days_in_month( int y, unsigned int m ) { static const unsigned int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 }; return m == 2 && is_leap( y ) ? 29 : days[ m - 1 ]; }
+
+inline comma::int64 days_from_civil( int y, unsigned int m, unsigned int d )
+{
+    y -= m <= 2;
+    int era = ( y >= 0 ? y : y - 399 ) / 400;
+    unsigned int yoe = y - era * 400;
+    unsigned int doy = ( 153 * ( m > 2 ? m - 3 : m + 9 ) + 2 ) / 5 + d - 1;
+    unsigned int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return comma::int64( era ) * 146097 + doe - 719468;
+}
+
+inline void civil_from_days( comma::int64 z, int& y, unsigned int& m, unsigned int& d )
+{
+    z += 719468;
+    comma::int64 era = ( z >= 0 ? z : z - 146096 ) / 146097;
+    unsigned int doe = z - era * 146097;
+    unsigned int yoe = ( doe - doe / 1460 + doe / 36524 - doe / 146096 ) / 365;
+    unsigned int doy = doe - ( 365 * yoe + yoe / 4 - yoe / 100 );
+    unsigned int mp = ( 5 * doy + 2 ) / 153;
+    d = doy - ( 153 * mp + 2 ) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = int( yoe + era * 400 ) + ( m <= 2 );
+}
+
+inline comma::int64 time_from_ascii( const char* begin, const char* end ) // as comma.csv.time.to_numpy(): no trimming, fractions truncated to microseconds
+{
+    std::string s( begin, end );
+    if( s.empty() || s == "not-a-date-time" ) { return not_a_date_time; }
+    if( s == "+infinity" || s == "+inf" || s == "infinity" || s == "inf" ) { return positive_infinity; }
+    if( s == "-infinity" || s == "-inf" ) { return negative_infinity; }
+    std::size_t size = end - begin;
+    if( size < 15 || begin[8] != 'T' || ( size > 15 && ( begin[15] != '.' || size > 28 ) ) ) { COMMA_THROW( comma::exception, "expected time as YYYYMMDDTHHMMSS[.ffffff], got '" << s << "'" ); }
+    unsigned int year = digits( begin, 4 ), month = digits( begin + 4, 2 ), day = digits( begin + 6, 2 );
+    unsigned int hours = digits( begin + 9, 2 ), minutes = digits( begin + 11, 2 ), seconds = digits( begin + 13, 2 );
+    unsigned int fraction = 0, n = 0;
+    for( const char* p = begin + 16; p < end; ++p, ++n ) { if( *p < '0' || *p > '9' ) { COMMA_THROW( comma::exception, "expected time, got '" << s << "'" ); } if( n < 6 ) { fraction = fraction * 10 + ( *p - '0' ); } }
+    for( ; n < 6; ++n ) { fraction *= 10; }
+    if( year > 9999 || month < 1 || month > 12 || day < 1 || day > days_in_month( year, month ) || hours > 23 || minutes > 59 || seconds > 59 ) { COMMA_THROW( comma::exception, "expected time, got '" << s << "'" ); }
+    return days_from_civil( year, month, day ) * microseconds_per_day + ( ( hours * 60 + minutes ) * 60 + seconds ) * comma::int64( 1000000 ) + fraction;
+}
+
+template < typename T > inline void integer_to_ascii( std::string& s, const char* buf )
+{
+    T t;
+    std::memcpy( &t, buf, sizeof( T ) );
+    char b[24];
+    s.append( b, std::to_chars( b, b + sizeof( b ), t ).ptr );
+}
+
+inline void double_to_ascii( std::string& s, double d, int precision ) // as python "{:.<precision>g}".format( d )
+{
+    if( std::isnan( d ) ) { s += "nan"; return; } // python does not output sign of nan
+    char b[128];
+    auto r = std::to_chars( b, b + sizeof( b ), d, std::chars_format::general, precision );
+    if( r.ec != std::errc() ) { COMMA_THROW( comma::exception, "failed to output " << d << " with precision " << precision ); }
+    s.append( b, r.ptr );
+}
+
+inline void two_digits( std::string& s, unsigned int v ) { s += char( '0' + v / 10 ); s += char( '0' + v % 10 ); }
+
+inline void time_to_ascii( std::string& s, comma::int64 t ) // as comma.csv.time.from_numpy()
+{
+    if( t == not_a_date_time ) { s += "not-a-date-time"; return; }
+    if( t == positive_infinity ) { s += "+infinity"; return; }
+    if( t == negative_infinity ) { s += "-infinity"; return; }
+    comma::int64 days = t / microseconds_per_day;
+    comma::int64 microseconds = t % microseconds_per_day;
+    if( microseconds < 0 ) { --days; microseconds += microseconds_per_day; }
+    int year;
+    unsigned int month, day;
+    civil_from_days( days, year, month, day );
+    if( year < 1 || year > 9999 ) { COMMA_THROW( comma::exception, "year " << year << " out of supported range [1,9999]" ); }
+    unsigned int seconds = microseconds / 1000000;
+    unsigned int fraction = microseconds % 1000000;
+    two_digits( s, year / 100 );
+    two_digits( s, year % 100 );
+    two_digits( s, month );
+    two_digits( s, day );
+    s += 'T';
+    two_digits( s, seconds / 3600 );
+    two_digits( s, seconds / 60 % 60 );
+    two_digits( s, seconds % 60 );
+    if( fraction == 0 ) { return; }
+    s += '.';
+    for( unsigned int d = 100000; d > 0; d /= 10 ) { s += char( '0' + fraction / d % 10 ); }
+}
+
+inline void from_ascii( const comma::csv::format::element& e, const char* begin, const char* end, char* buf )
+{
+    switch( e.type )
+    {
+        case comma::csv::format::int8: integer_from_ascii< signed char >( begin, end, buf ); break;
+        case comma::csv::format::uint8: integer_from_ascii< unsigned char >( begin, end, buf ); break;
+        case comma::csv::format::int16: integer_from_ascii< comma::int16 >( begin, end, buf ); break;
+        case comma::csv::format::uint16: integer_from_ascii< comma::uint16 >( begin, end, buf ); break;
+        case comma::csv::format::int32: integer_from_ascii< comma::int32 >( begin, end, buf ); break;
+        case comma::csv::format::uint32: integer_from_ascii< comma::uint32 >( begin, end, buf ); break;
+        case comma::csv::format::int64: integer_from_ascii< comma::int64 >( begin, end, buf ); break;
+        case comma::csv::format::uint64: integer_from_ascii< comma::uint64 >( begin, end, buf ); break;
+        case comma::csv::format::float_t:
+        {
+            double d = double_from_ascii( begin, end ); // as numpy: parse as double, then cast
+            if( std::isfinite( d ) && std::abs( d ) > FLT_MAX ) { COMMA_THROW( comma::exception, "value " << d << " out of float range" ); }
+            float f = static_cast< float >( d );
+            std::memcpy( buf, &f, sizeof( float ) );
+            break;
+        }
+        case comma::csv::format::double_t: { double d = double_from_ascii( begin, end ); std::memcpy( buf, &d, sizeof( double ) ); break; }
+        case comma::csv::format::time: { comma::int64 t = time_from_ascii( begin, end ); std::memcpy( buf, &t, sizeof( comma::int64 ) ); break; }
+        case comma::csv::format::fixed_string:
+        {
+            std::size_t size = std::min( std::size_t( end - begin ), e.size );
+            std::memcpy( buf, begin, size );
+            std::memset( buf + size, 0, e.size - size );
+            break;
+        }
+        default: COMMA_THROW( comma::exception, "type " << e.type << " not supported" );
+    }
+}
+
+inline void to_ascii( std::string& s, const comma::csv::format::element& e, const char* buf, int precision )
+{
+    switch( e.type )
+    {
+        case comma::csv::format::int8: integer_to_ascii< signed char >( s, buf ); break;
+        case comma::csv::format::uint8: integer_to_ascii< unsigned char >( s, buf ); break;
+        case comma::csv::format::int16: integer_to_ascii< comma::int16 >( s, buf ); break;
+        case comma::csv::format::uint16: integer_to_ascii< comma::uint16 >( s, buf ); break;
+        case comma::csv::format::int32: integer_to_ascii< comma::int32 >( s, buf ); break;
+        case comma::csv::format::uint32: integer_to_ascii< comma::uint32 >( s, buf ); break;
+        case comma::csv::format::int64: integer_to_ascii< comma::int64 >( s, buf ); break;
+        case comma::csv::format::uint64: integer_to_ascii< comma::uint64 >( s, buf ); break;
+        case comma::csv::format::float_t: { float f; std::memcpy( &f, buf, sizeof( float ) ); double_to_ascii( s, f, precision ); break; }
+        case comma::csv::format::double_t: { double d; std::memcpy( &d, buf, sizeof( double ) ); double_to_ascii( s, d, precision ); break; }
+        case comma::csv::format::time: { comma::int64 t; std::memcpy( &t, buf, sizeof( comma::int64 ) ); time_to_ascii( s, t ); break; }
+        case comma::csv::format::fixed_string: // as numpy: trailing zeroes stripped
+        {
+            std::size_t size = e.size;
+            while( size > 0 && buf[ size - 1 ] == 0 ) { --size; }
+            s.append( buf, size );
+            break;
+        }
+        default: COMMA_THROW( comma::exception, "type " << e.type << " not supported" );
+    }
+}
+
+class codec
+{
+    public:
+        codec( const std::string& f, char delimiter, int precision ): _delimiter( delimiter ), _precision( precision )
+        {
+            comma::csv::format format( f );
+            for( const auto& e: format.elements() )
+            {
+                if( e.swapped() ) { COMMA_THROW( comma::exception, "expected host byte order, got format '" << f << "'" ); }
+                switch( e.type )
+                {
+                    case comma::csv::format::char_t:
+                    case comma::csv::format::long_time:
+                    case comma::csv::format::time_point:
+                        COMMA_THROW( comma::exception, "type '" << comma::csv::format::to_format( e.type ) << "' not supported" );
+                    default:
+                        break;
+                }
+                for( std::size_t i = 0; i < e.count; ++i ) { _elements.push_back( comma::csv::format::element( e.offset + e.size * i, 1, e.size, e.type ) ); }
+            }
+            _size = format.size();
+        }
+
+        std::size_t from_lines( const char* buf, std::size_t size, char* records, std::size_t capacity )
+        {
+            const char* end = buf + size;
+            std::size_t count = 0;
+            for( const char* p = buf; p < end && count < capacity; )
+            {
+                const char* eol = static_cast< const char* >( std::memchr( p, '\n', end - p ) );
+                if( !eol ) { eol = end; }
+                const char* begin = p;
+                const char* line_end = eol;
+                p = eol + 1;
+                while( begin < line_end && ( *begin == ' ' || *begin == '\r' ) ) { ++begin; } // as numpy.genfromtxt
+                while( begin < line_end && ( line_end[-1] == ' ' || line_end[-1] == '\r' ) ) { --line_end; }
+                if( begin == line_end ) { continue; }
+                char* record = records + count * _size;
+                const char* field = begin;
+                for( std::size_t i = 0; i < _elements.size(); ++i )
+                {
+                    if( field > line_end ) { COMMA_THROW( comma::exception, "expected " << _elements.size() << " fields, got " << i << " in line: '" << std::string( begin, line_end ) << "'" ); }
+                    const char* field_end = static_cast< const char* >( std::memchr( field, _delimiter, line_end - field ) );
+                    if( !field_end ) { field_end = line_end; }
+                    from_ascii( _elements[i], field, field_end, record + _elements[i].offset );
+                    field = field_end + 1;
+                }
+                ++count;
+            }
+            return count;
+        }
+
+        const std::string& to_lines( const char* records, std::size_t count )
+        {
+            _buffer.clear();
+            for( std::size_t n = 0; n < count; ++n, records += _size )
+            {
+                for( std::size_t i = 0; i < _elements.size(); ++i )
+                {
+                    if( i > 0 ) { _buffer += _delimiter; }
+                    to_ascii( _buffer, _elements[i], records + _elements[i].offset, _precision );
+                }
+                _buffer += '\n';
+            }
+            return _buffer;
+        }
+
+        std::string error;
+
+    private:
+        char _delimiter;
+        int _precision;
+        std::size_t _size{0};
+        std::vector< comma::csv::format::element > _elements;
+        std::string _buffer;
+};
+
+} } } } // namespace comma { namespace csv { namespace impl { namespace numpy_ascii {
@@ -0,0 +1,59 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include "../../base/types.h"
+
+namespace comma { namespace csv { namespace impl {
+
+/// stable lsd radix sort of fixed-width keys, e.g. encoded with normalized_key::encode()
+///
+/// keys are stored row by row: key i is keys[i*width]...keys[i*width+width-1], the most significant
+/// word first; words are sorted least significant first, each in up to 8 passes of one byte over
+/// array of key word and index, skipping passes where all keys have the same byte; key words are
+/// gathered once per word, not once per pass; small inputs are sorted with std::stable_sort instead
+///
+/// @return indices of keys in sorted order; equal keys are kept in their input order
+inline std::vector< std::size_t > radix_sort( const comma::uint64* keys, std::size_t size, std::size_t width )
+{
+    std::vector< std::size_t > indices( size );
+    std::iota( indices.begin(), indices.end(), 0 );
+    if( size < 2 || width == 0 ) { return indices; }
+    if( size < 256 ) // histograms would cost more than sorting
+    {
+        std::stable_sort( indices.begin(), indices.end(), [&]( std::size_t i, std::size_t j ) { return std::lexicographical_compare( keys + i * width, keys + i * width + width, keys + j * width, keys + j * width + width ); } );
+        return indices;
+    }
+    struct entry { comma::uint64 key; std::size_t index; };
+    std::vector< entry > entries( size );
+    std::vector< entry > sorted( size );
+    std::vector< std::size_t > counts( 8 * 256 );
+    for( std::size_t w = width; w-- > 0; )
+    {
+        std::fill( counts.begin(), counts.end(), 0 );
+        for( std::size_t i = 0; i < size; ++i )
+        {
+            comma::uint64 k = keys[ indices[i] * width + w ];
+            entries[i] = entry{ k, indices[i] };
+            for( unsigned int d = 0; d < 8; ++d ) { ++counts[ d * 256 + ( ( k >> ( d * 8 ) ) & 0xff ) ]; }
+        }
+        for( unsigned int d = 0; d < 8; ++d )
+        {
+            std::size_t* c = &counts[ d * 256 ];
+            unsigned int shift = d * 8;
+            if( c[ ( entries[0].key >> shift ) & 0xff ] == size ) { continue; }
+            for( std::size_t b = 0, sum = 0; b < 256; ++b ) { std::size_t n = c[b]; c[b] = sum; sum += n; }
+            for( const auto& e: entries ) { sorted[ c[ ( e.key >> shift ) & 0xff ]++ ] = e; }
+            entries.swap( sorted );
+        }
+        for( std::size_t i = 0; i < size; ++i ) { indices[i] = entries[i].index; }
+    }
+    return indices;
+}
+
+} } } // namespace comma { namespace csv { namespace impl {
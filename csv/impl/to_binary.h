@@ -42,6 +42,7 @@
 #include "../../csv/format.h"
 #include "../../visiting/visit.h"
 #include "../../visiting/while.h"
+#include "byte_swap.h"
 #include "static_cast.h"
 
 namespace comma { namespace csv { namespace impl {
@@ -173,6 +174,7 @@ inline void to_binary::apply_final( const K&, const T& value )
                 case format::fixed_string: format::traits< std::string >::to_bin( static_cast_impl< std::string >::value( value ), buf, size ); break;
             };
         }
+        if( offsets_[ index_ ]->swapped() ) { swap_field( buf, type, size ); }
     }
     ++index_;
 }
@@ -0,0 +1,219 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+#ifndef WIN32
+#include <poll.h>
+#endif
+#include "../base/exception.h"
+#include "../containers/concurrent_cyclic_buffer.h"
+#include "parallel.h"
+#include "stream.h"
+
+namespace comma { namespace csv {
+
+namespace impl {
+
+struct chunk
+{
+    std::vector< char > input;
+    std::string output;
+    std::exception_ptr error;
+    std::size_t records{0}; // number of lines or binary records in input
+    bool done{false};
+};
+
+class input_buffer : public std::streambuf
+{
+    public:
+        input_buffer( std::vector< char >& v ) { if( !v.empty() ) { setg( &v[0], &v[0], &v[0] + v.size() ); } }
+};
+
+class pool
+{
+    public:
+        pool( unsigned int size, std::size_t capacity, std::size_t record_size, const parallel::filter_type& filter ): _filter( filter ), _record_size( record_size ), _queue( capacity )
+        {
+            for( unsigned int i = 0; i < size; ++i ) { _threads.emplace_back( &pool::_run, this ); }
+        }
+
+        ~pool()
+        {
+            _queue.close();
+            for( auto& t: _threads ) { t.join(); }
+        }
+
+        void push( const std::shared_ptr< chunk >& c ) { _queue.wait_push( c ); }
+
+        void wait( const chunk& c )
+        {
+            std::unique_lock< std::mutex > lock( _mutex );
+            _done.wait( lock, [&]() { return c.done; } );
+        }
+
+        bool done( const chunk& c )
+        {
+            std::lock_guard< std::mutex > lock( _mutex );
+            return c.done;
+        }
+
+    private:
+        parallel::filter_type _filter;
+        std::size_t _record_size;
+        std::vector< std::thread > _threads;
+        comma::mpmc_cyclic_buffer< std::shared_ptr< chunk > > _queue;
+        std::mutex _mutex;
+        std::condition_variable _done;
+
+        void _run()
+        {
+            std::shared_ptr< chunk > c;
+            while( _queue.wait_pop( c ) )
+            {
+                try
+                {
+                    input_buffer buf( c->input );
+                    std::istream is( &buf );
+                    std::ostringstream os;
+                    _filter( is, os );
+                    c->output = os.str();
+                }
+                catch( ... ) { c->error = std::current_exception(); }
+                c->records = _record_size == 0 ? std::count( c->input.begin(), c->input.end(), '\n' ) : c->input.size() / _record_size;
+                std::vector< char >().swap( c->input );
+                { std::lock_guard< std::mutex > lock( _mutex ); c->done = true; }
+                _done.notify_all();
+            }
+        }
+};
+
+// end of last whole record or line in input, 0 if none
+static std::size_t end_of_records( const std::vector< char >& input, std::size_t record_size )
+{
+    if( record_size > 0 ) { return input.size() - input.size() % record_size; }
+    auto it = std::find( input.rbegin(), input.rend(), '\n' ); // quick and dirty: does not handle newlines inside quoted fields
+    return it.base() - input.begin();
+}
+
+// true if stream has input that can be read without blocking; streams other than stdin are assumed to be files
+static bool available( std::istream& is )
+{
+    if( is.rdbuf()->in_avail() > 0 || &is != &std::cin ) { return true; }
+#ifndef WIN32
+    pollfd fd{ 0, POLLIN, 0 };
+    return ::poll( &fd, 1, 0 ) > 0; // end of stream also counts as available
+#else
+    return true;
+#endif
+}
+
+// read up to size bytes through stream buffer, blocking only until some input is available, so that live input is not held
+// back until a chunk is full; std::cin unsynchronized with stdio counts bytes in pipe as available, too; return 0 on end of stream
+static std::size_t read_some( std::istream& is, char* buf, std::size_t size )
+{
+    std::streambuf* b = is.rdbuf();
+    if( b->in_avail() <= 0 && std::streambuf::traits_type::eq_int_type( b->sgetc(), std::streambuf::traits_type::eof() ) ) { is.setstate( std::ios_base::eofbit ); return 0; }
+    std::streamsize available = std::max( b->in_avail(), std::streamsize( 1 ) ); // at least the character just peeked
+    return b->sgetn( buf, std::min( std::size_t( available ), size ) );
+}
+
+// read next chunk of whole records into input, keeping incomplete record in tail; return false on end of stream
+// chunk is cut short, if a whole record has been read and no more input is available yet, e.g. on live stream
+static bool read( std::istream& is, std::vector< char >& tail, std::vector< char >& input, std::size_t record_size, std::size_t chunk_size )
+{
+    input.swap( tail );
+    tail.clear();
+    std::size_t end = end_of_records( input, record_size );
+    while( end == 0 || ( input.size() < chunk_size && available( is ) ) )
+    {
+        std::size_t size = input.size();
+        input.resize( size + ( size < chunk_size ? chunk_size - size : chunk_size ) ); // line longer than chunk: read more
+        input.resize( size + read_some( is, &input[0] + size, input.size() - size ) );
+        if( input.size() == size ) { return false; } // last chunk, possibly with incomplete record: let the filter deal with it as it would with std::cin
+        end = end_of_records( input, record_size );
+    }
+    tail.assign( input.begin() + end, input.end() );
+    input.resize( end );
+    return true;
+}
+
+// rethrow chunk error, telling where the chunk starts, since filter counts lines from the beginning of chunk
+static void rethrow( const std::exception_ptr& error, std::size_t offset, std::size_t record_size )
+{
+    std::ostringstream oss;
+    oss << "in chunk starting at " << ( record_size == 0 ? "line " : "record " ) << ( offset + 1 ) << ": ";
+    try { std::rethrow_exception( error ); }
+    catch( const comma::exception& ex ) { throw comma::exception( oss.str() + ex.error(), ex.file(), ex.line(), ex.function() ); }
+    catch( const std::exception& ex ) { COMMA_THROW( comma::exception, oss.str() << ex.what() ); }
+}
+
+} // namespace impl {
+
+parallel::parallel( unsigned int threads, std::size_t record_size, std::size_t chunk_size )
+    : _threads( threads )
+    , _record_size( record_size )
+    , _chunk_size( record_size == 0 ? std::max( chunk_size, std::size_t( 1 ) ) : std::max( chunk_size / record_size, std::size_t( 1 ) ) * record_size )
+{
+}
+
+parallel::parallel( const comma::command_line_options& options, std::size_t record_size )
+    : parallel( options.value< unsigned int >( "--threads", 1 ), record_size, options.value< std::size_t >( "--threads-chunk-size", 1048576 ) )
+{
+}
+
+void parallel::operator()( std::istream& is, std::ostream& os, const filter_type& filter ) const
+{
+    if( _threads < 2 ) { filter( is, os ); return; }
+    comma::csv::detail::unsynchronize_with_stdio(); // for std::cin to tell how much input is available
+    impl::pool pool( _threads, 2 * _threads, _record_size, filter );
+    std::deque< std::shared_ptr< impl::chunk > > pending; // chunks in input order
+    std::vector< char > tail;
+    std::size_t records = 0; // lines or records output so far
+    bool more = true;
+    while( more || !pending.empty() )
+    {
+        while( !pending.empty() && pool.done( *pending.front() ) ) // output as soon as chunk at the head is done
+        {
+            const impl::chunk& c = *pending.front();
+            if( c.error ) { impl::rethrow( c.error, records, _record_size ); }
+            os.write( &c.output[0], c.output.size() );
+            os.flush();
+            records += c.records;
+            pending.pop_front();
+        }
+        if( more && pending.size() < 2 * _threads && ( pending.empty() || impl::available( is ) ) ) // keep a bounded number of chunks in memory; do not block on input, while chunks are in progress
+        {
+            auto c = std::make_shared< impl::chunk >();
+            more = impl::read( is, tail, c->input, _record_size, _chunk_size );
+            if( c->input.empty() ) { continue; }
+            pending.push_back( c );
+            pool.push( c );
+            continue;
+        }
+        if( !pending.empty() ) { pool.wait( *pending.front() ); }
+    }
+}
+
+std::string parallel::usage( unsigned int indent )
+{
+    std::string i( indent, ' ' );
+    std::ostringstream oss;
+    oss << i << "--threads=<n>; default=1: process input in chunks on <n> threads, output in input order" << std::endl;
+    oss << i << "                          efficient on large inputs; chunks are read as whole lines (or whole records for binary)" << std::endl;
+    oss << i << "                          on live streams, chunks are cut short to whole records available so far" << std::endl;
+    oss << i << "                          line numbers in error messages are counted from the beginning of chunk," << std::endl;
+    oss << i << "                          whose first line (or record) number is prepended to the error message" << std::endl;
+    oss << i << "--threads-chunk-size=<bytes>; default=1048576: maximum size of input chunk" << std::endl;
+    return oss.str();
+}
+
+} } // namespace comma { namespace csv {
@@ -0,0 +1,53 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include "../application/command_line_options.h"
+
+namespace comma { namespace csv {
+
+/// run a stateless stream filter on large input in parallel
+///
+/// input is read in chunks of whole records: for ascii, chunks end on newline; for binary,
+/// chunk size is a multiple of record size; each chunk is passed to the filter as an input stream
+/// on a thread pool; filter output for each chunk is buffered and written in input order
+///
+/// filter must not keep state across chunks (e.g. line numbers, previous record, etc),
+/// since each chunk is processed independently and possibly concurrently with other chunks
+///
+/// usage:
+///     auto filter = [&]( std::istream& is, std::ostream& os ) { ... }; // same loop as for std::cin and std::cout
+///     comma::csv::parallel( options, csv.binary() ? csv.format().size() : 0 )( std::cin, std::cout, filter );
+class parallel
+{
+    public:
+        typedef std::function< void( std::istream&, std::ostream& ) > filter_type;
+
+        /// @param threads number of worker threads; 0 or 1: run filter on given streams in the calling thread
+        /// @param record_size binary record size; 0: ascii
+        /// @param chunk_size approximate chunk size in bytes; rounded down to whole records
+        parallel( unsigned int threads, std::size_t record_size = 0, std::size_t chunk_size = 1048576 );
+
+        /// construct from --threads and --threads-chunk-size command line options
+        parallel( const comma::command_line_options& options, std::size_t record_size = 0 );
+
+        /// read input until its end, filter and output it
+        /// @throw exception thrown by filter on any chunk, rethrown in the calling thread
+        void operator()( std::istream& is, std::ostream& os, const filter_type& filter ) const;
+
+        unsigned int threads() const { return _threads; }
+
+        static std::string usage( unsigned int indent = 0 );
+
+    private:
+        unsigned int _threads;
+        std::size_t _record_size;
+        std::size_t _chunk_size;
+};
+
+} } // namespace comma { namespace csv {
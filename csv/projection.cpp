@@ -0,0 +1,104 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <algorithm>
+#include "../base/exception.h"
+#include "projection.h"
+#include "stream.h"
+
+namespace comma { namespace csv {
+
+namespace impl {
+
+// read up to size bytes, blocking only until some input is available, as in parallel.cpp; return 0 on end of stream
+static std::size_t read_some( std::istream& is, char* buf, std::size_t size )
+{
+    std::streambuf* b = is.rdbuf();
+    if( b->in_avail() <= 0 && std::streambuf::traits_type::eq_int_type( b->sgetc(), std::streambuf::traits_type::eof() ) ) { is.setstate( std::ios_base::eofbit ); return 0; }
+    std::streamsize available = std::max( b->in_avail(), std::streamsize( 1 ) ); // at least the character just peeked
+    return b->sgetn( buf, std::min( std::size_t( available ), size ) );
+}
+
+} // namespace impl {
+
+projection::projection( std::size_t input_size, const std::vector< std::pair< std::size_t, std::size_t > >& fields ): _input_size( input_size )
+{
+    for( const auto& f: fields ) { push_back( f.first, f.second ); }
+}
+
+projection& projection::push_back( std::size_t offset, std::size_t size )
+{
+    COMMA_ASSERT_BRIEF( offset + size <= _input_size, "field at offset " << offset << " of size " << size << " exceeds record size " << _input_size );
+    if( size == 0 ) { return *this; }
+    if( !_spans.empty() && _spans.back().offset + _spans.back().size == offset ) { _spans.back().size += size; }
+    else { _spans.push_back( span( offset, size, _size ) ); }
+    _size += size;
+    return *this;
+}
+
+char* projection::operator()( const char* input, char* output ) const
+{
+    for( const auto& s: _spans ) { std::memcpy( output + s.output_offset, input + s.offset, s.size ); }
+    return output + _size;
+}
+
+char* projection::operator()( const char* input, std::size_t count, char* output ) const
+{
+    if( identity() ) { std::memcpy( output, input, count * _size ); return output + count * _size; }
+    if( _spans.size() == 1 ) // quick path for the most common case of contiguous projection, e.g. a leading timestamp
+    {
+        const char* in = input + _spans[0].offset;
+        for( std::size_t i = 0; i < count; ++i, in += _input_size, output += _size ) { std::memcpy( output, in, _size ); }
+        return output;
+    }
+    for( std::size_t i = 0; i < count; ++i, input += _input_size ) { output = operator()( input, output ); }
+    return output;
+}
+
+projector::projector( const csv::projection& projection, std::size_t block_size, bool flush )
+    : _projection( projection )
+    , _flush( flush )
+{
+    COMMA_ASSERT_BRIEF( _projection.input_size() > 0, "expected non-zero record size" );
+    std::size_t records = flush ? 1 : std::max( block_size / _projection.input_size(), std::size_t( 1 ) );
+    _input.resize( records * _projection.input_size() );
+    if( !_projection.identity() ) { _output.resize( records * _projection.size() ); }
+}
+
+std::size_t projector::operator()( std::istream& is, std::ostream& os, std::size_t& skip, long int& count )
+{
+    comma::csv::detail::unsynchronize_with_stdio(); // for std::cin to tell how much input is available
+    const std::size_t record_size = _projection.input_size();
+    std::size_t written = 0;
+    std::size_t end = 0; // bytes in input buffer, the last of them possibly an incomplete record
+    _incomplete = 0;
+    while( count != 0 )
+    {
+        if( !_flush && is.rdbuf()->in_avail() <= 0 ) { os.flush(); } // input ran dry: do not hold back output of live stream
+        std::size_t size = impl::read_some( is, &_input[end], _input.size() - end );
+        if( size == 0 ) { _incomplete = end; break; }
+        end += size;
+        std::size_t records = end / record_size;
+        const std::size_t whole = records * record_size;
+        const char* begin = &_input[0];
+        std::size_t skipped = std::min( skip, records );
+        skip -= skipped;
+        records -= skipped;
+        begin += skipped * record_size;
+        if( count > 0 && records > std::size_t( count ) ) { records = count; }
+        if( records > 0 )
+        {
+            if( _projection.identity() ) { os.write( begin, records * record_size ); }
+            else { os.write( &_output[0], _projection( begin, records, &_output[0] ) - &_output[0] ); }
+            if( _flush ) { os.flush(); }
+            written += records;
+            if( count > 0 ) { count -= records; }
+        }
+        std::memmove( &_input[0], &_input[0] + whole, end - whole );
+        end -= whole;
+    }
+    return written;
+}
+
+} } // namespace comma { namespace csv {
@@ -0,0 +1,99 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace comma { namespace csv {
+
+/// gather plan for projecting fields of fixed-size binary records into contiguous output records
+///
+/// fields are added in output order as offset and size in the input record; adjacent fields
+/// (i.e. a field starting right where the previous one ends) are coalesced into a single copy span
+///
+/// usage:
+///     csv::projection p( csv.format().size() );
+///     for( auto i: output_field_indices ) { p.push_back( csv.format().offset( i ).offset, csv.format().offset( i ).size ); }
+///     p( input, count, output ); // project count records from input to output
+class projection
+{
+    public:
+        struct span
+        {
+            std::size_t offset{0}; /// offset in input record
+            std::size_t size{0}; /// number of bytes to copy
+            std::size_t output_offset{0}; /// offset in output record
+            span() = default;
+            span( std::size_t offset, std::size_t size, std::size_t output_offset ): offset( offset ), size( size ), output_offset( output_offset ) {}
+        };
+
+        projection( std::size_t input_size = 0 ): _input_size( input_size ) {}
+
+        projection( std::size_t input_size, const std::vector< std::pair< std::size_t, std::size_t > >& fields );
+
+        /// append field given by its offset and size in the input record
+        projection& push_back( std::size_t offset, std::size_t size );
+
+        /// return input record size
+        std::size_t input_size() const { return _input_size; }
+
+        /// return output record size
+        std::size_t size() const { return _size; }
+
+        /// return copy spans
+        const std::vector< span >& spans() const { return _spans; }
+
+        /// return true, if output record is the same as input record
+        bool identity() const { return _spans.size() == 1 && _spans[0].offset == 0 && _spans[0].size == _input_size; }
+
+        /// project a single record; return pointer past the end of output record
+        char* operator()( const char* input, char* output ) const;
+
+        /// project count contiguous records; return pointer past the end of output
+        char* operator()( const char* input, std::size_t count, char* output ) const;
+
+    private:
+        std::size_t _input_size{0};
+        std::size_t _size{0};
+        std::vector< span > _spans;
+};
+
+/// read fixed-size records in large blocks, project them and write each projected block with a single write;
+/// reads return whatever input is available up to block size, and output is flushed whenever input runs dry,
+/// so that records of a live stream are not held back until a block is full
+class projector
+{
+    public:
+        /// @param block_size input block size in bytes, rounded down to a whole number of records (but at least one record)
+        /// @param flush if true, read, write, and flush one record at a time for real-time streams
+        projector( const csv::projection& projection, std::size_t block_size = 65536, bool flush = false );
+
+        /// read records from input until end of stream or until count records written
+        /// @param skip number of records to skip before output; decremented as records are skipped
+        /// @param count maximum number of records to write; negative: no limit; decremented as records are written
+        /// @return number of records written; if input ends in the middle of record, all whole records are written
+        ///         and incomplete() tells the number of bytes left
+        std::size_t operator()( std::istream& is, std::ostream& os, std::size_t& skip, long int& count );
+
+        /// convenience method: read and project all records
+        std::size_t operator()( std::istream& is, std::ostream& os ) { std::size_t skip = 0; long int count = -1; return operator()( is, os, skip, count ); }
+
+        const csv::projection& projection() const { return _projection; }
+
+        /// return number of bytes of incomplete record at the end of input in the last call, 0 if none
+        std::size_t incomplete() const { return _incomplete; }
+
+    private:
+        csv::projection _projection;
+        bool _flush;
+        std::size_t _incomplete{0};
+        std::vector< char > _input;
+        std::vector< char > _output;
+};
+
+} } // namespace comma { namespace csv {
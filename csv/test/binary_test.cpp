@@ -389,6 +389,40 @@ TEST( csv, binary_put )
     // todo
 }
 
+TEST( csv, binary_endianness )
+{
+    const std::string prefix = comma::csv::format::host_endianness == comma::csv::format::little_endian ? ">" : "<";
+    const std::string f = prefix + "i," + prefix + "d,b," + prefix + "t," + prefix + "tp," + prefix + "2i";
+    comma::csv::binary_test::simple_struct t;
+    t.a = 1;
+    t.b = 2;
+    t.c = 'c';
+    t.t = boost::posix_time::from_iso_string( "20110304T111111.1234" );
+    t.p = comma::timing::as_time_point( boost::posix_time::from_iso_string( "20110304T111111.5678" ) );
+    t.nested.x = 5;
+    t.nested.y = 6;
+    char buf[1024];
+    comma::csv::binary< comma::csv::binary_test::simple_struct > b( f );
+    b.put( t, buf );
+    std::string copy( buf, b.format().size() );
+    b.format().to_host( &copy[0] );
+    comma::csv::binary_test::simple_struct s;
+    comma::csv::binary< comma::csv::binary_test::simple_struct >( "i,d,b,t,tp,2i" ).get( s, &copy[0] );
+    EXPECT_EQ( 1, s.a );
+    EXPECT_EQ( 2, s.b );
+    EXPECT_EQ( 5, s.nested.x );
+    EXPECT_EQ( 6, s.nested.y );
+    comma::csv::binary_test::simple_struct r;
+    b.get( r, buf );
+    EXPECT_EQ( 1, r.a );
+    EXPECT_EQ( 2, r.b );
+    EXPECT_EQ( 'c', r.c );
+    EXPECT_EQ( t.t, r.t );
+    EXPECT_EQ( t.p, r.p );
+    EXPECT_EQ( 5, r.nested.x );
+    EXPECT_EQ( 6, r.nested.y );
+}
+
 TEST( csv, binary_optional_element )
 {
     // todo
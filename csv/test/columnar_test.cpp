@@ -0,0 +1,113 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include "../../io/impl/filesystem.h"
+#include "../../visiting/traits.h"
+#include "../binary.h"
+#include "../columnar.h"
+#include "../stream.h"
+
+namespace comma { namespace csv { namespace columnar_test {
+
+struct record { comma::uint32 id{0}; double x{0}; double y{0}; float z{0}; };
+
+struct point { double x{0}; float z{0}; };
+
+static std::string make_dir()
+{
+    comma::filesystem::path p = comma::filesystem::temp_directory_path() / ( "comma-columnar-test-" + std::to_string( ::getpid() ) );
+    comma::filesystem::remove_all( p );
+    return p.string();
+}
+
+} } } // namespace comma { namespace csv { namespace columnar_test {
+
+namespace comma { namespace visiting {
+
+template <> struct traits< comma::csv::columnar_test::record >
+{
+    template < typename K, typename V > static void visit( const K&, const comma::csv::columnar_test::record& t, V& v ) { v.apply( "id", t.id ); v.apply( "x", t.x ); v.apply( "y", t.y ); v.apply( "z", t.z ); }
+    template < typename K, typename V > static void visit( const K&, comma::csv::columnar_test::record& t, V& v ) { v.apply( "id", t.id ); v.apply( "x", t.x ); v.apply( "y", t.y ); v.apply( "z", t.z ); }
+};
+
+template <> struct traits< comma::csv::columnar_test::point >
+{
+    template < typename K, typename V > static void visit( const K&, const comma::csv::columnar_test::point& t, V& v ) { v.apply( "x", t.x ); v.apply( "z", t.z ); }
+    template < typename K, typename V > static void visit( const K&, comma::csv::columnar_test::point& t, V& v ) { v.apply( "x", t.x ); v.apply( "z", t.z ); }
+};
+
+} } // namespace comma { namespace visiting {
+
+namespace comma { namespace csv { namespace columnar_test {
+
+TEST( columnar, write_read )
+{
+    const std::string dir = make_dir();
+    csv::binary< record > binary( "ui,2d,f" );
+    std::vector< char > records( 10 * binary.format().size() );
+    for( unsigned int i = 0; i < 10; ++i ) { record r; r.id = i; r.x = i * 2; r.y = i * 3; r.z = i * 4; binary.put( r, &records[0] + i * binary.format().size() ); }
+    {
+        columnar::writer writer( dir, binary.format(), "id,x,y,z", 3 ); // chunk smaller than number of rows
+        writer.write( &records[0], 4 );
+        writer.write( &records[0] + 4 * binary.format().size(), 6 );
+    }
+    columnar::header header = columnar::header::load( dir );
+    EXPECT_EQ( "ui,d,d,f", header.format.string() );
+    EXPECT_EQ( 10, header.size );
+    EXPECT_EQ( 2, header.index( "y" ) );
+    EXPECT_EQ( 3, header.index( "3" ) );
+    EXPECT_THROW( header.index( "w" ), comma::exception );
+    EXPECT_EQ( 10 * sizeof( double ), comma::filesystem::file_size( columnar::filename( dir, 1 ) ) );
+    {
+        columnar::reader reader( dir, "z,x", 4 );
+        EXPECT_EQ( "f,d", reader.format().string() );
+        EXPECT_EQ( "z,x", reader.fields() );
+        std::vector< char > buf( 10 * reader.format().size() );
+        EXPECT_EQ( 7, reader.read( &buf[0], 7 ) );
+        EXPECT_EQ( 3, reader.read( &buf[0] + 7 * reader.format().size(), 7 ) );
+        EXPECT_EQ( 0, reader.read( &buf[0], 7 ) );
+        for( unsigned int i = 0; i < 10; ++i )
+        {
+            EXPECT_EQ( i * 4, *reinterpret_cast< const float* >( &buf[0] + i * 12 ) );
+            EXPECT_EQ( i * 2, *reinterpret_cast< const double* >( &buf[0] + i * 12 + 4 ) );
+        }
+    }
+    {
+        columnar::reader reader( dir );
+        std::vector< char > buf( records.size() );
+        EXPECT_EQ( 10, reader.read( &buf[0], 100 ) );
+        EXPECT_EQ( records, buf );
+    }
+    comma::filesystem::remove_all( dir );
+}
+
+TEST( columnar, input_stream )
+{
+    const std::string dir = make_dir();
+    {
+        csv::binary< record > binary( "ui,2d,f" );
+        columnar::writer writer( dir, binary.format(), "id,x,y,z" );
+        std::vector< char > buf( binary.format().size() );
+        for( unsigned int i = 0; i < 5; ++i ) { record r; r.id = i; r.x = i + 0.5; r.z = i * 2; binary.put( r, &buf[0] ); writer.write( &buf[0] ); }
+    }
+    columnar::istream is( dir, "x,z", 2 );
+    csv::options csv;
+    csv.fields = is.reader().fields();
+    csv.format( is.reader().format() );
+    csv::input_stream< point > stream( is, csv );
+    for( unsigned int i = 0; i < 5; ++i )
+    {
+        const point* p = stream.read();
+        ASSERT_TRUE( p != nullptr );
+        EXPECT_EQ( i + 0.5, p->x );
+        EXPECT_EQ( i * 2, p->z );
+    }
+    EXPECT_TRUE( stream.read() == nullptr );
+    comma::filesystem::remove_all( dir );
+}
+
+} } } // namespace comma { namespace csv { namespace columnar_test {
@@ -416,3 +416,47 @@ TEST( csv, collapse )
     EXPECT_EQ( "s[10],s[10]", comma::csv::format( "s[10],s[10]" ).collapsed_string() );
     EXPECT_EQ( "i,3f,s[10],2f", comma::csv::format( "i,f,f,f,s[10],f,f" ).collapsed_string() );
 }
+
+TEST( csv, format_endianness )
+{
+    typedef comma::csv::format format;
+    EXPECT_EQ( format::native, format( "d" ).elements()[0].endianness );
+    EXPECT_EQ( format::big_endian, format( ">3d" ).elements()[0].endianness );
+    EXPECT_EQ( format::big_endian, format( "3>d" ).elements()[0].endianness );
+    EXPECT_EQ( format::little_endian, format( "<ui" ).elements()[0].endianness );
+    EXPECT_EQ( 3, format( ">3d" ).count() );
+    EXPECT_EQ( 24, format( ">3d" ).size() );
+    EXPECT_THROW( format( ">3<d" ), comma::exception );
+    EXPECT_THROW( format( ">" ), comma::exception );
+    EXPECT_EQ( "<d,<d,>ui", format( "<2d,>ui" ).expanded_string() );
+    EXPECT_EQ( "<2d,>ui,ui", format( "<d,<d,>ui,ui" ).collapsed_string() );
+    EXPECT_EQ( "<2d,>ui,ui", format( format( "<d,<d,>ui,ui" ).collapsed_string() ).collapsed_string() );
+    const format::endianness_enum foreign = format::host_endianness == format::little_endian ? format::big_endian : format::little_endian;
+    const std::string prefix = foreign == format::big_endian ? ">" : "<";
+    EXPECT_FALSE( format( "3d,ui" ).swapped() );
+    EXPECT_FALSE( format( format::host_endianness == format::little_endian ? "<3d" : ">3d" ).swapped() );
+    EXPECT_FALSE( format( prefix + "b," + prefix + "s[4]" ).swapped() );
+    EXPECT_TRUE( format( prefix + "d" ).swapped() );
+    {
+        format f( ">uw,>ui,<ui" ); // bytes do not depend on host byte order
+        std::string bin = f.csv_to_bin( "258,16909060,16909060" );
+        EXPECT_EQ( std::string( "\x01\x02\x01\x02\x03\x04\x04\x03\x02\x01", 10 ), bin );
+        EXPECT_EQ( "258,16909060,16909060", f.bin_to_csv( bin ) );
+    }
+    {
+        format f( prefix + "uw," + prefix + "ui,ui," + prefix + "lt" );
+        std::string bin = f.csv_to_bin( "258,16909060,16909060,20260101T000000.000001" );
+        EXPECT_EQ( "258,16909060,16909060,20260101T000000.000001", f.bin_to_csv( bin ) );
+        std::string host = bin;
+        f.to_host( &host[0] );
+        EXPECT_EQ( format( "uw,ui,ui,lt" ).csv_to_bin( "258,16909060,16909060,20260101T000000.000001" ), host );
+        f.from_host( &host[0] );
+        EXPECT_EQ( bin, host );
+    }
+    {
+        format f( prefix + "3d" );
+        std::string bin = f.csv_to_bin( "1,2,3" ) + f.csv_to_bin( "4,5,6" );
+        f.to_host( &bin[0], 2 );
+        EXPECT_EQ( format( "3d" ).csv_to_bin( "1,2,3" ) + format( "3d" ).csv_to_bin( "4,5,6" ), bin );
+    }
+}
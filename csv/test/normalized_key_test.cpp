@@ -0,0 +1,95 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include "../impl/normalized_key.h"
+
+namespace comma { namespace csv { namespace impl {
+
+template < typename T > static normalized_key key( const T& t ) { normalized_key k; k.append( t ); return k; }
+
+template < typename T > static void expect_sorted( const std::vector< T >& v )
+{
+    for( std::size_t i = 0; i + 1 < v.size(); ++i )
+    {
+        EXPECT_TRUE( key( v[i] ) < key( v[i + 1] ) ) << "at " << i;
+        EXPECT_FALSE( key( v[i + 1] ) < key( v[i] ) ) << "at " << i;
+        EXPECT_NE( key( v[i] ), key( v[i + 1] ) ) << "at " << i;
+    }
+}
+
+TEST( normalized_key, longs )
+{
+    expect_sorted( std::vector< comma::int64 >{ std::numeric_limits< comma::int64 >::min(), -256, -255, -1, 0, 1, 255, 256, 1LL << 40, std::numeric_limits< comma::int64 >::max() } );
+    EXPECT_EQ( key( comma::int64( 12 ) ), key( comma::int64( 12 ) ) );
+}
+
+TEST( normalized_key, doubles )
+{
+    double inf = std::numeric_limits< double >::infinity();
+    expect_sorted( std::vector< double >{ -inf, -1e300, -2.5, -1, -std::numeric_limits< double >::denorm_min(), 0, std::numeric_limits< double >::denorm_min(), 1e-300, 1, 1.5, 2, 1e300, inf, std::numeric_limits< double >::quiet_NaN() } );
+    EXPECT_EQ( key( 0.0 ), key( -0.0 ) );
+    EXPECT_EQ( key( std::numeric_limits< double >::quiet_NaN() ), key( -std::numeric_limits< double >::quiet_NaN() ) );
+}
+
+TEST( normalized_key, time )
+{
+    boost::posix_time::ptime t( boost::gregorian::date( 2020, 1, 1 ) );
+    expect_sorted( std::vector< boost::posix_time::ptime >{ boost::posix_time::neg_infin, boost::posix_time::ptime( boost::gregorian::date( 1960, 1, 1 ) ), t, t + boost::posix_time::microseconds( 1 ), t + boost::posix_time::hours( 1 ), boost::posix_time::not_a_date_time, boost::posix_time::pos_infin } );
+}
+
+TEST( normalized_key, strings )
+{
+    expect_sorted( std::vector< std::string >{ "", std::string( 1, 0 ), std::string( 2, 0 ), "\x01", "a", std::string( "a\0", 2 ), std::string( "a\0b", 3 ), "a\x01", "ab", "abc", "b", "\xff" } );
+    EXPECT_EQ( key( std::string( "abc" ) ), key( std::string( "abc" ) ) );
+}
+
+TEST( normalized_key, composite )
+{
+    auto make = []( comma::int64 l, const std::string& s, double d ) { normalized_key k; k.append( l ).append( s ).append( d ); return k; };
+    EXPECT_TRUE( make( 1, "b", 0 ) < make( 2, "a", 0 ) );
+    EXPECT_TRUE( make( 1, "a", 5 ) < make( 1, "b", 0 ) );
+    EXPECT_TRUE( make( 1, "a", 5 ) < make( 1, "ab", 0 ) );
+    EXPECT_TRUE( make( 1, "a", -5 ) < make( 1, "a", 0 ) );
+    EXPECT_EQ( make( 1, "a", 0 ), make( 1, "a", -0.0 ) );
+    normalized_key k;
+    std::string s( 1000, 'x' ); // beyond inline size
+    k.append( s ).append( comma::int64( 5 ) );
+    normalized_key c = k;
+    EXPECT_EQ( k, c );
+}
+
+TEST( normalized_key, unstructured )
+{
+    unstructured u;
+    u.resize( "s[8],l,d,t" );
+    u.longs[0] = 5;
+    u.doubles[0] = 1.5;
+    u.strings[0] = "hello";
+    u.time[0] = boost::posix_time::from_iso_string( "20200101T000000" );
+    unstructured v = u;
+    EXPECT_EQ( normalized_key::make( u ), normalized_key::make( v ) );
+    EXPECT_EQ( normalized_key::hash()( normalized_key::make( u ) ), normalized_key::hash()( normalized_key::make( v ) ) );
+    v.strings[0] = "hellO";
+    EXPECT_NE( normalized_key::make( u ), normalized_key::make( v ) );
+    EXPECT_NE( normalized_key::hash()( normalized_key::make( u ) ), normalized_key::hash()( normalized_key::make( v ) ) );
+}
+
+TEST( normalized_key, hash )
+{
+    normalized_key::hash hash;
+    std::vector< std::size_t > hashes;
+    for( comma::int64 i = 0; i < 1000; ++i ) { hashes.push_back( hash( key( i ) ) ); }
+    for( comma::int64 i = 0; i < 1000; ++i ) { hashes.push_back( hash( key( std::to_string( i ) ) ) ); }
+    std::sort( hashes.begin(), hashes.end() );
+    EXPECT_EQ( hashes.end(), std::adjacent_find( hashes.begin(), hashes.end() ) );
+    EXPECT_EQ( hash( normalized_key() ), hash( normalized_key() ) );
+}
+
+} } } // namespace comma { namespace csv { namespace impl {
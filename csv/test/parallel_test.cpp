@@ -0,0 +1,101 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+#include "../../base/exception.h"
+#include "../parallel.h"
+
+namespace comma { namespace csv {
+
+static void to_upper( std::istream& is, std::ostream& os )
+{
+    while( is.good() )
+    {
+        std::string line;
+        std::getline( is, line );
+        if( line.empty() ) { continue; }
+        for( auto& c: line ) { c = std::toupper( c ); }
+        os << line << std::endl;
+    }
+}
+
+TEST( parallel, ascii )
+{
+    std::ostringstream input;
+    std::ostringstream expected;
+    for( unsigned int i = 0; i < 10000; ++i ) { input << "line," << i << ",abc" << std::endl; expected << "LINE," << i << ",ABC" << std::endl; }
+    for( unsigned int threads: { 1, 2, 4 } )
+    {
+        for( std::size_t chunk_size: { 1, 7, 1000, 1048576 } )
+        {
+            std::istringstream is( input.str() );
+            std::ostringstream os;
+            parallel( threads, 0, chunk_size )( is, os, to_upper );
+            EXPECT_EQ( expected.str(), os.str() ) << "threads: " << threads << " chunk size: " << chunk_size;
+        }
+    }
+    std::istringstream is( "abc\ndef" ); // no trailing newline
+    std::ostringstream os;
+    parallel( 3, 0, 2 )( is, os, to_upper );
+    EXPECT_EQ( "ABC\nDEF\n", os.str() );
+}
+
+TEST( parallel, binary )
+{
+    std::string input;
+    for( unsigned int i = 0; i < 1000; ++i ) { input += std::string( 3, char( i % 256 ) ); }
+    auto reverse = []( std::istream& is, std::ostream& os )
+    {
+        char buf[3];
+        while( is.read( buf, 3 ).gcount() == 3 ) { std::swap( buf[0], buf[2] ); buf[1] = 'x'; os.write( buf, 3 ); }
+        COMMA_ASSERT_BRIEF( is.gcount() == 0, "got incomplete record" );
+    };
+    std::istringstream is( input );
+    std::ostringstream os;
+    parallel( 4, 3, 100 )( is, os, reverse );
+    ASSERT_EQ( input.size(), os.str().size() );
+    for( unsigned int i = 0; i < 1000; ++i ) { EXPECT_EQ( std::string( 1, char( i % 256 ) ) + "x" + std::string( 1, char( i % 256 ) ), os.str().substr( i * 3, 3 ) ); }
+}
+
+TEST( parallel, exception )
+{
+    std::ostringstream input;
+    for( unsigned int i = 0; i < 1000; ++i ) { input << i << std::endl; }
+    std::istringstream is( input.str() );
+    std::ostringstream os;
+    auto fail = []( std::istream& is, std::ostream& os )
+    {
+        std::string line;
+        while( std::getline( is, line ) ) { COMMA_ASSERT_BRIEF( line != "500", "failed on 500" ); os << line << std::endl; }
+    };
+    EXPECT_THROW( parallel( 4, 0, 64 )( is, os, fail ), comma::exception );
+    EXPECT_EQ( 0, os.str().find( "0\n1\n2\n" ) );
+    EXPECT_EQ( std::string::npos, os.str().find( "\n500\n" ) );
+}
+
+TEST( parallel, exception_line )
+{
+    std::ostringstream input;
+    for( unsigned int i = 0; i < 1000; ++i ) { input << i << std::endl; }
+    std::istringstream is( input.str() );
+    std::ostringstream os;
+    auto fail = []( std::istream& is, std::ostream& os )
+    {
+        std::string line;
+        for( unsigned int n = 1; std::getline( is, line ); ++n ) { COMMA_ASSERT_BRIEF( line != "500", "line " << n ); }
+    };
+    try { parallel( 4, 0, 64 )( is, os, fail ); FAIL() << "expected exception"; }
+    catch( const comma::exception& ex )
+    {
+        unsigned int start = 0, line = 0; // line 501 of input is line <line> of chunk starting at line <start>
+        ASSERT_EQ( 2, std::sscanf( ex.error(), "in chunk starting at line %u: line %u", &start, &line ) ) << ex.error();
+        EXPECT_LT( 1u, start );
+        EXPECT_EQ( 501u, start + line - 1 );
+    }
+}
+
+} } // namespace comma { namespace csv {
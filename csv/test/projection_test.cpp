@@ -0,0 +1,94 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+#include "../../base/exception.h"
+#include "../projection.h"
+
+namespace comma { namespace csv { namespace projection_test {
+
+TEST( projection, spans )
+{
+    {
+        projection p( 10 );
+        p.push_back( 0, 2 ).push_back( 2, 3 ).push_back( 7, 1 ).push_back( 8, 2 );
+        EXPECT_EQ( 5 + 3, p.size() );
+        ASSERT_EQ( 2, p.spans().size() );
+        EXPECT_EQ( 0, p.spans()[0].offset );
+        EXPECT_EQ( 5, p.spans()[0].size );
+        EXPECT_EQ( 7, p.spans()[1].offset );
+        EXPECT_EQ( 3, p.spans()[1].size );
+        EXPECT_EQ( 5, p.spans()[1].output_offset );
+        EXPECT_FALSE( p.identity() );
+    }
+    {
+        projection p( 4 );
+        p.push_back( 2, 2 ).push_back( 0, 2 ); // swapped, no coalescing
+        EXPECT_EQ( 2, p.spans().size() );
+    }
+    {
+        projection p( 4, { { 0, 1 }, { 1, 3 } } );
+        EXPECT_TRUE( p.identity() );
+    }
+    EXPECT_THROW( projection( 4 ).push_back( 3, 2 ), comma::exception );
+}
+
+TEST( projection, gather )
+{
+    projection p( 4 );
+    p.push_back( 3, 1 ).push_back( 0, 2 ).push_back( 3, 1 );
+    std::string input = "abcdefgh";
+    std::string output( 8, ' ' );
+    EXPECT_EQ( &output[0] + 8, p( &input[0], 2, &output[0] ) );
+    EXPECT_EQ( "dabdhefh", output );
+}
+
+TEST( projector, stream )
+{
+    projection p( 4 );
+    p.push_back( 1, 2 );
+    {
+        std::istringstream is( "abcdefghijklmnop" );
+        std::ostringstream os;
+        EXPECT_EQ( 4, projector( p, 8 )( is, os ) );
+        EXPECT_EQ( "bcfgjkno", os.str() );
+    }
+    {
+        std::istringstream is( "abcdefghijklmnop" );
+        std::ostringstream os;
+        std::size_t skip = 1;
+        long int count = 2;
+        EXPECT_EQ( 2, projector( p, 8 )( is, os, skip, count ) );
+        EXPECT_EQ( "fgjk", os.str() );
+        EXPECT_EQ( 0, skip );
+        EXPECT_EQ( 0, count );
+    }
+    {
+        std::istringstream is( "abcdefghijklmnop" );
+        std::ostringstream os;
+        EXPECT_EQ( 4, projector( projection( 4, { { 0, 4 } } ), 1 )( is, os ) );
+        EXPECT_EQ( "abcdefghijklmnop", os.str() );
+    }
+    {
+        std::istringstream is( "abcdefghijklmn" );
+        std::ostringstream os;
+        projector r( p, 1024 );
+        EXPECT_EQ( 3, r( is, os ) ); // whole records written before incomplete one
+        EXPECT_EQ( "bcfgjk", os.str() );
+        EXPECT_EQ( 2, r.incomplete() );
+    }
+    {
+        std::istringstream is( "abcdefghijklmn" );
+        std::ostringstream os;
+        std::size_t skip = 0;
+        long int count = 3;
+        projector r( p, 1024 );
+        EXPECT_EQ( 3, r( is, os, skip, count ) );
+        EXPECT_EQ( 0, r.incomplete() ); // trailing bytes not read as records, since count reached
+    }
+}
+
+} } } // namespace comma { namespace csv { namespace projection_test {
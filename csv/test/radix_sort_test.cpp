@@ -0,0 +1,56 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../impl/normalized_key.h"
+#include "../impl/radix_sort.h"
+
+namespace comma { namespace csv { namespace impl {
+
+static std::vector< std::size_t > stable_sorted( const std::vector< comma::uint64 >& keys, std::size_t width )
+{
+    std::vector< std::size_t > indices( keys.size() / width );
+    std::iota( indices.begin(), indices.end(), 0 );
+    const comma::uint64* k = &keys[0];
+    std::stable_sort( indices.begin(), indices.end(), [&]( std::size_t i, std::size_t j ) { return std::lexicographical_compare( k + i * width, k + i * width + width, k + j * width, k + j * width + width ); } );
+    return indices;
+}
+
+TEST( radix_sort, stable_sort )
+{
+    for( std::size_t size: { 0, 1, 10, 255, 256, 1000, 20000 } ) // below and above threshold for histograms
+    {
+        for( std::size_t width: { 1, 2, 3 } )
+        {
+            std::vector< comma::uint64 > keys( size * width );
+            for( std::size_t i = 0; i < keys.size(); ++i ) // many equal keys, some constant bytes
+            {
+                comma::uint64 r = std::rand() % 50;
+                keys[i] = i % width == 1 ? r << 40 : ( comma::uint64( 1 ) << 63 ) | ( r * 0x10001 );
+            }
+            if( size == 0 ) { EXPECT_TRUE( radix_sort( nullptr, 0, width ).empty() ); continue; }
+            ASSERT_EQ( stable_sorted( keys, width ), radix_sort( &keys[0], size, width ) ) << "size: " << size << " width: " << width;
+        }
+    }
+}
+
+TEST( radix_sort, encoded )
+{
+    std::vector< double > values( 1000 );
+    for( auto& v: values ) { v = ( std::rand() % 2001 - 1000 ) / 8.0; }
+    values[0] = -0.0;
+    std::vector< comma::uint64 > keys( values.size() );
+    for( std::size_t i = 0; i < values.size(); ++i ) { keys[i] = normalized_key::encode( values[i] ); }
+    std::vector< std::size_t > indices = radix_sort( &keys[0], keys.size(), 1 );
+    std::vector< double > sorted( values.size() );
+    for( std::size_t i = 0; i < indices.size(); ++i ) { sorted[i] = values[ indices[i] ]; }
+    std::stable_sort( values.begin(), values.end() );
+    EXPECT_EQ( values, sorted );
+}
+
+} } } // namespace comma { namespace csv { namespace impl {
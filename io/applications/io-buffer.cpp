@@ -34,6 +34,7 @@
 #include <sysexits.h>
 #include <stdlib.h>
 #include <sys/ioctl.h>
+#include <unistd.h>
 #endif
 
 #include <stdio.h>
@@ -41,28 +42,39 @@
 #include <memory.h>
 #include <iostream>
 #include <cctype>
+#include <cerrno>
+#include <cstring>
 #include <vector>
 #include <fstream>
+#include <memory>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 #include <boost/algorithm/string.hpp>
 #include "../../application/command_line_options.h"
+#include "../../application/signal_flag.h"
 #include "../../base/exception.h"
 #include "../../base/types.h"
 #include "../../io/stream.h"
 #include "../../io/select.h"
+#include "../../io/shm_queue.h"
 #include "../../string/string.h"
 #include "../../csv/stream.h"
 
 void usage( bool verbose = false )
 {
     std::cerr << std::endl;
-    std::cerr << "buffer stdin data to synchronised output data to stdout using a file lock" << std::endl;
+    std::cerr << "buffer stdin data to synchronised output data to stdout using a file lock or a shared memory queue" << std::endl;
     std::cerr << std::endl;
     std::cerr << "usage: io-buffer <in|out> --lock-file <file> [--size <size>] [--lines <num>] --buffer-size <size>" << std::endl;
+    std::cerr << "       io-buffer out --queue <name> [--size <size>] [--lines <num>] --buffer-size <size> [--drop]" << std::endl;
+    std::cerr << "       io-buffer daemon --queue <name> [<options>] > output" << std::endl;
+    std::cerr << "       io-buffer stats --queue <name>" << std::endl;
     std::cerr << std::endl;
     std::cerr << "options" << std::endl;
     std::cerr << " *  --lock-file,--lock=: an exiting or new filepath to be used as a file lock, content will be truncated if it exists." << std::endl;
+    std::cerr << "                        not required, if --queue is given" << std::endl;
+    std::cerr << "    --queue=<name>: name of shared memory queue, e.g. --queue=buffer for /dev/shm/buffer; see daemon operation" << std::endl;
     std::cerr << "    --lines,-n=[<num>]: for line based text input data, buffers number of lines before attempting to write to stdout, default is 1" << std::endl;
     std::cerr << "    --size,-s=[<bytes>]: for binary input data, where each message is of size x in bytes" << std::endl;
     std::cerr << "    --buffer-size,-b=[<size>]: for binary input data, binary storage to store multiple of x sized messages." << std::endl;
@@ -72,7 +84,28 @@ void usage( bool verbose = false )
     std::cerr << std::endl;
     std::cerr << "operations" << std::endl;
     std::cerr << "    out: read in standard input, attempt to write to stdout when buffer is full." << std::endl;
+    std::cerr << "         if --queue given, push buffer as one message to the shared memory queue instead" << std::endl;
     std::cerr << "    in: read in standard input, if buffer is full then write to standard output and exits" << std::endl;
+    std::cerr << "    daemon: create shared memory queue, write messages that 'out' operations push to it to stdout" << std::endl;
+    std::cerr << "            messages of different producers never interleave, thus output consists of whole records" << std::endl;
+    std::cerr << "            or lines; producers block while queue is full, unless --drop given" << std::endl;
+    std::cerr << "    stats: output statistics of running daemon as csv to stdout, see --output-fields" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "out options with --queue" << std::endl;
+    std::cerr << "    --drop: do not wait, if queue is full, drop buffer instead" << std::endl;
+    std::cerr << "    --wait=<seconds>; default=10: wait for daemon to create queue" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "daemon options" << std::endl;
+    std::cerr << "    --capacity=<size>; default=16777216: queue size, see buffer size suffixes below" << std::endl;
+    std::cerr << "    --fair: producers waiting for space are served first-come first-served" << std::endl;
+    std::cerr << "    --keep: keep running after producers detach, until killed" << std::endl;
+    std::cerr << "    --max-producers=<n>; default=64: maximum number of producers attached at the same time" << std::endl;
+    std::cerr << "    --producers=<n>; default=1: exit once queue is empty and at least n producers have come and gone" << std::endl;
+    std::cerr << "    --size,-s=[<bytes>]: if given, producers must use the same record size" << std::endl;
+    std::cerr << "    --stats=<seconds>: output statistics to stderr every given number of seconds, see --output-fields" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "stats options" << std::endl;
+    std::cerr << "    --output-fields: output statistics fields and exit" << std::endl;
     std::cerr << std::endl;
     std::cerr << std::endl;
     std::cerr << "<buffer size suffixes>" << std::endl;
@@ -99,6 +132,12 @@ void usage( bool verbose = false )
     std::cerr << "in operation" << std::endl;
     std::cerr << "          See 'out' operation, in this mode, the program write to standard output and exits when buffer is full." << std::endl;
     std::cerr << "          Call io-buffer multiple times to read more input data." << std::endl;
+    std::cerr << "daemon operation" << std::endl;
+    std::cerr << "        io-buffer daemon --queue buffer --size 512 --producers 3 --stats 1 > output.bin &" << std::endl;
+    std::cerr << "        for i in 1 2 3; do ( source-$i | io-buffer out --queue buffer --size 512 --buffer-size 64kb & ); done" << std::endl;
+    std::cerr << "          Write records from 3 sources to output.bin, output queue statistics every second, exit once all sources are done" << std::endl;
+    std::cerr << "        io-buffer stats --queue buffer" << std::endl;
+    std::cerr << "          Output queue depth and other statistics of the daemon above" << std::endl;
     std::cerr << std::endl;
     std::cerr << std::endl;
     exit( 0 );
@@ -142,18 +181,107 @@ using boost::interprocess::scoped_lock;
 
 static bool strict = false;
 
+typedef comma::io::shm::queue::producer producer_t;
+static std::unique_ptr< producer_t > producer;
+static comma::uint64 dropped = 0;
+
+// push data to queue in messages of whole records or lines
+static void push( const char* buf, std::size_t size, std::size_t record_size )
+{
+    std::size_t max_size = producer->max_size();
+    if( record_size > 0 ) { max_size -= max_size % record_size; }
+    while( size > 0 )
+    {
+        std::size_t n = std::min( size, max_size );
+        if( record_size == 0 && n < size )
+        {
+            const char* end = buf + n;
+            while( end > buf && end[-1] != '\n' ) { --end; }
+            COMMA_ASSERT_BRIEF( end > buf, "line longer than maximum queue message size of " << producer->max_size() << " bytes" );
+            n = end - buf;
+        }
+        if( !producer->push( buf, n ) ) { ++dropped; }
+        buf += n;
+        size -= n;
+    }
+}
+
 static void output_binary( file_lock& lock )
 {
+    if( producer ) { push( &( binary_buffer.get()[0] ), binary_buffer->size(), producer->record_size() ); return; }
     scoped_lock< file_lock > filelock( lock );  // Blocks until it has the lock
     std::cout.write( &(binary_buffer.get()[0]), binary_buffer->size() );
 }
 
 static void output_text( file_lock& lock )
 {
+    if( producer )
+    {
+        std::string s;
+        for( std::size_t i=0; i<lines_buffer->size(); ++i ) { s += lines_buffer.get()[i]; s += '\n'; }
+        push( &s[0], s.size(), 0 );
+        return;
+    }
     scoped_lock< file_lock > filelock( lock );  // Blocks until it has the lock
     for( std::size_t i=0; i<lines_buffer->size(); ++i ) { std::cout << lines_buffer.get()[i] << std::endl;  }
 }
 
+static const char* stats_fields = "t,producers,attached,detached,depth,max_depth,messages,bytes,waits,dropped,lost";
+
+static void output_stats( std::ostream& os, const comma::io::shm::queue::statistics& s )
+{
+    os << boost::posix_time::to_iso_string( boost::posix_time::microsec_clock::universal_time() )
+       << ',' << s.producers << ',' << s.attached << ',' << s.detached << ',' << s.depth << ',' << s.max_depth
+       << ',' << s.messages << ',' << s.bytes << ',' << s.waits << ',' << s.dropped << ',' << s.lost << std::endl;
+}
+
+static void write( const char* buf, std::size_t size ) // write directly from shared memory, bypassing std::cout buffer
+{
+    while( size > 0 )
+    {
+        ssize_t n = ::write( 1, buf, size );
+        if( n < 0 ) { if( errno == EINTR ) { continue; } COMMA_THROW_BRIEF( comma::exception, "failed to write to stdout: " << std::strerror( errno ) ); }
+        buf += n;
+        size -= n;
+    }
+}
+
+static int run_daemon( const comma::command_line_options& options, const std::string& queue )
+{
+    comma::io::shm::queue::options o;
+    o.capacity = get_buffer_size( options.value< std::string >( "--capacity", "16777216" ) );
+    o.record_size = options.value< comma::uint32 >( "--size,-s", 0 );
+    o.producers = options.value< unsigned int >( "--max-producers", 64 );
+    o.fair = options.exists( "--fair" );
+    comma::uint64 expected = options.value< comma::uint64 >( "--producers", 1 );
+    bool keep = options.exists( "--keep" );
+    boost::optional< double > period = options.optional< double >( "--stats" );
+    boost::posix_time::time_duration stats_period = boost::posix_time::microseconds( period ? comma::int64( *period * 1e6 ) : 0 );
+    boost::posix_time::ptime next_stats = period ? boost::posix_time::microsec_clock::universal_time() + stats_period : boost::posix_time::ptime();
+    comma::signal_flag is_shutdown;
+    comma::io::shm::queue::consumer consumer( queue, o );
+    if( verbose ) { std::cerr << name() << "created queue " << comma::io::shm::queue::object_name( queue ) << " of " << consumer.options().capacity << " bytes" << std::endl; }
+    auto output = [&]( const std::pair< const char*, std::size_t >& m )
+    {
+        COMMA_ASSERT_BRIEF( o.record_size == 0 || m.second % o.record_size == 0, "expected message of whole records of size " << o.record_size << "; got message of " << m.second << " bytes" );
+        write( m.first, m.second );
+        consumer.pop();
+    };
+    while( !is_shutdown )
+    {
+        std::pair< const char*, std::size_t > m = consumer.front( boost::posix_time::milliseconds( 100 ) );
+        if( m.first ) { output( m ); }
+        if( period && boost::posix_time::microsec_clock::universal_time() >= next_stats ) { std::cerr << name() << "stats: "; output_stats( std::cerr, consumer.stats() ); next_stats += stats_period; }
+        if( m.first || keep ) { continue; }
+        comma::io::shm::queue::statistics s = consumer.stats();
+        if( s.producers == 0 && s.detached >= expected && consumer.empty() ) { break; }
+    }
+    for( std::pair< const char*, std::size_t > m = consumer.front( boost::posix_time::seconds( 0 ) ); m.first; m = consumer.front( boost::posix_time::seconds( 0 ) ) ) { output( m ); }
+    if( verbose ) { std::cerr << name() << "stats: " << stats_fields << std::endl << name() << "stats: "; output_stats( std::cerr, consumer.stats() ); }
+    consumer.close();
+    return 0;
+}
+
 /// Because we need to use C code for IO input operations
 // This structure help manage the C code, memory allocation and de-allocation
 // ::getline() may actually re-allocate the buffer given to increase the size
@@ -206,14 +334,27 @@ int main( int argc, char** argv )
         if( argc < 2 ) { usage(); }
         comma::command_line_options options( argc, argv, usage );
         comma::uint32 lines_num = options.value( "--lines,-n", 1 );
-        std::string lockfile_path = options.value< std::string >( "--lock-file,--lock" );
+        boost::optional< std::string > queue = options.optional< std::string >( "--queue" );
         boost::optional< comma::uint32 > has_size = options.optional< comma::uint32 >( "--size,s" );
         boost::optional< std::string > buffer_size_string = options.optional< std::string >( "--buffer-size,-b" );
-        const std::vector< std::string >& operation = options.unnamed( "--help,-h,--verbose,-v,--strict", "-.+" );
+        const std::vector< std::string >& operation = options.unnamed( "--help,-h,--verbose,-v,--strict,--drop,--fair,--keep,--output-fields", "-.+" );
         
         strict = options.exists("--strict");
         verbose = options.value( "--verbose,-v", false );
         if( verbose ) { std::cerr << name() << ": called as: " << options.string() << std::endl; }
+        if( !operation.empty() && operation.front() == "stats" )
+        {
+            if( options.exists( "--output-fields" ) ) { std::cout << stats_fields << std::endl; return 0; }
+            COMMA_ASSERT_BRIEF( queue, "stats: please specify --queue" );
+            output_stats( std::cout, comma::io::shm::queue::stats( *queue ) );
+            return 0;
+        }
+        if( !operation.empty() && operation.front() == "daemon" )
+        {
+            COMMA_ASSERT_BRIEF( queue, "daemon: please specify --queue" );
+            return run_daemon( options, *queue );
+        }
+        std::string lockfile_path = queue ? std::string() : options.value< std::string >( "--lock-file,--lock" );
 
         #ifdef WIN32
         if( has_size || operation.size() == 1 ) { _setmode( _fileno( stdout ), _O_BINARY ); }
@@ -222,6 +363,7 @@ int main( int argc, char** argv )
         else if ( operation.front() == "out" ){ }
         else if ( operation.front() == "in" )
         { 
+            if( queue ) { std::cerr << "io-buffer: 'in' operation does not support --queue" << std::endl; return 1; }
 #ifdef WIN32
     std::cerr << "io-buffer: 'in' operation not implemented on windows" << std::endl; return 1;
 #endif // #ifdef WIN32
@@ -247,14 +389,27 @@ int main( int argc, char** argv )
             if( verbose) { std::cerr << "io-buffer: create binary buffer of size " << buffer_size << '(' << comma::uint32(buffer_size / message_size) << " messages)" << std::endl; }
         }
         
-        // Check the lockfile can be opened and  truncated
+        file_lock lock;
+        if( queue )
         {
-            std::ofstream  lockfile( lockfile_path.c_str(), std::ios::trunc | std::ios::out );
-            if( !lockfile.is_open() ) { std::cerr << name() << "failed to open lockfile: " << lockfile_path << std::endl; return 1; }
-            lockfile.close();
+            boost::posix_time::ptime deadline = boost::posix_time::microsec_clock::universal_time() + boost::posix_time::microseconds( comma::int64( options.value( "--wait", 10.0 ) * 1e6 ) );
+            while( !producer )
+            {
+                try { producer.reset( new producer_t( *queue, !options.exists( "--drop" ) ) ); }
+                catch( ... ) { if( boost::posix_time::microsec_clock::universal_time() >= deadline ) { throw; } ::usleep( 10000 ); }
+            }
+            if( producer->record_size() != message_size && producer->record_size() > 0 ) { std::cerr << name() << "queue " << *queue << " expects record size " << producer->record_size() << "; got: " << message_size << std::endl; return 1; }
+        }
+        else
+        {
+            // Check the lockfile can be opened and  truncated
+            {
+                std::ofstream  lockfile( lockfile_path.c_str(), std::ios::trunc | std::ios::out );
+                if( !lockfile.is_open() ) { std::cerr << name() << "failed to open lockfile: " << lockfile_path << std::endl; return 1; }
+                lockfile.close();
+            }
+            file_lock( lockfile_path.c_str() ).swap( lock );  // Note lock file must exists or an exception with crytic message is thrown 
         }
-        
-        file_lock lock( lockfile_path.c_str() );  // Note lock file must exists or an exception with crytic message is thrown 
         if( operation.front() == "in" )
         {
             // Everything IO in this code block must use C function, because we turn stdin buffering off
@@ -356,6 +511,11 @@ int main( int argc, char** argv )
                 if( !output_last && !lines_buffer->empty() ) { output_text(lock); }
             }
         }
+        if( producer )
+        {
+            if( dropped > 0 ) { std::cerr << name() << "dropped " << dropped << " buffer(s), since queue " << *queue << " was full" << std::endl; }
+            producer->close();
+        }
         return 0;
     }
     catch( std::exception& ex ) { std::cerr << "io-buffer: " << ex.what() << std::endl; }
@@ -36,7 +36,6 @@
 #endif
 
 #include <vector>
-#include <boost/asio/ip/udp.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/thread.hpp>
@@ -44,9 +43,12 @@
 #include "../../application/signal_flag.h"
 #include "../../base/exception.h"
 #include "../../base/types.h"
+#include "../../io/compressed.h"
 #include "../../io/select.h"
 #include "../../io/server.h"
+#include "../../io/shm.h"
 #include "../../io/stream.h"
+#include "../../io/udp.h"
 #include "../../string/string.h"
 
 void usage( bool verbose = false )
@@ -61,10 +63,17 @@ usage: io-cat <address> [<address>] ... [<options>]
     tcp:<host>:<port>: tcp socket
     tcp:<port>: tcp server socket (only partly implemented)
     udp:<port>: udp socket
+    udp-multicast:<group>:<port>[;<options>]: join udp multicast group, e.g. written by io-publish udp-multicast:<group>:<port>
+        interface=<address>: address of interface to receive multicast on, e.g. 127.0.0.1; default: chosen by system
+        sequence: packets are prefixed with sequence numbers by io-publish; strip them and report lost packets to stderr
+    udp-broadcast:[<address>:]<port>[;sequence]: same as udp:<port>, but port can be shared by many receivers on the same host
+    shm:<name>: shared memory ring buffer, e.g. written by io-publish shm:<name>
     zmp-<protocol>:<address>: zmq (todo)
     <filename>: file
     <fifo>: named pipe
     -: stdin
+    <address>;compressed[;<options>]: block-compressed stream, e.g. written by io-publish
+                                      run io-cat --help --verbose for compression options
 
 options
     --exit-on-first-closed,-e: exit, if one of the streams finishes
@@ -113,8 +122,9 @@ output order options
                                          before checking other inputs
                                          if not specified, read from each input
                                          all available data
-                                         ignored for udp streams, where one full udp
-                                         packet at a time is always read
+                                         ignored for udp streams, where whole udp
+                                         packets are always read, as many as received
+                                         in one batch (recvmmsg on linux)
     --size=[<bytes>]; on fixed-width binary records, size of the record in bytes, for --round-robin or --head
     
 connect options
@@ -122,18 +132,22 @@ connect options
     --connect-period=<seconds>; default=1; how long to wait before the next connect attempt
     --permissive; run even if connection to some sources fails
     
-supported address types: tcp, udp, local (unix) sockets, named pipes, files, zmq (todo)
+supported address types: tcp, udp (unicast, multicast, broadcast), local (unix) sockets, shared memory, named pipes, files, zmq (todo)
     
 examples
     single stream
         io-cat tcp:localhost:12345
         io-cat udp:12345
+        io-cat "udp-multicast:239.1.2.3:12345;sequence"
+        io-cat shm:/lidar
         io-cat local:/tmp/socket
         io-cat some/pipe
         io-cat some/file
         io-cat zmq-local:/tmp/socket (not implemented)
         io-cat zmq-tcp:localhost:12345 (not implemented)
         echo hello | io-cat -
+        io-cat "points.bin;compressed"
+        io-cat "tcp:localhost:12345;compressed"
     multiple streams
         merge line-based input
             io-cat tcp:localhost:55555 tcp:localhost:88888
@@ -142,6 +156,7 @@ examples
         merge line-based input with stdin
             echo hello | io-cat tcp:localhost:55555 -
 )" << std::endl;
+    if( verbose ) { std::cerr << std::endl << "compression" << std::endl << comma::io::compressed::options::usage( 4 ) << std::endl; }
     exit( 0 );
 }
 
@@ -173,9 +188,13 @@ class udp_stream : public stream
     public:
         udp_stream( const std::string& address ) : stream( address )
         {
-            const std::vector< std::string >& v = comma::split( address, ':' );
-            if( v.size() != 2 ) { COMMA_THROW( comma::exception, "io-cat: expected udp:<port>, e.g. udp:12345, got '" << address << "'" ); }
-            port_ = boost::lexical_cast< unsigned short >( v[1] );
+            std::string stripped = address;
+            options_ = comma::io::udp::options::strip( stripped );
+            options_.packet_size = 65536; // receive packets of any size
+            options_.reuse_address = stripped.substr( 0, 4 ) != "udp:"; // many receivers of multicast or broadcast on the same host
+            comma::io::udp::address a = comma::io::udp::address::from_string( stripped );
+            if( a.multicast ) { options_.group = a.host; }
+            port_ = a.port;
         }
         
         bool eof() const { return false; }
@@ -186,37 +205,45 @@ class udp_stream : public stream
         
         bool closed() const { return false; }
         
-        comma::io::file_descriptor fd() const { return socket_->native_handle(); }
+        comma::io::file_descriptor fd() const { return receiver_->fd(); }
         
-        unsigned int read_available( std::vector< char >& buffer, unsigned int, bool )
+        bool ready( comma::io::select& select ) const { return next_ < receiver_->size() || stream::ready( select ); }
+        
+        unsigned int read_available( std::vector< char >& buffer, unsigned int, bool ) // output whole packets received in one batch, as many as fit in buffer
         {
-            boost::system::error_code error;
-            std::size_t size = socket_->receive( boost::asio::buffer( buffer ), 0, error );
-            return error ? 0 : size;
+            if( next_ == receiver_->size() )
+            {
+                next_ = 0;
+                if( receiver_->receive() == 0 ) { return 0; }
+                if( receiver_->lost() > lost_ ) { std::cerr << "io-cat: " << address_ << ": lost " << ( receiver_->lost() - lost_ ) << " packet(s); total lost: " << receiver_->lost() << std::endl; lost_ = receiver_->lost(); }
+            }
+            std::size_t size = 0;
+            for( ; next_ < receiver_->size(); ++next_ )
+            {
+                const comma::io::udp::packet& packet = ( *receiver_ )[next_];
+                if( size > 0 && size + packet.size > buffer.size() ) { break; }
+                if( size + packet.size > buffer.size() ) { buffer.resize( size + packet.size ); }
+                ::memcpy( &buffer[size], packet.data, packet.size );
+                size += packet.size;
+            }
+            return size;
         }
         
-        bool connected() const { return bool( socket_ ); }
+        bool connected() const { return bool( receiver_ ); }
         
         void connect()
         {
-            if( socket_ ) { return; }
-            socket_.reset( new boost::asio::ip::udp::socket( service_ ) );
-            socket_->open( boost::asio::ip::udp::v4() );
-            boost::system::error_code error;
-            socket_->set_option( boost::asio::ip::udp::socket::broadcast( true ), error );
-            if( error ) { socket_.reset(); COMMA_THROW( comma::exception, "io-cat: udp failed to set broadcast option on port " << port_ ); }
-            socket_->bind( boost::asio::ip::udp::endpoint( boost::asio::ip::udp::v4(), port_ ), error );
-            if( error ) { socket_.reset(); COMMA_THROW( comma::exception, "io-cat: udp failed to bind port " << port_ ); }
+            if( receiver_ ) { return; }
+            try { receiver_.reset( new comma::io::udp::receiver( port_, options_ ) ); }
+            catch( std::exception& ex ) { COMMA_THROW( comma::exception, "io-cat: " << ex.what() ); }
         }
         
     private:
         unsigned short port_;
-#if (BOOST_VERSION >= 106600)
-        boost::asio::io_context service_;
-#else
-        boost::asio::io_service service_;
-#endif
-        mutable boost::scoped_ptr< boost::asio::ip::udp::socket > socket_; // boost::asio::ip::udp::socket::fd() is non-const for some reason
+        comma::io::udp::options options_;
+        boost::scoped_ptr< comma::io::udp::receiver > receiver_;
+        unsigned int next_{0};
+        comma::uint64 lost_{0};
 };
 
 class client_stream : public stream
@@ -228,7 +255,7 @@ class client_stream : public stream
         
         unsigned int read_available( std::vector< char >& buffer, unsigned int max_count, bool blocking )
         {
-            std::size_t available = available_();
+            std::size_t available = compressed_ ? decompressed_available_() : available_();
             if( !blocking && available == 0 ) { return 0; }
             if( binary_ )
             {
@@ -266,6 +293,7 @@ class client_stream : public stream
             if( istream_ ) { return; }
             auto blocking_mode = false ? comma::io::mode::non_blocking : comma::io::mode::blocking; // todo? expose on command line?
             istream_.reset( new comma::io::istream( address_, comma::io::mode::binary, blocking_mode ) );
+            compressed_ = dynamic_cast< comma::io::compressed::istream* >( ( *istream_ )() );
             if( ( *istream_ )() != &std::cin ) { return; }
             std::ios_base::sync_with_stdio( false ); // unsync to make rdbuf()->in_avail() working
             std::cin.tie( NULL ); // std::cin is tied to std::cout by default
@@ -276,16 +304,80 @@ class client_stream : public stream
         unsigned int size_;
         bool binary_;
         bool closed_;
+        comma::io::compressed::istream* compressed_{nullptr}; // compressed stream: decompressed and compressed bytes are counted separately
         
         std::size_t available_() const // seriously quick and dirty
         {
             if( ( *istream_ )() == NULL ) { return ( *istream_ ).available_on_file_descriptor(); } // quick and dirty
+            if( compressed_ ) { return compressed_->buffered() + compressed_->compressed_available() + ( *istream_ ).available_on_file_descriptor(); } // only to tell whether anything is available
+
             std::streamsize s = ( *istream_ )->rdbuf()->in_avail();
             if( s < 0 ) { return 0; }
             // todo: it should be s + available_on_file_descriptor(), but it won't work for std::cin (and potentially for std::ifstream (we have not checked)
             //       if performance becomes a problem e.g. for tcp, check whether the stream is not std::cin and use sum instead of max
             return std::max( static_cast< std::size_t >( s ), ( *istream_ ).available_on_file_descriptor() );
         }
+        
+        std::size_t decompressed_available_() // decompressed bytes buffered; if none, decompress next frame, if any of it is available
+        {
+            if( compressed_->buffered() > 0 ) { return compressed_->buffered(); }
+            if( compressed_->compressed_available() + ( *istream_ ).available_on_file_descriptor() == 0 ) { return 0; }
+            compressed_->peek(); // frames are written whole, thus the rest of the frame is already on its way
+            return compressed_->buffered();
+        }
+};
+
+class shm_stream : public stream
+{
+    public:
+        shm_stream( const std::string& address, bool binary ): stream( address ), _binary( binary ) {}
+
+        unsigned int read_available( std::vector< char >& buffer, unsigned int max_count, bool blocking )
+        {
+            if( _binary )
+            {
+                std::size_t size = _reader->record_size() > 1 && max_count ? std::min( buffer.size(), std::size_t( max_count ) * _reader->record_size() ) : buffer.size();
+                return _reader->read( &buffer[0], size, blocking );
+            }
+            if( _begin == _end ) // ascii: output one line at a time, as client_stream does
+            {
+                _buffer.resize( buffer.size() );
+                _begin = 0;
+                _end = _reader->read( &_buffer[0], _buffer.size(), blocking );
+                if( _end == 0 ) { return 0; }
+            }
+            std::size_t end = std::find( _buffer.begin() + _begin, _buffer.begin() + _end, '\n' ) - _buffer.begin();
+            end = std::min( end + 1, _end );
+            unsigned int size = end - _begin;
+            if( size > buffer.size() ) { buffer.resize( size ); }
+            ::memcpy( &buffer[0], &_buffer[_begin], size );
+            _begin = end;
+            return size;
+        }
+
+        bool eof() const { return _reader && _begin == _end && _reader->eof(); }
+
+        bool empty() const { return !_reader || _closed || ( _begin == _end && _reader->available() == 0 ); }
+
+        void close() { _closed = true; _reader->close(); }
+
+        bool closed() const { return _closed; }
+
+        bool connected() const { return bool( _reader ); }
+
+        void connect() { if( !_reader ) { _reader.reset( new comma::io::shm::reader( address_ ) ); } }
+
+        comma::io::file_descriptor fd() const { return _reader ? _reader->fd() : comma::io::invalid_file_descriptor; } // ready while data available or on end of stream
+
+        bool ready( comma::io::select& select ) const { return _begin != _end || stream::ready( select ); }
+
+    private:
+        bool _binary;
+        bool _closed{false};
+        boost::scoped_ptr< comma::io::shm::reader > _reader;
+        std::vector< char > _buffer;
+        std::size_t _begin{0};
+        std::size_t _end{0};
 };
 
 class server_stream : public stream // todo! super-quick and dirty! get streams from the server instead and add/remove them to/from read methods
@@ -383,7 +475,8 @@ class server_stream : public stream // todo! super-quick and dirty! get streams
 static stream* make_stream( const std::string& address, unsigned int size, bool binary, bool blocking )
 {
     const std::vector< std::string >& v = comma::split( address, ':' );
-    if( v[0] == "udp" ) { return new udp_stream( address ); }
+    if( v[0] == "udp" || v[0] == "udp-multicast" || v[0] == "udp-broadcast" ) { return new udp_stream( address ); }
+    if( v[0] == "shm" ) { return new shm_stream( address, binary ); }
     if( v[0] == "tcp" && v.size() == 2 ) { return new server_stream( address, size, binary, blocking ); } // todo: quick and dirty for now; a better check if tcp:<port>-like
     COMMA_ASSERT_BRIEF( v[0] != "zmq-local" && v[0] != "zero-local" && v[0] != "zmq-tcp" && v[0] != "zero-tcp", "zmq support not implemented" );
     return new client_stream( address, size, binary );
@@ -6,10 +6,13 @@
 #include "../../application/command_line_options.h"
 #include "../../application/signal_flag.h"
 #include "../../base/last_error.h"
+#include "../../io/compressed.h"
 #include "../../io/file_descriptor.h"
 #include "../../io/publisher.h"
 #include "../../io/impl/publish.h"
 #include "../../io/select.h"
+#include "../../io/shm.h"
+#include "../../io/udp.h"
 #include "../../name_value/map.h"
 #include "../../string/string.h"
 #include "../../sync/synchronized.h"
@@ -74,8 +77,13 @@ client options
 output streams: <address>[;<options>]
     <address>
         tcp:<port>: e.g. tcp:1234
-        udp:<port>: e.g. udp:1234 (todo)
+        udp-multicast:<group>:<port>: udp multicast, e.g. udp-multicast:239.1.2.3:1234; read with: io-cat udp-multicast:239.1.2.3:1234
+                                      each record is sent once for all receivers; records or lines are never split across packets
+                                      record size defaults to --size; see io-publish --help --verbose for options
+        udp-broadcast:[<address>:]<port>: udp broadcast, e.g. udp-broadcast:1234; read with: io-cat udp:1234
         local:<name>: linux/unix local server socket e.g. local:./tmp/my_socket
+        shm:<name>: shared memory ring buffer, e.g. shm:/lidar; read with: io-cat shm:/lidar
+                    record size defaults to --size; see io-publish --help --verbose for options
         <named pipe name>: named pipe, which will be re-opened, if client reconnects
         <filename>: a regular file
         -: stdout
@@ -85,12 +93,20 @@ output streams: <address>[;<options>]
                    if a client connects to a 'primary' stream, 'secondary' streams will be opened
                    if last client on a 'primary' stream disconnects, 'secondary' streams will be closed
                    e.g: io-publish tcp:8888 'tcp:9999;secondary'
+        compressed[;<options>]: write block-compressed frames, see io-publish --help --verbose
+                                e.g: io-publish --size 32 'tcp:9999;compressed;size=32;filter=xor'
+                                each flush writes a frame; use --no-flush on high-rate input for better compression
 
 examples
     cat data | io-publish tcp:1234 --size 100
     io-publish tcp:1234 --size 24000 --on-demand --exec \"camera-cat arg1 arg2\"
     io-publish tcp:1234 --size 24000 --on-demand -- camera-cat arg1 arg2
+    cat data | io-publish shm:/data --size 100
+    cat data | io-publish 'udp-multicast:239.1.2.3:1234;sequence' --size 100
 )";
+    if( verbose ) { std::cerr << std::endl << "compression" << std::endl << comma::io::compressed::options::usage( 4 ) << std::endl; }
+    if( verbose ) { std::cerr << "shared memory" << std::endl << comma::io::shm::options::usage( 4 ) << std::endl; }
+    if( verbose ) { std::cerr << "udp multicast and broadcast" << std::endl << comma::io::udp::options::usage( 4 ) << std::endl; }
     exit( 0 );
 }
 
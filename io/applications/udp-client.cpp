@@ -36,8 +36,6 @@
 #include <iostream>
 #include <sstream>
 #include <type_traits>
-#include <boost/array.hpp>
-#include <boost/asio/ip/udp.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/noncopyable.hpp>
 #include "../../application/command_line_options.h"
@@ -48,6 +46,7 @@
 #include "../../csv/options.h"
 #include "../../string/string.h"
 #include "../../io/impl/publish.h"
+#include "../../io/udp.h"
 
 static void usage()
 {
@@ -72,6 +71,7 @@ attention! it is possible to receive several packets udp packets in a single
 
 options
     --ascii; output timestamp as ascii; default: 64-bit binary
+    --batch-size=<n>; default=64; on linux, receive up to <n> packets in a single system call (recvmmsg)
     --cache-size,--cache=<n>; default=0; number of cached records; if a new client connects, the
                                          the cached records will be sent to it once connected
     --delimiter=<delimiter>: if ascii and --timestamp, use this delimiter; default: ','
@@ -84,12 +84,21 @@ options
             size: data size in bytes
             data: udp packet data
     --flush; flush stdout after each packet
+    --gro; on linux, enable udp generic receive offload, if supported by kernel: the kernel may
+           coalesce packets of the same size from the same sender, which then get split
+           back into separate packets, i.e. output is the same, but receiving is cheaper
+    --kernel-timestamp; on linux, timestamp packets in the kernel on arrival (SO_TIMESTAMPNS)
+                        rather than taking system time after receiving; use with --fields=t,...
+    --receive-buffer-size,--buffer-size=<bytes>; socket receive buffer size (SO_RCVBUF); default: system
+                                                 default; increase to avoid dropping packets on bursts;
+                                                 capped by /proc/sys/net/core/rmem_max
     --reuse-addr,--reuseaddr: reuse udp address/port
     --size=<size>; default=16384; hint of maximum buffer size in bytes, if using timestamped
                                   fixed-width data, use --size=<fixed-width-size>, otherwise
                                   multiple packets may be read from the UDP socket at once
-    --timestamp: deprecated, use --fields; output packet timestamp; currently just system
-                 time as UTC; if binary, little endian uint64
+    --timestamp: deprecated, use --fields; output packet timestamp; system time as UTC
+                 or kernel time, if --kernel-timestamp; if binary, little endian uint64
+    --verbose,-v; more output
 
 output streams: <address>
     <address>
@@ -122,7 +131,7 @@ int main( int argc, char** argv )
     {
         comma::command_line_options options( argc, argv );
         if( argc < 2 || options.exists( "--help,-h" ) ) { usage(); }
-        const std::vector< std::string >& unnamed = options.unnamed( "--ascii,--binary,--discard,--endl,--flush,--reuse-addr,--reuseaddr,--timestamp", "-.+" );
+        const std::vector< std::string >& unnamed = options.unnamed( "--ascii,--binary,--discard,--endl,--flush,--gro,--kernel-timestamp,--reuse-addr,--reuseaddr,--timestamp,--verbose,-v", "-.+" );
         COMMA_ASSERT_BRIEF( !unnamed.empty(), "please specify port" );
         std::vector< std::string > output_streams( unnamed.size() > 1 ? unnamed.size() - 1 : 1 );
         if( unnamed.size() == 1 ) { output_streams[0] = "-"; }
@@ -147,25 +156,16 @@ int main( int argc, char** argv )
         bool has_size = csv.has_field( "size" );
         bool has_data = csv.has_field( "data" );
         static_assert( sizeof( boost::posix_time::ptime ) == 8 ); // quick and dirty
-        unsigned max_size = options.value( "--size", 16384 );
-        std::vector< char > buffer( max_size + 12 ); // quick and dirty
-        #if BOOST_VERSION >= 106600
-            boost::asio::io_context service;
-        #else
-            boost::asio::io_service service;
-        #endif
-        boost::asio::ip::udp::socket socket( service );
-        socket.open( boost::asio::ip::udp::v4() );
-        boost::system::error_code error;
-        socket.set_option( boost::asio::ip::udp::socket::broadcast( true ), error );
-        COMMA_ASSERT_BRIEF( !bool( error ), "failed to set broadcast option on port " << port );
-        if( options.exists( "--reuse-addr,--reuseaddr" ) )
-        {
-            socket.set_option( boost::asio::ip::udp::socket::reuse_address( true ), error );
-            COMMA_ASSERT_BRIEF( !bool( error ), "failed to set reuse address option on port " << port );
-        }
-        socket.bind( boost::asio::ip::udp::endpoint( boost::asio::ip::udp::v4(), port ), error );
-        COMMA_ASSERT_BRIEF( !bool( error ), "failed to bind port " << port );
+        comma::io::udp::options udp_options;
+        udp_options.packet_size = options.value( "--size", 16384 );
+        udp_options.batch_size = options.value( "--batch-size", 64 );
+        udp_options.buffer_size = options.value( "--receive-buffer-size,--buffer-size", 0 );
+        udp_options.timestamps = options.exists( "--kernel-timestamp" );
+        udp_options.gro = options.exists( "--gro" );
+        udp_options.reuse_address = options.exists( "--reuse-addr,--reuseaddr" );
+        comma::io::udp::receiver receiver( port, udp_options );
+        if( options.exists( "--verbose,-v" ) ) { comma::say() << "listening on port " << port << "; receive buffer size: " << receiver.buffer_size() << " byte(s); batch size: " << udp_options.batch_size << "; gro: " << ( receiver.options().gro ? "on" : "off" ) << std::endl; }
+        std::vector< char > buffer( receiver.options().packet_size + 12 ); // quick and dirty
         #ifdef WIN32
         if( binary ) { _setmode( _fileno( stdout ), _O_BINARY ); }
         #endif
@@ -183,11 +183,21 @@ int main( int argc, char** argv )
             unsigned int offset = ( has_time ? 8 : 0 ) + ( has_size ? 4 : 0 ); // hyper-quick and dirty for now
             while( !is_shutdown )
             {
-                std::uint32_t size = socket.receive( boost::asio::buffer( &buffer[offset], max_size ), 0, error );
-                if( error || size == 0 ) { break; } // todo? throw on error?
-                if( has_time ) { comma::csv::format::traits< boost::posix_time::ptime, comma::csv::format::time >::to_bin( boost::posix_time::microsec_clock::universal_time(), &buffer[0] ); }
-                if( has_size ) { ::memcpy( &buffer[ has_time ? 8 : 0 ], reinterpret_cast< const char* >( &size ), 4 ); }
-                p.write( &buffer[0], offset + ( has_data ? size : 0 ) );
+                unsigned int count = receiver.receive();
+                if( count == 0 ) { continue; } // interrupted
+                bool done = false;
+                for( unsigned int i = 0; i < count; ++i )
+                {
+                    const comma::io::udp::packet& packet = receiver[i];
+                    std::uint32_t size = packet.size;
+                    if( size == 0 ) { done = true; break; } // todo? throw on error?
+                    if( has_time ) { comma::csv::format::traits< boost::posix_time::ptime, comma::csv::format::time >::to_bin( packet.timestamp, &buffer[0] ); }
+                    if( has_size ) { ::memcpy( &buffer[ has_time ? 8 : 0 ], reinterpret_cast< const char* >( &size ), 4 ); }
+                    if( offset == 0 ) { p.write( packet.data, has_data ? size : 0 ); continue; }
+                    if( has_data ) { ::memcpy( &buffer[offset], packet.data, size ); }
+                    p.write( &buffer[0], offset + ( has_data ? size : 0 ) );
+                }
+                if( done ) { break; }
             }
         }
         else
@@ -195,14 +205,21 @@ int main( int argc, char** argv )
             std::string delimiter;
             while( !is_shutdown )
             {
-                std::size_t size = socket.receive( boost::asio::buffer( &buffer[0], max_size ), 0, error );
-                if( error || size == 0 ) { break; } // todo? throw on error?
-                std::ostringstream oss;
-                if( has_time ) { oss << boost::posix_time::to_iso_string( boost::posix_time::microsec_clock::universal_time() ); delimiter = csv.delimiter; }
-                if( has_size ) { oss << delimiter << size; delimiter = csv.delimiter; }
-                if( has_data ) { oss << delimiter; oss.write( &buffer[0], size ); if( endl ) { oss << std::endl; } }
-                const std::string& s = oss.str();
-                p.write( &s[0], s.size() );
+                unsigned int count = receiver.receive();
+                if( count == 0 ) { continue; } // interrupted
+                bool done = false;
+                for( unsigned int i = 0; i < count; ++i )
+                {
+                    const comma::io::udp::packet& packet = receiver[i];
+                    if( packet.size == 0 ) { done = true; break; } // todo? throw on error?
+                    std::ostringstream oss;
+                    if( has_time ) { oss << boost::posix_time::to_iso_string( packet.timestamp ); delimiter = csv.delimiter; }
+                    if( has_size ) { oss << delimiter << packet.size; delimiter = csv.delimiter; }
+                    if( has_data ) { oss << delimiter; oss.write( packet.data, packet.size ); if( endl ) { oss << std::endl; } }
+                    const std::string& s = oss.str();
+                    p.write( &s[0], s.size() );
+                }
+                if( done ) { break; }
             }
         }
         return 0;
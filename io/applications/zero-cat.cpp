@@ -43,6 +43,7 @@
 #include <boost/thread.hpp>
 #include "../../application/signal_flag.h"
 #include "../../io/publisher.h"
+#include "../../io/zeromq/sender.h"
 #include "../../string/string.h"
 
 void usage( boost::program_options::options_description const & description, bool const verbose )
@@ -137,6 +138,7 @@ int main(int argc, char* argv[])
         double wait_after_connect = 0.0;
         std::size_t hwm;
         std::string server;
+        comma::io::zeromq::options options;
         boost::program_options::options_description description( "options" );
         description.add_options()
             ( "help,h", "display help message; --help --verbose for more help" )
@@ -147,6 +149,10 @@ int main(int argc, char* argv[])
             ( "reply", "request/reply server" )
             ( "size,s", boost::program_options::value< unsigned int >( &size ), "packet size in bytes, in publish, request, or reply mode; if not present, data is line-based ascii" )
             ( "buffer,b", boost::program_options::value< std::size_t >( &hwm )->default_value( 1024 ), "set buffer size in packets (high water mark in zmq)" )
+            ( "socket-buffer", boost::program_options::value< int >( &options.buffer ), "kernel socket buffer size in bytes" )
+            ( "batch", boost::program_options::value< std::size_t >( &options.batch ), "in publish mode, send <n> records per message without copying; subscribers receive data as usual" )
+            ( "latency", boost::program_options::value< double >( &options.latency ), "in publish mode with --batch, send incomplete batch, if its first record is older than <seconds>; checked when next record arrives" )
+            ( "multipart", "in publish mode with --batch, send batch as multipart message with a part per record" )
             ( "server", boost::program_options::value< std::string >( &server ), "in subscribe mode, republish the data on a socket, eg tcp:1234" )
             ( "wait-after-connect,conwait", boost::program_options::value< double >( &wait_after_connect ), "time to wait, in seconds, after initial connection before attempting to read or write" )
             ( "quiet-interrupt", "suppress error messages due to interrupt" )
@@ -164,6 +170,10 @@ int main(int argc, char* argv[])
         const std::vector< std::string >& endpoints = boost::program_options::collect_unrecognized( parsed.options, boost::program_options::include_positional );
         if( endpoints.empty() ) { std::cerr << "zero-cat: please provide at least one endpoint" << std::endl; return 1; }
         bool binary = vm.count( "size" );
+        options.hwm = hwm;
+        options.record_size = binary ? size : 0;
+        options.multipart = vm.count( "multipart" );
+        if( options.multipart && options.batch == 0 ) { std::cerr << "zero-cat: --multipart requires --batch" << std::endl; return 1; }
         quiet_interrupt = vm.count( "quiet-interrupt" );
         comma::signal_flag is_shutdown;
         zmq::context_t context( 1 );
@@ -177,9 +187,8 @@ int main(int argc, char* argv[])
             if( binary ) { _setmode( _fileno( stdin ), _O_BINARY ); _setmode( _fileno( stdout ), _O_BINARY ); }
             #endif
             zmq::socket_t socket( context, is_request ? ZMQ_REQ : ZMQ_REP );
-            #if ZMQ_VERSION_MAJOR == 2
-            socket.setsockopt( ZMQ_HWM, &hwm, sizeof( hwm ) );
-            #endif
+            options.apply( socket, true );
+            options.apply( socket, false );
             if( endpoints.size() != 1 ) { std::cerr << "zero-cat: request/reply server/client expected 1 endpoint, got " << endpoints.size() << ": " << comma::join( endpoints, ',' ) << std::endl; return 1; }
             if( is_request || vm.count( "connect" ) ) { socket.connect( &endpoints[0][0] ); }
             else if( is_reply || vm.count( "bind" ) ) { socket.bind( &endpoints[0][0] ); }
@@ -255,11 +264,7 @@ int main(int argc, char* argv[])
         #ifdef WIN32
         if( is_publisher && binary ) { _setmode( _fileno( stdin ), _O_BINARY ); }
         #endif
-        // Although the documentation says that HWM is supported in ZMQ4, the
-        // code shows that if the sock opt is HWM an exception will be thrown.
-        #if ZMQ_VERSION_MAJOR == 2
-        socket.setsockopt( ZMQ_HWM, &hwm, sizeof( hwm ) );
-        #endif
+        options.apply( socket, is_publisher ); // zmq 3 and later: ZMQ_SNDHWM or ZMQ_RCVHWM instead of ZMQ_HWM
         if( is_publisher )
         {
             bool output_to_stdout = false;
@@ -274,6 +279,7 @@ int main(int argc, char* argv[])
             
             std::string buffer;
             if( binary ) { buffer.resize( size ); }
+            comma::io::zeromq::sender sender( socket, options );
             while( !is_shutdown && std::cin.good() && !std::cin.eof() && !std::cin.bad() )
             {
                 if( binary )
@@ -289,17 +295,12 @@ int main(int argc, char* argv[])
                     if( !is_shutdown && std::cin.good() && !std::cin.eof() && !std::cin.bad() ) { buffer += endl; }
                 }
                 if( buffer.empty() ) { break; }
-                #if ZMQ_VERSION_MAJOR == 2
-                zmq::message_t message( buffer.size() );
-                ::memcpy( ( void * )message.data(), &buffer[0], buffer.size() );
-                if( !socket.send( message ) ) { std::cerr << "zero-cat: failed to send " << buffer.size() << " bytes; zmq errno: EAGAIN" << std::endl; return 1; }
-                #else // ZMQ_VERSION_MAJOR == 2
-                if( !socket.send( &buffer[0], buffer.size() ) ) { std::cerr << "zero-cat: failed to send " << buffer.size() << " bytes; zmq errno: EAGAIN" << std::endl; return 1; }
-                #endif // ZMQ_VERSION_MAJOR == 2
+                if( !sender.write( &buffer[0], buffer.size() ) ) { std::cerr << "zero-cat: failed to send " << buffer.size() << " bytes; zmq errno: EAGAIN" << std::endl; return 1; }
                 if( !output_to_stdout ) { continue; }
                 std::cout.write( &buffer[0], buffer.size() );
                 if( binary ) { std::cout.flush(); }
             }
+            if( !sender.close() ) { std::cerr << "zero-cat: failed to send last batch; zmq errno: EAGAIN" << std::endl; return 1; }
         }
         else
         {
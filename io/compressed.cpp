@@ -0,0 +1,381 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <boost/lexical_cast.hpp>
+#include "../base/exception.h"
+#include "../string/string.h"
+#include "compressed.h"
+
+namespace comma { namespace io { namespace compressed {
+
+namespace impl {
+
+static const std::size_t header_size = 20; // see frame layout in compressed.h
+
+static const char magic[] = { 'c', 'm', 'z', '1' };
+
+static inline void store_le32( char* p, std::uint32_t v ) { for( unsigned int i = 0; i < 4; ++i, v >>= 8 ) { p[i] = char( v & 0xff ); } }
+
+static inline std::uint32_t load_le32( const char* p )
+{
+    const unsigned char* q = reinterpret_cast< const unsigned char* >( p );
+    return std::uint32_t( q[0] ) | ( std::uint32_t( q[1] ) << 8 ) | ( std::uint32_t( q[2] ) << 16 ) | ( std::uint32_t( q[3] ) << 24 );
+}
+
+enum codec { stored = 0, lz = 1 };
+
+static const unsigned int min_match = 4;
+static const unsigned int hash_log = 14;
+static_assert( ( std::size_t( 1 ) << hash_log ) == hash_table_size, "expected hash table size matching hash bits" );
+
+static inline std::uint32_t read32( const unsigned char* p ) { std::uint32_t v; std::memcpy( &v, p, 4 ); return v; }
+
+static inline std::uint32_t hash( std::uint32_t v ) { return ( v * 2654435761u ) >> ( 32 - hash_log ); }
+
+static inline unsigned char* write_length( unsigned char* out, std::size_t length ) // length beyond 15 in token
+{
+    for( ; length >= 255; length -= 255 ) { *out++ = 255; }
+    *out++ = static_cast< unsigned char >( length );
+    return out;
+}
+
+static inline unsigned char* write_sequence( unsigned char* out, const unsigned char* literals, std::size_t literal_size, std::size_t offset, std::size_t match_size )
+{
+    unsigned char* token = out++;
+    *token = static_cast< unsigned char >( std::min( literal_size, std::size_t( 15 ) ) << 4 );
+    if( literal_size >= 15 ) { out = write_length( out, literal_size - 15 ); }
+    std::memcpy( out, literals, literal_size );
+    out += literal_size;
+    if( match_size == 0 ) { return out; } // last sequence: literals only
+    *out++ = static_cast< unsigned char >( offset & 0xff );
+    *out++ = static_cast< unsigned char >( offset >> 8 );
+    std::size_t m = match_size - min_match;
+    *token |= static_cast< unsigned char >( std::min( m, std::size_t( 15 ) ) );
+    if( m >= 15 ) { out = write_length( out, m - 15 ); }
+    return out;
+}
+
+static inline std::size_t read_length( const unsigned char*& in, const unsigned char* end )
+{
+    std::size_t length = 0;
+    while( true )
+    {
+        COMMA_ASSERT_BRIEF( in < end, "corrupted compressed block: unexpected end of length" );
+        unsigned char c = *in++;
+        length += c;
+        if( c != 255 ) { return length; }
+    }
+}
+
+} // namespace impl {
+
+std::size_t max_size( std::size_t size ) { return size + size / 255 + 16; }
+
+std::size_t compress( const char* input, std::size_t size, char* output )
+{
+    std::vector< std::uint32_t > table( hash_table_size );
+    return compress( input, size, output, &table[0] );
+}
+
+std::size_t compress( const char* input, std::size_t size, char* output, std::uint32_t* table )
+{
+    const unsigned char* in = reinterpret_cast< const unsigned char* >( input );
+    unsigned char* out = reinterpret_cast< unsigned char* >( output );
+    std::fill( table, table + hash_table_size, 0 ); // position + 1, 0 for empty
+    std::size_t anchor = 0;
+    std::size_t i = 0;
+    while( i + impl::min_match <= size )
+    {
+        std::uint32_t v = impl::read32( in + i );
+        std::uint32_t& entry = table[ impl::hash( v ) ];
+        std::size_t candidate = entry;
+        entry = i + 1;
+        if( candidate == 0 || i + 1 - candidate > 65535 || impl::read32( in + candidate - 1 ) != v )
+        {
+            i += 1 + ( ( i - anchor ) >> 6 ); // skip faster through incompressible data
+            continue;
+        }
+        std::size_t reference = candidate - 1;
+        std::size_t length = impl::min_match;
+        while( i + length < size && in[ reference + length ] == in[ i + length ] ) { ++length; }
+        out = impl::write_sequence( out, in + anchor, i - anchor, i - reference, length );
+        i += length;
+        anchor = i;
+    }
+    out = impl::write_sequence( out, in + anchor, size - anchor, 0, 0 );
+    return out - reinterpret_cast< unsigned char* >( output );
+}
+
+void decompress( const char* input, std::size_t size, char* output, std::size_t output_size )
+{
+    const unsigned char* in = reinterpret_cast< const unsigned char* >( input );
+    const unsigned char* end = in + size;
+    unsigned char* out = reinterpret_cast< unsigned char* >( output );
+    unsigned char* out_end = out + output_size;
+    while( in < end )
+    {
+        unsigned char token = *in++;
+        std::size_t literal_size = token >> 4;
+        if( literal_size == 15 ) { literal_size += impl::read_length( in, end ); }
+        COMMA_ASSERT_BRIEF( std::size_t( end - in ) >= literal_size && std::size_t( out_end - out ) >= literal_size, "corrupted compressed block: literals out of bounds" );
+        std::memcpy( out, in, literal_size );
+        in += literal_size;
+        out += literal_size;
+        if( in == end ) { break; } // last sequence
+        COMMA_ASSERT_BRIEF( end - in >= 2, "corrupted compressed block: unexpected end of offset" );
+        std::size_t offset = in[0] | ( std::size_t( in[1] ) << 8 );
+        in += 2;
+        std::size_t match_size = token & 15;
+        if( match_size == 15 ) { match_size += impl::read_length( in, end ); }
+        match_size += impl::min_match;
+        COMMA_ASSERT_BRIEF( offset > 0 && offset <= std::size_t( out - reinterpret_cast< unsigned char* >( output ) ), "corrupted compressed block: invalid offset " << offset );
+        COMMA_ASSERT_BRIEF( std::size_t( out_end - out ) >= match_size, "corrupted compressed block: match out of bounds" );
+        const unsigned char* match = out - offset;
+        if( offset >= match_size ) { std::memcpy( out, match, match_size ); out += match_size; }
+        else { for( std::size_t k = 0; k < match_size; ++k ) { *out++ = *match++; } } // overlapping copy, e.g. run of repeated bytes
+    }
+    COMMA_ASSERT_BRIEF( out == out_end, "corrupted compressed block: expected " << output_size << " bytes, got " << ( out - reinterpret_cast< unsigned char* >( output ) ) );
+}
+
+void encode( filters::values filter, char* buf, std::size_t size, std::size_t record_size )
+{
+    if( filter == filters::none || record_size == 0 || size < 2 * record_size ) { return; }
+    for( std::size_t i = ( size / record_size - 1 ) * record_size; i > 0; i -= record_size ) // backwards, so that previous record is still original
+    {
+        for( std::size_t j = 0; j < record_size; ++j ) { buf[ i + j ] ^= buf[ i + j - record_size ]; }
+    }
+}
+
+void decode( filters::values filter, char* buf, std::size_t size, std::size_t record_size )
+{
+    if( filter == filters::none || record_size == 0 || size < 2 * record_size ) { return; }
+    for( std::size_t i = record_size; i + record_size <= size; i += record_size )
+    {
+        for( std::size_t j = 0; j < record_size; ++j ) { buf[ i + j ] ^= buf[ i + j - record_size ]; }
+    }
+}
+
+boost::optional< options > options::strip( std::string& name )
+{
+    std::vector< std::string > v = comma::split( name, ';' );
+    if( v.size() < 2 ) { return boost::none; }
+    bool compressed = false;
+    for( unsigned int i = 1; i < v.size() && !compressed; compressed = v[i++] == "compressed" );
+    if( !compressed ) { return boost::none; }
+    options o;
+    for( unsigned int i = 1; i < v.size(); ++i )
+    {
+        if( v[i] == "compressed" ) { continue; }
+        std::string::size_type p = v[i].find( '=' );
+        COMMA_ASSERT_BRIEF( p != std::string::npos, "expected compressed stream option as <name>=<value>; got: '" << v[i] << "' in '" << name << "'" );
+        std::string key = v[i].substr( 0, p );
+        std::string value = v[i].substr( p + 1 );
+        if( key == "block-size" ) { o.block_size = boost::lexical_cast< std::size_t >( value ); }
+        else if( key == "record-size" || key == "size" ) { o.record_size = boost::lexical_cast< std::size_t >( value ); }
+        else if( key == "filter" ) { COMMA_ASSERT_BRIEF( value == "xor" || value == "none", "expected filter: xor or none; got: '" << value << "'" ); o.filter = value == "xor" ? filters::xor_previous : filters::none; }
+        else { COMMA_THROW( comma::exception, "unknown compressed stream option '" << key << "' in '" << name << "'" ); }
+    }
+    COMMA_ASSERT_BRIEF( o.record_size > 0, "expected positive record size in '" << name << "'" );
+    name = v[0];
+    return o;
+}
+
+std::string options::usage( unsigned int indent )
+{
+    std::string i( indent, ' ' );
+    std::ostringstream oss;
+    oss << i << "<name>;compressed[;<options>]: block-compressed stream, e.g. points.bin;compressed;size=32;filter=xor" << std::endl;
+    oss << i << "    block-size=<bytes>; default=65536: uncompressed frame size" << std::endl;
+    oss << i << "    size,record-size=<bytes>; default=1: record size; frames contain only whole records" << std::endl;
+    oss << i << "    filter=<filter>; default=none: pre-filter before compression" << std::endl;
+    oss << i << "        xor: xor each record with the previous one; good for timestamps and slowly changing values" << std::endl;
+    oss << i << "    options are used only on writing; on reading, they are taken from the stream" << std::endl;
+    return oss.str();
+}
+
+ostreambuf::ostreambuf( std::ostream* os, const compressed::options& options ): _os( os ), _options( options )
+{
+    COMMA_ASSERT_BRIEF( _options.record_size > 0 && _options.record_size < ( std::size_t( 1 ) << 31 ), "expected record size between 1 and 2^31; got: " << _options.record_size );
+    std::size_t records = std::max( _options.block_size / _options.record_size, std::size_t( 1 ) );
+    _buffer.resize( records * _options.record_size );
+    _frame.resize( impl::header_size + max_size( _buffer.size() ) );
+    _table.resize( hash_table_size );
+    setp( &_buffer[0], &_buffer[0] + _buffer.size() );
+}
+
+ostreambuf::~ostreambuf() { try { close(); } catch( ... ) {} }
+
+void ostreambuf::_write( std::size_t size )
+{
+    if( size == 0 ) { return; }
+    encode( _options.filter, &_buffer[0], size, _options.record_size );
+    char* header = &_frame[0];
+    std::size_t stored = compress( &_buffer[0], size, header + impl::header_size, &_table[0] );
+    std::uint8_t codec = impl::lz;
+    if( stored >= size ) { codec = impl::stored; stored = size; std::memcpy( header + impl::header_size, &_buffer[0], size ); }
+    std::memcpy( header, impl::magic, 4 );
+    impl::store_le32( header + 4, size );
+    impl::store_le32( header + 8, stored );
+    impl::store_le32( header + 12, _options.record_size );
+    header[16] = char( codec );
+    header[17] = char( _options.filter );
+    header[18] = header[19] = 0;
+    _os->write( header, impl::header_size + stored );
+    std::size_t remaining = pptr() - pbase() - size; // bytes of incomplete record
+    if( remaining > 0 ) { std::memmove( &_buffer[0], &_buffer[0] + size, remaining ); }
+    setp( &_buffer[0], &_buffer[0] + _buffer.size() );
+    pbump( remaining );
+}
+
+ostreambuf::int_type ostreambuf::overflow( int_type c )
+{
+    if( !_os || !_os->good() ) { return traits_type::eof(); }
+    _write( pptr() - pbase() ); // buffer is a multiple of record size
+    if( traits_type::eq_int_type( c, traits_type::eof() ) ) { return traits_type::not_eof( c ); }
+    *pptr() = traits_type::to_char_type( c );
+    pbump( 1 );
+    return c;
+}
+
+int ostreambuf::sync()
+{
+    if( !_os ) { return -1; }
+    std::size_t size = pptr() - pbase();
+    _write( size - size % _options.record_size ); // keep incomplete record in buffer to keep frames record-aligned
+    _os->flush();
+    return _os->good() ? 0 : -1;
+}
+
+void ostreambuf::close()
+{
+    if( !_os ) { return; }
+    _write( pptr() - pbase() );
+    _os->flush();
+    _os = nullptr;
+}
+
+istreambuf::istreambuf( std::istream* is ): _is( is ) {}
+
+bool istreambuf::_read_header( frame_header& h )
+{
+    char header[ impl::header_size ];
+    _is->read( header, impl::header_size );
+    if( _is->gcount() == 0 ) { return false; }
+    COMMA_ASSERT_BRIEF( std::size_t( _is->gcount() ) == impl::header_size, "compressed stream: expected frame header of " << impl::header_size << " bytes; got " << _is->gcount() );
+    COMMA_ASSERT_BRIEF( std::memcmp( header, impl::magic, 4 ) == 0, "compressed stream: expected frame header, got invalid magic" );
+    h.size = impl::load_le32( header + 4 );
+    h.stored = impl::load_le32( header + 8 );
+    h.record_size = impl::load_le32( header + 12 );
+    h.codec = std::uint8_t( header[16] );
+    h.filter = std::uint8_t( header[17] );
+    COMMA_ASSERT_BRIEF( h.codec == impl::stored || h.codec == impl::lz, "compressed stream: unknown codec " << int( h.codec ) );
+    return true;
+}
+
+void istreambuf::_read_payload( const frame_header& h )
+{
+    _buffer.resize( h.size );
+    if( h.codec == impl::stored )
+    {
+        _is->read( &_buffer[0], h.size );
+        COMMA_ASSERT_BRIEF( std::size_t( _is->gcount() ) == h.size, "compressed stream: expected " << h.size << " bytes; got " << _is->gcount() );
+    }
+    else
+    {
+        _payload.resize( h.stored );
+        _is->read( &_payload[0], h.stored );
+        COMMA_ASSERT_BRIEF( std::size_t( _is->gcount() ) == h.stored, "compressed stream: expected " << h.stored << " bytes; got " << _is->gcount() );
+        compressed::decompress( &_payload[0], h.stored, &_buffer[0], h.size );
+    }
+    compressed::decode( static_cast< filters::values >( h.filter ), &_buffer[0], h.size, h.record_size );
+    _begin = _next;
+    _next += h.size;
+    setg( &_buffer[0], &_buffer[0], &_buffer[0] + h.size );
+}
+
+void istreambuf::_skip_payload( const frame_header& h )
+{
+    if( _is->rdbuf()->pubseekoff( h.stored, std::ios_base::cur, std::ios_base::in ) == pos_type( off_type( -1 ) ) ) { _is->ignore( h.stored ); } // not seekable, e.g. pipe
+    _next += h.size;
+    _begin = _next;
+}
+
+istreambuf::int_type istreambuf::underflow()
+{
+    if( gptr() < egptr() ) { return traits_type::to_int_type( *gptr() ); }
+    frame_header h;
+    while( true )
+    {
+        if( !_read_header( h ) ) { return traits_type::eof(); }
+        if( h.size > 0 ) { break; }
+        _skip_payload( h );
+    }
+    _read_payload( h );
+    return traits_type::to_int_type( *gptr() );
+}
+
+std::size_t istreambuf::compressed_available() const
+{
+    std::streamsize n = _is->rdbuf()->in_avail();
+    return n < 0 ? 0 : n;
+}
+
+std::streamsize istreambuf::showmanyc()
+{
+    std::streamsize n = _is->rdbuf()->in_avail(); // quick and dirty: compressed bytes available from underlying stream are a rough estimate
+    return n < 0 ? -1 : n;
+}
+
+istreambuf::pos_type istreambuf::seekoff( off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which )
+{
+    static const pos_type failed( off_type( -1 ) );
+    if( !( which & std::ios_base::in ) ) { return failed; }
+    std::uint64_t position = _begin + ( gptr() - eback() );
+    std::uint64_t target;
+    switch( dir )
+    {
+        case std::ios_base::beg: target = off; break;
+        case std::ios_base::cur: if( off == 0 ) { return pos_type( position ); } target = position + off; break;
+        default: return failed; // seeking from the end would require reading the whole stream
+    }
+    if( eback() != nullptr && target >= _begin && target <= _next ) { setg( eback(), eback() + ( target - _begin ), egptr() ); return pos_type( target ); }
+    if( target < _begin ) // rewind, if underlying stream is seekable
+    {
+        _is->clear();
+        if( _is->rdbuf()->pubseekpos( 0, std::ios_base::in ) == failed ) { return failed; }
+        _begin = _next = 0;
+    }
+    else
+    {
+        _begin = _next;
+    }
+    setg( nullptr, nullptr, nullptr );
+    while( true ) // skip frames before target reading only their headers
+    {
+        frame_header h;
+        if( !_read_header( h ) ) { return target == _next ? pos_type( target ) : failed; }
+        if( target < _next + h.size )
+        {
+            _read_payload( h );
+            setg( eback(), eback() + ( target - _begin ), egptr() );
+            return pos_type( target );
+        }
+        _skip_payload( h );
+    }
+}
+
+istreambuf::pos_type istreambuf::seekpos( pos_type pos, std::ios_base::openmode which ) { return seekoff( off_type( pos ), std::ios_base::beg, which ); }
+
+istream::istream( std::istream* is, std::shared_ptr< void > owner ): std::istream( nullptr ), _owner( owner ), _buf( is ) { rdbuf( &_buf ); }
+
+istream::~istream() {}
+
+ostream::ostream( std::ostream* os, const compressed::options& options, std::shared_ptr< void > owner ): std::ostream( nullptr ), _owner( owner ), _buf( os, options ) { rdbuf( &_buf ); }
+
+ostream::~ostream() { try { _buf.close(); } catch( ... ) {} }
+
+} } } // namespace comma { namespace io { namespace compressed {
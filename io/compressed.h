@@ -0,0 +1,145 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/optional.hpp>
+
+namespace comma { namespace io { namespace compressed {
+
+/// framed block-compressed stream encoding
+///
+/// stream is a sequence of independent frames, each frame is a header followed by payload:
+///     magic: 4 bytes: "cmz1"
+///     size: uint32: uncompressed payload size
+///     stored: uint32: stored payload size
+///     record_size: uint32: record size used to align frames and for pre-filter
+///     codec: uint8: 0: stored as is, 1: lz
+///     filter: uint8: 0: none, 1: xor with previous record
+///     reserved: uint16
+/// header fields are little endian, independently of host byte order
+///
+/// frames always contain whole records (unless the writer was closed in the middle
+/// of a record), i.e. frame boundaries are record-aligned, thus seeking only needs to
+/// read frame headers until the frame containing the required offset
+struct filters { enum values { none = 0, xor_previous = 1 }; };
+
+struct options
+{
+    std::size_t block_size{65536}; /// maximum uncompressed frame size, rounded down to whole records
+    std::size_t record_size{1};
+    filters::values filter{filters::none};
+
+    options() = default;
+    options( std::size_t block_size, std::size_t record_size = 1, filters::values filter = filters::none ): block_size( block_size ), record_size( record_size ), filter( filter ) {}
+
+    /// if name has ";compressed" option, strip options from name and return them, e.g.
+    ///     "points.bin;compressed;record-size=32;filter=xor" -> "points.bin"
+    ///     "tcp:localhost:12345;compressed" -> "tcp:localhost:12345"
+    static boost::optional< options > strip( std::string& name );
+
+    static std::string usage( unsigned int indent = 0 );
+};
+
+/// return maximum size of compressed block for given input size
+std::size_t max_size( std::size_t size );
+
+/// number of entries in hash table used by compress()
+static const std::size_t hash_table_size = 1 << 14;
+
+/// compress block with lz codec (byte-oriented lz77 with 64kb window, lz4-like), return compressed size
+std::size_t compress( const char* input, std::size_t size, char* output );
+
+/// same as above, using given hash table of hash_table_size entries, e.g. to allocate it once per stream
+std::size_t compress( const char* input, std::size_t size, char* output, std::uint32_t* table );
+
+/// decompress block; throw comma::exception on corrupted input
+void decompress( const char* input, std::size_t size, char* output, std::size_t output_size );
+
+/// apply pre-filter to size bytes in place
+void encode( filters::values filter, char* buf, std::size_t size, std::size_t record_size );
+
+/// undo pre-filter in place
+void decode( filters::values filter, char* buf, std::size_t size, std::size_t record_size );
+
+class ostreambuf : public std::streambuf
+{
+    public:
+        ostreambuf( std::ostream* os, const compressed::options& options );
+        ~ostreambuf();
+        /// write buffered data, including incomplete record, and flush
+        void close();
+    protected:
+        int_type overflow( int_type c );
+        int sync();
+    private:
+        std::ostream* _os;
+        compressed::options _options;
+        std::vector< char > _buffer;
+        std::vector< char > _frame;
+        std::vector< std::uint32_t > _table;
+        void _write( std::size_t size );
+};
+
+class istreambuf : public std::streambuf
+{
+    public:
+        istreambuf( std::istream* is );
+        /// number of decompressed bytes of the current frame not read yet
+        std::size_t buffered() const { return egptr() - gptr(); }
+        /// number of compressed bytes buffered by underlying stream, i.e. of the next frames
+        std::size_t compressed_available() const;
+    protected:
+        int_type underflow();
+        std::streamsize showmanyc();
+        pos_type seekoff( off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which );
+        pos_type seekpos( pos_type pos, std::ios_base::openmode which );
+    private:
+        struct frame_header { std::uint32_t size; std::uint32_t stored; std::uint32_t record_size; std::uint8_t codec; std::uint8_t filter; };
+        std::istream* _is;
+        std::vector< char > _buffer;
+        std::vector< char > _payload;
+        std::uint64_t _begin{0}; /// uncompressed offset of the current frame
+        std::uint64_t _next{0}; /// uncompressed offset of the next frame
+        bool _read_header( frame_header& h );
+        void _read_payload( const frame_header& h );
+        void _skip_payload( const frame_header& h );
+};
+
+/// input stream decompressing frames from underlying stream
+class istream : public std::istream
+{
+    public:
+        /// @param owner optional holder of underlying stream to release on destruction
+        istream( std::istream* is, std::shared_ptr< void > owner = std::shared_ptr< void >() );
+        ~istream();
+        /// number of decompressed bytes of the current frame not read yet; unlike in_avail(), never counts compressed bytes
+        std::size_t buffered() const { return _buf.buffered(); }
+        /// number of compressed bytes buffered by underlying stream, not counting bytes on its file descriptor
+        std::size_t compressed_available() const { return _buf.compressed_available(); }
+    private:
+        std::shared_ptr< void > _owner;
+        istreambuf _buf;
+};
+
+/// output stream writing compressed frames to underlying stream
+class ostream : public std::ostream
+{
+    public:
+        /// @param owner optional holder of underlying stream to release on destruction
+        ostream( std::ostream* os, const compressed::options& options = compressed::options(), std::shared_ptr< void > owner = std::shared_ptr< void >() );
+        ~ostream();
+        /// write remaining data
+        void close() { _buf.close(); }
+    private:
+        std::shared_ptr< void > _owner; // declared first to outlive _buf, which writes the last frame on destruction
+        ostreambuf _buf;
+};
+
+} } } // namespace comma { namespace io { namespace compressed {
@@ -2,7 +2,9 @@
 // Copyright (c) 2020 Vsevolod Vlaskine
 // All rights reserved.
 
+#include <boost/lexical_cast.hpp>
 #include "../../name_value/map.h"
+#include "../../string/string.h"
 #include "publish.h"
 
 namespace comma { namespace io { namespace impl {
@@ -48,7 +50,11 @@ multiserver< Server >::multiserver( const std::vector< std::string >& endpoints
     {
         comma::name_value::map m( endpoints[i], "address", ';', '=' );
         bool secondary = !m.exists( "primary" ) && m.exists( "secondary" );
-        endpoints_.push_back( endpoint( m.value< std::string >( "address" ), secondary ) ); // todo? quick and dirty; better usage semantics?
+        std::string address = m.value< std::string >( "address" );
+        bool direct = address.substr( 0, 4 ) == "shm:" || address.substr( 0, 14 ) == "udp-multicast:" || address.substr( 0, 14 ) == "udp-broadcast:"; // single stream, no clients to accept
+        if( m.exists( "compressed" ) || direct ) { for( const auto& o: comma::split( endpoints[i], ';' ) ) { if( o != address && o != "primary" && o != "secondary" ) { address += ';' + o; } } } // pass compression, shared memory, or udp options to stream
+        if( direct && packet_size > 0 && !m.exists( "size" ) && !m.exists( "record-size" ) ) { address += ";size=" + boost::lexical_cast< std::string >( packet_size ); } // publish whole packets; udp: never split a packet across datagrams
+        endpoints_.push_back( endpoint( address, secondary ) ); // todo? quick and dirty; better usage semantics?
         if( !secondary ) { has_primary_stream = true; }
     }
     COMMA_ASSERT_BRIEF( has_primary_stream, "please specify at least one primary stream" );
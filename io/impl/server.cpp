@@ -17,6 +17,7 @@
 #include "../../base/exception.h"
 #include "../../io/file_descriptor.h"
 #include "../../string/string.h"
+#include "../compressed.h"
 #include "server.h"
 
 namespace comma { namespace io { namespace impl {
@@ -99,10 +100,36 @@ template <> struct stream_traits< io::iostream >
     static constexpr bool is_output_stream{true};
 };
 
+template < typename Stream > struct compressed_traits
+{
+    template < typename S > static Stream* make( S* s, io::file_descriptor, io::mode::value, const compressed::options& ) { delete s; COMMA_THROW( comma::exception, "compressed bidirectional streams not supported" ); }
+};
+
+template <> struct compressed_traits< io::istream >
+{
+    template < typename S > static io::istream* make( S* s, io::file_descriptor fd, io::mode::value mode, const compressed::options& )
+    {
+        std::shared_ptr< S > owner( s );
+        return new io::istream( new compressed::istream( s, owner ), fd, mode, io::mode::blocking, [owner]() { owner->close(); } );
+    }
+};
+
+template <> struct compressed_traits< io::ostream >
+{
+    template < typename S > static io::ostream* make( S* s, io::file_descriptor fd, io::mode::value mode, const compressed::options& options )
+    {
+        std::shared_ptr< S > owner( s );
+        compressed::ostream* c = new compressed::ostream( s, options, owner );
+        return new io::ostream( c, fd, mode, io::mode::blocking, [c, owner]() { c->close(); owner->close(); } );
+    }
+};
+
 template < typename Stream > class file_acceptor : public acceptor< Stream >
 {
     public:
-        file_acceptor( const std::string& name, io::mode::value mode ): name_( name ), mode_( mode ), fd_( io::invalid_file_descriptor ) { this->_closed = true; }
+        /// @param name file name
+        /// @param stream_name stream name, e.g. with compression options
+        file_acceptor( const std::string& name, const std::string& stream_name, io::mode::value mode ): name_( name ), stream_name_( stream_name ), mode_( mode ), fd_( io::invalid_file_descriptor ) { this->_closed = true; }
 
         ~file_acceptor()
         {
@@ -123,7 +150,7 @@ template < typename Stream > class file_acceptor : public acceptor< Stream >
 #endif
             if( fd_ == io::invalid_file_descriptor ) { return nullptr; }
             this->_closed = false;
-            return new Stream( name_, mode_, io::mode::non_blocking ); // quick and dirty
+            return new Stream( stream_name_, mode_, io::mode::non_blocking ); // quick and dirty
         }
 
         void notify_closed() { this->_closed = true; ::close( fd_ ); }
@@ -134,6 +161,7 @@ template < typename Stream > class file_acceptor : public acceptor< Stream >
 
     private:
         const std::string name_;
+        const std::string stream_name_;
         const io::mode::value mode_;
         io::file_descriptor fd_{0}; // todo: make io::istream, io::ostream non-throwing on construction
 };
@@ -165,8 +193,9 @@ template <> struct socket_traits< local >
 template < typename Stream, typename S > class socket_acceptor : public acceptor< Stream >
 {
     public:
-        socket_acceptor( const typename socket_traits< S >::name_type& name, io::mode::value mode )
+        socket_acceptor( const typename socket_traits< S >::name_type& name, io::mode::value mode, const boost::optional< compressed::options >& compression = boost::none )
             : mode_( mode )
+            , compression_( compression )
             , _acceptor( m_service, socket_traits< S >::endpoint( name ) )
         {
             select_.read().add( impl::acceptor_native_handle( _acceptor ) );
@@ -178,6 +207,7 @@ template < typename Stream, typename S > class socket_acceptor : public acceptor
             if( !select_.read().ready( impl::acceptor_native_handle( _acceptor ) ) ) { return nullptr; }
             typename socket_traits< S >::iostream* stream = new typename socket_traits< S >::iostream;
             _acceptor.accept( impl::socket( stream ) );
+            if( compression_ ) { return compressed_traits< Stream >::make( stream, impl::native_handle( stream ), mode_, *compression_ ); }
             return new Stream( stream, impl::native_handle( stream ), mode_, boost::bind( &socket_traits< S >::iostream::close, stream ) );
         }
 
@@ -189,6 +219,7 @@ template < typename Stream, typename S > class socket_acceptor : public acceptor
 
     private:
         io::mode::value mode_{io::mode::binary};
+        boost::optional< compressed::options > compression_;
         io::select select_;
 #if (BOOST_VERSION >= 106600)
         boost::asio::io_context m_service;
@@ -226,11 +257,13 @@ template < typename Stream > server< Stream >::server( const std::string& name,
     : blocking_( blocking ),
       flush_( flush )
 {
-    std::vector< std::string > v = comma::split( name, ':' );
+    std::string stripped = name;
+    boost::optional< compressed::options > compression = compressed::options::strip( stripped );
+    std::vector< std::string > v = comma::split( stripped, ':' );
     if( v[0] == "tcp" )
     {
         if( v.size() != 2 ) { COMMA_THROW( comma::exception, "expected tcp server endpoint, got " << name ); }
-        _acceptor.reset( new socket_acceptor< Stream, Tcp >( boost::lexical_cast< unsigned short >( v[1] ), mode ) );
+        _acceptor.reset( new socket_acceptor< Stream, Tcp >( boost::lexical_cast< unsigned short >( v[1] ), mode, compression ) );
     }
     else if( v[0] == "udp" )
     {
@@ -240,7 +273,15 @@ template < typename Stream > server< Stream >::server( const std::string& name,
     {
 #ifndef WIN32
         if( v.size() != 2 ) { COMMA_THROW( comma::exception, "expected local socket, got " << name ); }
-        _acceptor.reset( new socket_acceptor< Stream, local >( v[1], mode ) );
+        _acceptor.reset( new socket_acceptor< Stream, local >( v[1], mode, compression ) );
+#endif
+    }
+    else if( v[0] == "shm" || v[0] == "udp-multicast" || v[0] == "udp-broadcast" ) // single stream, readers attach to the ring or join multicast group directly
+    {
+        streams_.insert( std::unique_ptr< Stream >( new Stream( name, mode ) ) );
+#ifndef WIN32
+        if( stream_traits< Stream >::is_input_stream ) { select_.read().add( ( *streams_.begin() )->fd() ); }
+        if( stream_traits< Stream >::is_output_stream ) { select_.write().add( ( *streams_.begin() )->fd() ); }
 #endif
     }
     else if( v[0].substr( 0, 4 ) == "zero" )
@@ -249,7 +290,7 @@ template < typename Stream > server< Stream >::server( const std::string& name,
     }
     else
     {
-        if( name == "-" )
+        if( stripped == "-" )
         {
             streams_.insert( std::unique_ptr< Stream >( new Stream( name, mode ) ) );
 #ifndef WIN32
@@ -259,7 +300,7 @@ template < typename Stream > server< Stream >::server( const std::string& name,
         }
         else
         {
-            _acceptor.reset( new file_acceptor< Stream >( name, mode ) );
+            _acceptor.reset( new file_acceptor< Stream >( stripped, name, mode ) );
             Stream* s = _acceptor->accept( boost::posix_time::time_duration() );
             streams_.insert( std::unique_ptr< Stream >( s ) ); // todo: should we simply abolish file_acceptor and do it in the same way as for stdout?
             if( s->fd() == comma::io::invalid_file_descriptor ) { COMMA_THROW( comma::exception, "failed to open '" << name << "'" ); }
@@ -0,0 +1,39 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <signal.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include "../../sync/futex.h"
+
+namespace comma { namespace io { namespace shm { namespace impl {
+
+static_assert( std::atomic< std::uint32_t >::is_always_lock_free && std::atomic< std::uint64_t >::is_always_lock_free, "expected lock-free atomics for shared memory" );
+
+enum { spin = 2000 }; // number of busy-wait iterations before going to sleep
+
+/// return true, if process with given pid exists
+inline bool alive( std::uint32_t pid ) { return pid != 0 && ( ::kill( pid_t( pid ), 0 ) == 0 || errno == EPERM ); }
+
+/// cpu hint for busy-wait loops
+inline void relax()
+{
+    #if defined( __x86_64__ ) || defined( __i386__ )
+    __builtin_ia32_pause();
+    #elif defined( __aarch64__ )
+    asm volatile( "yield" );
+    #endif
+}
+
+/// increment sequence and wake up its waiters, if any
+inline void notify( std::atomic< std::uint32_t >& sequence, const std::atomic< std::uint32_t >& waiters )
+{
+    sequence.fetch_add( 1 );
+    if( waiters.load() > 0 ) { comma::futex::wake( sequence ); }
+}
+
+} } } } // namespace comma { namespace io { namespace shm { namespace impl {
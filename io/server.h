@@ -20,9 +20,9 @@ class server
 {
     public:
         /// constructor
-        /// @param name ::= tcp:<port> | udp:<port> | <filename>
+        /// @param name ::= tcp:<port> | udp-multicast:<group>:<port> | udp-broadcast:[<address>:]<port> | <filename>
         ///     if tcp:<port>, create tcp server
-        ///     @todo if udp:<port>, broadcast on udp
+        ///     if udp-multicast or udp-broadcast, send each write once as record-aligned datagrams to all receivers
         ///     if <filename> is a regular file, just write to it
         ///     @todo if <filename> is named pipe, keep reopening it, if closed
         ///     if <filename> is Linux domain socket, create Linux domain socket server
@@ -66,9 +66,9 @@ class server
 
 struct oserver: public io::server< io::ostream >
 {
-    /// @param name ::= tcp:<port> | udp:<port> | <filename>
+    /// @param name ::= tcp:<port> | udp-multicast:<group>:<port> | udp-broadcast:[<address>:]<port> | <filename>
     ///     if tcp:<port>, create tcp server
-    ///     @todo if udp:<port>, broadcast on udp
+    ///     if udp-multicast or udp-broadcast, send each write once as record-aligned datagrams to all receivers
     ///     if <filename> is a regular file, just write to it
     ///     @todo if <filename> is named pipe, keep reopening it, if closed
     ///     if <filename> is Linux domain socket, create Linux domain socket server
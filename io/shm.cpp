@@ -0,0 +1,477 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/lexical_cast.hpp>
+#include "../base/exception.h"
+#include "../base/last_error.h"
+#include "../string/split.h"
+#include "impl/shm.h"
+#include "shm.h"
+
+namespace comma { namespace io { namespace shm {
+
+namespace impl {
+
+static const char magic[4] = { 'c', 's', 'h', 'm' };
+
+enum { version = 1 };
+
+struct header
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t capacity;
+    std::uint64_t record_size;
+    std::uint32_t readers;
+    std::uint32_t block;
+    std::atomic< std::uint32_t > writer; // writer pid, 0 once writer closed
+    std::atomic< std::uint32_t > ready; // 1 once header is initialised
+    alignas( 64 ) std::atomic< std::uint64_t > head; // number of bytes published, always on record or line boundary, except the last write
+    std::atomic< std::uint64_t > reserved; // number of bytes published or being written, to detect data overwritten while being read
+    std::atomic< std::uint32_t > data_sequence; // futex: incremented on publishing data or closing
+    std::atomic< std::uint32_t > data_waiters; // number of readers sleeping on data_sequence
+    alignas( 64 ) std::atomic< std::uint32_t > space_sequence; // futex: incremented by readers when writer waits for space
+    std::atomic< std::uint32_t > space_waiters;
+};
+
+struct alignas( 64 ) slot
+{
+    std::atomic< std::uint32_t > pid; // reader pid, 0 if slot is free
+    std::atomic< std::uint64_t > cursor; // number of bytes read
+    std::atomic< std::uint64_t > lost; // number of bytes overwritten before being read
+};
+
+static std::size_t data_offset( std::uint32_t readers ) { return sizeof( header ) + sizeof( slot ) * readers; }
+
+struct segment
+{
+    std::string name;
+    int fd{-1};
+    char* address{nullptr};
+    std::size_t size{0};
+    shm::impl::header* header{nullptr};
+    shm::impl::slot* slots{nullptr};
+    char* data{nullptr};
+
+    segment( const std::string& name ): name( name ) {}
+
+    ~segment()
+    {
+        if( address ) { ::munmap( address, size ); }
+        if( fd >= 0 ) { ::close( fd ); }
+    }
+
+    bool open( bool writable ) // return false, if shared memory object does not exist
+    {
+        fd = ::shm_open( &name[0], writable ? O_RDWR : O_RDONLY, 0 );
+        if( fd < 0 ) { if( errno == ENOENT ) { return false; } last_error::to_exception( "failed to open shared memory '" + name + "'" ); }
+        struct stat s;
+        if( ::fstat( fd, &s ) != 0 ) { last_error::to_exception( "failed to stat shared memory '" + name + "'" ); }
+        if( std::size_t( s.st_size ) < sizeof( shm::impl::header ) ) { return false; }
+        _map( s.st_size, writable );
+        if( !header->ready.load( std::memory_order_acquire ) || std::memcmp( header->magic, impl::magic, 4 ) != 0 || header->version != impl::version ) { return false; }
+        COMMA_ASSERT_BRIEF( size >= data_offset( header->readers ) + header->capacity, "shared memory '" << name << "' is truncated" );
+        return true;
+    }
+
+    void create( const shm::options& options )
+    {
+        fd = ::shm_open( &name[0], O_RDWR | O_CREAT | O_EXCL, 0666 ); // never unlink existing object: its writer may be creating it right now
+        if( fd < 0 && errno == EEXIST ) { COMMA_THROW_BRIEF( comma::exception, "shared memory '" << name << "' already exists; if its writer exited without closing it, remove it, e.g: rm /dev/shm" << name ); }
+        if( fd < 0 ) { last_error::to_exception( "failed to create shared memory '" + name + "'" ); }
+        std::size_t s = data_offset( options.readers ) + options.capacity;
+        if( ::ftruncate( fd, s ) != 0 ) { ::shm_unlink( &name[0] ); last_error::to_exception( "failed to resize shared memory '" + name + "' to " + boost::lexical_cast< std::string >( s ) + " bytes" ); }
+        _map( s, true );
+        new ( header ) shm::impl::header;
+        std::memcpy( header->magic, impl::magic, 4 );
+        header->version = impl::version;
+        header->capacity = options.capacity;
+        header->record_size = options.record_size;
+        header->readers = options.readers;
+        header->block = options.block;
+        header->writer = ::getpid();
+        header->head = 0;
+        header->reserved = 0;
+        header->data_sequence = 0;
+        header->data_waiters = 0;
+        header->space_sequence = 0;
+        header->space_waiters = 0;
+        for( unsigned int i = 0; i < options.readers; ++i ) { new ( slots + i ) shm::impl::slot; slots[i].pid = 0; slots[i].cursor = 0; slots[i].lost = 0; }
+        data = address + data_offset( options.readers );
+        header->ready.store( 1, std::memory_order_release );
+    }
+
+    void copy( std::uint64_t from, char* buf, std::size_t n ) const // copy from ring
+    {
+        std::size_t offset = from % header->capacity;
+        std::size_t m = std::min< std::size_t >( n, header->capacity - offset );
+        std::memcpy( buf, data + offset, m );
+        std::memcpy( buf + m, data, n - m );
+    }
+
+    private:
+        void _map( std::size_t s, bool writable )
+        {
+            void* a = ::mmap( nullptr, s, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0 );
+            if( a == MAP_FAILED ) { last_error::to_exception( "failed to map shared memory '" + name + "'" ); }
+            address = static_cast< char* >( a );
+            size = s;
+            header = reinterpret_cast< shm::impl::header* >( address );
+            slots = reinterpret_cast< shm::impl::slot* >( address + sizeof( shm::impl::header ) );
+            data = address + data_offset( header->readers ); // valid only for initialised header
+        }
+};
+
+/// pipe ready for reading, while reader has data available or writer is gone, for reader to be used in select()
+struct notifier
+{
+    int pipe[2]{-1, -1};
+    std::atomic< std::uint32_t > armed{1}; // 1: thread waits for data; 0: pipe signalled, thread waits for reader to read all data
+    std::atomic< bool > stop{false};
+    std::mutex mutex; // pipe signalled and armed change together
+    shm::impl::header* header;
+    const shm::impl::slot* slot;
+    std::thread thread;
+
+    notifier( shm::impl::header* header, const shm::impl::slot* slot ): header( header ), slot( slot )
+    {
+        if( ::pipe( pipe ) != 0 ) { last_error::to_exception( "shm: failed to create pipe" ); }
+        ::fcntl( pipe[0], F_SETFL, ::fcntl( pipe[0], F_GETFL ) | O_NONBLOCK );
+        thread = std::thread( &notifier::run, this );
+    }
+
+    ~notifier()
+    {
+        stop = true;
+        armed = 1;
+        comma::futex::wake( armed, false );
+        impl::notify( header->data_sequence, header->data_waiters ); // spurious wake-up for other readers, if any, is harmless
+        thread.join();
+        ::close( pipe[0] );
+        ::close( pipe[1] );
+    }
+
+    bool ready() const
+    {
+        std::uint32_t writer = header->writer.load( std::memory_order_acquire );
+        return header->head.load( std::memory_order_acquire ) != slot->cursor.load() || writer == 0 || !impl::alive( writer );
+    }
+
+    void run()
+    {
+        while( !stop )
+        {
+            if( armed.load() == 0 ) { comma::futex::wait( armed, 0, -1, false ); continue; }
+            header->data_waiters.fetch_add( 1 );
+            std::uint32_t sequence = header->data_sequence.load();
+            bool r = ready();
+            if( !r ) { comma::futex::wait( header->data_sequence, sequence, 100000 ); } // wake up periodically to check whether writer is alive
+            header->data_waiters.fetch_sub( 1 );
+            if( stop || !( r || ready() ) ) { continue; }
+            std::lock_guard< std::mutex > lock( mutex );
+            char c = 0;
+            while( ::write( pipe[1], &c, 1 ) < 0 && errno == EINTR );
+            armed = 0;
+        }
+    }
+
+    void rearm() // call after reading, if no data available and writer alive
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        if( armed.load() != 0 ) { return; }
+        char buf[16];
+        while( ::read( pipe[0], buf, sizeof( buf ) ) > 0 );
+        armed = 1;
+        comma::futex::wake( armed, false );
+    }
+};
+
+} // namespace impl {
+
+options options::strip( std::string& name, std::size_t default_record_size )
+{
+    options o;
+    o.record_size = default_record_size;
+    std::vector< std::string > v = comma::split( name, ';' );
+    for( unsigned int i = 1; i < v.size(); ++i )
+    {
+        if( v[i] == "block" ) { o.block = true; continue; }
+        if( v[i] == "overwrite" ) { o.block = false; continue; }
+        std::string::size_type p = v[i].find( '=' );
+        COMMA_ASSERT_BRIEF( p != std::string::npos, "expected shm stream option as <name>=<value>; got: '" << v[i] << "' in '" << name << "'" );
+        std::string key = v[i].substr( 0, p );
+        std::string value = v[i].substr( p + 1 );
+        if( key == "size" || key == "record-size" ) { o.record_size = boost::lexical_cast< std::size_t >( value ); }
+        else if( key == "capacity" ) { o.capacity = boost::lexical_cast< std::size_t >( value ); }
+        else if( key == "readers" ) { o.readers = boost::lexical_cast< unsigned int >( value ); }
+        else { COMMA_THROW( comma::exception, "unknown shm stream option '" << key << "' in '" << name << "'" ); }
+    }
+    COMMA_ASSERT_BRIEF( o.readers > 0, "expected positive number of readers in '" << name << "'" );
+    COMMA_ASSERT_BRIEF( o.capacity >= 2 * std::max( o.record_size, std::size_t( 1 ) ), "expected capacity of at least 2 records in '" << name << "'" );
+    name = v[0];
+    return o;
+}
+
+std::string options::usage( unsigned int indent )
+{
+    std::string i( indent, ' ' );
+    std::ostringstream oss;
+    oss << i << "shm:<name>[;<options>]: shared memory ring buffer, one writer, many readers, e.g. shm:/lidar;size=32" << std::endl;
+    oss << i << "    capacity=<bytes>; default=16777216: ring size" << std::endl;
+    oss << i << "    size,record-size=<bytes>: record size; default: 1 for binary, lines for ascii" << std::endl;
+    oss << i << "    block: writer waits for the slowest reader" << std::endl;
+    oss << i << "    overwrite: default; writer does not wait, slow readers skip to the latest data" << std::endl;
+    oss << i << "    readers=<n>; default=16: maximum number of readers" << std::endl;
+    oss << i << "    options are used only by writer; readers take them from the ring" << std::endl;
+    return oss.str();
+}
+
+std::string object_name( const std::string& name )
+{
+    std::string n = name.substr( 0, 4 ) == "shm:" ? name.substr( 4 ) : name;
+    COMMA_ASSERT_BRIEF( !n.empty(), "expected shm:<name>; got: '" << name << "'" );
+    return n[0] == '/' ? n : "/" + n;
+}
+
+writer::writer( const std::string& name, const shm::options& options ): _options( options ), _segment( new impl::segment( object_name( name ) ) )
+{
+    {
+        impl::segment existing( _segment->name );
+        COMMA_ASSERT_BRIEF( !existing.open( false ) || !impl::alive( existing.header->writer.load() ), "shared memory '" << _segment->name << "' already has a writer with pid " << existing.header->writer.load() );
+    }
+    _segment->create( options );
+}
+
+writer::~writer()
+{
+    try { close(); }
+    catch( ... ) {}
+}
+
+void writer::write( const char* buf, std::size_t size )
+{
+    COMMA_ASSERT_BRIEF( _segment, "shm: writing to closed writer" );
+    std::size_t chunk = std::max( _options.capacity / 2, std::size_t( 1 ) );
+    for( std::size_t i = 0; i < size; i += chunk ) { _write( buf + i, std::min( chunk, size - i ) ); }
+}
+
+void writer::_write( const char* buf, std::size_t size )
+{
+    impl::header* h = _segment->header;
+    if( _options.block ) { _wait_for_space( size ); }
+    h->reserved.store( _written + size, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release ); // readers see reserved before overwritten data
+    std::size_t offset = _written % _options.capacity;
+    std::size_t n = std::min( size, _options.capacity - offset );
+    std::memcpy( _segment->data + offset, buf, n );
+    std::memcpy( _segment->data, buf + n, size - n );
+    std::uint64_t begin = _written;
+    _written += size;
+    if( _options.record_size > 0 ) { _publish( _written - _written % _options.record_size ); return; }
+    std::reverse_iterator< const char* > it = std::find( std::reverse_iterator< const char* >( buf + size ), std::reverse_iterator< const char* >( buf ), '\n' );
+    if( it.base() != buf ) { _publish( begin + ( it.base() - buf ) ); }
+}
+
+void writer::_publish( std::uint64_t head )
+{
+    if( head <= _published ) { return; }
+    impl::header* h = _segment->header;
+    h->head.store( head, std::memory_order_release );
+    _published = head;
+    impl::notify( h->data_sequence, h->data_waiters );
+}
+
+void writer::_wait_for_space( std::size_t size )
+{
+    impl::header* h = _segment->header;
+    auto has_space = [&]() -> bool
+    {
+        std::uint64_t min = _written;
+        for( unsigned int i = 0; i < _options.readers; ++i ) { if( _segment->slots[i].pid.load() != 0 ) { min = std::min< std::uint64_t >( min, _segment->slots[i].cursor.load() ); } }
+        return _written + size - min <= _options.capacity;
+    };
+    while( !has_space() )
+    {
+        h->space_waiters.fetch_add( 1 );
+        std::uint32_t sequence = h->space_sequence.load();
+        if( !has_space() ) { comma::futex::wait( h->space_sequence, sequence, 100000 ); }
+        h->space_waiters.fetch_sub( 1 );
+        for( unsigned int i = 0; i < _options.readers; ++i ) // release slots of readers that exited without closing
+        {
+            std::uint32_t pid = _segment->slots[i].pid.load();
+            if( pid != 0 && !impl::alive( pid ) ) { _segment->slots[i].pid.compare_exchange_strong( pid, 0 ); }
+        }
+    }
+}
+
+void writer::close()
+{
+    if( !_segment ) { return; }
+    impl::header* h = _segment->header;
+    h->reserved.store( _written );
+    h->head.store( _written, std::memory_order_release ); // publish incomplete record, if any
+    h->writer.store( 0, std::memory_order_release );
+    h->data_sequence.fetch_add( 1 );
+    comma::futex::wake( h->data_sequence );
+    ::shm_unlink( &_segment->name[0] );
+    _segment.reset();
+}
+
+unsigned int writer::readers() const
+{
+    unsigned int count = 0;
+    if( !_segment ) { return count; }
+    for( unsigned int i = 0; i < _options.readers; ++i ) { if( _segment->slots[i].pid.load() != 0 ) { ++count; } }
+    return count;
+}
+
+io::file_descriptor writer::fd() const { return _segment ? _segment->fd : io::invalid_file_descriptor; }
+
+reader::reader( const std::string& name ): _segment( new impl::segment( object_name( name ) ) )
+{
+    COMMA_ASSERT_BRIEF( _segment->open( true ), "shared memory ring '" << _segment->name << "' not found" );
+    impl::header* h = _segment->header;
+    std::uint32_t self = ::getpid();
+    for( unsigned int i = 0; i < h->readers && !_slot; ++i )
+    {
+        impl::slot& s = _segment->slots[i];
+        std::uint32_t pid = s.pid.load();
+        if( pid != 0 && ( pid == self || impl::alive( pid ) ) ) { continue; }
+        if( !s.pid.compare_exchange_strong( pid, self ) ) { continue; }
+        s.lost = 0;
+        s.cursor.store( h->head.load() );
+        _slot = &s;
+    }
+    COMMA_ASSERT_BRIEF( _slot, "shared memory ring '" << _segment->name << "' has no free reader slots (maximum " << h->readers << " readers)" );
+    impl::notify( h->space_sequence, h->space_waiters );
+}
+
+reader::~reader() { close(); }
+
+void reader::close()
+{
+    if( !_slot ) { return; }
+    _notifier.reset();
+    impl::header* h = _segment->header;
+    _slot->pid.store( 0 );
+    _slot = nullptr;
+    impl::notify( h->space_sequence, h->space_waiters );
+    _segment.reset();
+}
+
+std::size_t reader::read( char* buf, std::size_t size, bool blocking )
+{
+    COMMA_ASSERT_BRIEF( _slot, "shm: reading from closed reader" );
+    std::size_t n = _read( buf, size, blocking );
+    if( _notifier && available() == 0 && _writer_alive() ) { _notifier->rearm(); }
+    return n;
+}
+
+std::size_t reader::_read( char* buf, std::size_t size, bool blocking )
+{
+    if( size == 0 ) { return 0; }
+    impl::header* h = _segment->header;
+    auto skip = [&]( std::uint64_t cursor ) // skip overwritten data to the oldest whole record still in ring or, for lines, to the latest data
+    {
+        std::uint64_t head = h->head.load( std::memory_order_acquire );
+        std::uint64_t from = head;
+        if( h->record_size > 0 )
+        {
+            std::uint64_t reserved = h->reserved.load();
+            from = reserved - h->capacity + h->record_size - 1;
+            from = std::min( from - from % h->record_size, head );
+        }
+        _slot->lost += from - cursor;
+        _slot->cursor.store( from );
+    };
+    while( true )
+    {
+        std::uint64_t cursor = _slot->cursor.load( std::memory_order_relaxed );
+        std::uint64_t head = h->head.load( std::memory_order_acquire );
+        if( head == cursor )
+        {
+            if( !blocking || eof() ) { return 0; }
+            wait( boost::posix_time::pos_infin );
+            continue;
+        }
+        if( h->reserved.load() > cursor + h->capacity ) { skip( cursor ); continue; } // overwritten
+        std::size_t n = std::min< std::uint64_t >( size, head - cursor );
+        if( h->record_size > 0 && n >= h->record_size ) { n -= n % h->record_size; }
+        _segment->copy( cursor, buf, n );
+        if( !h->block )
+        {
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if( h->reserved.load( std::memory_order_relaxed ) > cursor + h->capacity ) { skip( cursor ); continue; } // overwritten while being copied
+        }
+        if( h->record_size == 0 ) // end on line boundary, if possible
+        {
+            std::reverse_iterator< char* > it = std::find( std::reverse_iterator< char* >( buf + n ), std::reverse_iterator< char* >( buf ), '\n' );
+            if( it.base() != buf ) { n = it.base() - buf; }
+        }
+        _slot->cursor.store( cursor + n );
+        if( h->block && h->space_waiters.load() > 0 ) { impl::notify( h->space_sequence, h->space_waiters ); } // check waiters first to save atomic increment on each read
+        return n;
+    }
+}
+
+std::size_t reader::available() const
+{
+    if( !_slot ) { return 0; }
+    return std::min< std::uint64_t >( _segment->header->head.load( std::memory_order_acquire ) - _slot->cursor.load( std::memory_order_relaxed ), _segment->header->capacity );
+}
+
+bool reader::_writer_alive() const { return _segment->header->writer.load( std::memory_order_acquire ) != 0 && ( !_writer_dead ); }
+
+bool reader::eof() const { return _slot && !_writer_alive() && available() == 0; }
+
+bool reader::wait( boost::posix_time::time_duration timeout )
+{
+    if( !_slot ) { return true; }
+    impl::header* h = _segment->header;
+    for( unsigned int i = 0; i < impl::spin; ++i ) { if( available() > 0 || !_writer_alive() ) { return true; } impl::relax(); }
+    boost::posix_time::ptime deadline = timeout.is_pos_infinity() ? boost::posix_time::ptime( boost::posix_time::pos_infin ) : boost::posix_time::microsec_clock::universal_time() + timeout;
+    while( true )
+    {
+        h->data_waiters.fetch_add( 1 );
+        std::uint32_t sequence = h->data_sequence.load();
+        bool ready = available() > 0 || !_writer_alive();
+        if( !ready )
+        {
+            long microseconds = 100000; // wake up periodically to check whether writer is alive
+            if( !deadline.is_pos_infinity() ) { microseconds = std::min( microseconds, long( ( deadline - boost::posix_time::microsec_clock::universal_time() ).total_microseconds() ) ); }
+            if( microseconds > 0 ) { comma::futex::wait( h->data_sequence, sequence, microseconds ); }
+        }
+        h->data_waiters.fetch_sub( 1 );
+        if( ready || available() > 0 ) { return true; }
+        if( !impl::alive( h->writer.load() ) ) { _writer_dead = true; }
+        if( !_writer_alive() ) { return true; }
+        if( !deadline.is_pos_infinity() && boost::posix_time::microsec_clock::universal_time() >= deadline ) { return false; }
+    }
+}
+
+std::uint64_t reader::lost() const { return _slot ? _slot->lost.load() : 0; }
+
+std::size_t reader::record_size() const { return _segment ? _segment->header->record_size : 0; }
+
+io::file_descriptor reader::fd() const
+{
+    if( !_slot ) { return io::invalid_file_descriptor; }
+    if( !_notifier ) { _notifier.reset( new impl::notifier( _segment->header, _slot ) ); }
+    return _notifier->pipe[0];
+}
+
+} } } // namespace comma { namespace io { namespace shm {
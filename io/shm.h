@@ -0,0 +1,158 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/iostreams/concepts.hpp>
+#include <boost/noncopyable.hpp>
+#include "file_descriptor.h"
+
+namespace comma { namespace io { namespace shm {
+
+/// single-producer multiple-consumer ring buffer in posix shared memory
+///
+/// the writer creates a shared memory object (e.g. /dev/shm/lidar for "shm:/lidar"), copies data
+/// to the ring and publishes it only on record boundaries (or line boundaries for ascii), thus a
+/// reader always starts on and skips to the beginning of a record; each reader has its own cursor
+///
+/// if readers do not keep up:
+///     overwrite mode (default): the writer never waits, slow readers skip to the latest data
+///     block mode: the writer waits for the slowest reader
+///
+/// waiting readers and the writer in block mode sleep on futexes in shared memory; the writer
+/// only makes a system call to wake up readers, if any is waiting
+///
+/// when the writer closes, the shared memory object is unlinked; attached readers read remaining
+/// data and then get end of stream
+struct options
+{
+    std::size_t capacity{16777216}; /// ring size in bytes
+    std::size_t record_size{0}; /// record size in bytes, 0: ascii lines
+    bool block{false}; /// if true, writer waits for slowest reader, otherwise slow readers lose data
+    unsigned int readers{16}; /// maximum number of readers
+
+    /// strip options from name and return them, e.g:
+    ///     "shm:/lidar;size=32;capacity=67108864;block" -> "shm:/lidar"
+    static options strip( std::string& name, std::size_t default_record_size = 0 );
+
+    static std::string usage( unsigned int indent = 0 );
+};
+
+/// return shared memory object name for stream name, e.g. "shm:/lidar" or "shm:lidar" -> "/lidar"
+std::string object_name( const std::string& name );
+
+namespace impl { struct header; struct slot; struct segment; struct notifier; }
+
+class writer : public boost::noncopyable
+{
+    public:
+        /// create ring; throw, if shared memory object with this name already exists, e.g. ring with a live writer
+        /// or a stale ring of a writer that exited without closing, which has to be removed then, e.g. in /dev/shm
+        writer( const std::string& name, const shm::options& options = shm::options() );
+
+        ~writer();
+
+        /// write data, publish whole records or lines written so far
+        void write( const char* buf, std::size_t size );
+
+        /// publish remaining data, even if not a whole record, mark end of stream, unlink shared memory object
+        void close();
+
+        /// return number of attached readers
+        unsigned int readers() const;
+
+        /// return file descriptor of shared memory object; always ready for writing in select, since
+        /// writer never waits in overwrite mode; in block mode, write() waits for the slowest reader
+        io::file_descriptor fd() const;
+
+        const shm::options& options() const { return _options; }
+
+    private:
+        shm::options _options;
+        std::unique_ptr< impl::segment > _segment;
+        std::uint64_t _written{0};
+        std::uint64_t _published{0};
+
+        void _write( const char* buf, std::size_t size );
+        void _publish( std::uint64_t head );
+        void _wait_for_space( std::size_t size );
+};
+
+class reader : public boost::noncopyable
+{
+    public:
+        /// attach to ring as a new reader starting from the latest data; throw, if no ring or no free reader slots
+        reader( const std::string& name );
+
+        ~reader();
+
+        /// read up to size bytes ending on record or line boundary where possible
+        /// @param blocking if true, wait for data
+        /// @return number of bytes read; 0 on end of stream or, if non-blocking, if no data available
+        std::size_t read( char* buf, std::size_t size, bool blocking = true );
+
+        /// return number of bytes available for reading
+        std::size_t available() const;
+
+        /// wait for data for no longer than timeout; return true, if data available or end of stream
+        bool wait( boost::posix_time::time_duration timeout );
+
+        /// return true if writer closed or exited and all data has been read
+        bool eof() const;
+
+        /// return number of bytes skipped, since the writer overwrote them before this reader read them
+        std::uint64_t lost() const;
+
+        /// return record size set by writer; 0: ascii lines
+        std::size_t record_size() const;
+
+        /// detach from ring
+        void close();
+
+        /// return file descriptor for select, ready for reading while data is available or on end of stream
+        /// on first call, starts a thread sleeping on the ring and signalling the file descriptor
+        io::file_descriptor fd() const;
+
+    private:
+        std::unique_ptr< impl::segment > _segment;
+        impl::slot* _slot{nullptr};
+        bool _writer_dead{false};
+        mutable std::unique_ptr< impl::notifier > _notifier;
+        bool _writer_alive() const;
+        std::size_t _read( char* buf, std::size_t size, bool blocking );
+};
+
+/// boost::iostreams source
+class source : public boost::iostreams::source
+{
+    public:
+        source( const std::shared_ptr< shm::reader >& reader ): _reader( reader ) {}
+
+        std::streamsize read( char* s, std::streamsize n ) { std::size_t r = _reader->read( s, n ); return r == 0 ? -1 : std::streamsize( r ); }
+
+    private:
+        std::shared_ptr< shm::reader > _reader;
+};
+
+/// boost::iostreams sink; data is published, whenever the stream writes out its buffer
+class sink : public boost::iostreams::sink
+{
+    public:
+        struct category : boost::iostreams::sink_tag, boost::iostreams::closable_tag {};
+
+        sink( const std::shared_ptr< shm::writer >& writer ): _writer( writer ) {}
+
+        std::streamsize write( const char* s, std::streamsize n ) { _writer->write( s, n ); return n; }
+
+        void close() { _writer->close(); }
+
+    private:
+        std::shared_ptr< shm::writer > _writer;
+};
+
+} } } // namespace comma { namespace io { namespace shm {
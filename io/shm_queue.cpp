@@ -0,0 +1,497 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/lexical_cast.hpp>
+#include "../base/exception.h"
+#include "../base/last_error.h"
+#include "impl/shm.h"
+#include "shm_queue.h"
+
+namespace comma { namespace io { namespace shm { namespace queue {
+
+namespace impl {
+
+using shm::impl::alive;
+
+static const char magic[4] = { 'c', 's', 'h', 'q' };
+
+enum { version = 1, alignment = 16 };
+
+enum state { empty = 0, full = 1, skip = 2 };
+
+struct header
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t capacity;
+    std::uint64_t record_size;
+    std::uint32_t producers;
+    std::uint32_t fair;
+    std::atomic< std::uint32_t > consumer; // consumer pid, 0 once consumer closed
+    std::atomic< std::uint32_t > ready; // 1 once header is initialised
+    alignas( 64 ) std::atomic< std::uint64_t > tail; // end of reserved space
+    std::atomic< std::uint32_t > ticket; // next ticket for fair mode
+    alignas( 64 ) std::atomic< std::uint32_t > serving; // futex: ticket currently served in fair mode
+    std::atomic< std::uint32_t > serving_waiters;
+    alignas( 64 ) std::atomic< std::uint64_t > head; // end of consumed space
+    std::atomic< std::uint64_t > max_depth;
+    std::atomic< std::uint32_t > space_sequence; // futex: incremented by consumer when producers wait for space
+    std::atomic< std::uint32_t > space_waiters;
+    alignas( 64 ) std::atomic< std::uint32_t > data_sequence; // futex: incremented by producers when consumer waits for data
+    std::atomic< std::uint32_t > data_waiters;
+    alignas( 64 ) std::atomic< std::uint64_t > attached; // totals; counters of attached producers are in their slots
+    std::atomic< std::uint64_t > detached;
+    std::atomic< std::uint64_t > messages;
+    std::atomic< std::uint64_t > bytes;
+    std::atomic< std::uint64_t > waits;
+    std::atomic< std::uint64_t > dropped;
+    std::atomic< std::uint64_t > lost;
+};
+
+struct alignas( 64 ) slot
+{
+    std::atomic< std::uint32_t > pid; // producer pid, 0 if slot is free
+    std::atomic< std::uint32_t > queued; // 1 if waiting for its turn or being served in fair mode
+    std::atomic< std::uint32_t > ticket;
+    std::atomic< std::uint64_t > begin; // space being reserved or written by producer; none if begin == end
+    std::atomic< std::uint64_t > end;
+    std::atomic< std::uint64_t > messages; // counters, updated only by producer
+    std::atomic< std::uint64_t > bytes;
+    std::atomic< std::uint64_t > waits;
+    std::atomic< std::uint64_t > dropped;
+
+    void reset() { queued = 0; ticket = 0; begin = 0; end = 0; messages = 0; bytes = 0; waits = 0; dropped = 0; }
+};
+
+struct message
+{
+    std::atomic< std::uint32_t > state;
+    std::uint32_t size;
+    std::uint64_t padding;
+};
+
+static_assert( sizeof( message ) == alignment, "expected message header of alignment size" );
+
+static std::size_t footprint( std::size_t size ) { return sizeof( message ) + ( size + alignment - 1 ) / alignment * alignment; }
+
+static std::size_t data_offset( std::uint32_t producers ) { return sizeof( header ) + sizeof( slot ) * producers; }
+
+struct segment
+{
+    std::string name;
+    int fd{-1};
+    char* address{nullptr};
+    std::size_t size{0};
+    queue::impl::header* header{nullptr};
+    queue::impl::slot* slots{nullptr};
+    char* data{nullptr};
+
+    segment( const std::string& name ): name( name ) {}
+
+    ~segment()
+    {
+        if( address ) { ::munmap( address, size ); }
+        if( fd >= 0 ) { ::close( fd ); }
+    }
+
+    bool open( bool writable ) // return false, if shared memory object does not exist
+    {
+        fd = ::shm_open( &name[0], writable ? O_RDWR : O_RDONLY, 0 );
+        if( fd < 0 ) { if( errno == ENOENT ) { return false; } last_error::to_exception( "failed to open shared memory '" + name + "'" ); }
+        struct stat s;
+        if( ::fstat( fd, &s ) != 0 ) { last_error::to_exception( "failed to stat shared memory '" + name + "'" ); }
+        if( std::size_t( s.st_size ) < sizeof( queue::impl::header ) ) { return false; }
+        _map( s.st_size, writable );
+        if( !header->ready.load( std::memory_order_acquire ) || std::memcmp( header->magic, impl::magic, 4 ) != 0 || header->version != impl::version ) { return false; }
+        COMMA_ASSERT_BRIEF( size >= data_offset( header->producers ) + header->capacity, "shared memory '" << name << "' is truncated" );
+        data = address + data_offset( header->producers );
+        return true;
+    }
+
+    void create( const queue::options& options )
+    {
+        ::shm_unlink( &name[0] ); // remove stale queue
+        fd = ::shm_open( &name[0], O_RDWR | O_CREAT | O_EXCL, 0666 );
+        if( fd < 0 ) { last_error::to_exception( "failed to create shared memory '" + name + "'" ); }
+        std::size_t s = data_offset( options.producers ) + options.capacity;
+        if( ::ftruncate( fd, s ) != 0 ) { ::shm_unlink( &name[0] ); last_error::to_exception( "failed to resize shared memory '" + name + "' to " + boost::lexical_cast< std::string >( s ) + " bytes" ); }
+        _map( s, true ); // ftruncate fills memory with zeroes, i.e. all messages are empty
+        new ( header ) queue::impl::header;
+        std::memcpy( header->magic, impl::magic, 4 );
+        header->version = impl::version;
+        header->capacity = options.capacity;
+        header->record_size = options.record_size;
+        header->producers = options.producers;
+        header->fair = options.fair;
+        header->consumer = ::getpid();
+        header->tail = 0;
+        header->ticket = 0;
+        header->serving = 0;
+        header->serving_waiters = 0;
+        header->head = 0;
+        header->max_depth = 0;
+        header->space_sequence = 0;
+        header->space_waiters = 0;
+        header->data_sequence = 0;
+        header->data_waiters = 0;
+        header->attached = 0;
+        header->detached = 0;
+        header->messages = 0;
+        header->bytes = 0;
+        header->waits = 0;
+        header->dropped = 0;
+        header->lost = 0;
+        for( unsigned int i = 0; i < options.producers; ++i ) { new ( slots + i ) queue::impl::slot; slots[i].pid = 0; slots[i].reset(); }
+        data = address + data_offset( options.producers );
+        header->ready.store( 1, std::memory_order_release );
+    }
+
+    message* at( std::uint64_t position ) const { return reinterpret_cast< message* >( data + position % header->capacity ); }
+
+    /// if slot belongs to a dead producer without unfinished message, take it over as owner, add its counters to totals, and reset it
+    bool reap( slot& s, std::uint32_t owner )
+    {
+        std::uint32_t pid = s.pid.load();
+        if( pid == 0 || alive( pid ) || s.begin.load() != s.end.load() || !s.pid.compare_exchange_strong( pid, owner ) ) { return false; }
+        fold( s );
+        return true;
+    }
+
+    /// add slot counters to totals, reset slot
+    void fold( slot& s )
+    {
+        header->messages += s.messages.load();
+        header->bytes += s.bytes.load();
+        header->waits += s.waits.load();
+        header->dropped += s.dropped.load();
+        s.reset();
+        ++header->detached;
+    }
+
+    statistics stats() const
+    {
+        statistics s;
+        const queue::impl::header* h = header;
+        s.attached = h->attached.load();
+        s.detached = h->detached.load();
+        s.messages = h->messages.load();
+        s.bytes = h->bytes.load();
+        s.waits = h->waits.load();
+        s.dropped = h->dropped.load();
+        s.lost = h->lost.load();
+        for( unsigned int i = 0; i < h->producers; ++i )
+        {
+            if( slots[i].pid.load() == 0 ) { continue; }
+            ++s.producers;
+            s.messages += slots[i].messages.load( std::memory_order_relaxed );
+            s.bytes += slots[i].bytes.load( std::memory_order_relaxed );
+            s.waits += slots[i].waits.load( std::memory_order_relaxed );
+            s.dropped += slots[i].dropped.load( std::memory_order_relaxed );
+        }
+        std::uint64_t head = h->head.load();
+        std::uint64_t tail = h->tail.load();
+        s.depth = tail > head ? tail - head : 0;
+        s.max_depth = std::max< std::uint64_t >( h->max_depth.load(), s.depth );
+        return s;
+    }
+
+    private:
+        void _map( std::size_t s, bool writable )
+        {
+            void* a = ::mmap( nullptr, s, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0 );
+            if( a == MAP_FAILED ) { last_error::to_exception( "failed to map shared memory '" + name + "'" ); }
+            address = static_cast< char* >( a );
+            size = s;
+            header = reinterpret_cast< queue::impl::header* >( address );
+            slots = reinterpret_cast< queue::impl::slot* >( address + sizeof( queue::impl::header ) );
+        }
+};
+
+} // namespace impl {
+
+std::string object_name( const std::string& name )
+{
+    COMMA_ASSERT_BRIEF( !name.empty(), "expected shared memory queue name; got empty string" );
+    return name[0] == '/' ? name : "/" + name;
+}
+
+consumer::consumer( const std::string& name, const queue::options& options ): _options( options ), _segment( new impl::segment( object_name( name ) ) )
+{
+    _options.capacity = ( _options.capacity + 63 ) / 64 * 64;
+    COMMA_ASSERT_BRIEF( _options.producers > 0, "shm queue: expected positive number of producers" );
+    COMMA_ASSERT_BRIEF( _options.capacity >= 4 * impl::alignment, "shm queue: expected capacity of at least " << ( 4 * impl::alignment ) << " bytes; got: " << options.capacity );
+    {
+        impl::segment existing( _segment->name );
+        COMMA_ASSERT_BRIEF( !existing.open( false ) || !impl::alive( existing.header->consumer.load() ), "shared memory queue '" << _segment->name << "' already has a consumer with pid " << existing.header->consumer.load() );
+    }
+    _segment->create( _options );
+}
+
+consumer::~consumer()
+{
+    try { close(); }
+    catch( ... ) {}
+}
+
+std::pair< const char*, std::size_t > consumer::front( boost::posix_time::time_duration timeout )
+{
+    COMMA_ASSERT_BRIEF( _segment, "shm queue: reading from closed consumer" );
+    impl::header* h = _segment->header;
+    boost::posix_time::ptime deadline = timeout.is_pos_infinity() ? boost::posix_time::ptime( boost::posix_time::pos_infin ) : boost::posix_time::microsec_clock::universal_time() + timeout;
+    unsigned int spin = 0;
+    while( true )
+    {
+        impl::message* m = _segment->at( _head );
+        std::uint32_t state = m->state.load( std::memory_order_acquire );
+        if( state == impl::skip ) { _release( _head + h->capacity - _head % h->capacity ); continue; }
+        if( state == impl::full )
+        {
+            _front = _head + impl::footprint( m->size );
+            _stalled = boost::posix_time::not_a_date_time;
+            return std::make_pair( reinterpret_cast< const char* >( m + 1 ), std::size_t( m->size ) );
+        }
+        if( h->tail.load( std::memory_order_acquire ) != _head ) // message reserved, but not written yet
+        {
+            if( _stalled.is_not_a_date_time() ) { _stalled = boost::posix_time::microsec_clock::universal_time(); }
+            if( _recover() ) { continue; }
+        }
+        if( spin < shm::impl::spin ) { ++spin; shm::impl::relax(); continue; }
+        h->data_waiters.fetch_add( 1 );
+        std::atomic_thread_fence( std::memory_order_seq_cst ); // pairs with fence in producer::push()
+        std::uint32_t sequence = h->data_sequence.load();
+        bool ready = m->state.load() != impl::empty;
+        if( !ready )
+        {
+            long microseconds = 100000; // wake up periodically to check for dead producers
+            if( !deadline.is_pos_infinity() ) { microseconds = std::min( microseconds, long( ( deadline - boost::posix_time::microsec_clock::universal_time() ).total_microseconds() ) ); }
+            if( microseconds > 0 ) { comma::futex::wait( h->data_sequence, sequence, microseconds ); }
+        }
+        h->data_waiters.fetch_sub( 1 );
+        if( !ready ) { _reap(); }
+        if( !ready && m->state.load() == impl::empty && !deadline.is_pos_infinity() && boost::posix_time::microsec_clock::universal_time() >= deadline ) { return std::make_pair( nullptr, 0 ); }
+    }
+}
+
+void consumer::pop()
+{
+    COMMA_ASSERT_BRIEF( _front > 0, "shm queue: pop() without front()" );
+    _release( _front );
+    _front = 0;
+}
+
+void consumer::_release( std::uint64_t end )
+{
+    impl::header* h = _segment->header;
+    std::uint64_t tail = h->tail.load( std::memory_order_relaxed );
+    if( tail - _head > h->max_depth.load( std::memory_order_relaxed ) ) { h->max_depth.store( tail - _head, std::memory_order_relaxed ); }
+    std::memset( _segment->data + _head % h->capacity, 0, end - _head ); // never wraps, since messages are contiguous
+    _head = end;
+    h->head.store( _head );
+    std::atomic_thread_fence( std::memory_order_seq_cst ); // make space visible before checking for waiting producers
+    if( h->space_waiters.load() > 0 ) { h->space_sequence.fetch_add( 1 ); comma::futex::wake( h->space_sequence ); }
+}
+
+bool consumer::_recover() // skip message, if its producer died while writing it
+{
+    if( ( boost::posix_time::microsec_clock::universal_time() - _stalled ).total_milliseconds() < 1000 ) { return false; }
+    _stalled = boost::posix_time::microsec_clock::universal_time();
+    impl::header* h = _segment->header;
+    for( unsigned int i = 0; i < h->producers; ++i )
+    {
+        impl::slot& s = _segment->slots[i];
+        std::uint32_t pid = s.pid.load();
+        if( pid == 0 || impl::alive( pid ) ) { continue; }
+        std::uint64_t begin = s.begin.load( std::memory_order_acquire );
+        std::uint64_t end = s.end.load();
+        if( begin == end || _head < begin || _head >= end || h->tail.load() < end ) { continue; }
+        if( !s.pid.compare_exchange_strong( pid, ::getpid() ) ) { continue; }
+        while( _head < end ) { _release( std::min( end, _head + h->capacity - _head % h->capacity ) ); } // message may follow padding at the end of ring
+        ++h->lost;
+        _segment->fold( s );
+        s.pid.store( 0 );
+        return true;
+    }
+    return false;
+}
+
+void consumer::_reap() // release slots of producers that exited without closing
+{
+    impl::header* h = _segment->header;
+    std::uint32_t self = ::getpid();
+    for( unsigned int i = 0; i < h->producers; ++i ) { if( _segment->reap( _segment->slots[i], self ) ) { _segment->slots[i].pid.store( 0 ); } }
+}
+
+bool consumer::empty() const
+{
+    return !_segment || ( _front == 0 && _segment->header->tail.load() == _head );
+}
+
+void consumer::close()
+{
+    if( !_segment ) { return; }
+    impl::header* h = _segment->header;
+    h->consumer.store( 0, std::memory_order_release );
+    h->space_sequence.fetch_add( 1 );
+    comma::futex::wake( h->space_sequence );
+    h->serving.fetch_add( 1 );
+    comma::futex::wake( h->serving );
+    ::shm_unlink( &_segment->name[0] );
+    _segment.reset();
+}
+
+statistics consumer::stats() const { return _segment ? _segment->stats() : statistics(); }
+
+producer::producer( const std::string& name, bool blocking ): _blocking( blocking ), _segment( new impl::segment( object_name( name ) ) )
+{
+    COMMA_ASSERT_BRIEF( _segment->open( true ), "shared memory queue '" << _segment->name << "' not found" );
+    impl::header* h = _segment->header;
+    COMMA_ASSERT_BRIEF( h->consumer.load() != 0, "shared memory queue '" << _segment->name << "' is closed" );
+    std::uint32_t self = ::getpid();
+    for( unsigned int i = 0; i < h->producers && !_slot; ++i )
+    {
+        impl::slot& s = _segment->slots[i];
+        std::uint32_t free = 0;
+        if( s.pid.compare_exchange_strong( free, self ) || _segment->reap( s, self ) ) { _slot = &s; }
+    }
+    COMMA_ASSERT_BRIEF( _slot, "shared memory queue '" << _segment->name << "' has no free producer slots (maximum " << h->producers << " producers)" );
+    ++h->attached;
+}
+
+producer::~producer()
+{
+    try { close(); }
+    catch( ... ) {}
+}
+
+void producer::close()
+{
+    if( !_slot ) { return; }
+    _segment->fold( *_slot );
+    _slot->pid.store( 0 );
+    _slot = nullptr;
+    _segment.reset();
+}
+
+std::size_t producer::max_size() const { return _segment ? _segment->header->capacity / 2 - sizeof( impl::message ) : 0; }
+
+std::size_t producer::record_size() const { return _segment ? _segment->header->record_size : 0; }
+
+bool producer::connected() const { return _segment && impl::alive( _segment->header->consumer.load() ); }
+
+bool producer::push( const char* buf, std::size_t size )
+{
+    COMMA_ASSERT_BRIEF( _slot, "shm queue: pushing to closed producer" );
+    COMMA_ASSERT_BRIEF( size <= max_size(), "shm queue: expected message size not greater than " << max_size() << " bytes; got: " << size );
+    impl::header* h = _segment->header;
+    COMMA_ASSERT_BRIEF( h->consumer.load() != 0, "shared memory queue '" << _segment->name << "' is closed" );
+    const std::uint64_t capacity = h->capacity;
+    const std::size_t f = impl::footprint( size );
+    bool turn = false; // whether holding turn in fair mode
+    bool waited = false;
+    auto release_turn = [&]()
+    {
+        if( !turn ) { return; }
+        _slot->queued.store( 0 );
+        h->serving.fetch_add( 1 );
+        if( h->serving_waiters.load() > 0 ) { comma::futex::wake( h->serving ); }
+        turn = false;
+    };
+    std::uint64_t tail, padding;
+    try
+    {
+        while( true )
+        {
+            tail = h->tail.load( std::memory_order_acquire );
+            std::uint64_t offset = tail % capacity;
+            padding = offset + f > capacity ? capacity - offset : 0;
+            std::uint64_t head = h->head.load( std::memory_order_acquire );
+            bool full = tail + padding + f - head > capacity;
+            if( full && !_blocking ) { _slot->dropped.store( _slot->dropped.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed ); release_turn(); return false; }
+            if( h->fair && _blocking && !turn && ( full || h->ticket.load() != h->serving.load() ) ) { turn = _wait_for_turn(); continue; }
+            if( full ) { waited = true; _wait_for_space( head ); continue; }
+            _slot->end.store( tail + padding + f, std::memory_order_relaxed );
+            _slot->begin.store( tail, std::memory_order_release );
+            if( h->tail.compare_exchange_weak( tail, tail + padding + f ) ) { break; }
+        }
+    }
+    catch( ... )
+    {
+        release_turn();
+        _slot->begin.store( _slot->end.load() );
+        throw;
+    }
+    release_turn();
+    if( padding > 0 ) { _segment->at( tail )->state.store( impl::skip, std::memory_order_release ); }
+    impl::message* m = _segment->at( tail + padding );
+    std::memcpy( reinterpret_cast< char* >( m + 1 ), buf, size );
+    m->size = size;
+    m->state.store( impl::full, std::memory_order_release );
+    _slot->begin.store( _slot->end.load( std::memory_order_relaxed ), std::memory_order_release );
+    _slot->messages.store( _slot->messages.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+    _slot->bytes.store( _slot->bytes.load( std::memory_order_relaxed ) + size, std::memory_order_relaxed );
+    if( waited ) { _slot->waits.store( _slot->waits.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed ); }
+    std::atomic_thread_fence( std::memory_order_seq_cst ); // make message visible before checking for waiting consumer
+    if( h->data_waiters.load() > 0 ) { h->data_sequence.fetch_add( 1 ); comma::futex::wake( h->data_sequence ); }
+    return true;
+}
+
+bool producer::_wait_for_turn()
+{
+    impl::header* h = _segment->header;
+    std::uint32_t ticket = h->ticket.fetch_add( 1 );
+    _slot->ticket.store( ticket );
+    _slot->queued.store( 1 );
+    unsigned int orphaned = 0;
+    while( true )
+    {
+        std::uint32_t serving = h->serving.load();
+        if( serving == ticket ) { return true; }
+        h->serving_waiters.fetch_add( 1 );
+        comma::futex::wait( h->serving, serving, 100000 );
+        h->serving_waiters.fetch_sub( 1 );
+        if( h->serving.load() != serving ) { orphaned = 0; continue; }
+        if( !impl::alive( h->consumer.load() ) ) { _slot->queued.store( 0 ); COMMA_THROW_BRIEF( comma::exception, "shared memory queue '" << _segment->name << "' is closed" ); }
+        bool held = false; // ticket being served may belong to a producer that died or has not registered it yet
+        for( unsigned int i = 0; i < h->producers && !held; ++i )
+        {
+            const impl::slot& s = _segment->slots[i];
+            std::uint32_t pid = s.pid.load();
+            held = pid != 0 && s.queued.load() && s.ticket.load() == serving && impl::alive( pid );
+        }
+        if( held ) { orphaned = 0; continue; }
+        if( ++orphaned < 2 ) { continue; } // give a producer that has just taken its ticket time to register it
+        if( h->serving.compare_exchange_strong( serving, serving + 1 ) ) { comma::futex::wake( h->serving ); }
+        orphaned = 0;
+    }
+}
+
+void producer::_wait_for_space( std::uint64_t head )
+{
+    impl::header* h = _segment->header;
+    for( unsigned int i = 0; i < shm::impl::spin; ++i ) { if( h->head.load( std::memory_order_relaxed ) != head ) { return; } shm::impl::relax(); }
+    h->space_waiters.fetch_add( 1 );
+    std::atomic_thread_fence( std::memory_order_seq_cst ); // pairs with fence in consumer::_release()
+    std::uint32_t sequence = h->space_sequence.load();
+    if( h->head.load() == head ) { comma::futex::wait( h->space_sequence, sequence, 100000 ); }
+    h->space_waiters.fetch_sub( 1 );
+    if( !impl::alive( h->consumer.load() ) ) { COMMA_THROW_BRIEF( comma::exception, "shared memory queue '" << _segment->name << "' is closed" ); }
+}
+
+statistics stats( const std::string& name )
+{
+    impl::segment segment( object_name( name ) );
+    COMMA_ASSERT_BRIEF( segment.open( false ), "shared memory queue '" << segment.name << "' not found" );
+    return segment.stats();
+}
+
+} } } } // namespace comma { namespace io { namespace shm { namespace queue {
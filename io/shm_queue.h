@@ -0,0 +1,131 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace comma { namespace io { namespace shm { namespace queue {
+
+/// multiple-producer single-consumer message queue in posix shared memory
+///
+/// the consumer creates a shared memory object (e.g. /dev/shm/buffer for "/buffer"); producers
+/// attach to it and push messages, each message is delivered whole and messages from different
+/// producers never interleave; if a producer pushes only whole records or lines in a message,
+/// the consumer output consists of whole records or lines
+///
+/// producers reserve space with an atomic compare-and-swap on the queue tail and copy their
+/// messages concurrently; the consumer takes messages in order of reservation directly from
+/// shared memory and zeroes consumed space; waiting producers and consumer sleep on futexes
+///
+/// if the queue is full, producers wait (backpressure) or drop their message (non-blocking);
+/// in fair mode, producers that have to wait are served in the order they came to wait, so
+/// that a producer of large messages is not starved by producers of small ones
+struct options
+{
+    std::size_t capacity{16777216}; /// queue size in bytes
+    std::size_t record_size{0}; /// record size for information, 0: ascii lines
+    unsigned int producers{64}; /// maximum number of producers attached at the same time
+    bool fair{false}; /// if true, producers waiting for space are served first-come first-served
+};
+
+struct statistics
+{
+    unsigned int producers{0}; /// number of currently attached producers
+    std::uint64_t attached{0}; /// total number of producers that have attached
+    std::uint64_t detached{0}; /// total number of producers that have detached or died
+    std::uint64_t depth{0}; /// current queue depth in bytes, including message headers
+    std::uint64_t max_depth{0}; /// maximum queue depth in bytes seen by consumer
+    std::uint64_t messages{0}; /// number of messages pushed
+    std::uint64_t bytes{0}; /// number of payload bytes pushed
+    std::uint64_t waits{0}; /// number of times producers had to wait for space
+    std::uint64_t dropped{0}; /// number of messages dropped by non-blocking producers, since queue was full
+    std::uint64_t lost{0}; /// number of messages lost, since their producers died while writing them
+};
+
+/// return shared memory object name, e.g. "buffer" -> "/buffer"
+std::string object_name( const std::string& name );
+
+namespace impl { struct segment; struct slot; }
+
+class consumer : public boost::noncopyable
+{
+    public:
+        /// create queue; throw, if queue with this name has a live consumer
+        consumer( const std::string& name, const queue::options& options = queue::options() );
+
+        ~consumer();
+
+        /// wait for the next message for no longer than timeout
+        /// @return message data and size, valid until pop(); { nullptr, 0 } on timeout
+        std::pair< const char*, std::size_t > front( boost::posix_time::time_duration timeout = boost::posix_time::pos_infin );
+
+        /// release message returned by front()
+        void pop();
+
+        /// return true, if queue is empty
+        bool empty() const;
+
+        /// mark queue closed, unlink shared memory object; producers get an exception on push
+        void close();
+
+        statistics stats() const;
+
+        const queue::options& options() const { return _options; }
+
+    private:
+        queue::options _options;
+        std::unique_ptr< impl::segment > _segment;
+        std::uint64_t _head{0};
+        std::uint64_t _front{0}; // end of the message returned by front(), 0 if none
+        boost::posix_time::ptime _stalled; // time since when a reserved message is not written
+
+        void _release( std::uint64_t end );
+        bool _recover();
+        void _reap();
+};
+
+class producer : public boost::noncopyable
+{
+    public:
+        /// attach to queue; throw, if no queue or no free producer slots
+        /// @param blocking if true, wait, while queue is full, otherwise drop messages
+        producer( const std::string& name, bool blocking = true );
+
+        ~producer();
+
+        /// push message; throw, if message is larger than max_size() or consumer has gone
+        /// @return false, if non-blocking and queue is full, i.e. message dropped
+        bool push( const char* buf, std::size_t size );
+
+        /// return maximum message size
+        std::size_t max_size() const;
+
+        /// return record size set by consumer
+        std::size_t record_size() const;
+
+        /// return true, if consumer is alive
+        bool connected() const;
+
+        /// detach from queue
+        void close();
+
+    private:
+        bool _blocking;
+        std::unique_ptr< impl::segment > _segment;
+        impl::slot* _slot{nullptr};
+
+        bool _wait_for_turn();
+        void _wait_for_space( std::uint64_t head );
+};
+
+/// return statistics of an existing queue; throw, if no queue
+statistics stats( const std::string& name );
+
+} } } } // namespace comma { namespace io { namespace shm { namespace queue {
@@ -23,12 +23,16 @@
 #include <boost/bind/bind.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/iostreams/stream.hpp>
 #include "../base/exception.h"
 #include "../string/string.h"
 #include "impl/filesystem.h"
+#include "compressed.h"
 #include "file_descriptor.h"
 #include "select.h"
+#include "shm.h"
 #include "stream.h"
+#include "udp.h"
 
 #ifdef USE_ZEROMQ
 #include "zeromq/stream.h"
@@ -141,6 +145,88 @@ template <> struct traits < std::iostream >
     #endif
 };
 
+template < typename S > struct compressed_traits
+{
+    static S* make( const std::string& name, const compressed::options&, io::file_descriptor&, boost::function< void() >& ) { COMMA_THROW( comma::exception, "compressed bidirectional streams not supported; got: '" << name << "'" ); }
+};
+
+template <> struct compressed_traits< std::istream >
+{
+    static std::istream* make( const std::string& name, const compressed::options&, io::file_descriptor& fd, boost::function< void() >& close )
+    {
+        auto s = std::make_shared< io::istream >( name, mode::binary, mode::blocking ); // frames are read and written whole
+        COMMA_ASSERT_BRIEF( ( *s )(), "failed to open '" << name << "'" );
+        fd = s->fd();
+        close = [s]() { s->close(); };
+        return new compressed::istream( ( *s )(), s );
+    }
+};
+
+template <> struct compressed_traits< std::ostream >
+{
+    static std::ostream* make( const std::string& name, const compressed::options& options, io::file_descriptor& fd, boost::function< void() >& close )
+    {
+        auto s = std::make_shared< io::ostream >( name, mode::binary, mode::blocking ); // frames are read and written whole
+        COMMA_ASSERT_BRIEF( ( *s )(), "failed to open '" << name << "'" );
+        fd = s->fd();
+        compressed::ostream* c = new compressed::ostream( ( *s )(), options, s );
+        close = [c, s]() { c->close(); s->close(); }; // write the last frame before closing underlying stream
+        return c;
+    }
+};
+
+template < typename S > struct shm_traits
+{
+    static S* make( const std::string& name, mode::value, io::file_descriptor&, boost::function< void() >& ) { COMMA_THROW( comma::exception, "shared memory bidirectional streams not supported; got: '" << name << "'" ); }
+};
+
+template <> struct shm_traits< std::istream >
+{
+    static std::istream* make( const std::string& name, mode::value, io::file_descriptor& fd, boost::function< void() >& close )
+    {
+        std::string stripped = name;
+        shm::options::strip( stripped ); // options are taken from the ring
+        auto r = std::make_shared< shm::reader >( stripped );
+        fd = r->fd();
+        close = [r]() { r->close(); };
+        std::streamsize buffer_size = r->record_size() > 0 ? std::max< std::streamsize >( 65536 / r->record_size(), 1 ) * r->record_size() : 65536; // read whole records
+        return new boost::iostreams::stream< shm::source >( shm::source( r ), buffer_size );
+    }
+};
+
+template <> struct shm_traits< std::ostream >
+{
+    static std::ostream* make( const std::string& name, mode::value m, io::file_descriptor& fd, boost::function< void() >& close )
+    {
+        std::string stripped = name;
+        shm::options options = shm::options::strip( stripped, m == mode::binary ? 1 : 0 );
+        auto w = std::make_shared< shm::writer >( stripped, options );
+        fd = w->fd();
+        auto s = new boost::iostreams::stream< shm::sink >( shm::sink( w ) );
+        close = [s]() { s->close(); };
+        return s;
+    }
+};
+
+template < typename S > struct udp_traits
+{
+    static S* make( const std::string& name, mode::value, io::file_descriptor&, boost::function< void() >& ) { COMMA_THROW( comma::exception, "udp multicast and broadcast streams are write-only; use io-cat to receive; got: '" << name << "'" ); }
+};
+
+template <> struct udp_traits< std::ostream >
+{
+    static std::ostream* make( const std::string& name, mode::value m, io::file_descriptor& fd, boost::function< void() >& close )
+    {
+        std::string stripped = name;
+        udp::options options = udp::options::strip( stripped, m == mode::binary ? 1 : 0 );
+        auto w = std::make_shared< udp::writer >( stripped, options );
+        fd = w->fd();
+        auto s = new boost::iostreams::stream< udp::sink >( udp::sink( w ) );
+        close = [s]() { s->close(); };
+        return s;
+    }
+};
+
 template < typename S > void close_file_stream( typename traits< S >::file_stream* s, int fd )
 {
     if( s ) { s->close(); }
@@ -238,7 +324,12 @@ template < typename S > stream< S >::stream( const std::string& name, mode::valu
     , close_d( false )
     , blocking_( blocking )
 {
+    std::string stripped = name;
+    boost::optional< compressed::options > compression = compressed::options::strip( stripped );
+    if( compression ) { stream_ = impl::compressed_traits< S >::make( stripped, *compression, fd_, close_ ); return; }
     std::vector< std::string > v = comma::split( name, ':' );
+    if( v[0] == "shm" ) { stream_ = impl::shm_traits< S >::make( name, m, fd_, close_ ); return; }
+    if( v[0] == "udp-multicast" || v[0] == "udp-broadcast" ) { stream_ = impl::udp_traits< S >::make( name, m, fd_, close_ ); return; }
     if( v[0] == "tcp" )
     {
         if( v.size() != 3 ) { COMMA_THROW( comma::exception, "expected tcp:<address>:<port>, got \"" << name << "\"" ); }
@@ -313,14 +404,18 @@ template < typename S > stream< S >::stream( const std::string& name, mode::valu
     }
 #endif
 #ifdef USE_ZEROMQ
-    else if( v[0] == "zero-local" || v[0] == "zmq-local" )
+    else if( v[0] == "zero-local" || v[0] == "zmq-local" || v[0] == "zero-inproc" || v[0] == "zmq-inproc" )
     {
-        stream_ = zeromq::make_stream< S >( "ipc://" + v[1], fd_ );
+        zeromq::options options = zeromq::options::strip( stripped );
+        v = comma::split( stripped, ':' );
+        stream_ = zeromq::make_stream< S >( ( v[0] == "zero-local" || v[0] == "zmq-local" ? "ipc://" : "inproc://" ) + v[1], options, fd_ );
     }
     else if( v[0] == "zero-tcp" || v[0] == "zmq-tcp" )
     {
+        zeromq::options options = zeromq::options::strip( stripped );
+        v = comma::split( stripped, ':' );
         if( v.size() != 3 ) { COMMA_THROW( comma::exception, "expected zero-tcp:<address>:<port>, got \"" << name << "\"" ); }
-        stream_ = zeromq::make_stream< S >( "tcp://" + v[1] + ":" + v[2], fd_ );
+        stream_ = zeromq::make_stream< S >( "tcp://" + v[1] + ":" + v[2], options, fd_ );
     }
 #endif
     else if( name == "-" )
@@ -385,6 +480,15 @@ static std::string usage( const std::string& what, const std::string& dash, unsi
         oss << i << "    <path>               : path to input file or named pipe" << std::endl;
         oss << i << "    local:<path>         : local linux socket" << std::endl;
         oss << i << "    tcp:<address>:<port> : tcp socket" << std::endl;
+        oss << compressed::options::usage( indent + 4 );
+        oss << shm::options::usage( indent + 4 );
+        oss << udp::options::usage( indent + 4 );
+#ifdef USE_ZEROMQ
+        oss << i << "    zmq-local:<path>         : zeromq ipc socket" << std::endl;
+        oss << i << "    zmq-inproc:<name>        : zeromq in-process socket" << std::endl;
+        oss << i << "    zmq-tcp:<address>:<port> : zeromq tcp socket" << std::endl;
+        oss << zeromq::options::usage( indent + 4 );
+#endif
     }
     else
     {
@@ -0,0 +1,171 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../base/exception.h"
+#include "../compressed.h"
+#include "../impl/filesystem.h"
+#include "../stream.h"
+
+namespace comma { namespace io { namespace compressed_test {
+
+static std::vector< char > records( std::size_t count, std::size_t size ) // slowly changing fields to resemble typical sensor data
+{
+    std::vector< char > v( count * size );
+    for( std::size_t i = 0; i < count; ++i ) { for( std::size_t j = 0; j < size; ++j ) { v[ i * size + j ] = char( j < size / 2 ? j : ( i / ( j + 1 ) ) ); } }
+    return v;
+}
+
+static void round_trip( const std::vector< char >& v )
+{
+    std::vector< char > c( compressed::max_size( v.size() ) );
+    std::size_t size = compressed::compress( &v[0], v.size(), &c[0] );
+    EXPECT_LE( size, c.size() );
+    std::vector< char > d( v.size() );
+    compressed::decompress( &c[0], size, &d[0], d.size() );
+    EXPECT_EQ( v, d );
+}
+
+TEST( compressed, codec )
+{
+    std::vector< char > v = records( 1000, 24 );
+    round_trip( v );
+    std::vector< char > c( compressed::max_size( v.size() ) );
+    EXPECT_LT( compressed::compress( &v[0], v.size(), &c[0] ), v.size() / 4 );
+    std::srand( 0 );
+    std::vector< char > r( 10000 );
+    for( auto& b: r ) { b = char( std::rand() ); }
+    round_trip( r );
+    round_trip( std::vector< char >( 1, 'a' ) );
+    round_trip( std::vector< char >( 100000, 'a' ) );
+    std::vector< char > d( v.size() );
+    EXPECT_THROW( compressed::decompress( &c[0], 10, &d[0], d.size() ), comma::exception );
+}
+
+TEST( compressed, filter )
+{
+    std::vector< char > v = records( 100, 16 );
+    std::vector< char > e = v;
+    compressed::encode( compressed::filters::xor_previous, &e[0], e.size(), 16 );
+    EXPECT_EQ( std::vector< char >( v.begin(), v.begin() + 16 ), std::vector< char >( e.begin(), e.begin() + 16 ) );
+    EXPECT_NE( v, e );
+    compressed::decode( compressed::filters::xor_previous, &e[0], e.size(), 16 );
+    EXPECT_EQ( v, e );
+}
+
+TEST( compressed, options )
+{
+    std::string name = "points.bin;compressed;size=32;filter=xor;block-size=1024";
+    boost::optional< compressed::options > options = compressed::options::strip( name );
+    ASSERT_TRUE( bool( options ) );
+    EXPECT_EQ( "points.bin", name );
+    EXPECT_EQ( 32, options->record_size );
+    EXPECT_EQ( 1024, options->block_size );
+    EXPECT_EQ( compressed::filters::xor_previous, options->filter );
+    name = "tcp:localhost:1234";
+    EXPECT_FALSE( bool( compressed::options::strip( name ) ) );
+    EXPECT_EQ( "tcp:localhost:1234", name );
+}
+
+TEST( compressed, stream )
+{
+    const std::vector< char > v = records( 1000, 20 );
+    std::stringstream ss;
+    {
+        compressed::ostream os( &ss, compressed::options( 1000, 20, compressed::filters::xor_previous ) );
+        os.write( &v[0], 30 ); // incomplete record stays buffered on flush
+        os.flush();
+        os.write( &v[0] + 30, v.size() - 30 );
+    }
+    EXPECT_LT( ss.str().size(), v.size() / 2 );
+    compressed::istream is( &ss );
+    std::vector< char > d( v.size() );
+    is.read( &d[0], d.size() );
+    EXPECT_EQ( std::streamsize( v.size() ), is.gcount() );
+    EXPECT_EQ( v, d );
+    is.get();
+    EXPECT_TRUE( is.eof() );
+}
+
+TEST( compressed, available )
+{
+    const std::vector< char > v = records( 100, 20 );
+    std::stringstream ss;
+    {
+        compressed::ostream os( &ss, compressed::options( 1000, 20 ) );
+        os.write( &v[0], v.size() );
+    }
+    std::istringstream iss( ss.str() );
+    compressed::istream is( &iss );
+    EXPECT_EQ( 0u, is.buffered() );
+    EXPECT_EQ( ss.str().size(), is.compressed_available() );
+    char c[10];
+    is.read( c, 10 );
+    EXPECT_EQ( 990u, is.buffered() ); // rest of decompressed frame of 50 records
+    EXPECT_LT( 0u, is.compressed_available() ); // second frame, still compressed
+    EXPECT_GT( 1000u, is.compressed_available() );
+}
+
+TEST( compressed, header )
+{
+    const std::vector< char > v = records( 10, 20 );
+    std::stringstream ss;
+    {
+        compressed::ostream os( &ss, compressed::options( 1000, 20, compressed::filters::xor_previous ) );
+        os.write( &v[0], v.size() );
+    }
+    const std::string s = ss.str();
+    ASSERT_LE( 20u, s.size() );
+    EXPECT_EQ( "cmz1", s.substr( 0, 4 ) );
+    EXPECT_EQ( std::string( "\xc8\0\0\0", 4 ), s.substr( 4, 4 ) ); // little endian whatever the host byte order
+    EXPECT_EQ( std::string( "\x14\0\0\0", 4 ), s.substr( 12, 4 ) );
+    EXPECT_EQ( 1, s[17] );
+}
+
+TEST( compressed, seek )
+{
+    const std::vector< char > v = records( 1000, 20 );
+    std::stringstream ss;
+    {
+        compressed::ostream os( &ss, compressed::options( 1000, 20 ) );
+        os.write( &v[0], v.size() );
+    }
+    compressed::istream is( &ss );
+    std::vector< char > d( 20 );
+    is.seekg( 12340 );
+    is.read( &d[0], 20 );
+    EXPECT_EQ( std::vector< char >( v.begin() + 12340, v.begin() + 12360 ), d );
+    EXPECT_EQ( 12360, is.tellg() );
+    is.seekg( 100 );
+    is.read( &d[0], 20 );
+    EXPECT_EQ( std::vector< char >( v.begin() + 100, v.begin() + 120 ), d );
+    is.seekg( 5000, std::ios::cur );
+    is.read( &d[0], 20 );
+    EXPECT_EQ( std::vector< char >( v.begin() + 5120, v.begin() + 5140 ), d );
+}
+
+TEST( compressed, io_stream )
+{
+    const std::vector< char > v = records( 500, 8 );
+    comma::filesystem::remove( "./test.compressed.bin" );
+    {
+        comma::io::ostream os( "./test.compressed.bin;compressed;size=8", comma::io::mode::binary );
+        os->write( &v[0], v.size() );
+        os.close();
+    }
+    EXPECT_LT( comma::filesystem::file_size( "./test.compressed.bin" ), v.size() );
+    {
+        comma::io::istream is( "./test.compressed.bin;compressed", comma::io::mode::binary );
+        std::vector< char > d( v.size() );
+        is->read( &d[0], d.size() );
+        EXPECT_EQ( v, d );
+    }
+    comma::filesystem::remove( "./test.compressed.bin" );
+}
+
+} } } // namespace comma { namespace io { namespace compressed_test {
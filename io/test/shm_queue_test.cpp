@@ -0,0 +1,138 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <unistd.h>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../base/exception.h"
+#include "../shm_queue.h"
+
+namespace comma { namespace io { namespace shm_queue_test {
+
+namespace queue = comma::io::shm::queue;
+
+static std::string name( const std::string& n ) { return "/comma-shm-queue-test-" + n + "-" + std::to_string( ::getpid() ); }
+
+static std::string pop( queue::consumer& consumer )
+{
+    auto m = consumer.front( boost::posix_time::milliseconds( 100 ) );
+    if( !m.first ) { return std::string(); }
+    std::string s( m.first, m.second );
+    consumer.pop();
+    return s;
+}
+
+TEST( shm_queue, basics )
+{
+    queue::options options;
+    options.capacity = 256;
+    queue::consumer consumer( name( "basics" ), options );
+    EXPECT_THROW( queue::consumer( name( "basics" ), options ), comma::exception );
+    EXPECT_TRUE( consumer.empty() );
+    EXPECT_EQ( nullptr, consumer.front( boost::posix_time::milliseconds( 1 ) ).first );
+    queue::producer producer( name( "basics" ) );
+    EXPECT_EQ( 112u, producer.max_size() );
+    EXPECT_THROW( producer.push( std::string( 113, 'x' ).c_str(), 113 ), comma::exception );
+    EXPECT_TRUE( producer.push( "hello\n", 6 ) );
+    EXPECT_TRUE( producer.push( "world\n", 6 ) );
+    EXPECT_FALSE( consumer.empty() );
+    EXPECT_EQ( 2u, consumer.stats().messages );
+    EXPECT_EQ( 64u, consumer.stats().depth );
+    EXPECT_EQ( "hello\n", pop( consumer ) );
+    EXPECT_EQ( "world\n", pop( consumer ) );
+    EXPECT_TRUE( consumer.empty() );
+    for( unsigned int i = 0; i < 100; ++i ) // wrap around with messages of different sizes
+    {
+        std::string s( 1 + i % 50, char( 'a' + i % 26 ) );
+        ASSERT_TRUE( producer.push( &s[0], s.size() ) );
+        ASSERT_EQ( s, pop( consumer ) );
+    }
+    queue::statistics s = consumer.stats();
+    EXPECT_EQ( 1u, s.producers );
+    EXPECT_EQ( 102u, s.messages );
+    EXPECT_EQ( 0u, s.depth );
+    producer.close();
+    s = queue::stats( name( "basics" ) );
+    EXPECT_EQ( 0u, s.producers );
+    EXPECT_EQ( 1u, s.attached );
+    EXPECT_EQ( 1u, s.detached );
+    EXPECT_EQ( 102u, s.messages );
+    consumer.close();
+    EXPECT_THROW( queue::producer( name( "basics" ) ), comma::exception );
+}
+
+TEST( shm_queue, drop )
+{
+    queue::options options;
+    options.capacity = 128;
+    queue::consumer consumer( name( "drop" ), options );
+    queue::producer producer( name( "drop" ), false );
+    std::string s( 40, 'x' );
+    EXPECT_TRUE( producer.push( &s[0], s.size() ) );
+    EXPECT_TRUE( producer.push( &s[0], s.size() ) );
+    EXPECT_FALSE( producer.push( &s[0], s.size() ) );
+    EXPECT_EQ( 1u, consumer.stats().dropped );
+    EXPECT_EQ( s, pop( consumer ) );
+    EXPECT_TRUE( producer.push( &s[0], s.size() ) );
+}
+
+static void run( bool fair )
+{
+    queue::options options;
+    options.capacity = 1024;
+    options.fair = fair;
+    queue::consumer consumer( name( fair ? "fair" : "producers" ), options );
+    const unsigned int producers = 4;
+    const unsigned int messages = 2000;
+    std::vector< std::thread > threads;
+    for( unsigned int i = 0; i < producers; ++i )
+    {
+        threads.emplace_back( [&,i]()
+        {
+            queue::producer producer( name( fair ? "fair" : "producers" ) );
+            for( unsigned int j = 0; j < messages; ++j )
+            {
+                std::string s = std::to_string( i ) + "," + std::to_string( j ) + std::string( ( i * 7 + j ) % 100, '.' ) + "\n";
+                producer.push( &s[0], s.size() );
+            }
+        } );
+    }
+    std::vector< std::string > received;
+    for( unsigned int count = 0; count < producers * messages; ++count )
+    {
+        auto m = consumer.front();
+        received.emplace_back( m.first, m.second );
+        consumer.pop();
+    }
+    for( auto& t: threads ) { t.join(); } // join before asserting, since failed assertion returns
+    std::map< unsigned int, unsigned int > next;
+    for( const auto& s: received )
+    {
+        ASSERT_FALSE( s.empty() );
+        ASSERT_EQ( '\n', s.back() );
+        unsigned int i = std::stoul( s );
+        unsigned int j = std::stoul( s.substr( s.find( ',' ) + 1 ) );
+        ASSERT_EQ( next[i], j ); // messages of each producer come whole and in order
+        ASSERT_EQ( ( i * 7 + j ) % 100 + 2 + std::to_string( i ).size() + std::to_string( j ).size(), s.size() );
+        ++next[i];
+    }
+    queue::statistics s = consumer.stats();
+    EXPECT_EQ( producers * messages, s.messages );
+    EXPECT_EQ( producers, s.attached );
+    EXPECT_EQ( producers, s.detached );
+    EXPECT_EQ( 0u, s.lost );
+    EXPECT_EQ( 0u, s.dropped );
+    EXPECT_LE( s.max_depth, 1024u );
+    EXPECT_TRUE( consumer.empty() );
+}
+
+TEST( shm_queue, producers ) { run( false ); }
+
+TEST( shm_queue, fair ) { run( true ); }
+
+} } } // namespace comma { namespace io { namespace shm_queue_test {
@@ -0,0 +1,181 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../base/exception.h"
+#include "../shm.h"
+#include "../stream.h"
+
+namespace comma { namespace io { namespace shm_test {
+
+static std::string name( const std::string& n ) { return "shm:/comma-shm-test-" + n + "-" + std::to_string( ::getpid() ); }
+
+static std::vector< char > records( std::size_t begin, std::size_t end, std::size_t size ) // record i is filled with i
+{
+    std::vector< char > v;
+    for( std::size_t i = begin; i < end; ++i ) { v.insert( v.end(), size, char( i ) ); }
+    return v;
+}
+
+TEST( shm, basics )
+{
+    shm::options options;
+    options.capacity = 1000;
+    options.record_size = 10;
+    shm::writer writer( name( "basics" ), options );
+    EXPECT_THROW( shm::writer( name( "basics" ), options ), comma::exception );
+    shm::reader reader( name( "basics" ) );
+    EXPECT_EQ( 1u, writer.readers() );
+    EXPECT_EQ( 10u, reader.record_size() );
+    EXPECT_EQ( 0u, reader.available() );
+    char buf[1000];
+    EXPECT_EQ( 0u, reader.read( buf, 1000, false ) );
+    std::vector< char > v = records( 0, 5, 10 );
+    writer.write( &v[0], 25 ); // only whole records are published
+    EXPECT_EQ( 20u, reader.available() );
+    writer.write( &v[25], 25 );
+    EXPECT_EQ( 50u, reader.available() );
+    EXPECT_EQ( 30u, reader.read( buf, 35 ) ); // whole records
+    EXPECT_EQ( 0, std::memcmp( buf, &v[0], 30 ) );
+    EXPECT_EQ( 20u, reader.read( buf, 1000 ) );
+    EXPECT_EQ( 0, std::memcmp( buf, &v[30], 20 ) );
+    for( unsigned int i = 0; i < 100; ++i ) // wrap around
+    {
+        std::vector< char > w = records( i * 7, i * 7 + 7, 10 );
+        writer.write( &w[0], w.size() );
+        ASSERT_EQ( 70u, reader.read( buf, 1000 ) );
+        ASSERT_EQ( 0, std::memcmp( buf, &w[0], 70 ) );
+    }
+    EXPECT_EQ( 0u, reader.lost() );
+    EXPECT_FALSE( reader.eof() );
+    writer.close();
+    EXPECT_TRUE( reader.eof() );
+    EXPECT_EQ( 0u, reader.read( buf, 1000 ) );
+    EXPECT_THROW( shm::reader( name( "basics" ) ), comma::exception );
+}
+
+TEST( shm, lines )
+{
+    shm::writer writer( name( "lines" ), shm::options() );
+    shm::reader reader( name( "lines" ) );
+    std::string s = "hello,1\nworld,2\npar";
+    writer.write( &s[0], s.size() );
+    char buf[100];
+    EXPECT_EQ( 16u, reader.available() );
+    EXPECT_EQ( 8u, reader.read( buf, 10 ) ); // ends on line boundary
+    EXPECT_EQ( "hello,1\n", std::string( buf, 8 ) );
+    EXPECT_EQ( 8u, reader.read( buf, 100 ) );
+    EXPECT_EQ( "world,2\n", std::string( buf, 8 ) );
+    writer.write( "tial\n", 5 );
+    EXPECT_EQ( 8u, reader.read( buf, 100 ) );
+    EXPECT_EQ( "partial\n", std::string( buf, 8 ) );
+}
+
+TEST( shm, overwrite )
+{
+    shm::options options;
+    options.capacity = 100;
+    options.record_size = 4;
+    shm::writer writer( name( "overwrite" ), options );
+    shm::reader reader( name( "overwrite" ) );
+    std::vector< char > v = records( 0, 100, 4 );
+    writer.write( &v[0], v.size() );
+    char buf[100];
+    std::size_t size = reader.read( buf, 100 );
+    ASSERT_GT( size, 0u );
+    EXPECT_EQ( 0u, size % 4 );
+    EXPECT_GT( reader.lost(), 0u );
+    EXPECT_EQ( 400u, reader.lost() + size );
+    EXPECT_EQ( 0, std::memcmp( buf, &v[ 400 - size ], size ) ); // got the latest whole records
+}
+
+TEST( shm, block )
+{
+    shm::options options;
+    options.capacity = 64;
+    options.record_size = 8;
+    options.block = true;
+    shm::writer writer( name( "block" ), options );
+    shm::reader reader( name( "block" ) );
+    std::vector< char > v = records( 0, 1000, 8 );
+    std::thread t( [&]() { for( std::size_t i = 0; i < v.size(); i += 24 ) { writer.write( &v[i], std::min< std::size_t >( 24, v.size() - i ) ); } writer.close(); } );
+    std::vector< char > received;
+    char buf[40];
+    while( true )
+    {
+        std::size_t size = reader.read( buf, 40 );
+        if( size == 0 ) { break; }
+        received.insert( received.end(), buf, buf + size );
+    }
+    t.join();
+    EXPECT_EQ( v, received );
+    EXPECT_EQ( 0u, reader.lost() );
+}
+
+TEST( shm, exists )
+{
+    std::string n = shm::object_name( name( "exists" ) );
+    int fd = ::shm_open( &n[0], O_RDWR | O_CREAT | O_EXCL, 0666 ); // e.g. left by writer that exited without closing
+    ASSERT_LE( 0, fd );
+    ::close( fd );
+    EXPECT_THROW( shm::writer( name( "exists" ) ), comma::exception );
+    struct stat s;
+    EXPECT_EQ( 0, ::stat( ( "/dev/shm" + n ).c_str(), &s ) ); // not removed by failed writer
+    ::shm_unlink( &n[0] );
+    EXPECT_NO_THROW( shm::writer( name( "exists" ) ) );
+}
+
+TEST( shm, fd )
+{
+    shm::options options;
+    options.record_size = 4;
+    shm::writer writer( name( "fd" ), options );
+    shm::reader reader( name( "fd" ) );
+    auto ready = [&]( int timeout ) { pollfd p = { reader.fd(), POLLIN, 0 }; return ::poll( &p, 1, timeout ) > 0; };
+    EXPECT_FALSE( ready( 50 ) );
+    std::vector< char > v = records( 0, 3, 4 );
+    writer.write( &v[0], v.size() );
+    EXPECT_TRUE( ready( 2000 ) );
+    char buf[100];
+    EXPECT_EQ( 4u, reader.read( buf, 4 ) );
+    EXPECT_TRUE( ready( 2000 ) ); // still data available
+    EXPECT_EQ( 8u, reader.read( buf, 100 ) );
+    EXPECT_FALSE( ready( 50 ) );
+    writer.write( &v[0], 4 );
+    EXPECT_TRUE( ready( 2000 ) );
+    EXPECT_EQ( 4u, reader.read( buf, 100 ) );
+    EXPECT_FALSE( ready( 50 ) );
+    writer.close();
+    EXPECT_TRUE( ready( 2000 ) ); // end of stream
+    EXPECT_EQ( 0u, reader.read( buf, 100 ) );
+    EXPECT_TRUE( reader.eof() );
+}
+
+TEST( shm, stream )
+{
+    std::string n = name( "stream" );
+    io::ostream os( n + ";size=8;capacity=4096", io::mode::binary );
+    io::istream is( n, io::mode::binary );
+    std::vector< char > v = records( 0, 100, 8 );
+    os->write( &v[0], v.size() );
+    os->flush();
+    std::vector< char > r( v.size() );
+    is->read( &r[0], r.size() );
+    EXPECT_EQ( int( r.size() ), is->gcount() );
+    EXPECT_EQ( v, r );
+    os.close();
+    is->read( &r[0], 1 );
+    EXPECT_TRUE( is->eof() );
+}
+
+} } } // namespace comma { namespace io { namespace shm_test {
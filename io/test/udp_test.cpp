@@ -0,0 +1,159 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <string>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <gtest/gtest.h>
+#include "../../base/exception.h"
+#include "../udp.h"
+
+namespace comma { namespace io { namespace udp_test {
+
+static std::vector< std::string > receive( udp::receiver& receiver, std::size_t expected )
+{
+    std::vector< std::string > packets;
+    while( packets.size() < expected && receiver.receive( false ) > 0 ) { for( unsigned int i = 0; i < receiver.size(); ++i ) { packets.emplace_back( receiver[i].data, receiver[i].size ); } }
+    return packets;
+}
+
+TEST( udp, batches )
+{
+    udp::options options;
+    options.batch_size = 16;
+    options.packet_size = 1024;
+    options.buffer_size = 1048576;
+    udp::receiver receiver( 0, options );
+    EXPECT_EQ( 0u, receiver.receive( false ) );
+    udp::sender sender( "127.0.0.1", receiver.port(), options );
+    std::vector< std::string > sent;
+    for( unsigned int i = 0; i < 100; ++i ) { sent.push_back( std::string( 1 + i % 50, 'a' + i % 26 ) + std::to_string( i ) ); sender.send( &sent.back()[0], sent.back().size() ); }
+    EXPECT_EQ( 100u % 16, sender.size() ); // full batches sent
+    sender.flush();
+    EXPECT_EQ( 0u, sender.size() );
+    EXPECT_EQ( 16u, receiver.receive( true ) ); // up to batch size at once
+    EXPECT_EQ( sent[0], std::string( receiver[0].data, receiver[0].size ) );
+    std::vector< std::string > received;
+    for( unsigned int i = 0; i < receiver.size(); ++i ) { received.emplace_back( receiver[i].data, receiver[i].size ); }
+    std::vector< std::string > rest = receive( receiver, 84 );
+    received.insert( received.end(), rest.begin(), rest.end() );
+    EXPECT_EQ( sent, received );
+    std::string large( 1025, 'x' );
+    EXPECT_THROW( sender.send( &large[0], large.size() ), comma::exception );
+}
+
+TEST( udp, timestamps )
+{
+    udp::options options;
+    options.timestamps = true;
+    options.gro = true; // harmless, if kernel does not support it
+    udp::receiver receiver( 0, options );
+    udp::sender sender( "localhost", receiver.port() );
+    boost::posix_time::ptime before = boost::posix_time::microsec_clock::universal_time();
+    sender.send( "hello", 5 );
+    sender.flush();
+    ASSERT_EQ( 1u, receiver.receive() );
+    boost::posix_time::ptime after = boost::posix_time::microsec_clock::universal_time();
+    EXPECT_EQ( "hello", std::string( receiver[0].data, receiver[0].size ) );
+    EXPECT_LE( before - boost::posix_time::milliseconds( 1 ), receiver[0].timestamp );
+    EXPECT_GE( after, receiver[0].timestamp );
+}
+
+TEST( udp, address )
+{
+    udp::address a = udp::address::from_string( "udp-multicast:239.1.2.3:12345" );
+    EXPECT_EQ( "239.1.2.3", a.host );
+    EXPECT_EQ( 12345, a.port );
+    EXPECT_TRUE( a.multicast );
+    EXPECT_EQ( "255.255.255.255", udp::address::from_string( "udp-broadcast:12345" ).host );
+    EXPECT_EQ( "127.255.255.255", udp::address::from_string( "udp-broadcast:127.255.255.255:12345" ).host );
+    EXPECT_TRUE( udp::address::from_string( "udp:12345" ).host.empty() );
+    EXPECT_THROW( udp::address::from_string( "udp-multicast:127.0.0.1:12345" ), comma::exception );
+    std::string name = "udp-multicast:239.1.2.3:12345;size=24;ttl=2;interface=127.0.0.1;sequence";
+    udp::options options = udp::options::strip( name );
+    EXPECT_EQ( "udp-multicast:239.1.2.3:12345", name );
+    EXPECT_EQ( 24u, options.record_size );
+    EXPECT_EQ( 2, options.ttl );
+    EXPECT_EQ( "127.0.0.1", options.interface );
+    EXPECT_TRUE( options.sequence );
+}
+
+TEST( udp, multicast )
+{
+    udp::options options;
+    options.group = "239.255.43.21";
+    options.interface = "127.0.0.1";
+    options.reuse_address = true;
+    options.sequence = true;
+    udp::receiver first( 0, options );
+    udp::receiver second( first.port(), options ); // many receivers on the same host
+    udp::sender unicast( "127.0.0.1", first.port() );
+    unicast.send( "not for group", 13 ); // receivers bound to group do not get it
+    unicast.flush();
+    std::string name = "udp-multicast:239.255.43.21:" + std::to_string( first.port() ) + ";size=4;packet-size=20;interface=127.0.0.1;sequence";
+    udp::options writer_options = udp::options::strip( name );
+    udp::writer writer( name, writer_options );
+    std::string data = "0000111122223333444455556666";
+    writer.write( &data[0], 10 ); // two records sent, two bytes pending
+    writer.write( &data[10], data.size() - 10 );
+    writer.close();
+    EXPECT_EQ( 3u, writer.packets() ); // three records per packet of 12 bytes plus 8 bytes of sequence number
+    for( udp::receiver* r: { &first, &second } )
+    {
+        std::vector< std::string > packets = receive( *r, 3 );
+        ASSERT_EQ( 3u, packets.size() );
+        EXPECT_EQ( "00001111", packets[0] );
+        EXPECT_EQ( "222233334444", packets[1] );
+        EXPECT_EQ( "55556666", packets[2] );
+        EXPECT_EQ( 0u, r->lost() );
+    }
+}
+
+TEST( udp, lines )
+{
+    udp::receiver receiver( 0 );
+    std::string name = "udp-broadcast:127.255.255.255:" + std::to_string( receiver.port() ) + ";packet-size=12";
+    udp::options options = udp::options::strip( name );
+    udp::writer writer( name, options );
+    std::string data = "a,b\nccc,ddd\ne\nf";
+    writer.write( &data[0], data.size() );
+    std::string line = "g\n" + std::string( 20, 'x' );
+    EXPECT_THROW( writer.write( &line[0], line.size() ), comma::exception ); // rejected as a whole: nothing sent or kept
+    writer.close();
+    std::vector< std::string > packets = receive( receiver, 3 );
+    ASSERT_EQ( 3u, packets.size() );
+    EXPECT_EQ( "a,b\nccc,ddd\n", packets[0] ); // whole lines only
+    EXPECT_EQ( "e\n", packets[1] );
+    EXPECT_EQ( "f", packets[2] ); // pending incomplete line sent on close
+}
+
+TEST( udp, default_packet_size )
+{
+    udp::receiver receiver( 0 );
+    udp::writer writer( "udp-broadcast:127.255.255.255:" + std::to_string( receiver.port() ), udp::options() ); // as constructed by default, not through strip()
+    std::string data( 65506, 'x' );
+    data += '\n';
+    writer.write( &data[0], data.size() );
+    writer.close();
+    std::vector< std::string > packets = receive( receiver, 1 );
+    ASSERT_EQ( 1u, packets.size() );
+    EXPECT_EQ( data, packets[0] );
+}
+
+TEST( udp, sequence )
+{
+    udp::options options;
+    options.sequence = true;
+    udp::receiver receiver( 0, options );
+    udp::sender sender( "127.0.0.1", receiver.port() );
+    char packet[9] = { 0, 0, 0, 0, 0, 0, 0, 0, 'x' };
+    for( char sequence: { 0, 1, 4, 5, 9 } ) { packet[0] = sequence; sender.send( packet, 9 ); }
+    sender.flush();
+    std::vector< std::string > packets = receive( receiver, 5 );
+    EXPECT_EQ( 5u, packets.size() );
+    EXPECT_EQ( "x", packets[0] );
+    EXPECT_EQ( 5u, receiver.lost() );
+}
+
+} } } // namespace comma { namespace io { namespace udp_test {
@@ -0,0 +1,145 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <zmq.hpp>
+#include "../../base/types.h"
+#include "../stream.h"
+#include "../zeromq/options.h"
+#include "../zeromq/stream.h"
+
+namespace comma { namespace io { namespace zeromq_test {
+
+static std::vector< char > records( std::size_t count, std::size_t size )
+{
+    std::vector< char > v( count * size );
+    for( std::size_t i = 0; i < v.size(); ++i ) { v[i] = char( i ); }
+    return v;
+}
+
+struct subscriber // raw subscriber on the context shared with comma streams, so that inproc endpoints are visible
+{
+    std::shared_ptr< zmq::context_t > context;
+    zmq::socket_t socket;
+
+    subscriber( const std::string& endpoint, int timeout = 2000 ): context( comma::io::zeromq::context() ), socket( *context, ZMQ_SUB )
+    {
+        socket.setsockopt( ZMQ_RCVTIMEO, &timeout, sizeof( timeout ) );
+        socket.connect( endpoint.c_str() );
+        socket.setsockopt( ZMQ_SUBSCRIBE, "", 0 );
+    }
+
+    bool receive( std::string& message, bool& more )
+    {
+        zmq::message_t m;
+        if( !socket.recv( &m ) ) { return false; }
+        message.assign( static_cast< const char* >( m.data() ), m.size() );
+        int value = 0;
+        std::size_t size = sizeof( value );
+        socket.getsockopt( ZMQ_RCVMORE, &value, &size );
+        more = value != 0;
+        return true;
+    }
+
+    std::string receive()
+    {
+        std::string message;
+        bool more;
+        return receive( message, more ) ? message : std::string();
+    }
+};
+
+/// pub drops messages until subscription reaches it: send numbered probe records until one arrives, then
+/// drain probes up to the last one sent, since all sent after the first one received arrive, too
+/// @param suffix e.g. line end for ascii streams
+static void handshake( std::ostream& os, zmq::socket_t& socket, const std::string& suffix = "" )
+{
+    auto probe = []( unsigned int i, const std::string& suffix ) { char s[16]; std::snprintf( s, sizeof( s ), "probe%03u", i ); return s + suffix; };
+    zmq_pollitem_t item = { static_cast< void* >( socket ), 0, ZMQ_POLLIN, 0 };
+    unsigned int sent = 0;
+    for( ; sent < 500; ++sent )
+    {
+        const std::string& p = probe( sent, suffix );
+        os.write( &p[0], p.size() );
+        os.flush();
+        if( zmq_poll( &item, 1, 20 ) > 0 ) { break; }
+    }
+    ASSERT_GT( 500u, sent ) << "subscription did not reach publisher";
+    const std::string& last = probe( sent, suffix );
+    zmq::message_t m;
+    do { ASSERT_TRUE( socket.recv( &m ) ); } while( std::string( static_cast< const char* >( m.data() ), m.size() ) != last );
+}
+
+TEST( zeromq, batch )
+{
+    comma::io::ostream os( "zmq-inproc:batch;size=8;batch=4", comma::io::mode::binary );
+    subscriber sub( "inproc://batch" );
+    handshake( *os, sub.socket );
+    const std::vector< char > v = records( 10, 8 );
+    os->write( &v[0], 76 ); // 9 whole records and incomplete one
+    EXPECT_EQ( std::string( &v[0], 32 ), sub.receive() );
+    EXPECT_EQ( std::string( &v[32], 32 ), sub.receive() );
+    os->flush(); // sends whole records, keeps incomplete one
+    EXPECT_EQ( std::string( &v[64], 8 ), sub.receive() );
+    os->write( &v[76], 4 );
+    os->flush();
+    EXPECT_EQ( std::string( &v[72], 8 ), sub.receive() );
+}
+
+TEST( zeromq, multipart )
+{
+    comma::io::ostream os( "zmq-inproc:multipart;size=8;batch=3;multipart", comma::io::mode::binary );
+    subscriber sub( "inproc://multipart" );
+    handshake( *os, sub.socket );
+    const std::vector< char > v = records( 3, 8 );
+    os->write( &v[0], v.size() );
+    for( unsigned int i = 0; i < 3; ++i )
+    {
+        std::string part;
+        bool more;
+        ASSERT_TRUE( sub.receive( part, more ) );
+        EXPECT_EQ( std::string( &v[ i * 8 ], 8 ), part );
+        EXPECT_EQ( i < 2, more );
+    }
+}
+
+TEST( zeromq, latency )
+{
+    comma::io::ostream os( "zmq-inproc:latency;batch=100;latency=0.05", comma::io::mode::ascii );
+    subscriber sub( "inproc://latency" );
+    handshake( *os, sub.socket, "\n" );
+    auto start = std::chrono::steady_clock::now();
+    *os << "1,2\n3,4\n5"; // no more writes: timer has to send the whole lines
+    EXPECT_EQ( "1,2\n3,4\n", sub.receive() );
+    double elapsed = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+    EXPECT_LE( 0.04, elapsed );
+    EXPECT_GT( 1.0, elapsed );
+}
+
+TEST( zeromq, ipc )
+{
+    const std::vector< char > v = records( 100, 8 );
+    const std::string path = "./test.zeromq.ipc";
+    {
+        comma::io::ostream os( "zmq-local:" + path + ";size=8;batch=16", comma::io::mode::binary );
+        boost::iostreams::stream< comma::io::zeromq::istream > is( comma::io::zeromq::istream( "ipc://" + path ) );
+        int timeout = 2000;
+        is->socket().setsockopt( ZMQ_RCVTIMEO, &timeout, sizeof( timeout ) );
+        handshake( *os, is->socket() );
+        os->write( &v[0], v.size() );
+        os->flush();
+        std::vector< char > d( v.size() );
+        is.read( &d[0], d.size() ); // records of seven messages reassembled, receiving into the same message
+        EXPECT_EQ( std::streamsize( v.size() ), is.gcount() );
+        EXPECT_EQ( v, d );
+    }
+    std::remove( path.c_str() );
+}
+
+} } } // namespace comma { namespace io { namespace zeromq_test {
@@ -0,0 +1,462 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/lexical_cast.hpp>
+#include "../base/exception.h"
+#include "../base/last_error.h"
+#include "../string/split.h"
+#include "udp.h"
+
+#if defined( __linux__ ) && !defined( UDP_GRO )
+#define UDP_GRO 104 // as in linux/udp.h since 5.0; older kernels reject it in setsockopt()
+#endif
+
+namespace comma { namespace io { namespace udp {
+
+namespace impl {
+
+static void set_option( int fd, int level, int name, int value, const std::string& what )
+{
+    if( ::setsockopt( fd, level, name, &value, sizeof( value ) ) != 0 ) { ::close( fd ); last_error::to_exception( "udp: failed to set " + what ); }
+}
+
+static int open( const udp::options& options, bool receive )
+{
+    COMMA_ASSERT_BRIEF( options.batch_size > 0, "udp: expected positive batch size" );
+    COMMA_ASSERT_BRIEF( options.packet_size > 0, "udp: expected positive packet size" );
+    int fd = ::socket( AF_INET, SOCK_DGRAM, 0 );
+    if( fd < 0 ) { last_error::to_exception( "udp: failed to open socket" ); }
+    if( options.broadcast ) { set_option( fd, SOL_SOCKET, SO_BROADCAST, 1, "broadcast option" ); }
+    if( options.reuse_address ) { set_option( fd, SOL_SOCKET, SO_REUSEADDR, 1, "reuse address option" ); }
+    if( options.buffer_size > 0 ) { set_option( fd, SOL_SOCKET, receive ? SO_RCVBUF : SO_SNDBUF, options.buffer_size, "socket buffer size" ); }
+    return fd;
+}
+
+static boost::posix_time::ptime time_of( const ::timespec& t ) { return boost::posix_time::from_time_t( t.tv_sec ) + boost::posix_time::microseconds( t.tv_nsec / 1000 ); }
+
+static ::in_addr address_of( const std::string& s, const std::string& what )
+{
+    ::in_addr a;
+    COMMA_ASSERT_BRIEF( ::inet_pton( AF_INET, &s[0], &a ) == 1, "udp: expected " << what << " as ipv4 address, e.g. 127.0.0.1; got: '" << s << "'" );
+    return a;
+}
+
+static const std::size_t header_size = sizeof( comma::uint64 ); // sequence number
+
+static void write_sequence( char* p, comma::uint64 sequence ) { for( unsigned int i = 0; i < header_size; ++i, sequence >>= 8 ) { p[i] = char( sequence & 0xff ); } } // little endian on any host
+
+static comma::uint64 read_sequence( const char* p )
+{
+    comma::uint64 sequence = 0;
+    for( unsigned int i = header_size; i > 0; --i ) { sequence = ( sequence << 8 ) | static_cast< unsigned char >( p[ i - 1 ] ); }
+    return sequence;
+}
+
+} // namespace impl {
+
+options options::strip( std::string& name, std::size_t default_record_size )
+{
+    options o;
+    o.record_size = default_record_size;
+    o.packet_size = 1472; // ethernet mtu minus ip and udp headers: no ip fragmentation
+    std::vector< std::string > v = comma::split( name, ';' );
+    for( unsigned int i = 1; i < v.size(); ++i )
+    {
+        if( v[i] == "sequence" ) { o.sequence = true; continue; }
+        if( v[i] == "no-loopback" ) { o.loopback = false; continue; }
+        std::string::size_type p = v[i].find( '=' );
+        COMMA_ASSERT_BRIEF( p != std::string::npos, "expected udp stream option as <name>=<value>; got: '" << v[i] << "' in '" << name << "'" );
+        std::string key = v[i].substr( 0, p );
+        std::string value = v[i].substr( p + 1 );
+        if( key == "size" || key == "record-size" ) { o.record_size = boost::lexical_cast< std::size_t >( value ); }
+        else if( key == "packet-size" ) { o.packet_size = boost::lexical_cast< std::size_t >( value ); }
+        else if( key == "ttl" ) { o.ttl = boost::lexical_cast< int >( value ); }
+        else if( key == "interface" ) { o.interface = value; }
+        else if( key == "buffer-size" ) { o.buffer_size = boost::lexical_cast< int >( value ); }
+        else { COMMA_THROW( comma::exception, "unknown udp stream option '" << key << "' in '" << name << "'" ); }
+    }
+    name = v[0];
+    return o;
+}
+
+std::string options::usage( unsigned int indent )
+{
+    std::string i( indent, ' ' );
+    std::ostringstream oss;
+    oss << i << "udp-multicast:<group>:<port>[;<options>]: udp multicast, e.g. udp-multicast:239.1.2.3:12345;size=24" << std::endl;
+    oss << i << "udp-broadcast:[<address>:]<port>[;<options>]: udp broadcast; default address: 255.255.255.255" << std::endl;
+    oss << i << "    e.g. udp-broadcast:127.255.255.255:12345 for receivers on local host only" << std::endl;
+    oss << i << "    size,record-size=<bytes>: record size; default: 1 for binary, lines for ascii" << std::endl;
+    oss << i << "                              records or lines are never split across packets" << std::endl;
+    oss << i << "    packet-size=<bytes>; default=1472: maximum packet size, ethernet mtu minus ip and udp headers" << std::endl;
+    oss << i << "    buffer-size=<bytes>: socket buffer size; default: system default" << std::endl;
+    oss << i << "    ttl=<n>; default=1: multicast time to live; 1: local network only" << std::endl;
+    oss << i << "    interface=<address>: address of interface for multicast, e.g. 127.0.0.1; default: chosen by system" << std::endl;
+    oss << i << "    no-loopback: do not deliver multicast to receivers on the same host" << std::endl;
+    oss << i << "    sequence: prefix each packet with 64-bit little-endian sequence number" << std::endl;
+    oss << i << "              receivers specify it, too, to strip sequence numbers and report lost packets" << std::endl;
+    return oss.str();
+}
+
+address address::from_string( const std::string& name )
+{
+    std::vector< std::string > v = comma::split( name, ':' );
+    address a;
+    if( v[0] == "udp" )
+    {
+        COMMA_ASSERT_BRIEF( v.size() == 2, "udp: expected udp:<port>; got: '" << name << "'" );
+    }
+    else if( v[0] == "udp-multicast" )
+    {
+        COMMA_ASSERT_BRIEF( v.size() == 3, "udp: expected udp-multicast:<group>:<port>; got: '" << name << "'" );
+        COMMA_ASSERT_BRIEF( IN_MULTICAST( ntohl( impl::address_of( v[1], "multicast group" ).s_addr ) ), "udp: expected multicast group in 224.0.0.0/4, e.g. 239.1.2.3; got: '" << v[1] << "' in '" << name << "'" );
+        a.host = v[1];
+        a.multicast = true;
+    }
+    else if( v[0] == "udp-broadcast" )
+    {
+        COMMA_ASSERT_BRIEF( v.size() == 2 || v.size() == 3, "udp: expected udp-broadcast:[<address>:]<port>; got: '" << name << "'" );
+        a.host = v.size() == 3 ? v[1] : std::string( "255.255.255.255" );
+    }
+    else
+    {
+        COMMA_THROW_BRIEF( comma::exception, "udp: expected udp:<port>, udp-multicast:<group>:<port>, or udp-broadcast:[<address>:]<port>; got: '" << name << "'" );
+    }
+    a.port = boost::lexical_cast< unsigned short >( v.back() );
+    return a;
+}
+
+#ifdef __linux__
+
+struct receiver::messages
+{
+    std::vector< ::mmsghdr > headers;
+    std::vector< ::iovec > iovecs;
+    std::vector< char > control;
+    std::size_t control_size{0};
+    int received{0}; // number of headers used by the last recvmmsg()
+};
+
+struct sender::messages
+{
+    std::vector< ::mmsghdr > headers;
+    std::vector< ::iovec > iovecs;
+};
+
+#else
+
+struct receiver::messages {};
+
+struct sender::messages {};
+
+#endif
+
+receiver::receiver( unsigned short port, const udp::options& options ): _options( options ), _fd( impl::open( options, true ) ), _messages( new messages )
+{
+    #ifdef __linux__
+    if( _options.timestamps ) { impl::set_option( _fd, SOL_SOCKET, SO_TIMESTAMPNS, 1, "kernel timestamps option" ); }
+    if( _options.gro )
+    {
+        int on = 1;
+        if( ::setsockopt( _fd, SOL_UDP, UDP_GRO, &on, sizeof( on ) ) == 0 ) { _options.packet_size = std::max( _options.packet_size, std::size_t( 65536 ) ); } // coalesced packets are up to 64k
+        else { _options.gro = false; } // not supported by kernel
+    }
+    #else
+    _options.timestamps = false;
+    _options.gro = false;
+    #endif
+    ::sockaddr_in address;
+    std::memset( &address, 0, sizeof( address ) );
+    address.sin_family = AF_INET;
+    address.sin_port = htons( port );
+    try { address.sin_addr.s_addr = _options.group.empty() ? htonl( INADDR_ANY ) : impl::address_of( _options.group, "multicast group" ).s_addr; } // bound to group: no packets sent to other groups or unicast on the same port
+    catch( ... ) { ::close( _fd ); throw; }
+    if( ::bind( _fd, reinterpret_cast< const ::sockaddr* >( &address ), sizeof( address ) ) != 0 ) { ::close( _fd ); last_error::to_exception( "udp: failed to bind port " + std::to_string( port ) ); }
+    if( !_options.group.empty() )
+    {
+        ::ip_mreq m;
+        m.imr_multiaddr = address.sin_addr;
+        try { m.imr_interface.s_addr = _options.interface.empty() ? htonl( INADDR_ANY ) : impl::address_of( _options.interface, "interface" ).s_addr; }
+        catch( ... ) { ::close( _fd ); throw; }
+        if( ::setsockopt( _fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &m, sizeof( m ) ) != 0 ) { ::close( _fd ); last_error::to_exception( "udp: failed to join multicast group " + _options.group ); }
+    }
+    COMMA_ASSERT_BRIEF( !_options.sequence || _options.packet_size > impl::header_size, "udp: expected packet size greater than " << impl::header_size << " for sequence numbers" );
+    _buffer.resize( _options.batch_size * _options.packet_size );
+    _packets.reserve( _options.batch_size );
+    #ifdef __linux__
+    messages& m = *_messages;
+    m.headers.resize( _options.batch_size );
+    m.iovecs.resize( _options.batch_size );
+    m.control_size = ( _options.timestamps ? CMSG_SPACE( sizeof( ::timespec ) ) : 0 ) + ( _options.gro ? CMSG_SPACE( sizeof( int ) ) : 0 );
+    m.control.resize( _options.batch_size * m.control_size + 1 );
+    for( unsigned int i = 0; i < _options.batch_size; ++i )
+    {
+        std::memset( &m.headers[i], 0, sizeof( ::mmsghdr ) );
+        m.iovecs[i].iov_base = &_buffer[ i * _options.packet_size ];
+        m.iovecs[i].iov_len = _options.packet_size;
+        m.headers[i].msg_hdr.msg_iov = &m.iovecs[i];
+        m.headers[i].msg_hdr.msg_iovlen = 1;
+        if( m.control_size == 0 ) { continue; }
+        m.headers[i].msg_hdr.msg_control = &m.control[ i * m.control_size ];
+        m.headers[i].msg_hdr.msg_controllen = m.control_size;
+    }
+    #endif
+}
+
+receiver::~receiver() { ::close( _fd ); }
+
+void receiver::_push( const char* data, std::size_t size, const boost::posix_time::ptime& timestamp )
+{
+    if( !_options.sequence ) { _packets.push_back( udp::packet{ data, size, timestamp } ); return; }
+    if( size < impl::header_size ) { return; } // not from a sequenced sender
+    comma::uint64 sequence = impl::read_sequence( data );
+    if( sequence >= _next ) { if( _started ) { _lost += sequence - _next; } _next = sequence + 1; }
+    else if( sequence == 0 ) { _next = 1; } // sender restarted
+    _started = true;
+    _packets.push_back( udp::packet{ data + impl::header_size, size - impl::header_size, timestamp, sequence } );
+}
+
+unsigned short receiver::port() const
+{
+    ::sockaddr_in address;
+    ::socklen_t size = sizeof( address );
+    if( ::getsockname( _fd, reinterpret_cast< ::sockaddr* >( &address ), &size ) != 0 ) { last_error::to_exception( "udp: failed to get socket name" ); }
+    return ntohs( address.sin_port );
+}
+
+int receiver::buffer_size() const
+{
+    int size = 0;
+    ::socklen_t length = sizeof( size );
+    if( ::getsockopt( _fd, SOL_SOCKET, SO_RCVBUF, &size, &length ) != 0 ) { last_error::to_exception( "udp: failed to get receive buffer size" ); }
+    return size;
+}
+
+unsigned int receiver::receive( bool blocking )
+{
+    _packets.clear();
+    _size = 0;
+    #ifdef __linux__
+    messages& m = *_messages;
+    if( m.control_size > 0 ) { for( int i = 0; i < m.received; ++i ) { m.headers[i].msg_hdr.msg_controllen = m.control_size; } } // kernel overwrites it
+    int n = ::recvmmsg( _fd, &m.headers[0], _options.batch_size, blocking ? MSG_WAITFORONE : MSG_DONTWAIT, nullptr );
+    m.received = std::max( n, 0 );
+    if( n < 0 )
+    {
+        if( errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK ) { return 0; }
+        last_error::to_exception( "udp: failed to receive" );
+    }
+    boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+    for( int i = 0; i < n; ++i )
+    {
+        ::msghdr& h = m.headers[i].msg_hdr;
+        std::size_t size = m.headers[i].msg_len;
+        std::size_t segment = size;
+        boost::posix_time::ptime timestamp = now;
+        for( ::cmsghdr* c = m.control_size ? CMSG_FIRSTHDR( &h ) : nullptr; c; c = CMSG_NXTHDR( &h, c ) )
+        {
+            if( c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS ) { ::timespec t; std::memcpy( &t, CMSG_DATA( c ), sizeof( t ) ); timestamp = impl::time_of( t ); }
+            else if( c->cmsg_level == SOL_UDP && c->cmsg_type == UDP_GRO ) { int s; std::memcpy( &s, CMSG_DATA( c ), sizeof( s ) ); if( s > 0 ) { segment = s; } }
+        }
+        const char* data = &_buffer[ i * _options.packet_size ];
+        if( size == 0 ) { _push( data, 0, timestamp ); continue; }
+        for( std::size_t offset = 0; offset < size; offset += segment ) { _push( data + offset, std::min( segment, size - offset ), timestamp ); } // split coalesced packets
+    }
+    #else
+    int size = ::recv( _fd, &_buffer[0], _options.packet_size, blocking ? 0 : MSG_DONTWAIT );
+    if( size < 0 )
+    {
+        if( errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK ) { return 0; }
+        last_error::to_exception( "udp: failed to receive" );
+    }
+    _push( &_buffer[0], std::size_t( size ), boost::posix_time::microsec_clock::universal_time() );
+    #endif
+    _size = _packets.size();
+    return _size;
+}
+
+sender::sender( const std::string& host, unsigned short port, const udp::options& options ): _options( options ), _fd( impl::open( options, false ) ), _messages( new messages )
+{
+    ::addrinfo hints;
+    std::memset( &hints, 0, sizeof( hints ) );
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    ::addrinfo* addresses = nullptr;
+    int r = ::getaddrinfo( &host[0], &std::to_string( port )[0], &hints, &addresses );
+    if( r != 0 || !addresses ) { ::close( _fd ); COMMA_THROW_BRIEF( comma::exception, "udp: failed to resolve '" << host << "': " << ::gai_strerror( r ) ); }
+    if( IN_MULTICAST( ntohl( reinterpret_cast< const ::sockaddr_in* >( addresses->ai_addr )->sin_addr.s_addr ) ) )
+    {
+        try
+        {
+            impl::set_option( _fd, IPPROTO_IP, IP_MULTICAST_TTL, _options.ttl, "multicast ttl" );
+            impl::set_option( _fd, IPPROTO_IP, IP_MULTICAST_LOOP, _options.loopback ? 1 : 0, "multicast loopback" );
+            if( !_options.interface.empty() )
+            {
+                ::in_addr a = impl::address_of( _options.interface, "interface" );
+                if( ::setsockopt( _fd, IPPROTO_IP, IP_MULTICAST_IF, &a, sizeof( a ) ) != 0 ) { ::close( _fd ); last_error::to_exception( "udp: failed to set multicast interface " + _options.interface ); }
+            }
+        }
+        catch( ... ) { ::freeaddrinfo( addresses ); throw; }
+    }
+    r = ::connect( _fd, addresses->ai_addr, addresses->ai_addrlen ); // connected socket: no destination lookup per packet
+    ::freeaddrinfo( addresses );
+    if( r != 0 ) { ::close( _fd ); last_error::to_exception( "udp: failed to connect to " + host + ":" + std::to_string( port ) ); }
+    _buffer.resize( _options.batch_size * _options.packet_size );
+    _sizes.reserve( _options.batch_size );
+    #ifdef __linux__
+    messages& m = *_messages;
+    m.headers.resize( _options.batch_size );
+    m.iovecs.resize( _options.batch_size );
+    for( unsigned int i = 0; i < _options.batch_size; ++i )
+    {
+        std::memset( &m.headers[i], 0, sizeof( ::mmsghdr ) );
+        m.iovecs[i].iov_base = &_buffer[ i * _options.packet_size ];
+        m.headers[i].msg_hdr.msg_iov = &m.iovecs[i];
+        m.headers[i].msg_hdr.msg_iovlen = 1;
+    }
+    #endif
+}
+
+sender::~sender()
+{
+    try { flush(); } catch( ... ) {}
+    ::close( _fd );
+}
+
+void sender::send( const char* buf, std::size_t size )
+{
+    COMMA_ASSERT_BRIEF( size <= _options.packet_size, "udp: expected packet of at most " << _options.packet_size << " byte(s), got " << size );
+    std::memcpy( &_buffer[ _sizes.size() * _options.packet_size ], buf, size );
+    _sizes.push_back( size );
+    if( _sizes.size() == _options.batch_size ) { flush(); }
+}
+
+void sender::flush()
+{
+    #ifdef __linux__
+    messages& m = *_messages;
+    for( std::size_t i = 0; i < _sizes.size(); ++i ) { m.iovecs[i].iov_len = _sizes[i]; }
+    for( std::size_t sent = 0; sent < _sizes.size(); )
+    {
+        int n = ::sendmmsg( _fd, &m.headers[sent], _sizes.size() - sent, 0 );
+        if( n >= 0 ) { sent += n; continue; }
+        if( errno == EINTR || errno == ECONNREFUSED ) { continue; } // connection refused: icmp from previous packets with no receiver, as usual with udp
+        _sizes.clear();
+        last_error::to_exception( "udp: failed to send" );
+    }
+    #else
+    for( std::size_t i = 0; i < _sizes.size(); ++i )
+    {
+        while( ::send( _fd, &_buffer[ i * _options.packet_size ], _sizes[i], 0 ) < 0 )
+        {
+            if( errno == EINTR || errno == ECONNREFUSED ) { continue; }
+            _sizes.clear();
+            last_error::to_exception( "udp: failed to send" );
+        }
+    }
+    #endif
+    _sizes.clear();
+}
+
+writer::writer( const std::string& name, const udp::options& options ): _options( options )
+{
+    const std::size_t capacity = _options.packet_size - ( _options.sequence ? impl::header_size : 0 );
+    COMMA_ASSERT_BRIEF( _options.packet_size <= 65507, "udp: expected packet size of at most 65507 bytes; got: " << _options.packet_size );
+    COMMA_ASSERT_BRIEF( _options.packet_size > ( _options.sequence ? impl::header_size : 0 ), "udp: packet size " << _options.packet_size << " too small" );
+    COMMA_ASSERT_BRIEF( _options.record_size <= capacity, "udp: record size " << _options.record_size << " does not fit in packet of " << capacity << " bytes; increase packet-size" );
+    udp::address a = udp::address::from_string( name );
+    COMMA_ASSERT_BRIEF( !a.host.empty(), "udp: expected udp-multicast:<group>:<port> or udp-broadcast:[<address>:]<port>; got: '" << name << "'" );
+    _sender.reset( new udp::sender( a.host, a.port, _options ) );
+    if( _options.sequence ) { _packet.resize( _options.packet_size ); }
+}
+
+writer::~writer() { try { close(); } catch( ... ) {} }
+
+void writer::_check( const char* buf, std::size_t size ) const
+{
+    if( _options.record_size > 0 ) { return; } // records fit in packet, as checked on construction
+    const std::size_t capacity = _options.packet_size - ( _options.sequence ? impl::header_size : 0 );
+    std::size_t length = _pending.size(); // pending data is incomplete line
+    for( const char* p = buf; p < buf + size; )
+    {
+        const char* newline = static_cast< const char* >( std::memchr( p, '\n', buf + size - p ) );
+        const char* end = newline ? newline + 1 : buf + size;
+        length += end - p;
+        COMMA_ASSERT_BRIEF( newline ? length <= capacity : length < capacity, "udp: line longer than " << capacity << " bytes does not fit in packet; increase packet-size" );
+        length = 0;
+        p = end;
+    }
+}
+
+void writer::_send( const char* buf, std::size_t size, bool all, std::size_t& offset )
+{
+    const std::size_t capacity = _options.packet_size - ( _options.sequence ? impl::header_size : 0 );
+    while( offset < size )
+    {
+        const char* begin = buf + offset;
+        std::size_t remaining = size - offset;
+        std::size_t n = 0;
+        if( _options.record_size > 0 )
+        {
+            n = std::min( capacity / _options.record_size, remaining / _options.record_size ) * _options.record_size;
+        }
+        else
+        {
+            for( std::size_t i = std::min( remaining, capacity ); i > 0; --i ) { if( begin[ i - 1 ] == '\n' ) { n = i; break; } }
+        }
+        if( n == 0 ) { if( !all ) { break; } n = std::min( remaining, capacity ); }
+        if( _options.sequence )
+        {
+            impl::write_sequence( &_packet[0], _sequence );
+            std::memcpy( &_packet[ impl::header_size ], begin, n );
+            _sender->send( &_packet[0], impl::header_size + n );
+        }
+        else
+        {
+            _sender->send( begin, n );
+        }
+        ++_sequence;
+        offset += n;
+    }
+}
+
+void writer::write( const char* buf, std::size_t size )
+{
+    _check( buf, size );
+    std::size_t sent = 0; // on failure, data handed to sender so far counts as sent, since resending it would duplicate packets
+    if( _pending.empty() )
+    {
+        try { _send( buf, size, false, sent ); } catch( ... ) { _pending.assign( buf + sent, buf + size ); throw; }
+        _pending.assign( buf + sent, buf + size );
+    }
+    else
+    {
+        _pending.insert( _pending.end(), buf, buf + size );
+        try { _send( &_pending[0], _pending.size(), false, sent ); } catch( ... ) { _pending.erase( _pending.begin(), _pending.begin() + sent ); throw; }
+        _pending.erase( _pending.begin(), _pending.begin() + sent );
+    }
+    _sender->flush();
+}
+
+void writer::close()
+{
+    if( _closed ) { return; }
+    _closed = true;
+    std::size_t sent = 0;
+    if( !_pending.empty() ) { _send( &_pending[0], _pending.size(), true, sent ); _pending.clear(); }
+    _sender->flush();
+}
+
+} } } // namespace comma { namespace io { namespace udp {
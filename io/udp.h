@@ -0,0 +1,187 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/iostreams/concepts.hpp>
+#include <boost/noncopyable.hpp>
+#include "../base/types.h"
+#include "file_descriptor.h"
+
+namespace comma { namespace io { namespace udp {
+
+/// batched udp i/o: on linux, packets are received with recvmmsg() and sent with sendmmsg(), i.e.
+/// up to batch_size packets per system call, into and from buffers preallocated once;
+/// elsewhere, one packet per system call
+struct options
+{
+    unsigned int batch_size{64}; /// maximum number of packets received or sent in one system call
+    std::size_t packet_size{65507}; /// maximum packet size; default: largest udp payload over ipv4
+    int buffer_size{0}; /// socket receive or send buffer size in bytes (SO_RCVBUF/SO_SNDBUF); 0: system default
+    bool timestamps{false}; /// take receive timestamps from kernel (SO_TIMESTAMPNS) rather than system time after receiving
+    bool gro{false}; /// generic receive offload: kernel may coalesce packets of the same size; they are split back on receive
+    bool reuse_address{false};
+    bool broadcast{true};
+    std::string group; /// receiver: multicast group to join, e.g. 239.1.2.3
+    std::string interface; /// address of interface for multicast, e.g. 127.0.0.1; default: chosen by system
+    int ttl{1}; /// sender: multicast time to live, i.e. number of routers to pass; 1: local network only
+    bool loopback{true}; /// sender: deliver multicast packets to receivers on the same host
+    bool sequence{false}; /// sender: prefix each packet with 64-bit little-endian sequence number; receiver: strip it and count lost packets
+    std::size_t record_size{0}; /// writer: record size for packetisation; 0: lines
+
+    /// strip options from stream name and return them, e.g:
+    /// "udp-multicast:239.1.2.3:12345;size=24;ttl=2;sequence" -> "udp-multicast:239.1.2.3:12345"
+    static options strip( std::string& name, std::size_t default_record_size = 0 );
+
+    static std::string usage( unsigned int indent = 0 );
+};
+
+/// stream address without options: udp:<port>, udp-multicast:<group>:<port>, or udp-broadcast:[<address>:]<port>
+struct address
+{
+    std::string host; /// multicast group or broadcast address; empty for udp:<port>
+    unsigned short port{0};
+    bool multicast{false};
+
+    static address from_string( const std::string& name );
+};
+
+struct packet
+{
+    const char* data{nullptr};
+    std::size_t size{0};
+    boost::posix_time::ptime timestamp;
+    comma::uint64 sequence{0}; /// sequence number, if options::sequence
+};
+
+class receiver : public boost::noncopyable
+{
+    public:
+        /// bind to port on all interfaces; if options.group is not empty, bind to group and port and join group
+        receiver( unsigned short port, const udp::options& options = udp::options() );
+
+        ~receiver();
+
+        /// receive packets into ring of preallocated buffers
+        /// @param blocking if true, wait for at least one packet
+        /// @return number of packets, valid until next receive(); 0, if non-blocking and no packets, or if interrupted by signal
+        unsigned int receive( bool blocking = true );
+
+        /// packets from the last receive()
+        const udp::packet& operator[]( unsigned int i ) const { return _packets[i]; }
+
+        unsigned int size() const { return _size; }
+
+        comma::io::file_descriptor fd() const { return _fd; }
+
+        /// bound port, e.g. if constructed with port 0, i.e. any free port
+        unsigned short port() const;
+
+        /// actual receive buffer size as reported by socket
+        int buffer_size() const;
+
+        const udp::options& options() const { return _options; }
+
+        /// if options.sequence, total number of packets missing in sequence so far
+        comma::uint64 lost() const { return _lost; }
+
+    private:
+        udp::options _options;
+        comma::io::file_descriptor _fd;
+        std::vector< char > _buffer;
+        std::vector< udp::packet > _packets;
+        unsigned int _size{0};
+        comma::uint64 _lost{0};
+        comma::uint64 _next{0}; // next expected sequence number
+        bool _started{false};
+        void _push( const char* data, std::size_t size, const boost::posix_time::ptime& timestamp );
+        struct messages;
+        std::unique_ptr< messages > _messages;
+};
+
+class sender : public boost::noncopyable
+{
+    public:
+        /// send to given host and port, e.g. "localhost", "255.255.255.255" for broadcast, "239.1.2.3" for multicast
+        sender( const std::string& host, unsigned short port, const udp::options& options = udp::options() );
+
+        ~sender();
+
+        /// queue packet; send queued packets, if batch is full; throw, if packet is larger than packet_size
+        void send( const char* buf, std::size_t size );
+
+        /// send queued packets; call after the last packet of a burst, since packets are only sent in batches
+        void flush();
+
+        /// number of queued packets
+        std::size_t size() const { return _sizes.size(); }
+
+        comma::io::file_descriptor fd() const { return _fd; }
+
+        const udp::options& options() const { return _options; }
+
+    private:
+        udp::options _options;
+        comma::io::file_descriptor _fd;
+        std::vector< char > _buffer;
+        std::vector< std::size_t > _sizes;
+        struct messages;
+        std::unique_ptr< messages > _messages;
+};
+
+/// packetise stream of records or lines into udp packets, never splitting a record or line across packets,
+/// e.g. to publish to many receivers at the cost of a single write with multicast or broadcast
+class writer : public boost::noncopyable
+{
+    public:
+        /// @param name e.g. "udp-multicast:239.1.2.3:12345", "udp-broadcast:12345", or "udp-broadcast:127.255.255.255:12345"
+        writer( const std::string& name, const udp::options& options );
+
+        ~writer();
+
+        /// send all whole records or lines as packets; keep trailing incomplete record until next write
+        /// throw, if a line does not fit in packet, before sending or keeping any of buf
+        void write( const char* buf, std::size_t size );
+
+        /// send remaining data, even if incomplete record
+        void close();
+
+        comma::io::file_descriptor fd() const { return _sender->fd(); }
+
+        /// number of packets sent so far
+        comma::uint64 packets() const { return _sequence; }
+
+    private:
+        udp::options _options;
+        std::unique_ptr< udp::sender > _sender;
+        std::vector< char > _pending;
+        std::vector< char > _packet;
+        comma::uint64 _sequence{0};
+        bool _closed{false};
+        void _check( const char* buf, std::size_t size ) const;
+        void _send( const char* buf, std::size_t size, bool all, std::size_t& offset );
+};
+
+/// boost::iostreams sink; whole records are sent, whenever the stream writes out its buffer
+class sink : public boost::iostreams::sink
+{
+    public:
+        struct category : boost::iostreams::sink_tag, boost::iostreams::closable_tag {};
+
+        sink( const std::shared_ptr< udp::writer >& writer ): _writer( writer ) {}
+
+        std::streamsize write( const char* s, std::streamsize n ) { _writer->write( s, n ); return n; }
+
+        void close() { _writer->close(); }
+
+    private:
+        std::shared_ptr< udp::writer > _writer;
+};
+
+} } } // namespace comma { namespace io { namespace udp {
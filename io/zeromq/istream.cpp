@@ -34,36 +34,28 @@
 
 namespace comma { namespace io { namespace zeromq {
 
-istream::istream( const std::string& endpoint )
-    : context_( new zmq::context_t( 1 ) )
+istream::istream( const std::string& endpoint, const zeromq::options& options )
+    : context_( zeromq::context() )
     , socket_( new zmq::socket_t( *context_, ZMQ_SUB ) )
-    , index_( buffer_.size() )
+    , message_( new zmq::message_t )
+    , index_( 0 )
 {
+    options.apply( *socket_, false );
     socket_->connect( endpoint.c_str() );
     socket_->setsockopt( ZMQ_SUBSCRIBE, "", 0 );
 }
 
 std::streamsize istream::read( char* s, std::streamsize n )
 {
-    zmq::message_t message;
-    if( !socket_->recv( &message ) ) { return -1; } // eof
-    if( index_ != buffer_.size() )
+    while( index_ >= message_->size() )
     {
-        unsigned int size = std::min( buffer_.size() - index_, static_cast< std::size_t >( n ) );
-        ::memcpy( s, &buffer_[ index_ ], size );
-        index_ += size;
-        return size;
+        if( !socket_->recv( message_.get() ) ) { return -1; } // eof
+        index_ = 0;
     }
-    if ( message.size() < static_cast< unsigned int >( n ) )
-    {
-        ::memcpy( s, ( const char* )message.data(), message.size() );
-        return message.size();
-    }
-    ::memcpy( s, ( const char* )message.data(), n );
-    buffer_.resize( message.size() - n );
-    ::memcpy( &buffer_[0], ( const char* )message.data(), buffer_.size() );
-    index_ = 0;
-    return n;
+    std::size_t size = std::min( message_->size() - index_, static_cast< std::size_t >( n ) );
+    ::memcpy( s, static_cast< const char* >( message_->data() ) + index_, size );
+    index_ += size;
+    return size;
 }
 
 } } } // namespace comma { namespace io { namespace zeromq {
@@ -33,29 +33,32 @@
 #ifndef COMMA_IO_ZEROMQ_ISTREAM_H_
 #define COMMA_IO_ZEROMQ_ISTREAM_H_
 
-#include <vector>
 #include <boost/shared_ptr.hpp>
 #include <boost/iostreams/concepts.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <zmq.hpp>
+#include "options.h"
 
 namespace comma { namespace io { namespace zeromq {
 
 /// istream wrapper for zeromq
+///
+/// data are copied directly from received message; a new message is received only
+/// when the current one is exhausted; multipart messages are read as consecutive parts
 class istream : public boost::iostreams::source
 {
 public:
-    istream( const std::string& endpoint );
+    istream( const std::string& endpoint, const zeromq::options& options = zeromq::options() );
 
     std::streamsize read( char* s, std::streamsize n );
 
     zmq::socket_t& socket() { return *socket_; }
 
 private:
-    boost::shared_ptr< zmq::context_t > context_; // super-ugly, just to make boost happy for now
+    std::shared_ptr< zmq::context_t > context_;
     boost::shared_ptr< zmq::socket_t > socket_; // super-ugly, just to make boost happy for now
-    std::vector< char > buffer_;
-    unsigned int index_;
+    boost::shared_ptr< zmq::message_t > message_; // current message, reused for receiving
+    std::size_t index_; // read position in current message
 };
 
 } } } // namespace comma { namespace io { namespace zeromq {
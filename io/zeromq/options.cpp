@@ -0,0 +1,77 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <mutex>
+#include <sstream>
+#include <vector>
+#include <boost/lexical_cast.hpp>
+#include "../../base/exception.h"
+#include "../../base/types.h"
+#include "../../string/split.h"
+#include "options.h"
+
+namespace comma { namespace io { namespace zeromq {
+
+options options::strip( std::string& name )
+{
+    options o;
+    std::vector< std::string > v = comma::split( name, ';' );
+    if( v.size() < 2 ) { return o; }
+    for( unsigned int i = 1; i < v.size(); ++i )
+    {
+        if( v[i] == "multipart" ) { o.multipart = true; continue; }
+        std::string::size_type p = v[i].find( '=' );
+        COMMA_ASSERT_BRIEF( p != std::string::npos, "expected zeromq stream option as <name>=<value>; got: '" << v[i] << "' in '" << name << "'" );
+        std::string key = v[i].substr( 0, p );
+        std::string value = v[i].substr( p + 1 );
+        if( key == "size" || key == "record-size" ) { o.record_size = boost::lexical_cast< std::size_t >( value ); }
+        else if( key == "batch" ) { o.batch = boost::lexical_cast< std::size_t >( value ); }
+        else if( key == "latency" ) { o.latency = boost::lexical_cast< double >( value ); }
+        else if( key == "hwm" ) { o.hwm = boost::lexical_cast< int >( value ); }
+        else if( key == "buffer" ) { o.buffer = boost::lexical_cast< int >( value ); }
+        else { COMMA_THROW( comma::exception, "unknown zeromq stream option '" << key << "' in '" << name << "'" ); }
+    }
+    COMMA_ASSERT_BRIEF( o.latency >= 0, "expected non-negative latency in '" << name << "'" );
+    COMMA_ASSERT_BRIEF( !o.multipart || o.batch > 0, "multipart requires batch in '" << name << "'" );
+    name = v[0];
+    return o;
+}
+
+std::string options::usage( unsigned int indent )
+{
+    std::string i( indent, ' ' );
+    std::ostringstream oss;
+    oss << i << "zeromq stream options: <name>[;<options>], e.g. zmq-local:/tmp/points;size=32;batch=1000;latency=0.01" << std::endl;
+    oss << i << "    size,record-size=<bytes>: binary record size; default: line-based ascii" << std::endl;
+    oss << i << "    batch=<n>: send <n> records per message; default: one message per write" << std::endl;
+    oss << i << "    latency=<seconds>: send incomplete batch, if its first record is older than <seconds>" << std::endl;
+    oss << i << "                       also when nothing is written any more; default: wait until batch is full" << std::endl;
+    oss << i << "    multipart: send batch as multipart message, one part per record, without copying" << std::endl;
+    oss << i << "    hwm=<n>: high water mark in messages; default: zeromq default" << std::endl;
+    oss << i << "    buffer=<bytes>: kernel socket buffer size; default: os default" << std::endl;
+    return oss.str();
+}
+
+void options::apply( zmq::socket_t& socket, bool send ) const
+{
+    #if ZMQ_VERSION_MAJOR == 2
+    if( hwm > 0 ) { comma::uint64 h = hwm; socket.setsockopt( ZMQ_HWM, &h, sizeof( h ) ); }
+    if( buffer > 0 ) { comma::uint64 b = buffer; socket.setsockopt( send ? ZMQ_SNDBUF : ZMQ_RCVBUF, &b, sizeof( b ) ); }
+    #else // ZMQ_VERSION_MAJOR == 2
+    if( hwm > 0 ) { socket.setsockopt( send ? ZMQ_SNDHWM : ZMQ_RCVHWM, &hwm, sizeof( hwm ) ); }
+    if( buffer > 0 ) { socket.setsockopt( send ? ZMQ_SNDBUF : ZMQ_RCVBUF, &buffer, sizeof( buffer ) ); }
+    #endif // ZMQ_VERSION_MAJOR == 2
+}
+
+std::shared_ptr< zmq::context_t > context()
+{
+    static std::mutex mutex;
+    static std::weak_ptr< zmq::context_t > weak; // context is not destroyed at exit, if a stream still holds it, which otherwise would block on open sockets
+    std::lock_guard< std::mutex > lock( mutex );
+    std::shared_ptr< zmq::context_t > c = weak.lock();
+    if( !c ) { c.reset( new zmq::context_t( 1 ) ); weak = c; }
+    return c;
+}
+
+} } } // namespace comma { namespace io { namespace zeromq {
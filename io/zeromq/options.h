@@ -0,0 +1,36 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <zmq.hpp>
+
+namespace comma { namespace io { namespace zeromq {
+
+/// zeromq stream options
+struct options
+{
+    std::size_t record_size{0}; /// record size in bytes; 0: line-based ascii
+    std::size_t batch{0}; /// number of records per message; 0: send one message per write (as before)
+    double latency{0}; /// if batching, maximum time in seconds records wait for the batch to fill; 0: no limit
+    bool multipart{false}; /// if batching, send batch as multipart message with a part per record
+    int hwm{0}; /// high water mark in messages; 0: zeromq default
+    int buffer{0}; /// kernel socket buffer size in bytes; 0: os default
+
+    /// strip zeromq options from name and return them, e.g.
+    ///     "zmq-local:/tmp/points;size=32;batch=1000;latency=0.01" -> "zmq-local:/tmp/points"
+    static options strip( std::string& name );
+
+    static std::string usage( unsigned int indent = 0 );
+
+    /// set high water mark and socket buffer sizes; call before bind or connect
+    void apply( zmq::socket_t& socket, bool send ) const;
+};
+
+/// context shared by all zeromq streams in the process while any of them is alive, thus inproc:// endpoints work across streams
+std::shared_ptr< zmq::context_t > context();
+
+} } } // namespace comma { namespace io { namespace zeromq {
@@ -33,18 +33,41 @@
 
 namespace comma { namespace io { namespace zeromq {
 
-ostream::ostream( const std::string& endpoint )
-    : context_( new zmq::context_t( 1 ) )
+ostream::ostream( const std::string& endpoint, const zeromq::options& options )
+    : context_( zeromq::context() )
     , socket_( new zmq::socket_t( *context_, ZMQ_PUB ) )
 {
+    options.apply( *socket_, true );
     socket_->bind( endpoint.c_str() );
+    sender_.reset( new zeromq::sender( *socket_, options ) );
 }
 
-std::streamsize ostream::write( const char* s, std::streamsize n )
+std::streamsize ostream::write( const char* s, std::streamsize n ) { return sender_->write( s, n ) ? n : -1; }
+
+bool ostream::flush() { return sender_->flush(); }
+
+void ostream::close() { sender_->close(); }
+
+ostreambuf::ostreambuf( const std::string& endpoint, const zeromq::options& options )
+    : context_( zeromq::context() )
+    , socket_( new zmq::socket_t( *context_, ZMQ_PUB ) )
 {
-    zmq::message_t message( n );
-    ::memcpy( ( void * )message.data(), s, n );
-    return socket_->send( message ) ? n : -1;
+    options.apply( *socket_, true );
+    socket_->bind( endpoint.c_str() );
+    sender_.reset( new zeromq::sender( *socket_, options ) );
 }
 
+ostreambuf::~ostreambuf() { try { sender_->close(); } catch( ... ) {} }
+
+std::streamsize ostreambuf::xsputn( const char* s, std::streamsize n ) { return sender_->write( s, n ) ? n : 0; }
+
+ostreambuf::int_type ostreambuf::overflow( int_type c )
+{
+    if( traits_type::eq_int_type( c, traits_type::eof() ) ) { return traits_type::not_eof( c ); }
+    char ch = traits_type::to_char_type( c );
+    return sender_->write( &ch, 1 ) ? c : traits_type::eof();
+}
+
+int ostreambuf::sync() { return sender_->flush() ? 0 : -1; }
+
 } } } // namespace comma { namespace io { namespace zeromq {
@@ -33,28 +33,76 @@
 #ifndef COMMA_IO_ZEROMQ_OSTREAM_H_
 #define COMMA_IO_ZEROMQ_OSTREAM_H_
 
+#include <memory>
 #include <boost/iostreams/concepts.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <boost/shared_ptr.hpp>
 #include <zmq.hpp>
+#include "options.h"
+#include "sender.h"
 
 namespace comma {
 namespace io {
 namespace zeromq {
 
-/// ostream wrapper for zeromq
+/// ostream wrapper for zeromq, sending a message per write
 class ostream : public boost::iostreams::sink
 {
 public:
-    ostream( const std::string& endpoint );
+    struct category : boost::iostreams::sink_tag, boost::iostreams::flushable_tag, boost::iostreams::closable_tag {};
+
+    ostream( const std::string& endpoint, const zeromq::options& options = zeromq::options() );
 
     std::streamsize write( const char* s, std::streamsize n );
 
+    bool flush();
+
+    void close();
+
     zmq::socket_t& socket() { return *socket_; }
 
 private:
-    boost::shared_ptr< zmq::context_t > context_; // super-ugly, just to make boost happy for now
+    std::shared_ptr< zmq::context_t > context_;
     boost::shared_ptr< zmq::socket_t > socket_; // super-ugly, just to make boost happy for now
+    boost::shared_ptr< zeromq::sender > sender_;
+};
+
+/// stream buffer sending records in batches without copying, see sender
+///
+/// writes go straight to the sender rather than through boost::iostreams buffer, which would
+/// hold records back from the sender's latency timer until the buffer is full or flushed
+class ostreambuf : public std::streambuf
+{
+public:
+    ostreambuf( const std::string& endpoint, const zeromq::options& options );
+
+    ~ostreambuf();
+
+    zmq::socket_t& socket() { return *socket_; }
+
+protected:
+    std::streamsize xsputn( const char* s, std::streamsize n );
+
+    int_type overflow( int_type c );
+
+    int sync();
+
+private:
+    std::shared_ptr< zmq::context_t > context_;
+    std::unique_ptr< zmq::socket_t > socket_;
+    std::unique_ptr< zeromq::sender > sender_; // declared after socket to stop sender timer before closing socket
+};
+
+/// output stream sending records in batches, used if options.batch is set
+class batch_ostream : public std::ostream
+{
+public:
+    batch_ostream( const std::string& endpoint, const zeromq::options& options ): std::ostream( nullptr ), buf_( endpoint, options ) { rdbuf( &buf_ ); }
+
+    zmq::socket_t& socket() { return buf_.socket(); }
+
+private:
+    ostreambuf buf_;
 };
 
 } } }
@@ -0,0 +1,200 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include "../../base/exception.h"
+#include "sender.h"
+
+namespace comma { namespace io { namespace zeromq {
+
+namespace impl {
+
+struct buffer
+{
+    std::vector< char > data;
+    std::size_t size{0};
+    std::atomic< unsigned int > references{0};
+    std::shared_ptr< buffer_pool > pool; // keeps pool alive while buffer is in flight
+
+    void append( const char* buf, std::size_t n )
+    {
+        if( n == 0 ) { return; }
+        if( size + n > data.size() ) { data.resize( std::max( size + n, data.size() * 2 ) ); }
+        std::memcpy( &data[0] + size, buf, n );
+        size += n;
+    }
+};
+
+class buffer_pool
+{
+    public:
+        enum { max_size = 64 };
+
+        buffer_pool( std::size_t capacity ): _capacity( capacity ) {}
+
+        ~buffer_pool() { for( auto b: _free ) { delete b; } }
+
+        buffer* get()
+        {
+            {
+                std::lock_guard< std::mutex > lock( _mutex );
+                if( !_free.empty() ) { buffer* b = _free.back(); _free.pop_back(); return b; }
+            }
+            buffer* b = new buffer;
+            b->data.resize( _capacity );
+            return b;
+        }
+
+        void put( buffer* b ) // called from zeromq i/o threads
+        {
+            b->size = 0;
+            std::lock_guard< std::mutex > lock( _mutex );
+            if( _free.size() < max_size ) { _free.push_back( b ); } else { delete b; }
+        }
+
+    private:
+        std::size_t _capacity;
+        std::mutex _mutex;
+        std::vector< buffer* > _free;
+};
+
+static void release( void*, void* hint ) // zeromq free function
+{
+    buffer* b = static_cast< buffer* >( hint );
+    if( --b->references > 0 ) { return; }
+    std::shared_ptr< buffer_pool > pool;
+    pool.swap( b->pool );
+    pool->put( b );
+}
+
+static bool send( zmq::socket_t& socket, buffer* b, std::size_t offset, std::size_t size, int flags )
+{
+    zmq::message_t message( &b->data[0] + offset, size, &release, b );
+    ++b->references;
+    return socket.send( message, flags );
+}
+
+} // namespace impl {
+
+sender::sender( zmq::socket_t& socket, const zeromq::options& options )
+    : _socket( socket )
+    , _options( options )
+    , _pool( new impl::buffer_pool( options.record_size > 0 ? options.record_size * std::max( options.batch, std::size_t( 1 ) ) : 65536 ) )
+    , _buffer( _pool->get() )
+    , _records( 0 )
+    , _end( 0 )
+    , _latency( std::chrono::duration_cast< std::chrono::steady_clock::duration >( std::chrono::duration< double >( options.latency ) ) )
+    , _shutdown( false )
+{
+    if( _options.batch > 0 && _options.latency > 0 ) { _timer = std::thread( &sender::_run_timer, this ); }
+}
+
+sender::~sender()
+{
+    if( _timer.joinable() )
+    {
+        { std::lock_guard< std::mutex > lock( _mutex ); _shutdown = true; }
+        _pending.notify_one();
+        _timer.join();
+    }
+    _pool->put( _buffer );
+}
+
+bool sender::write( const char* buf, std::size_t size )
+{
+    if( _options.batch == 0 )
+    {
+        zmq::message_t message( size );
+        ::memcpy( message.data(), buf, size );
+        return _socket.send( message );
+    }
+    std::lock_guard< std::mutex > lock( _mutex );
+    std::size_t begin = _buffer->size;
+    _buffer->append( buf, size );
+    std::size_t records = _records;
+    if( _options.record_size > 0 )
+    {
+        _records = _buffer->size / _options.record_size;
+        _end = _records * _options.record_size;
+    }
+    else
+    {
+        for( std::size_t i = begin; i < _buffer->size; ++i ) { if( _buffer->data[i] == '\n' ) { ++_records; _end = i + 1; } }
+    }
+    if( _records >= _options.batch ) { return _send( _end ); }
+    if( _options.latency == 0 || _records == 0 ) { return true; }
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if( records == 0 ) { _first = now; _pending.notify_one(); return true; }
+    return now - _first < _latency || _send( _end );
+}
+
+bool sender::flush()
+{
+    if( _options.batch == 0 ) { return true; }
+    std::lock_guard< std::mutex > lock( _mutex );
+    return _send( _end );
+}
+
+bool sender::close()
+{
+    if( _options.batch == 0 ) { return true; }
+    std::lock_guard< std::mutex > lock( _mutex );
+    return _send( _buffer->size );
+}
+
+void sender::_run_timer()
+{
+    std::unique_lock< std::mutex > lock( _mutex );
+    while( !_shutdown )
+    {
+        if( _records == 0 ) { _pending.wait( lock ); continue; }
+        std::chrono::steady_clock::time_point deadline = _first + _latency;
+        if( std::chrono::steady_clock::now() < deadline ) { _pending.wait_until( lock, deadline ); continue; } // records may have been sent meanwhile
+        try { _send( _end ); } catch( ... ) {} // quick and dirty: there is no caller to report send errors to
+    }
+}
+
+bool sender::_send( std::size_t size )
+{
+    if( size == 0 ) { return true; }
+    impl::buffer* b = _buffer;
+    _buffer = _pool->get();
+    _buffer->append( &b->data[0] + size, b->size - size ); // remainder has no whole records
+    b->size = size;
+    _records = 0;
+    _end = 0;
+    b->pool = _pool;
+    b->references = 1; // hold buffer until all parts are sent
+    bool ok = true;
+    try
+    {
+        for( std::size_t begin = 0, records = 0; begin < size && ok; records = 0 ) // message per batch, each sent out of the same buffer
+        {
+            for( std::size_t offset = begin; offset < size && ok; ++records )
+            {
+                std::size_t end = _options.record_size > 0 ? std::min( offset + _options.record_size, size )
+                                                           : std::find( b->data.begin() + offset, b->data.begin() + size, '\n' ) - b->data.begin() + 1;
+                end = std::min( end, size );
+                bool last = records + 1 == _options.batch || end == size;
+                if( _options.multipart ) { ok = impl::send( _socket, b, offset, end - offset, last ? 0 : ZMQ_SNDMORE ); }
+                else if( last ) { ok = impl::send( _socket, b, begin, end - begin, 0 ); }
+                offset = end;
+                if( last ) { begin = end; break; }
+            }
+        }
+    }
+    catch( ... )
+    {
+        impl::release( nullptr, b );
+        throw;
+    }
+    impl::release( nullptr, b );
+    return ok;
+}
+
+} } } // namespace comma { namespace io { namespace zeromq {
@@ -0,0 +1,66 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <boost/noncopyable.hpp>
+#include <zmq.hpp>
+#include "options.h"
+
+namespace comma { namespace io { namespace zeromq {
+
+namespace impl { struct buffer; class buffer_pool; }
+
+/// batching zero-copy sender
+///
+/// records are accumulated in pooled buffers; a full batch is sent as a message (or multipart
+/// message with a part per record) pointing into the buffer, without copying; the buffer returns
+/// to the pool when zeromq releases the last message referring to it
+///
+/// if options.latency is set, a timer thread sends incomplete batch once its first record is
+/// older than latency, even if nothing is written any more; socket is used under a mutex then
+///
+/// if options.batch is 0, each write is sent as a separate message, as before
+class sender : public boost::noncopyable
+{
+    public:
+        sender( zmq::socket_t& socket, const zeromq::options& options );
+
+        ~sender();
+
+        /// buffer data and send whole batches; return false, if message could not be sent
+        bool write( const char* buf, std::size_t size );
+
+        /// send all buffered whole records
+        bool flush();
+
+        /// send all buffered data, including incomplete record
+        bool close();
+
+        const zeromq::options& options() const { return _options; }
+
+    private:
+        zmq::socket_t& _socket;
+        zeromq::options _options;
+        std::shared_ptr< impl::buffer_pool > _pool;
+        impl::buffer* _buffer;
+        std::size_t _records; // number of whole records in buffer
+        std::size_t _end; // end of last whole record in buffer
+        std::chrono::steady_clock::time_point _first; // time of first buffered record
+        std::chrono::steady_clock::duration _latency;
+        std::mutex _mutex;
+        std::condition_variable _pending; // first whole record buffered or shutdown
+        bool _shutdown;
+        std::thread _timer;
+
+        bool _send( std::size_t size );
+        void _run_timer();
+};
+
+} } } // namespace comma { namespace io { namespace zeromq {
@@ -30,7 +30,9 @@
 
 /// @author cedric wohlleber
 
+#include "../../base/exception.h"
 #include "istream.h"
+#include "options.h"
 #include "ostream.h"
 #include <boost/thread/thread.hpp>
 #include <iostream>
@@ -41,18 +43,15 @@ template< typename S > struct traits {};
 template<> struct traits< std::istream > { typedef comma::io::zeromq::istream stream; };
 template<> struct traits< std::ostream > { typedef comma::io::zeromq::ostream stream; };
 
-template< typename S >
-inline static S* make_stream( const std::string& endpoint, comma::io::file_descriptor& fd )
+inline static void get_file_descriptor( zmq::socket_t& socket, comma::io::file_descriptor& fd )
 {
-    typedef typename traits< S >::stream stream_t;
-    boost::iostreams::stream< stream_t >* stream = new boost::iostreams::stream< stream_t >( endpoint.c_str() );
     bool have_fd = false;
     while( !have_fd ) // TODO ugly, have timeout instead.
     {
         try
         {
             std::size_t size = sizeof( comma::io::file_descriptor );
-            ( *stream )->socket().getsockopt( ZMQ_FD, &fd, &size );
+            socket.getsockopt( ZMQ_FD, &fd, &size );
             have_fd = true;
             assert( size == sizeof( fd ) );
         }
@@ -61,11 +60,33 @@ inline static S* make_stream( const std::string& endpoint, comma::io::file_descr
             boost::this_thread::sleep( boost::posix_time::microseconds( 20 ) );
         }
     }
+}
+
+template< typename S >
+inline static S* make_stream( const std::string& endpoint, const zeromq::options& options, comma::io::file_descriptor& fd )
+{
+    typedef typename traits< S >::stream stream_t;
+    boost::iostreams::stream< stream_t >* stream = new boost::iostreams::stream< stream_t >( stream_t( endpoint, options ) );
+    get_file_descriptor( ( *stream )->socket(), fd );
+    return stream;
+}
+
+template<>
+inline std::ostream* make_stream< std::ostream >( const std::string& endpoint, const zeromq::options& options, comma::io::file_descriptor& fd )
+{
+    if( options.batch == 0 )
+    {
+        boost::iostreams::stream< zeromq::ostream >* stream = new boost::iostreams::stream< zeromq::ostream >( zeromq::ostream( endpoint, options ) );
+        get_file_descriptor( ( *stream )->socket(), fd );
+        return stream;
+    }
+    zeromq::batch_ostream* stream = new zeromq::batch_ostream( endpoint, options );
+    get_file_descriptor( stream->socket(), fd );
     return stream;
 }
 
 template<>
-inline std::iostream* make_stream<std::iostream>( const std::string& endpoint, comma::io::file_descriptor& fd )
+inline std::iostream* make_stream<std::iostream>( const std::string& endpoint, const zeromq::options& options, comma::io::file_descriptor& fd )
 {
     COMMA_THROW( comma::exception, "zeromq does not support bidirectional iostream/or its not implemented in comma")
 }
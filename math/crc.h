@@ -0,0 +1,205 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <vector>
+#include "../base/exception.h"
+#include "../base/types.h"
+
+#if defined( __x86_64__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#define COMMA_MATH_CRC_SSE42
+#include <nmmintrin.h>
+#endif
+
+namespace comma { namespace math {
+
+/// crc of width up to 32 bits, table-driven, processing 8 bytes per step (slicing-by-8);
+/// if crc is crc-32c and cpu supports sse4.2, uses crc32 instruction, which is chosen at run time
+///
+/// parameters follow the usual crc model: width, polynomial, init, xor-out and reflected
+/// (input and output reflected together, which covers all crcs used here), see http://reveng.sourceforge.net/crc-catalogue
+class crc
+{
+    public:
+        struct parameters
+        {
+            unsigned int width;
+            comma::uint32 polynomial;
+            comma::uint32 init;
+            comma::uint32 xor_out;
+            bool reflected;
+        };
+
+        /// crc-16/arc, boost::crc_16_type
+        static parameters crc16() { return parameters{ 16, 0x8005, 0, 0, true }; }
+
+        /// crc-16/ibm-3740, boost::crc_ccitt_type
+        static parameters ccitt() { return parameters{ 16, 0x1021, 0xffff, 0, false }; }
+
+        /// crc-16/xmodem
+        static parameters xmodem() { return parameters{ 16, 0x1021, 0, 0, false }; }
+
+        /// what boost::crc_xmodem_type actually is: crc-16/kermit with reflected polynomial
+        static parameters xmodem_boost() { return parameters{ 16, 0x8408, 0, 0, true }; }
+
+        /// crc-32/iso-hdlc, boost::crc_32_type
+        static parameters crc32() { return parameters{ 32, 0x04c11db7, 0xffffffff, 0xffffffff, true }; }
+
+        /// crc-32c (castagnoli), as computed by sse4.2 crc32 instruction
+        static parameters crc32c() { return parameters{ 32, 0x1edc6f41, 0xffffffff, 0xffffffff, true }; }
+
+        /// rolling crc of fixed-size window, e.g. to search for a valid packet in a byte stream in linear time
+        class rolling;
+
+        /// @param hardware if false, always use tables, e.g. for testing
+        crc( const parameters& p, bool hardware = true );
+
+        /// return crc of buffer
+        comma::uint32 operator()( const char* buf, std::size_t size ) const { return finish( update( start(), buf, size ) ); }
+
+        /// incremental computation: finish( update( update( start(), a, n ), b, m ) ) is crc of a and b concatenated
+        comma::uint32 start() const { return _init; }
+
+        comma::uint32 update( comma::uint32 r, const char* buf, std::size_t size ) const;
+
+        comma::uint32 finish( comma::uint32 r ) const { return ( ( _parameters.reflected ? r : r >> ( 32 - _parameters.width ) ) ^ _parameters.xor_out ) & _mask; }
+
+        const crc::parameters& params() const { return _parameters; }
+
+        /// true, if hardware crc instruction is used
+        bool hardware() const { return _hardware; }
+
+    private:
+        parameters _parameters;
+        comma::uint32 _mask;
+        comma::uint32 _init; // register representation: reflected in lower bits or not reflected in upper bits
+        std::array< std::array< comma::uint32, 256 >, 8 > _table;
+        bool _hardware{false};
+
+        comma::uint32 _step( comma::uint32 r, unsigned char b ) const { return _parameters.reflected ? ( r >> 8 ) ^ _table[0][ ( r ^ b ) & 0xff ] : ( r << 8 ) ^ _table[0][ ( r >> 24 ) ^ b ]; }
+        comma::uint32 _update_reflected( comma::uint32 r, const unsigned char* p, std::size_t size ) const;
+        comma::uint32 _update( comma::uint32 r, const unsigned char* p, std::size_t size ) const;
+        static comma::uint32 _reflect( comma::uint32 v, unsigned int width ) { comma::uint32 r = 0; for( unsigned int i = 0; i < width; ++i, v >>= 1 ) { r = ( r << 1 ) | ( v & 1 ); } return r; }
+};
+
+class crc::rolling
+{
+    public:
+        /// @param size window size in bytes
+        rolling( const math::crc& c, std::size_t size );
+
+        /// set window and return its crc
+        comma::uint32 reset( const char* window ) { _r = _crc.update( 0, window, _size ); return value(); }
+
+        /// slide window by one byte, where out is its first byte and in is the byte following window; return new crc
+        comma::uint32 roll( char out, char in ) { _r = _crc._step( _r, static_cast< unsigned char >( in ) ) ^ _out[ static_cast< unsigned char >( out ) ]; return value(); }
+
+        /// crc of current window
+        comma::uint32 value() const { return _crc.finish( _r ^ _offset ); }
+
+        std::size_t size() const { return _size; }
+
+    private:
+        const math::crc& _crc;
+        std::size_t _size;
+        comma::uint32 _r{0}; // register with zero init, since crc is linear in init and data
+        comma::uint32 _offset; // contribution of init
+        std::array< comma::uint32, 256 > _out; // contribution of byte leaving window
+};
+
+namespace impl {
+
+#ifdef COMMA_MATH_CRC_SSE42
+
+__attribute__(( target( "sse4.2" ) ))
+inline comma::uint32 crc32c_sse42( comma::uint32 r, const unsigned char* p, std::size_t size )
+{
+    comma::uint64 s = r;
+    for( ; size >= 8; size -= 8, p += 8 ) { comma::uint64 v; std::memcpy( &v, p, 8 ); s = _mm_crc32_u64( s, v ); }
+    r = comma::uint32( s );
+    for( ; size > 0; --size, ++p ) { r = _mm_crc32_u8( r, *p ); }
+    return r;
+}
+
+inline bool has_sse42() { static const bool b = __builtin_cpu_supports( "sse4.2" ); return b; }
+
+#endif
+
+inline comma::uint32 load_le32( const unsigned char* p ) { return comma::uint32( p[0] ) | ( comma::uint32( p[1] ) << 8 ) | ( comma::uint32( p[2] ) << 16 ) | ( comma::uint32( p[3] ) << 24 ); }
+
+inline comma::uint32 load_be32( const unsigned char* p ) { return comma::uint32( p[3] ) | ( comma::uint32( p[2] ) << 8 ) | ( comma::uint32( p[1] ) << 16 ) | ( comma::uint32( p[0] ) << 24 ); }
+
+} // namespace impl {
+
+inline crc::crc( const parameters& p, bool hardware ): _parameters( p ), _mask( p.width == 32 ? 0xffffffff : ( comma::uint32( 1 ) << p.width ) - 1 )
+{
+    COMMA_ASSERT_BRIEF( p.width >= 8 && p.width <= 32, "crc: expected width between 8 and 32; got: " << p.width );
+    if( p.reflected )
+    {
+        comma::uint32 polynomial = _reflect( p.polynomial, p.width );
+        _init = _reflect( p.init & _mask, p.width );
+        for( unsigned int b = 0; b < 256; ++b ) { comma::uint32 r = b; for( unsigned int i = 0; i < 8; ++i ) { r = r & 1 ? ( r >> 1 ) ^ polynomial : r >> 1; } _table[0][b] = r; }
+        for( unsigned int k = 1; k < 8; ++k ) { for( unsigned int b = 0; b < 256; ++b ) { _table[k][b] = ( _table[ k - 1 ][b] >> 8 ) ^ _table[0][ _table[ k - 1 ][b] & 0xff ]; } }
+    }
+    else
+    {
+        comma::uint32 polynomial = ( p.polynomial & _mask ) << ( 32 - p.width );
+        _init = ( p.init & _mask ) << ( 32 - p.width );
+        for( unsigned int b = 0; b < 256; ++b ) { comma::uint32 r = b << 24; for( unsigned int i = 0; i < 8; ++i ) { r = r & 0x80000000 ? ( r << 1 ) ^ polynomial : r << 1; } _table[0][b] = r; }
+        for( unsigned int k = 1; k < 8; ++k ) { for( unsigned int b = 0; b < 256; ++b ) { _table[k][b] = ( _table[ k - 1 ][b] << 8 ) ^ _table[0][ _table[ k - 1 ][b] >> 24 ]; } }
+    }
+    #ifdef COMMA_MATH_CRC_SSE42
+    _hardware = hardware && p.width == 32 && p.polynomial == 0x1edc6f41 && p.reflected && impl::has_sse42();
+    #endif
+}
+
+inline comma::uint32 crc::update( comma::uint32 r, const char* buf, std::size_t size ) const
+{
+    const unsigned char* p = reinterpret_cast< const unsigned char* >( buf );
+    #ifdef COMMA_MATH_CRC_SSE42
+    if( _hardware ) { return impl::crc32c_sse42( r, p, size ); }
+    #endif
+    return _parameters.reflected ? _update_reflected( r, p, size ) : _update( r, p, size );
+}
+
+inline comma::uint32 crc::_update_reflected( comma::uint32 r, const unsigned char* p, std::size_t size ) const
+{
+    for( ; size >= 8; size -= 8, p += 8 )
+    {
+        comma::uint32 a = impl::load_le32( p ) ^ r;
+        comma::uint32 b = impl::load_le32( p + 4 );
+        r = _table[7][ a & 0xff ] ^ _table[6][ ( a >> 8 ) & 0xff ] ^ _table[5][ ( a >> 16 ) & 0xff ] ^ _table[4][ a >> 24 ]
+          ^ _table[3][ b & 0xff ] ^ _table[2][ ( b >> 8 ) & 0xff ] ^ _table[1][ ( b >> 16 ) & 0xff ] ^ _table[0][ b >> 24 ];
+    }
+    for( ; size > 0; --size, ++p ) { r = ( r >> 8 ) ^ _table[0][ ( r ^ *p ) & 0xff ]; }
+    return r;
+}
+
+inline comma::uint32 crc::_update( comma::uint32 r, const unsigned char* p, std::size_t size ) const
+{
+    for( ; size >= 8; size -= 8, p += 8 )
+    {
+        comma::uint32 a = impl::load_be32( p ) ^ r;
+        comma::uint32 b = impl::load_be32( p + 4 );
+        r = _table[7][ a >> 24 ] ^ _table[6][ ( a >> 16 ) & 0xff ] ^ _table[5][ ( a >> 8 ) & 0xff ] ^ _table[4][ a & 0xff ]
+          ^ _table[3][ b >> 24 ] ^ _table[2][ ( b >> 16 ) & 0xff ] ^ _table[1][ ( b >> 8 ) & 0xff ] ^ _table[0][ b & 0xff ];
+    }
+    for( ; size > 0; --size, ++p ) { r = ( r << 8 ) ^ _table[0][ ( r >> 24 ) ^ *p ]; }
+    return r;
+}
+
+inline crc::rolling::rolling( const math::crc& c, std::size_t size ): _crc( c ), _size( size )
+{
+    COMMA_ASSERT_BRIEF( size > 0, "crc: expected positive rolling window size" );
+    std::vector< char > zeros( size + 1, 0 );
+    _offset = _crc.update( _crc.start(), &zeros[0], size );
+    std::array< comma::uint32, 8 > bits; // contribution of byte leaving window is linear in its bits
+    for( unsigned int i = 0; i < 8; ++i ) { zeros[0] = char( 1 << i ); bits[i] = _crc.update( 0, &zeros[0], size + 1 ); }
+    for( unsigned int b = 0; b < 256; ++b ) { _out[b] = 0; for( unsigned int i = 0; i < 8; ++i ) { if( b & ( 1 << i ) ) { _out[b] ^= bits[i]; } } }
+}
+
+} } // namespace comma { namespace math {
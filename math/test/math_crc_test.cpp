@@ -0,0 +1,75 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <boost/crc.hpp>
+#include <gtest/gtest.h>
+#include "../crc.h"
+
+namespace comma { namespace math {
+
+template < typename Crc > static comma::uint32 boost_crc( const char* buf, std::size_t size ) { return std::for_each( buf, buf + size, Crc() )(); }
+
+static std::vector< char > random_bytes( std::size_t size )
+{
+    std::vector< char > v( size );
+    for( auto& c: v ) { c = char( std::rand() ); }
+    return v;
+}
+
+TEST( crc, check )
+{
+    const std::string s = "123456789"; // check values from crc catalogue
+    EXPECT_EQ( 0xbb3du, crc( crc::crc16() )( &s[0], s.size() ) );
+    EXPECT_EQ( 0x29b1u, crc( crc::ccitt() )( &s[0], s.size() ) );
+    EXPECT_EQ( 0x31c3u, crc( crc::xmodem() )( &s[0], s.size() ) );
+    EXPECT_EQ( 0xcbf43926u, crc( crc::crc32() )( &s[0], s.size() ) );
+    EXPECT_EQ( 0xe3069283u, crc( crc::crc32c() )( &s[0], s.size() ) );
+    EXPECT_EQ( 0xe3069283u, crc( crc::crc32c(), false )( &s[0], s.size() ) );
+}
+
+TEST( crc, boost )
+{
+    crc crc16( crc::crc16() ), ccitt( crc::ccitt() ), xmodem( crc::xmodem() ), xmodem_boost( crc::xmodem_boost() ), crc32( crc::crc32() );
+    for( std::size_t size = 0; size < 100; ++size ) // all tails of slicing
+    {
+        std::vector< char > v = random_bytes( size );
+        const char* p = size ? &v[0] : nullptr;
+        ASSERT_EQ( boost_crc< boost::crc_16_type >( p, size ), crc16( p, size ) );
+        ASSERT_EQ( boost_crc< boost::crc_ccitt_type >( p, size ), ccitt( p, size ) );
+        ASSERT_EQ( ( boost_crc< boost::crc_optimal< 16, 0x1021, 0, 0, false, false > >( p, size ) ), xmodem( p, size ) );
+        ASSERT_EQ( boost_crc< boost::crc_xmodem_type >( p, size ), xmodem_boost( p, size ) );
+        ASSERT_EQ( boost_crc< boost::crc_32_type >( p, size ), crc32( p, size ) );
+    }
+}
+
+TEST( crc, incremental )
+{
+    crc c( crc::ccitt() );
+    std::vector< char > v = random_bytes( 1000 );
+    EXPECT_EQ( c( &v[0], v.size() ), c.finish( c.update( c.update( c.start(), &v[0], 333 ), &v[333], 667 ) ) );
+    crc h( crc::crc32c() ), t( crc::crc32c(), false );
+    EXPECT_EQ( t( &v[0], v.size() ), h( &v[0], v.size() ) );
+}
+
+TEST( crc, rolling )
+{
+    std::vector< crc::parameters > parameters{ crc::crc16(), crc::ccitt(), crc::crc32(), crc::crc32c() };
+    std::vector< char > v = random_bytes( 300 );
+    for( const auto& p: parameters )
+    {
+        crc c( p );
+        for( std::size_t size: { 1, 7, 50 } )
+        {
+            crc::rolling r( c, size );
+            ASSERT_EQ( c( &v[0], size ), r.reset( &v[0] ) );
+            for( std::size_t i = 1; i + size <= v.size(); ++i ) { ASSERT_EQ( c( &v[i], size ), r.roll( v[ i - 1 ], v[ i + size - 1 ] ) ); }
+        }
+    }
+}
+
+} } // namespace comma { namespace math {
@@ -0,0 +1,36 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#include "../../../csv/impl/numpy_ascii.h"
+#include "ascii.h"
+
+typedef comma::csv::impl::numpy_ascii::codec codec_t;
+
+void* comma_csv_ascii_create( const char* format, char delimiter, int precision )
+{
+    try { return new codec_t( format, delimiter, precision ); }
+    catch( ... ) { return nullptr; }
+}
+
+void comma_csv_ascii_destroy( void* p ) { delete reinterpret_cast< codec_t* >( p ); }
+
+long comma_csv_ascii_from_lines( void* p, const char* buf, unsigned long size, void* records, unsigned long capacity )
+{
+    codec_t* c = reinterpret_cast< codec_t* >( p );
+    try { return c->from_lines( buf, size, reinterpret_cast< char* >( records ), capacity ); }
+    catch( std::exception& ex ) { c->error = ex.what(); }
+    catch( ... ) { c->error = "unknown exception"; }
+    return -1;
+}
+
+const char* comma_csv_ascii_to_lines( void* p, const void* records, unsigned long count, unsigned long* size )
+{
+    codec_t* c = reinterpret_cast< codec_t* >( p );
+    try { const std::string& s = c->to_lines( reinterpret_cast< const char* >( records ), count ); *size = s.size(); return s.data(); }
+    catch( std::exception& ex ) { c->error = ex.what(); }
+    catch( ... ) { c->error = "unknown exception"; }
+    return nullptr;
+}
+
+const char* comma_csv_ascii_error( const void* p ) { return reinterpret_cast< const codec_t* >( p )->error.c_str(); }
@@ -0,0 +1,32 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include "../definitions.h"
+#include "../memory.h"
+
+extern "C" {
+
+/// ascii codec for packed binary records of given comma format, e.g. "t,3d,ui,s[12]", to be used
+/// directly on numpy structured array buffers; functions do not touch python objects, thus with ctypes
+/// they run with python global interpreter lock released
+///
+/// @return codec or null, if format is invalid or contains types not supported, e.g. "lt"
+DLL_EXPORT void* comma_csv_ascii_create( const char* format, char delimiter, int precision );
+
+DLL_EXPORT void comma_csv_ascii_destroy( void* p );
+
+/// parse up to capacity newline-separated lines from buf into preallocated records
+/// @return number of records or -1 on error, see comma_csv_ascii_error()
+DLL_EXPORT long comma_csv_ascii_from_lines( void* p, const char* buf, unsigned long size, void* records, unsigned long capacity );
+
+/// output records as newline-terminated lines into codec buffer valid until next call
+/// @return buffer or null on error, see comma_csv_ascii_error()
+DLL_EXPORT const char* comma_csv_ascii_to_lines( void* p, const void* records, unsigned long count, unsigned long* size );
+
+/// @return last error message
+DLL_EXPORT const char* comma_csv_ascii_error( const void* p );
+
+}
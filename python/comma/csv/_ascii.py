@@ -0,0 +1,101 @@
+import ctypes, ctypes.util, numpy as np
+from ..numpy import types_of_dtype
+from . import time as csv_time
+
+_comma_types = { 'i1': 'b', 'u1': 'ub', 'i2': 'w', 'u2': 'uw', 'i4': 'i', 'u4': 'ui', 'i8': 'l', 'u8': 'ul', 'f4': 'f', 'f8': 'd' }
+
+_bindings = None
+
+def _load():
+    global _bindings
+    if _bindings is not None: return _bindings or None
+    _bindings = False
+    try:
+        bindings = ctypes.CDLL( ctypes.util.find_library( 'comma_python_bindings' ) or 'libcomma_python_bindings.so' ) # ctypes releases global interpreter lock for the duration of the calls
+        bindings.comma_csv_ascii_create.argtypes = [ ctypes.c_char_p, ctypes.c_char, ctypes.c_int ]
+        bindings.comma_csv_ascii_create.restype = ctypes.c_void_p
+        bindings.comma_csv_ascii_destroy.argtypes = [ ctypes.c_void_p ]
+        bindings.comma_csv_ascii_destroy.restype = None
+        bindings.comma_csv_ascii_from_lines.argtypes = [ ctypes.c_void_p, ctypes.c_char_p, ctypes.c_ulong, ctypes.c_void_p, ctypes.c_ulong ]
+        bindings.comma_csv_ascii_from_lines.restype = ctypes.c_long
+        bindings.comma_csv_ascii_to_lines.argtypes = [ ctypes.c_void_p, ctypes.c_void_p, ctypes.c_ulong, ctypes.POINTER( ctypes.c_ulong ) ]
+        bindings.comma_csv_ascii_to_lines.restype = ctypes.c_void_p
+        bindings.comma_csv_ascii_error.argtypes = [ ctypes.c_void_p ]
+        bindings.comma_csv_ascii_error.restype = ctypes.c_char_p
+    except ( OSError, AttributeError ): return # library not found or older library without csv codec
+    _bindings = bindings
+    return _bindings
+
+def comma_format( dtype ):
+    """
+    return comma format of packed records of given numpy dtype or None, if dtype cannot be represented exactly
+
+    >>> import numpy as np
+    >>> from comma.csv._ascii import comma_format
+    >>> comma_format( np.dtype( 'M8[us],(2,3)f8,i4,S12,u8' ) )
+    't,d,d,d,d,d,d,i,s[12],ul'
+    >>> comma_format( np.dtype( 'f8,S' ) ) is None
+    True
+    """
+    if dtype.newbyteorder( '=' ) != dtype: return
+    types = []
+    size = 0
+    for t in types_of_dtype( dtype, unroll=True ):
+        scalar = np.dtype( t )
+        if scalar == csv_time.DTYPE: types.append( 't' )
+        elif scalar.kind == 'S' and scalar.itemsize > 0: types.append( 's[{}]'.format( scalar.itemsize ) )
+        elif scalar.str[1:] in _comma_types: types.append( _comma_types[ scalar.str[1:] ] )
+        else: return
+        size += scalar.itemsize
+    if size != dtype.itemsize: return # e.g. padding for alignment
+    return ','.join( types )
+
+class codec:
+    """
+    ascii codec implemented in c++ reading lines directly into numpy structured arrays and writing them
+    from arrays without converting each scalar in python; conversions are the same as in comma.csv.stream,
+    anything the codec cannot convert exactly the same way, e.g. '1_000' as integer, is reported by
+    returning None, in which case the caller is expected to fall back to its own conversions
+    """
+    def __init__( self, bindings, c, dtype ):
+        self._bindings = bindings
+        self._codec = c
+        self.dtype = dtype
+        self.error = None
+
+    @staticmethod
+    def create( dtype, delimiter=',', precision=12 ):
+        """
+        return codec for given dtype or None, if dtype, delimiter, or precision are not supported or the library is not found
+        """
+        if len( delimiter ) != 1 or not isinstance( precision, int ) or precision < 0: return
+        format = comma_format( dtype )
+        if format is None: return
+        bindings = _load()
+        if bindings is None: return
+        c = bindings.comma_csv_ascii_create( format.encode( 'ascii' ), delimiter.encode( 'ascii' ), precision )
+        return None if c is None else codec( bindings, c, dtype )
+
+    def __del__( self ):
+        if self._codec is not None: self._bindings.comma_csv_ascii_destroy( self._codec ); self._codec = None
+
+    def read( self, lines ):
+        """
+        return array of records parsed from given list of lines or None on failure
+        """
+        try: buf = '\n'.join( lines ).encode( 'ascii' )
+        except UnicodeEncodeError: self.error = 'non-ascii input'; return
+        a = np.empty( len( lines ), dtype=self.dtype )
+        n = self._bindings.comma_csv_ascii_from_lines( self._codec, buf, len( buf ), a.ctypes.data, a.size )
+        if n == a.size: return a
+        self.error = self._bindings.comma_csv_ascii_error( self._codec ).decode().split( '\n' )[0] if n < 0 else 'expected {} records, got {}'.format( a.size, n )
+
+    def write( self, a ):
+        """
+        return given array as newline-terminated lines or None on failure
+        """
+        a = np.ascontiguousarray( a )
+        size = ctypes.c_ulong()
+        p = self._bindings.comma_csv_ascii_to_lines( self._codec, a.ctypes.data, a.size, ctypes.byref( size ) )
+        if p is None: self.error = self._bindings.comma_csv_ascii_error( self._codec ).decode().split( '\n' )[0]; return
+        return ctypes.string_at( p, size.value ).decode( 'utf-8' )
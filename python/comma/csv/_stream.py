@@ -14,6 +14,7 @@ from ..util import warning
 from ..io import readlines_unbuffered
 from ..numpy import merge_arrays, types_of_dtype, structured_dtype
 from . import time as csv_time
+from ._ascii import codec as ascii_codec
 from ._struct import struct
 
 DEFAULT_PRECISION = 12
@@ -78,6 +79,8 @@ class stream(object):
         #print( "self.unrolled_write_dtype = %s" % str(self.unrolled_write_dtype), file = sys.stderr )
         self._input_array = None
         self._ascii_buffer = None
+        self._ascii_reader = None if self.binary else ascii_codec.create(self.input_dtype, self.delimiter)
+        self._ascii_writer = None if self.binary else ascii_codec.create(self.struct.unrolled_flat_dtype, self.delimiter, self.precision)
         self._strings = functools.partial(map, self.numpy_scalar_to_string)
 
     def iter(self, size=None):
@@ -103,7 +106,9 @@ class stream(object):
         if no records have been read, return None
         """
         if size is None: size = self.size
-        self._input_array = copy.deepcopy( self._read( size ) ) if sys.version_info.major > 2 else self._read( size ) # todo! watch performance in python3!
+        input_array = self._read( size )
+        owned = input_array.flags.owndata and input_array.flags.writeable # arrays read directly into preallocated buffers do not need a copy
+        self._input_array = copy.deepcopy( input_array ) if sys.version_info.major > 2 and not owned else input_array # todo! watch performance in python3!
         if self._input_array.size == 0: return
         return self._struct_array(self._input_array, self.missing_values)
 
@@ -137,6 +142,11 @@ class stream(object):
     def _read(self, size):
         if self.binary:
             if sys.version_info.major > 2: #if np.__version__ >= '1.16.0': # sigh...
+                if self.source == sys.stdin and size >= 0: # read directly into numpy array buffer
+                    a = np.empty( size, dtype = self.input_dtype )
+                    n = sys.stdin.buffer.readinto( a.view( np.uint8 ) ) or 0
+                    if n % self.input_dtype.itemsize != 0: raise ValueError( "expected records of size {}, got {} bytes, which is not divisible by record size".format( self.input_dtype.itemsize, n ) )
+                    return a if n == a.nbytes else a[:n // self.input_dtype.itemsize]
                 if self.source == sys.stdin:
                     b = sys.stdin.buffer.read( ( size * self.input_dtype.itemsize ) if size >= 0 else -1 ) # b = sys.stdin.buffer.read( self.input_dtype.itemsize * ( size if size >= 0 else self.size ) )
                     # todo! test on streams where bytes come with irregular delays!
@@ -154,6 +164,10 @@ class stream(object):
             with warnings.catch_warnings():
                 warnings.simplefilter('ignore')
                 self._ascii_buffer = readlines_unbuffered(size, self.source)
+                if self._ascii_reader:
+                    a = self._ascii_reader.read( self._ascii_buffer )
+                    if a is not None: return a
+                    if self.verbose: self._warn( "falling back to numpy.genfromtxt: {}".format( self._ascii_reader.error ) )
                 return np.atleast_1d( self._genfromtxt() )
 
     def _struct_array(self, input_array, missing_values):
@@ -202,18 +216,32 @@ class stream(object):
         if self.binary:
             if sys.version_info.major > 2 and self.target == sys.stdout: # sigh...
                 #self.stdout.write( self._tie_binary(self.tied._input_array, s).tobytes() if self.tied else s.tobytes() )
-                sys.stdout.buffer.write( self._tie_binary(self.tied._input_array, s).tobytes() if self.tied else s.tobytes() )
+                sys.stdout.buffer.write( self._tie_binary(self.tied._input_array, s).tobytes() if self.tied else np.ascontiguousarray( s ).view( np.uint8 ) ) # untied: written from array buffer
             else:
                 if self.tied: self._tie_binary(self.tied._input_array, s).tofile(self.target)
                 else: s.tofile(self.target)
         else:
             unrolled_array = s.view(self.struct.unrolled_flat_dtype)
+            if self._write_ascii(unrolled_array): self.target.flush(); return
             #unrolled_array = s.view( self.unrolled_write_dtype )
             if self.tied: lines = self._tie_ascii(self.tied._ascii_buffer, unrolled_array)
             else: lines = (self._toline(scalars) for scalars in unrolled_array)
             for line in lines: print( line, file = self.target )
         self.target.flush()
 
+    def _write_ascii(self, unrolled_array):
+        if not self._ascii_writer: return False
+        text = self._ascii_writer.write(unrolled_array)
+        if text is None:
+            if self.verbose: self._warn("falling back to numpy_scalar_to_string: {}".format(self._ascii_writer.error))
+            return False
+        if self.tied:
+            lines = text.split('\n')
+            if len(lines) != len(self.tied._ascii_buffer) + 1: return False # e.g. strings with newlines
+            text = ''.join(tied_line + self.delimiter + line + '\n' for tied_line, line in izip(self.tied._ascii_buffer, lines))
+        self.target.write(text)
+        return True
+
     def _tie_binary(self, tied_array, array): return merge_arrays(tied_array, array)
 
     if sys.version_info.major < 3: # python3, sigh... don't ask
@@ -0,0 +1,76 @@
+// Copyright (c) 2026 agent
+
+/// @author agent
+
+#pragma once
+
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#else
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#endif
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+
+namespace comma { namespace futex {
+
+#ifndef __linux__
+namespace impl {
+
+struct waiters
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+/// condition variables for process-private words, shared by words with the same hash
+inline waiters& waiters_of( const void* word )
+{
+    static waiters table[64];
+    return table[ ( reinterpret_cast< std::uintptr_t >( word ) / sizeof( std::uint32_t ) ) % 64 ];
+}
+
+} // namespace impl {
+#endif // #ifndef __linux__
+
+/// sleep, while word equals value, but no longer than given time, negative: no timeout
+/// @param shared true: word may be in memory shared between processes; false: faster, process-private word
+/// on other platforms than linux, process-private words sleep on condition variable, shared words are polled
+inline void wait( std::atomic< std::uint32_t >& word, std::uint32_t value, long long microseconds, bool shared = true )
+{
+    #ifdef __linux__
+    struct timespec t;
+    t.tv_sec = microseconds / 1000000;
+    t.tv_nsec = ( microseconds % 1000000 ) * 1000;
+    ::syscall( SYS_futex, reinterpret_cast< std::uint32_t* >( &word ), shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE, value, microseconds < 0 ? nullptr : &t, nullptr, 0 );
+    #else
+    if( shared ) { if( word.load() == value ) { ::usleep( microseconds < 0 ? 100 : std::min( microseconds, 100LL ) ); } return; } // quick and dirty: condition variable does not work across processes
+    impl::waiters& w = impl::waiters_of( &word );
+    std::unique_lock< std::mutex > lock( w.mutex );
+    auto woken = [&]() { return word.load() != value; };
+    if( microseconds < 0 ) { w.condition.wait( lock, woken ); } else { w.condition.wait_for( lock, std::chrono::microseconds( microseconds ), woken ); }
+    #endif
+}
+
+/// wake up all waiting on word; call after changing word
+inline void wake( std::atomic< std::uint32_t >& word, bool shared = true )
+{
+    #ifdef __linux__
+    ::syscall( SYS_futex, reinterpret_cast< std::uint32_t* >( &word ), shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0 );
+    #else
+    if( shared ) { return; }
+    impl::waiters& w = impl::waiters_of( &word );
+    std::lock_guard< std::mutex > lock( w.mutex ); // waiter checks word under the same mutex, thus wake-up is not lost
+    w.condition.notify_all();
+    #endif
+}
+
+} } // namespace comma { namespace futex {